@@ -0,0 +1,152 @@
+"""
+Export a trained PCA+LDA model to the flat binary container read in place by
+the embedded classifier (src/helper/model/modelContainer.h).
+
+Layout (little-endian, every section 16-byte aligned):
+- header:   magic "A36M", u16 version, u16 section count, u32 total size,
+            u32 CRC-32 of every byte after the header
+- sections: u32 id, u32 offset, u16 rows, u16 cols, u16 type, u16 reserved
+- payload:  row-major float32 arrays
+
+Usage:
+    python export_model.py bin/pca_lda.pkl --bin bin/classifier_model.bin
+    python export_model.py bin/pca_lda.pkl --cpp defaultClassifierModel.cpp
+
+The .bin file can be memory mapped on the host. The .cpp file places the same
+bytes as a const array in flash on the target.
+"""
+
+import argparse
+import struct
+import zlib
+
+import numpy as np
+
+MODEL_MAGIC = 0x4D363341  # "A36M"
+MODEL_FORMAT_VERSION = 1
+MODEL_ALIGNMENT = 16
+HEADER_FORMAT = "<IHHII"
+SECTION_FORMAT = "<IIHHHH"
+SECTION_TYPE_F32 = 0
+
+# Section ids, see classifierModel.h.
+PCA_MEAN = 1
+PCA_PROJECTION = 2
+LDA_WEIGHTS = 3
+LDA_BIASES = 4
+LDA_SCALINGS = 5
+LDA_HOST_BIASES = 6
+
+
+def _align(offset):
+    return (offset + MODEL_ALIGNMENT - 1) // MODEL_ALIGNMENT * MODEL_ALIGNMENT
+
+
+def build_model(sections):
+    """
+    Build the container from (id, 2D array) pairs.
+
+    Returns:
+        bytes: The container.
+    """
+    header_size = struct.calcsize(HEADER_FORMAT)
+    table_size = struct.calcsize(SECTION_FORMAT) * len(sections)
+
+    offset = _align(header_size + table_size)
+    table = b""
+    payload = b""
+    for section_id, values in sections:
+        values = np.atleast_2d(np.asarray(values, dtype="<f4"))
+        rows, cols = values.shape
+        table += struct.pack(SECTION_FORMAT, section_id, offset, rows, cols,
+                             SECTION_TYPE_F32, 0)
+        data = values.tobytes(order="C")
+        padding = _align(len(data)) - len(data)
+        payload += data + b"\0" * padding
+        offset += len(data) + padding
+
+    body = table + b"\0" * (_align(header_size + table_size) - header_size -
+                            table_size) + payload
+    total_size = header_size + len(body)
+    header = struct.pack(HEADER_FORMAT, MODEL_MAGIC, MODEL_FORMAT_VERSION,
+                         len(sections), total_size, zlib.crc32(body))
+    return header + body
+
+
+def build_pca_lda_model(pca_mean, pca_projection, lda_weights, lda_biases,
+                        lda_scalings, lda_host_biases=None):
+    """
+    Build the container of a PCA+LDA classifier.
+
+    Args:
+        pca_mean: MFCC mean, numDCTCoeff values.
+        pca_projection: numDCTCoeff x numPCAComponents (components_.T).
+        lda_weights: numClasses x numPCAComponents (coef_).
+        lda_biases: numClasses values (intercept_).
+        lda_scalings: numPCAComponents x (numClasses - 1) (scalings_), or None
+            if the solver has none.
+        lda_host_biases: Optional biases used by host builds instead.
+    """
+    sections = [
+        (PCA_MEAN, np.reshape(pca_mean, (1, -1))),
+        (PCA_PROJECTION, pca_projection),
+        (LDA_WEIGHTS, lda_weights),
+        (LDA_BIASES, np.reshape(lda_biases, (1, -1))),
+    ]
+    if lda_scalings is not None:
+        sections.append((LDA_SCALINGS, lda_scalings))
+    if lda_host_biases is not None:
+        sections.append((LDA_HOST_BIASES, np.reshape(lda_host_biases, (1, -1))))
+    return build_model(sections)
+
+
+def write_cpp(path, model, symbol="DEFAULT_CLASSIFIER_MODEL"):
+    """Write the container as a 16-byte aligned const array."""
+    lines = []
+    for i in range(0, len(model), 12):
+        chunk = model[i: i + 12]
+        lines.append("    " + ", ".join(f"0x{b:02x}" for b in chunk) + ",")
+    with open(path, "w", encoding="utf-8") as f:
+        f.write("/**\n")
+        f.write(" " + "*" * 78 + "\n")
+        f.write(f" * @file    {path.split('/')[-1]}\n")
+        f.write(" * @brief   Default classifier model in the flat binary "
+                "container. Generated\n")
+        f.write(" *          by scripts/classification_scripts/export_model.py"
+                ", do not edit.\n")
+        f.write(" " + "*" * 78 + "\n")
+        f.write(" */\n\n")
+        f.write("#include \"classifierModel.h\"\n\n")
+        f.write(f"alignas(MODEL_ALIGNMENT) const uint8_t {symbol}_DATA[] = {{\n")
+        f.write("\n".join(lines) + "\n};\n\n")
+        f.write(f"const size_t {symbol}_SIZE =\n    sizeof({symbol}_DATA);\n")
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("model", help="pca_lda.pkl written by the training scripts")
+    parser.add_argument("--bin", help="Destination of the binary container")
+    parser.add_argument("--cpp", help="Destination of the C++ array")
+    parser.add_argument("--host-biases", nargs="+", type=float, default=None,
+                        help="LDA biases used by host builds instead")
+    args = parser.parse_args()
+
+    import joblib
+
+    trained = joblib.load(args.model)
+    pca, lda = trained["pca"], trained["lda"]
+    model = build_pca_lda_model(pca.mean_, pca.components_.T, lda.coef_,
+                                lda.intercept_, getattr(lda, "scalings_", None),
+                                args.host_biases)
+
+    if args.bin:
+        with open(args.bin, "wb") as f:
+            f.write(model)
+        print(f"Model container saved to {args.bin} ({len(model)} bytes)")
+    if args.cpp:
+        write_cpp(args.cpp, model)
+        print(f"Model array saved to {args.cpp}")
+
+
+if __name__ == "__main__":
+    main()
@@ -27,6 +27,8 @@ from sklearn.metrics import accuracy_score
 from sklearn.model_selection import StratifiedKFold
 from tqdm import tqdm
 
+from export_model import build_pca_lda_model
+
 
 # Embedded-aligned defaults
 SR = 16000
@@ -558,6 +560,12 @@ def train_pca_lda_model(
         f.write(f"Class order: {format_cpp_string_vector(lda.classes_)}\n")
     print(f"💾 Matrices saved to {matrices_path}")
 
+    model_bin_path = os.path.join(os.path.dirname(save_path), "classifier_model.bin")
+    with open(model_bin_path, "wb") as f:
+        f.write(build_pca_lda_model(pca.mean_, pca.components_.T, lda.coef_,
+                                    lda.intercept_, getattr(lda, "scalings_", None)))
+    print(f"💾 Model container saved to {model_bin_path}")
+
 
 def main():
     parser = argparse.ArgumentParser()
@@ -32,6 +32,7 @@ from sklearn.decomposition import PCA
 from sklearn.discriminant_analysis import LinearDiscriminantAnalysis as LDA
 from sklearn.linear_model import LogisticRegression
 
+from export_model import build_pca_lda_model
 from final_training_esc50 import (
     extract_mfcc_features,
     transform_pca_frames,
@@ -276,6 +277,12 @@ def train_small(
 
     print(f"Matrices saved to {matrices_path}")
 
+    model_bin_path = os.path.join(os.path.dirname(save_path), "classifier_model.bin")
+    with open(model_bin_path, "wb") as f:
+        f.write(build_pca_lda_model(pca.mean_, pca.components_.T, lda.coef_,
+                                    lda.intercept_, getattr(lda, "scalings_", None)))
+    print(f"Model container saved to {model_bin_path}")
+
 
 def main():
     base_dir = os.path.dirname(os.path.abspath(__file__))
@@ -14,42 +14,55 @@
 #include <numeric>
 
 #include "constants.h"
+#include "fastmath.h"
 #include "matrix.h"
 
-void Classification::GenerateSTFT(float* powerSpectra, matrix& stftData) {
-  const uint16_t numFrames = this->powerFramesSize;
-
-  matrix_init_f32(&stftData, numFrames, this->numFreqBins, powerSpectra);
-}
-
 Classification::Classification(uint16_t fftSize, uint16_t numMelFilters,
                                uint16_t numDCTCoeff, uint16_t numPCAComponents,
-                               uint16_t numClasses)
+                               uint16_t numClasses, bool usePreDetector,
+                               uint16_t contextFrames)
     : fftSize(fftSize),
       numFreqBins(fftSize / 2 + 1),
       numMelFilters(numMelFilters),
       numDCTCoeff(numDCTCoeff),
       numPCAComponents(numPCAComponents),
       numClasses(numClasses),
+      toneDetector({SMOKE_ALARM_BAND, SIREN_BAND, VOICE_BAND},
+                   SAMPLE_FREQUENCY),
+      usePreDetector(usePreDetector),
       fft(fftSize, SAMPLE_FREQUENCY),
       melFilter(numMelFilters, fftSize, SAMPLE_FREQUENCY),
       dct(numDCTCoeff, numMelFilters),
       pca(numPCAComponents, numDCTCoeff),
       lda(numPCAComponents, numClasses),
+      fusedClassifier(dct, pca, lda, numMelFilters, numDCTCoeff,
+                      numPCAComponents, numClasses),
+      quantizedClassifier(pca, lda, numDCTCoeff, numPCAComponents, numClasses),
       currClassification(ClassificationLabel::Unknown),
-      melSpectrogramVector{},
-      mfccSpectrogramVector{},
-      pcaFeatureVector{},
-      normalized{} {
-  memset(this->powerFrames, 0,
-         sizeof(float) * (this->numFreqBins * CLASSIFICATION_BUFFER_SIZE));
-}
+      contextFrames(std::max<uint16_t>(contextFrames, 1)),
+      featureRing(static_cast<size_t>(this->contextFrames) * numPCAComponents),
+      scoreRing(static_cast<size_t>(this->contextFrames) * numClasses),
+      confidenceRing(this->contextFrames),
+      scoreSums(numClasses),
+      windowScores(numClasses),
+      melFrame(numMelFilters),
+      mfccFrame(numDCTCoeff),
+      normalized{} {}
 
 std::string Classification::getClassificationLabel() {
   return ClassificationClassToString(this->currClassification);
 }
 
 void Classification::classify(const float* rawAudio) {
+  // Silence and broadband background cannot be any of the classes. Skip the
+  // whole pipeline. The history keeps the latest active frames.
+  if (this->usePreDetector &&
+      !this->toneDetector.isActive(rawAudio, this->fftSize)) {
+    this->skippedFrames++;
+    this->currClassification = ClassificationLabel::Unknown;
+    return;
+  }
+
   // Compute FFT and immediately extract power spectrum, discarding other
   // fields.
 
@@ -103,41 +116,122 @@ void Classification::classify(const float* rawAudio) {
 
   constexpr float kSoftClipDrive = 1.5f;
 
+  const float drive = kSoftClipDrive * gain;
   for (int i = 0; i < this->fftSize; i++) {
-    float v = normalized[i];
-    v = v * gain;
-    v = tanh(kSoftClipDrive * v);
-    v = std::clamp(v, -1.0f, 1.0f);
-    normalized[i] = v;
+    normalized[i] *= drive;
   }
 
-  this->fft.signalToFrequency(normalized, freq, WindowFunction::HANN_WINDOW);
-  float* power = powerFrames[currFrameIndex];
+  // Soft clip the whole frame in one block. fastTanh stays within [-1, 1].
+  fastTanh(normalized, normalized, this->fftSize);
+
+  // Only the power spectrum feeds the mel filter bank.
+  this->fft.signalToFrequency(normalized, freq, WindowFunction::HANN_WINDOW,
+                              SPECTRUM_POWER);
+  this->classifyPowerSpectrum(freq.powerMagnitude);
+}
+
+void Classification::classifyPowerSpectrum(const float* powerSpectrum) {
+  // Features of the newest frame only. The scores of the older frames are
+  // cached in the rings.
+  this->melFilter.applyFrame(powerSpectrum, this->melFrame.data());
 
-  for (uint16_t i = 0; i < this->numFreqBins; ++i) {
-    power[i] = freq.powerMagnitude[i];
+  float* scores =
+      &this->scoreRing[static_cast<size_t>(this->ringIndex) * this->numClasses];
+
+  // The new frame overwrites the oldest one, whose scores leave the sums.
+  if (this->ringSize == this->contextFrames) {
+    for (uint16_t c = 0; c < this->numClasses; ++c) {
+      this->scoreSums[c] -= scores[c];
+    }
+    this->confidenceSum -= this->confidenceRing[this->ringIndex];
+  } else {
+    this->ringSize++;
   }
 
-  this->currFrameIndex =
-      (this->currFrameIndex + 1) % CLASSIFICATION_BUFFER_SIZE;
+  float confidence;
+  if (this->backend == ClassifierBackend::FUSED) {
+    this->fusedClassifier.scoreFrame(this->melFrame.data(), scores);
+    confidence = this->lda.frameConfidence(scores);
+  } else {
+    matrix melSpec;
+    matrix_init_f32(&melSpec, 1, this->numMelFilters, this->melFrame.data());
+    matrix mfccSpec;
+    this->dct.apply(melSpec, mfccSpec, this->mfccFrame.data());
+
+    float* features =
+        &this->featureRing[static_cast<size_t>(this->ringIndex) *
+                           this->numPCAComponents];
+    if (this->backend == ClassifierBackend::STAGED) {
+      matrix pcaSpec;
+      this->pca.apply(mfccSpec, pcaSpec, features);
+      confidence = this->lda.scoreFrame(features, scores);
+    } else {
+      this->quantizedClassifier.projectFrame(this->mfccFrame.data(),
+                                              features);
+      this->quantizedClassifier.scoreFeatures(features, scores);
+      confidence = this->lda.frameConfidence(scores);
+    }
+  }
 
-  this->powerFramesSize = (this->powerFramesSize == CLASSIFICATION_BUFFER_SIZE)
-                              ? CLASSIFICATION_BUFFER_SIZE
-                              : this->powerFramesSize + 1;
+  this->confidenceRing[this->ringIndex] = confidence;
+  for (uint16_t c = 0; c < this->numClasses; ++c) {
+    this->scoreSums[c] += scores[c];
+  }
+  this->confidenceSum += confidence;
 
-  if (this->powerFramesSize < CLASSIFICATION_BUFFER_SIZE) {
+  this->ringIndex = (this->ringIndex + 1) % this->contextFrames;
+
+  if (this->ringSize < this->contextFrames) {
     return;
   }
 
-  // Pass pointer to first element in 2D array, we can then use pointer
-  // arithmetic to access all of it.
-  this->GenerateSTFT(&powerFrames[0][0], stftSpec);
+  for (uint16_t c = 0; c < this->numClasses; ++c) {
+    this->windowScores[c] = static_cast<float>(this->scoreSums[c]);
+  }
+  this->currClassification = this->lda.decide(
+      this->windowScores.data(), static_cast<float>(this->confidenceSum),
+      this->contextFrames);
+}
 
-  this->melFilter.apply(stftSpec, melSpec, melSpectrogramVector);
+void Classification::setBackend(ClassifierBackend backend) {
+  if (backend == this->backend) {
+    return;
+  }
+  this->backend = backend;
+  this->clearContext();
+}
 
-  this->dct.apply(melSpec, mfccSpec, mfccSpectrogramVector);
+bool Classification::setModel(const ClassifierModel& model) {
+  if (!model.isLoaded()) {
+    return false;
+  }
+  this->pca.setModel(model);
+  this->lda.setModel(model);
+  this->fusedClassifier =
+      FusedLinearClassifier(this->dct, this->pca, this->lda,
+                            this->numMelFilters, this->numDCTCoeff,
+                            this->numPCAComponents, this->numClasses);
+  this->quantizedClassifier =
+      QuantizedClassifier(this->pca, this->lda, this->numDCTCoeff,
+                          this->numPCAComponents, this->numClasses);
+  this->clearContext();
+  return true;
+}
 
-  this->pca.apply(mfccSpec, pcaSpec, pcaFeatureVector);
+void Classification::clearContext() {
+  this->ringIndex = 0;
+  this->ringSize = 0;
+  std::fill(this->scoreSums.begin(), this->scoreSums.end(), 0.0);
+  this->confidenceSum = 0.0;
+  this->currClassification = ClassificationLabel::Unknown;
+}
 
-  this->currClassification = this->lda.apply(pcaSpec);
+const float* Classification::getFeatureRow(uint16_t age) const {
+  if (this->backend == ClassifierBackend::FUSED || age >= this->ringSize) {
+    return nullptr;
+  }
+  const uint16_t slot =
+      (this->ringIndex + this->contextFrames - 1 - age) % this->contextFrames;
+  return &this->featureRing[static_cast<size_t>(slot) *
+                            this->numPCAComponents];
 }
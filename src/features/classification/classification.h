@@ -5,6 +5,8 @@
  ******************************************************************************
  */
 
+#pragma once
+
 #include <string>
 #include <vector>
 
@@ -12,10 +14,23 @@
 #include "dct.h"
 #include "fft.h"
 #include "frequencyDomain.h"
+#include "fusedClassifier.h"
 #include "lda.h"
 #include "mel_filter.h"
 #include "pca.h"
+#include "quantizedClassifier.h"
 #include "runtime_audio360.hpp"
+#include "toneDetector.h"
+
+/** @brief How the features of a frame are scored. */
+enum class ClassifierBackend {
+  /** @brief DCT, PCA and LDA composed into one float matrix. */
+  FUSED,
+  /** @brief DCT, PCA and LDA in sequence, in float. */
+  STAGED,
+  /** @brief Float DCT, then PCA and LDA with int8 weights. */
+  INT8,
+};
 
 class Classification {
  public:
@@ -27,36 +42,105 @@ class Classification {
    * @param numDCTCoeff Number of DCT coefficients to retain.
    * @param numPCAComponents Number of PCA components to retain.
    * @param numClasses Number of output classes supported.
+   * @param usePreDetector Skip the pipeline on frames the tone pre-detector
+   * rejects.
+   * @param contextFrames Number of frames whose scores are averaged into a
+   * decision. The cost per frame does not depend on it.
    */
   Classification(uint16_t fftSize, uint16_t numMelFilters, uint16_t numDCTCoeff,
-                 uint16_t numPCAComponents, uint16_t numClasses);
+                 uint16_t numPCAComponents, uint16_t numClasses,
+                 bool usePreDetector = true,
+                 uint16_t contextFrames = CLASSIFICATION_BUFFER_SIZE);
 
   /**
    * @brief Runs the end-to-end classification pipeline on FFT frames.
    *
    * Applies mel filtering, DCT, PCA, and LDA in sequence to infer a class.
+   * Frames rejected by the tone pre-detector are labeled unknown without
+   * running the pipeline.
    *
    * @param rawAudio Input array of FFT frames, of size frames x
    * (fftSize/2 + 1) [nyquist].
    */
   void classify(const float* rawAudio);
 
+  /**
+   * @brief Add the features of one frame to the context and update the label.
+   *
+   * Only the new frame goes through mel filtering and scoring, by the backend
+   * set with setBackend. Its scores replace those of
+   * the oldest frame in running sums, so the decision covers the last
+   * contextFrames frames at a constant cost.
+   *
+   * @param powerSpectrum Power spectrum of the frame, of size fftSize/2 + 1.
+   */
+  void classifyPowerSpectrum(const float* powerSpectrum);
+
+  /**
+   * @brief Get the number of frames in a decision.
+   *
+   * @return uint16_t Number of frames.
+   */
+  uint16_t getContextFrames() const { return this->contextFrames; }
+
+  /**
+   * @brief Use the weights of another model. The fused and quantized
+   * classifiers are rebuilt and the context is cleared.
+   *
+   * @param model Model read in place. Must outlive the object.
+   * @return true if the model is loaded and now in use.
+   */
+  bool setModel(const ClassifierModel& model);
+
+  /**
+   * @brief Choose how frames are scored. Switching clears the context.
+   *
+   * The fused backend is the fastest. The staged backend is slower but keeps
+   * the PCA features of every frame for debugging. The int8 backend keeps
+   * them too. Its weights and scales (156 bytes with the default model, see
+   * QuantizedClassifier::getWeightBytes) are built for every classifier on top
+   * of the 384 bytes of float PCA and LDA weights, which stay loaded for the
+   * other backends, so it adds RAM rather than saving it. It also still runs
+   * the float DCT and quantizes each frame. On the host that makes it about
+   * 20% slower than the fused backend, and no faster than the staged one.
+   *
+   * @param backend Backend scoring the next frames.
+   */
+  void setBackend(ClassifierBackend backend);
+
+  /**
+   * @brief Get the backend scoring frames.
+   *
+   * @return ClassifierBackend The backend in use.
+   */
+  ClassifierBackend getBackend() const { return this->backend; }
+
+  /**
+   * @brief Get the PCA features of a frame in the context. Only the staged
+   * and int8 backends compute them.
+   *
+   * @param age 0 for the newest frame, up to the number of frames held - 1.
+   * @return const float* numPCAComponents features, or nullptr if the context
+   * does not hold that frame or the fused backend is in use.
+   */
+  const float* getFeatureRow(uint16_t age) const;
+
   /**
    * @brief Returns the classification label state value from the classification
    * module
    */
   std::string getClassificationLabel();
 
- private:
   /**
-   * @brief Builds the STFT matrix representation from FFT frames.
+   * @brief Get the number of frames the tone pre-detector skipped.
    *
-   * @param powerSpectra Input vector of power spectra, of size frames x
-   * (fftSize/2 + 1) [nyquist].
-   * @param stftData Output STFT matrix, of dimensions frames x
-   * (fftSize/2 + 1) [nyquist].
+   * @return uint32_t Number of skipped frames.
    */
-  void GenerateSTFT(float* powerSpectra, matrix& stftData);
+  uint32_t getSkippedFrameCount() const { return this->skippedFrames; }
+
+ private:
+  /** @brief Forget every frame of the context. */
+  void clearContext();
 
   /** @brief FFT size used for frequency-domain processing. */
   uint16_t fftSize;
@@ -76,6 +160,15 @@ class Classification {
   /** @brief Number of supported output classes. */
   uint16_t numClasses;
 
+  /** @brief Cheap first stage deciding whether a frame is classified. */
+  ToneDetector toneDetector;
+
+  /** @brief Whether frames rejected by the tone pre-detector are skipped. */
+  bool usePreDetector;
+
+  /** @brief Number of frames skipped by the tone pre-detector. */
+  uint32_t skippedFrames = 0;
+
   /** @brief FFT module. */
   FFT fft;
 
@@ -91,39 +184,53 @@ class Classification {
   /** @brief LDA processor for classification. */
   LinearDiscriminantAnalysis lda;
 
+  /** @brief DCT, PCA and LDA composed into one matrix. */
+  FusedLinearClassifier fusedClassifier;
+
+  /** @brief PCA and LDA with int8 weights. */
+  QuantizedClassifier quantizedClassifier;
+
+  /** @brief Backend scoring frames. */
+  ClassifierBackend backend = ClassifierBackend::FUSED;
+
   /** @brief Last inferred classification result. */
   ClassificationLabel currClassification;
 
-  /** @brief Sliding buffer of power spectra per frame (size: n_fft/2 + 1). */
-  float powerFrames[CLASSIFICATION_BUFFER_SIZE][(DOA_SAMPLES / 2) + 1];
+  /** @brief Number of frames in a decision. */
+  uint16_t contextFrames;
+
+  /** @brief Slot of the next frame in the rings. */
+  uint16_t ringIndex = 0;
 
-  /** @brief Index tracking for current frame. */
-  uint8_t currFrameIndex = 0;
+  /** @brief Number of frames held in the rings, up to contextFrames. */
+  uint16_t ringSize = 0;
 
-  /** @brief The size of the power frame */
-  uint8_t powerFramesSize = 0;
+  /** @brief Ring of PCA features per frame, contextFrames x numPCAComponents.
+   * Not filled by the fused backend. */
+  std::vector<float> featureRing;
 
-  /** @brief Matrix representation of the fftData vector */
-  matrix stftSpec;
+  /** @brief Ring of LDA class scores per frame, contextFrames x numClasses. */
+  std::vector<float> scoreRing;
 
-  /** @brief Matrix that will store the computed mel spectrogram */
-  matrix melSpec;
+  /** @brief Ring of LDA confidences per frame, of size contextFrames. */
+  std::vector<float> confidenceRing;
 
-  /** @brief Helper of melSpec, contains the actual data for the matrix */
-  float melSpectrogramVector[CLASSIFICATION_BUFFER_SIZE * NUM_MEL_FILTERS];
+  /** @brief Running sums of the scores held in scoreRing, of size numClasses.
+   * Double precision keeps the drift of adding and removing frames
+   * negligible. */
+  std::vector<double> scoreSums;
 
-  /** @brief Matrix that will store the computed mfcc coefficients for each
-   * frame */
-  matrix mfccSpec;
+  /** @brief Window scores passed to the decision, of size numClasses. */
+  std::vector<float> windowScores;
 
-  /** @brief Helper of mfccSpec, contains the actual data for the matrix */
-  float mfccSpectrogramVector[CLASSIFICATION_BUFFER_SIZE * NUM_DCT_COEFF];
+  /** @brief Running sum of the confidences held in confidenceRing. */
+  double confidenceSum = 0.0;
 
-  /** @brief Matrix that will store the data projected onto pca space */
-  matrix pcaSpec;
+  /** @brief Mel energies of the newest frame, of size numMelFilters. */
+  std::vector<float> melFrame;
 
-  /** @brief Helper of pcaSpec, contains the actual data for the matrix */
-  float pcaFeatureVector[CLASSIFICATION_BUFFER_SIZE * NUM_PCA_COMPONENTS];
+  /** @brief MFCC coefficients of the newest frame, of size numDCTCoeff. */
+  std::vector<float> mfccFrame;
 
   /** @brief Frequency domain struct. This is where FFT results be stored. */
   FrequencyDomain freq;
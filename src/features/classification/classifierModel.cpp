@@ -0,0 +1,69 @@
+/**
+ ******************************************************************************
+ * @file    classifierModel.cpp
+ * @brief   PCA and LDA weights of the classifier, read in place from a model
+ *          container.
+ ******************************************************************************
+ */
+
+#include "classifierModel.h"
+
+#include "logging.hpp"
+
+ModelStatus ClassifierModel::load(const void* data, size_t size) {
+  *this = ClassifierModel();
+
+  ModelContainer opened;
+  ModelStatus status = opened.open(data, size);
+  if (status != ModelStatus::OK) {
+    return status;
+  }
+
+  const float* mean = opened.getFloatSection(PCA_MEAN_SECTION, 1,
+                                             NUM_DCT_COEFF, status);
+  const float* projection = opened.getFloatSection(
+      PCA_PROJECTION_SECTION, NUM_DCT_COEFF, NUM_PCA_COMPONENTS, status);
+  const float* weights = opened.getFloatSection(
+      LDA_WEIGHTS_SECTION, NUM_CLASSES, NUM_PCA_COMPONENTS, status);
+  const float* biases =
+      opened.getFloatSection(LDA_BIASES_SECTION, 1, NUM_CLASSES, status);
+  if (status != ModelStatus::OK) {
+    return status;
+  }
+
+  const float* scalings = nullptr;
+  if (opened.findSection(LDA_SCALINGS_SECTION) != nullptr) {
+    scalings = opened.getFloatSection(LDA_SCALINGS_SECTION, NUM_PCA_COMPONENTS,
+                                      NUM_CLASSES - 1, status);
+  }
+#ifdef BUILD_TESTS
+  if (opened.findSection(LDA_HOST_BIASES_SECTION) != nullptr) {
+    biases =
+        opened.getFloatSection(LDA_HOST_BIASES_SECTION, 1, NUM_CLASSES, status);
+  }
+#endif
+  if (status != ModelStatus::OK) {
+    return status;
+  }
+
+  this->container = opened;
+  this->pcaMean = mean;
+  this->pcaProjection = projection;
+  this->ldaWeights = weights;
+  this->ldaBiases = biases;
+  this->ldaScalings = scalings;
+  return ModelStatus::OK;
+}
+
+const ClassifierModel& defaultClassifierModel() {
+  static const ClassifierModel model = [] {
+    ClassifierModel loaded;
+    const ModelStatus status = loaded.load(DEFAULT_CLASSIFIER_MODEL_DATA,
+                                           DEFAULT_CLASSIFIER_MODEL_SIZE);
+    if (status != ModelStatus::OK) {
+      ERROR("Default classifier model rejected: %s", modelStatusName(status));
+    }
+    return loaded;
+  }();
+  return model;
+}
@@ -0,0 +1,95 @@
+/**
+ ******************************************************************************
+ * @file    classifierModel.h
+ * @brief   PCA and LDA weights of the classifier, read in place from a model
+ *          container.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "modelContainer.h"
+#include "runtime_audio360.hpp"
+
+/** @brief Section identifiers of a classifier model. Keep in sync with
+ * scripts/classification_scripts/export_model.py. */
+enum ClassifierModelSection : uint32_t {
+  PCA_MEAN_SECTION = 1,         // 1 x NUM_DCT_COEFF.
+  PCA_PROJECTION_SECTION = 2,   // NUM_DCT_COEFF x NUM_PCA_COMPONENTS.
+  LDA_WEIGHTS_SECTION = 3,      // NUM_CLASSES x NUM_PCA_COMPONENTS.
+  LDA_BIASES_SECTION = 4,       // 1 x NUM_CLASSES.
+  LDA_SCALINGS_SECTION = 5,     // Optional, NUM_PCA_COMPONENTS x
+                                // (NUM_CLASSES - 1).
+  LDA_HOST_BIASES_SECTION = 6,  // Optional, 1 x NUM_CLASSES. Replaces the
+                                // biases in test builds.
+};
+
+/**
+ * @brief Classifier weights held by a model container. Every pointer points
+ * into the container, which must outlive the model and every stage built from
+ * it.
+ */
+class ClassifierModel {
+ public:
+  /**
+   * @brief Open a container and check the shape of every section against
+   * NUM_DCT_COEFF, NUM_PCA_COMPONENTS and NUM_CLASSES.
+   *
+   * @param data Start of the container, aligned to MODEL_ALIGNMENT.
+   * @param size Number of readable bytes.
+   * @return ModelStatus OK, or why the model was rejected. The model is empty
+   * unless OK.
+   */
+  ModelStatus load(const void* data, size_t size);
+
+  /**
+   * @brief Check whether a model was loaded.
+   *
+   * @return true if load() succeeded.
+   */
+  bool isLoaded() const { return this->pcaMean != nullptr; }
+
+  /** @brief MFCC mean, NUM_DCT_COEFF values. */
+  const float* getPCAMean() const { return this->pcaMean; }
+
+  /** @brief PCA projection, NUM_DCT_COEFF x NUM_PCA_COMPONENTS. */
+  const float* getPCAProjection() const { return this->pcaProjection; }
+
+  /** @brief LDA class weights, NUM_CLASSES x NUM_PCA_COMPONENTS. */
+  const float* getLDAWeights() const { return this->ldaWeights; }
+
+  /** @brief LDA class biases, NUM_CLASSES values. */
+  const float* getLDABiases() const { return this->ldaBiases; }
+
+  /** @brief LDA scalings, NUM_PCA_COMPONENTS x (NUM_CLASSES - 1), or nullptr
+   * if the model has none. */
+  const float* getLDAScalings() const { return this->ldaScalings; }
+
+ private:
+  /** @brief Container holding the weights. */
+  ModelContainer container;
+
+  /** @brief Pointers into the container. */
+  const float* pcaMean = nullptr;
+  const float* pcaProjection = nullptr;
+  const float* ldaWeights = nullptr;
+  const float* ldaBiases = nullptr;
+  const float* ldaScalings = nullptr;
+};
+
+/** @brief Container of the default model, a const array placed in flash.
+ * Generated by export_model.py. */
+extern const uint8_t DEFAULT_CLASSIFIER_MODEL_DATA[];
+extern const size_t DEFAULT_CLASSIFIER_MODEL_SIZE;
+
+/**
+ * @brief Get the default model, loaded from DEFAULT_CLASSIFIER_MODEL_DATA on
+ * first use.
+ *
+ * @return const ClassifierModel& The model. Not loaded if the compiled-in
+ * container is damaged, in which case PCA and LDA refuse to construct.
+ */
+const ClassifierModel& defaultClassifierModel();
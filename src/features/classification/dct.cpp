@@ -12,6 +12,7 @@
 #include <cmath>
 
 #include "constants.h"
+#include "fastmath.h"
 
 DiscreteCosineTransform::DiscreteCosineTransform(uint16_t numCoefficients,
                                                  uint16_t numMelFilters)
@@ -58,14 +59,12 @@ void DiscreteCosineTransform::apply(const matrix& melSpectrogram,
   matrix logMel;
   matrix_init_f32(&logMel, numFrames, numMelFilters, logMelData);
 
-  for (uint16_t frame = 0; frame < numFrames; ++frame) {
-    const size_t rowStart = static_cast<size_t>(frame) * numMelFilters;
-    for (uint16_t melBin = 0; melBin < numMelFilters; ++melBin) {
-      const float val =
-          std::log(melSpectrogram.pData[rowStart + melBin] + 1e-10f);
-      logMel.pData[rowStart + melBin] = val;
-    }
+  // The rows are contiguous, so the whole spectrogram is one log block.
+  const size_t numValues = static_cast<size_t>(numFrames) * numMelFilters;
+  for (size_t i = 0; i < numValues; ++i) {
+    logMel.pData[i] = melSpectrogram.pData[i] + LOG_MEL_FLOOR;
   }
+  fastLog(logMel.pData, logMel.pData, numValues);
 
   matrix_init_f32(&mfccSpectrogram, numFrames, this->numCoefficients,
                   mfccSpectrogramVector);
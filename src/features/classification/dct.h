@@ -4,12 +4,19 @@
  * @brief   Discrete Cosine Transform (DCT) Header
  ******************************************************************************
  */
+
+#pragma once
+
 #include <vector>
 
 #include "constants.h"
 #include "matrix.h"
 #include "runtime_audio360.hpp"
 
+/** @brief Added to the mel energies before the log, so that silent bands
+ * stay finite. */
+constexpr inline float LOG_MEL_FLOOR = 1e-10f;
+
 /** @brief Struct to hold DCT matrix. */
 struct dctMatrix {
   uint16_t numCoefficients;  // Number of coefficients of in the matrix.
@@ -39,6 +46,14 @@ class DiscreteCosineTransform {
   void apply(const matrix& melSpectrogram, matrix& mfccSpectrogram,
              float* mfccSpectrogramVector);
 
+  /**
+   * @brief Get the DCT transformation matrix.
+   *
+   * @return const matrix& numMelFilters x numCoefficients matrix. apply()
+   * zeroes coefficient 0 after multiplying by it.
+   */
+  const matrix& getDCTMatrix() const { return this->dctMatrixData.mat; }
+
  private:
   /** @brief Create the DCT transformation matrix. */
   void CreateDCTMatrix();
@@ -0,0 +1,70 @@
+/**
+ ******************************************************************************
+ * @file    defaultClassifierModel.cpp
+ * @brief   Default classifier model in the flat binary container. Generated
+ *          by scripts/classification_scripts/export_model.py, do not edit.
+ ******************************************************************************
+ */
+
+#include "classifierModel.h"
+
+alignas(MODEL_ALIGNMENT) const uint8_t DEFAULT_CLASSIFIER_MODEL_DATA[] = {
+    0x41, 0x33, 0x36, 0x4d, 0x01, 0x00, 0x06, 0x00, 0x90, 0x02, 0x00, 0x00,
+    0xe5, 0xaa, 0x01, 0x57, 0x01, 0x00, 0x00, 0x00, 0x70, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x0d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0xb0, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0xf0, 0x01, 0x00, 0x00, 0x03, 0x00, 0x06, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x40, 0x02, 0x00, 0x00,
+    0x01, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+    0x50, 0x02, 0x00, 0x00, 0x06, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x06, 0x00, 0x00, 0x00, 0x80, 0x02, 0x00, 0x00, 0x01, 0x00, 0x03, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xb6, 0xc2, 0x38, 0x41, 0xe8, 0xa9, 0xe9, 0x3f,
+    0xd6, 0x57, 0x08, 0xc0, 0xc4, 0x3f, 0xbe, 0xbe, 0x56, 0x96, 0x4e, 0xbe,
+    0x26, 0xbb, 0x4c, 0x3f, 0x16, 0x42, 0x6c, 0x3f, 0x49, 0x75, 0x37, 0x3f,
+    0xa2, 0x62, 0x56, 0xbe, 0x5c, 0x1a, 0xb5, 0x3e, 0xdd, 0xf9, 0xbf, 0x3e,
+    0x92, 0x68, 0xb0, 0x3e, 0x7a, 0x2f, 0x9e, 0xbd, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3c, 0xac, 0x7d, 0x3f,
+    0xd0, 0xc8, 0x90, 0x3c, 0x24, 0xbd, 0xd8, 0xbd, 0x84, 0x14, 0xb5, 0x3c,
+    0x5c, 0xfe, 0x45, 0x3c, 0x66, 0x48, 0xf6, 0xbc, 0x4d, 0x1d, 0x6a, 0x3d,
+    0x8e, 0xd2, 0x02, 0x3f, 0x51, 0x1b, 0x40, 0x3f, 0xef, 0x03, 0x81, 0x3e,
+    0xb2, 0x81, 0x92, 0x3e, 0xb1, 0x87, 0xfa, 0xbd, 0xa3, 0x7e, 0x31, 0xbd,
+    0x29, 0x77, 0x38, 0x3f, 0xf1, 0x47, 0x97, 0xbe, 0x12, 0x8d, 0xdd, 0xbd,
+    0xbe, 0x21, 0x46, 0xbe, 0x44, 0x9d, 0x80, 0x3e, 0x26, 0xc7, 0x7d, 0xbd,
+    0x4a, 0x23, 0xc3, 0x3e, 0xce, 0xfe, 0x03, 0xbf, 0x83, 0x33, 0x76, 0xbc,
+    0xc1, 0x77, 0xcb, 0x3e, 0x76, 0x53, 0xa7, 0xbe, 0xd2, 0x85, 0xbc, 0x3c,
+    0xc3, 0xae, 0x33, 0x3e, 0xb4, 0x6f, 0x31, 0xbd, 0x51, 0x33, 0xaf, 0x3e,
+    0x10, 0xad, 0xc0, 0xbe, 0x8b, 0xd8, 0x57, 0x3e, 0xc1, 0xb7, 0xe0, 0xbc,
+    0x52, 0xe9, 0xad, 0xbc, 0xc4, 0xdc, 0x30, 0xbe, 0x1e, 0x3d, 0x14, 0x3f,
+    0xc6, 0xb9, 0x5b, 0x3e, 0x8a, 0x2b, 0x44, 0x3e, 0x3a, 0xe9, 0x1b, 0xbd,
+    0xdb, 0x80, 0x3f, 0xbe, 0xe4, 0x43, 0x2c, 0xbe, 0x4b, 0x41, 0xca, 0x3e,
+    0x98, 0x57, 0x01, 0x3f, 0x91, 0xbf, 0x1d, 0x3e, 0x01, 0x26, 0xa0, 0x3d,
+    0x24, 0xa8, 0x3f, 0xbd, 0x73, 0x31, 0xba, 0x3d, 0xbd, 0x7b, 0x69, 0xbe,
+    0x4f, 0x18, 0x8a, 0x3e, 0x85, 0x10, 0x05, 0x3f, 0x13, 0x77, 0xe5, 0x39,
+    0xc0, 0x12, 0xfc, 0x3c, 0x94, 0x7e, 0xea, 0x3c, 0xf2, 0xb1, 0xe6, 0xbe,
+    0x91, 0xa2, 0xe2, 0x3e, 0x93, 0x38, 0x8c, 0xbc, 0xa3, 0xa8, 0x79, 0x3c,
+    0x92, 0x18, 0xaf, 0x3c, 0x72, 0x7b, 0x76, 0x3c, 0x53, 0x38, 0xd7, 0xbd,
+    0xc3, 0x07, 0x3e, 0x3d, 0x44, 0x9c, 0x8c, 0xbe, 0xb7, 0xa7, 0xf5, 0x3a,
+    0xd9, 0x04, 0x2b, 0xbd, 0x59, 0xff, 0x65, 0xbc, 0x9a, 0x3d, 0x2b, 0x3e,
+    0x5d, 0x68, 0xba, 0xbd, 0x34, 0x41, 0x04, 0xbf, 0x86, 0x9d, 0xb5, 0x3b,
+    0x1c, 0x9c, 0xe4, 0xbc, 0xb0, 0x6a, 0xf5, 0xbc, 0x55, 0x34, 0x12, 0x3d,
+    0x2b, 0xd7, 0xbf, 0xbc, 0x4d, 0x0f, 0x9a, 0xbe, 0x9b, 0xe9, 0xda, 0xba,
+    0x72, 0x7d, 0x2a, 0x3d, 0x16, 0x08, 0x3c, 0x3d, 0xe5, 0x11, 0x12, 0xbe,
+    0x9e, 0x7b, 0x6e, 0x3b, 0xf6, 0x25, 0x9f, 0x3d, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xfb, 0x3a, 0x46, 0x3e, 0x3b, 0xa8, 0xb1, 0x3f,
+    0xbc, 0x10, 0x4a, 0x3e, 0x1e, 0xa3, 0x46, 0x3e, 0x7c, 0x3a, 0x82, 0xbf,
+    0x7a, 0x80, 0x90, 0x3e, 0x84, 0x75, 0xfb, 0xbd, 0x73, 0x19, 0x36, 0xc0,
+    0x62, 0x38, 0x90, 0x3e, 0xe9, 0x12, 0xa9, 0xbc, 0xf7, 0xa5, 0xd3, 0x3f,
+    0xa9, 0xfc, 0x9a, 0xbe, 0xfb, 0x04, 0x9c, 0xbf, 0x5c, 0xfb, 0x4b, 0xbf,
+    0x13, 0xc3, 0x38, 0xc0, 0xf3, 0x50, 0xd1, 0xbf, 0x36, 0x2f, 0x15, 0x40,
+    0xc8, 0x76, 0xa3, 0xbf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x61, 0x69, 0xce, 0xc0, 0xe0, 0x5d, 0x8c, 0x40, 0xb0, 0xa4, 0x04, 0xc1,
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x44, 0x7f, 0xbd, 0x1d, 0x34, 0x38, 0xbe,
+    0xc6, 0x71, 0x0a, 0xbf, 0x48, 0x73, 0xd1, 0x3d, 0x00, 0xbc, 0x4e, 0xbd,
+    0x39, 0xb2, 0xaa, 0xbe, 0xa0, 0x7a, 0x87, 0xbd, 0x04, 0x75, 0xdb, 0xbd,
+    0x7f, 0xf3, 0xd9, 0x3e, 0x69, 0x3c, 0x46, 0x3e, 0x73, 0x9c, 0x26, 0x3e,
+    0x52, 0xbf, 0x36, 0x3e, 0x61, 0x69, 0xce, 0xc0, 0xf0, 0x2e, 0x36, 0x41,
+    0xb0, 0xa4, 0x04, 0xc1, 0x00, 0x00, 0x00, 0x00,
+};
+
+const size_t DEFAULT_CLASSIFIER_MODEL_SIZE =
+    sizeof(DEFAULT_CLASSIFIER_MODEL_DATA);
@@ -0,0 +1,81 @@
+/**
+ ******************************************************************************
+ * @file    fusedClassifier.cpp
+ * @brief   Linear classifier compiled from the DCT, PCA and LDA stages.
+ ******************************************************************************
+ */
+
+#include "fusedClassifier.h"
+
+#include "fastmath.h"
+
+FusedLinearClassifier::FusedLinearClassifier(
+    const DiscreteCosineTransform& dct, const PrincipleComponentAnalysis& pca,
+    const LinearDiscriminantAnalysis& lda, uint16_t numMelFilters,
+    uint16_t numDCTCoeff, uint16_t numPCAComponents, uint16_t numClasses)
+    : numMelFilters(numMelFilters),
+      numClasses(numClasses),
+      weights(static_cast<size_t>(numClasses) * numMelFilters),
+      biases(numClasses),
+      logMel(numMelFilters) {
+  const matrix& dctMatrix = dct.getDCTMatrix();
+  const pcaProjectionData& pcaProjection = pca.getProjection();
+  const matrix& projection = pcaProjection.projectionMatrix;
+  const ldaProjectionData& ldaProjection = lda.getProjection();
+  const matrix& classWeights = ldaProjection.classWeights;
+
+  // Composed in double precision, so the fused model rounds once per weight.
+  // PW[k][c] = sum_e P[k][e] W[c][e] maps a DCT coefficient to a class score.
+  // Stored numDCTCoeff x numClasses.
+  std::vector<double> pw(static_cast<size_t>(numDCTCoeff) * numClasses);
+  for (uint16_t k = 0; k < numDCTCoeff; ++k) {
+    for (uint16_t c = 0; c < numClasses; ++c) {
+      double sum = 0.0;
+      for (uint16_t e = 0; e < numPCAComponents; ++e) {
+        const double p = projection.pData[k * projection.numCols + e];
+        sum += p * classWeights.pData[c * classWeights.numCols + e];
+      }
+      pw[static_cast<size_t>(k) * numClasses + c] = sum;
+    }
+  }
+
+  // Coefficient 0 is zeroed after the DCT, so its row never contributes.
+  for (uint16_t c = 0; c < numClasses; ++c) {
+    for (uint16_t m = 0; m < numMelFilters; ++m) {
+      double sum = 0.0;
+      for (uint16_t k = 1; k < numDCTCoeff; ++k) {
+        sum += dctMatrix.pData[m * dctMatrix.numCols + k] *
+               pw[static_cast<size_t>(k) * numClasses + c];
+      }
+      this->weights[static_cast<size_t>(c) * numMelFilters + m] =
+          static_cast<float>(sum);
+    }
+
+    // The PCA mean applies to every coefficient, including coefficient 0.
+    double bias = ldaProjection.classBiases[c];
+    for (uint16_t k = 0; k < numDCTCoeff; ++k) {
+      bias -= pcaProjection.meanVector[k] *
+              pw[static_cast<size_t>(k) * numClasses + c];
+    }
+    this->biases[c] = static_cast<float>(bias);
+  }
+}
+
+void FusedLinearClassifier::scoreFrame(const float* melEnergies,
+                                       float* scores) {
+  float* logMel = this->logMel.data();
+  for (uint16_t m = 0; m < this->numMelFilters; ++m) {
+    logMel[m] = melEnergies[m] + LOG_MEL_FLOOR;
+  }
+  fastLog(logMel, logMel, this->numMelFilters);
+
+  for (uint16_t c = 0; c < this->numClasses; ++c) {
+    const float* classWeights =
+        &this->weights[static_cast<size_t>(c) * this->numMelFilters];
+    float score = this->biases[c];
+    for (uint16_t m = 0; m < this->numMelFilters; ++m) {
+      score += logMel[m] * classWeights[m];
+    }
+    scores[c] = score;
+  }
+}
@@ -0,0 +1,96 @@
+/**
+ ******************************************************************************
+ * @file    fusedClassifier.h
+ * @brief   Linear classifier compiled from the DCT, PCA and LDA stages. Maps
+ *          the log mel energies of a frame to its class scores with a single
+ *          matrix and bias.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "dct.h"
+#include "lda.h"
+#include "pca.h"
+
+/**
+ * @brief After the log, the DCT, the zeroing of coefficient 0, the PCA
+ * centering and projection and the LDA scores are all affine, so
+ *
+ *   scores = log(mel) D' P W^T + (b - mean P W^T)
+ *
+ * where D' is the DCT matrix with column 0 zeroed, P the PCA projection, W the
+ * LDA class weights and b the LDA biases. The product is composed once when
+ * the classifier is built, which turns about 270 multiply-adds per frame into
+ * numMelFilters x numClasses.
+ */
+class FusedLinearClassifier {
+ public:
+  /**
+   * @brief Compose the stages into one matrix and bias.
+   *
+   * @param dct DCT stage, numMelFilters -> numDCTCoeff.
+   * @param pca PCA stage, numDCTCoeff -> numPCAComponents.
+   * @param lda LDA stage, numPCAComponents -> numClasses.
+   * @param numMelFilters Number of mel filters.
+   * @param numDCTCoeff Number of DCT coefficients.
+   * @param numPCAComponents Number of PCA components.
+   * @param numClasses Number of classes.
+   */
+  FusedLinearClassifier(const DiscreteCosineTransform& dct,
+                        const PrincipleComponentAnalysis& pca,
+                        const LinearDiscriminantAnalysis& lda,
+                        uint16_t numMelFilters, uint16_t numDCTCoeff,
+                        uint16_t numPCAComponents, uint16_t numClasses);
+
+  /**
+   * @brief Score a frame from its mel energies.
+   *
+   * @param melEnergies Mel energies of the frame, of size numMelFilters.
+   * @param [out] scores Class scores, of size numClasses.
+   */
+  void scoreFrame(const float* melEnergies, float* scores);
+
+  /**
+   * @brief Get the fused weight of a mel band for a class.
+   *
+   * @param classIndex Class.
+   * @param melBand Mel band.
+   * @return float The weight.
+   */
+  float getWeight(uint16_t classIndex, uint16_t melBand) const {
+    return this->weights[static_cast<size_t>(classIndex) * this->numMelFilters +
+                         melBand];
+  }
+
+  /**
+   * @brief Get the fused bias of a class.
+   *
+   * @param classIndex Class.
+   * @return float The bias.
+   */
+  float getBias(uint16_t classIndex) const {
+    return this->biases[classIndex];
+  }
+
+ private:
+  /** @brief Number of mel filters. */
+  uint16_t numMelFilters;
+
+  /** @brief Number of classes. */
+  uint16_t numClasses;
+
+  /** @brief Fused weights, numClasses x numMelFilters so that each class is a
+   * contiguous dot product. */
+  std::vector<float> weights;
+
+  /** @brief Fused biases, of size numClasses. */
+  std::vector<float> biases;
+
+  /** @brief Log mel energies of the frame being scored, of size
+   * numMelFilters. */
+  std::vector<float> logMel;
+};
@@ -15,65 +15,48 @@
 #include "classificationLabel.h"
 #include "classification_constants.h"
 #include "constants.h"
+#include "exceptions.hpp"
+#include "fastmath.h"
 #include "logging.hpp"
 
-float LinearDiscriminantAnalysis::LDA_CLASS_WEIGHTS_DATA[NUM_PCA_COMPONENTS *
-                                                         NUM_CLASSES] = {
-    0.19358437f,  1.38794649f,  0.19732946f,  0.19398162f,  -1.01740980f,
-    0.28223020f,  -0.12278274f, -2.84530330f, 0.28168017f,  -0.02063890f,
-    1.65350235f,  -0.30270889f, -1.21890199f, -0.79680419f, -2.88690639f,
-    -1.63528287f, 2.33100653f,  -1.27706242f};
-
-float LinearDiscriminantAnalysis::LDA_SCALINGS_DATA[NUM_PCA_COMPONENTS *
-                                                    (NUM_CLASSES - 1)] = {
-    -0.06232077f, -0.17988630f, -0.54079854f, 0.10227066f,
-    -0.05047226f, -0.33339098f, -0.06615186f, -0.10715678f,
-    0.42568585f,  0.19358982f,  0.16270618f,  0.17846420f};
-
-float LinearDiscriminantAnalysis::LDA_CLASS_BIASES[NUM_CLASSES] = {
-    -6.45036364f, 4.38645935f, -8.29020691f};
-
-float LinearDiscriminantAnalysis::LDA_CLASS_BIASES_NOT_EMBEDDED[NUM_CLASSES] = {
-    -6.45036364f, 11.38645935f, -8.29020691f};
-
-// Use this configuration when in a room filled with people talking.
-float LinearDiscriminantAnalysis::LDA_CLASS_BIASES_ENV[NUM_CLASSES] = {
-    -3.05036364f, 1.38645935f, -10.29020691f};
-
 ClassificationLabel
     LinearDiscriminantAnalysis::CLASSIFICATION_CLASSES[NUM_CLASSES] = {
         ClassificationLabel::SomeoneTalking, ClassificationLabel::Siren,
         ClassificationLabel::SmokeAlarm};
 
-LinearDiscriminantAnalysis::LinearDiscriminantAnalysis(uint16_t numEigenvectors,
-                                                       uint16_t numClasses)
+LinearDiscriminantAnalysis::LinearDiscriminantAnalysis(
+    uint16_t numEigenvectors, uint16_t numClasses,
+    const ClassifierModel& model)
     : numEigenvectors(numEigenvectors),
       numClasses(numClasses),
       ldaProjection(numEigenvectors) {
-  this->numEigenvectors = numEigenvectors;
-  this->numClasses = numClasses;
-  this->initializeLDAData();
+  this->setModel(model);
 }
 
-void LinearDiscriminantAnalysis::initializeLDAData() {
-  // Three-class model (talking, siren, smoke alarm) trained on 13 MFCC -> 6
-  // PCA features.
-
-  LDA_CLASS_WEIGHTS = {3, 6, LDA_CLASS_WEIGHTS_DATA};
-
-  LDA_SCALINGS = {6, 2, LDA_SCALINGS_DATA};
-
-  this->ldaProjection.classWeights = LDA_CLASS_WEIGHTS;
+void LinearDiscriminantAnalysis::setModel(const ClassifierModel& model) {
+  // A rejected model has no weights to point at.
+  if (!model.isLoaded()) {
+    throw AudioProcessingException("LDA model is not loaded.");
+  }
 
-#ifndef BUILD_TESTS
-  memcpy(this->ldaProjection.classBiases, LDA_CLASS_BIASES,
-         sizeof(float) * NUM_CLASSES);
-#else
-  memcpy(this->ldaProjection.classBiases, LDA_CLASS_BIASES_NOT_EMBEDDED,
-         sizeof(float) * NUM_CLASSES);
-#endif
+  // Three-class model (talking, siren, smoke alarm) trained on 13 MFCC -> 6
+  // PCA features. The matrix type is not const, but the weights are only ever
+  // read.
+  matrix_init_f32(&this->ldaProjection.classWeights, NUM_CLASSES,
+                  NUM_PCA_COMPONENTS,
+                  const_cast<float*>(model.getLDAWeights()));
+  this->ldaProjection.classBiases = model.getLDABiases();
+
+  if (model.getLDAScalings() != nullptr) {
+    matrix_init_f32(&this->ldaProjection.scalings, NUM_PCA_COMPONENTS,
+                    NUM_CLASSES - 1,
+                    const_cast<float*>(model.getLDAScalings()));
+  } else {
+    this->ldaProjection.scalings = matrix();
+  }
 
-  this->ldaProjection.scalings = LDA_SCALINGS;
+  matrix_init_f32(&this->wT, NUM_PCA_COMPONENTS, NUM_CLASSES, this->wTData);
+  matrix_transpose_f32(&this->ldaProjection.classWeights, &this->wT);
 }
 
 ClassificationLabel LinearDiscriminantAnalysis::predictFrameClass(
@@ -129,17 +112,10 @@ ClassificationLabel LinearDiscriminantAnalysis::apply(
   }
 
   // scores = X (numFrames x featLen) * W^T (featLen x numClasses)
-
-  matrix wT;
-  matrix_init_f32(&wT, featLen, this->numClasses, wTData);
-  if (matrix_transpose_f32(&this->ldaProjection.classWeights, &wT) !=
-      ARM_MATH_SUCCESS) {
-    return ClassificationLabel::Unknown;
-  }
-
   matrix scores;
   matrix_init_f32(&scores, numFrames, this->numClasses, scoresData);
-  if (matrix_mult_f32(&pcaFeatureVector, &wT, &scores) != ARM_MATH_SUCCESS) {
+  if (matrix_mult_f32(&pcaFeatureVector, &this->wT, &scores) !=
+      ARM_MATH_SUCCESS) {
     return ClassificationLabel::Unknown;
   }
 
@@ -157,25 +133,75 @@ ClassificationLabel LinearDiscriminantAnalysis::apply(
   for (uint16_t frame = 0; frame < numFrames; ++frame) {
     const size_t rowStart = static_cast<size_t>(frame) * this->numClasses;
     float maxScore = scores.pData[rowStart];
-    float total = std::exp(maxScore);
     uint16_t best = 0;
     for (uint16_t c = 1; c < this->numClasses; ++c) {
       const float s = scores.pData[rowStart + c];
-      total += std::exp(s);
       if (s > maxScore) {
         maxScore = s;
         best = c;
       }
     }
-    totalConfidence += std::exp(maxScore) / total;
     classCounts[best]++;
     for (uint16_t c = 0; c < this->numClasses; ++c) {
       scoreSums[c] += scores.pData[rowStart + c];
+      // Shifted by the row maximum so the softmax cannot overflow.
+      scores.pData[rowStart + c] -= maxScore;
     }
   }
-  totalConfidence /= numFrames;
 
-  if (totalConfidence < CONFIDENCE_THRESHOLD) {
+  // Softmax of every frame in one exp block. The confidence of a frame is the
+  // probability of its best class, e^0 / sum(e^(s - max)).
+  fastExp(scores.pData, scores.pData,
+          static_cast<size_t>(numFrames) * this->numClasses);
+  for (uint16_t frame = 0; frame < numFrames; ++frame) {
+    const size_t rowStart = static_cast<size_t>(frame) * this->numClasses;
+    float total = 0.0f;
+    for (uint16_t c = 0; c < this->numClasses; ++c) {
+      total += scores.pData[rowStart + c];
+    }
+    totalConfidence += 1.0f / total;
+  }
+
+  return this->decide(scoreSums, totalConfidence, numFrames);
+}
+
+float LinearDiscriminantAnalysis::scoreFrame(const float* pcaFrame,
+                                             float* scores) const {
+  for (uint16_t c = 0; c < this->numClasses; ++c) {
+    const float* weights =
+        &this->ldaProjection.classWeights
+             .pData[static_cast<size_t>(c) * this->numEigenvectors];
+    float score = this->ldaProjection.classBiases[c];
+    for (uint16_t i = 0; i < this->numEigenvectors; ++i) {
+      score += pcaFrame[i] * weights[i];
+    }
+    scores[c] = score;
+  }
+
+  return this->frameConfidence(scores);
+}
+
+float LinearDiscriminantAnalysis::frameConfidence(const float* scores) const {
+  float maxScore = scores[0];
+  for (uint16_t c = 1; c < this->numClasses; ++c) {
+    maxScore = (scores[c] > maxScore) ? scores[c] : maxScore;
+  }
+
+  float total = 0.0f;
+  for (uint16_t c = 0; c < this->numClasses; ++c) {
+    total += fastExp(scores[c] - maxScore);
+  }
+  return 1.0f / total;
+}
+
+ClassificationLabel LinearDiscriminantAnalysis::decide(
+    const float* scoreSums, float confidenceSum, uint16_t numFrames) const {
+  if (numFrames == 0) {
+    return ClassificationLabel::Unknown;
+  }
+
+  const float averageConfidence = confidenceSum / numFrames;
+  if (averageConfidence < CONFIDENCE_THRESHOLD) {
     return ClassificationLabel::Unknown;
   }
 
@@ -193,7 +219,7 @@ ClassificationLabel LinearDiscriminantAnalysis::apply(
           ClassificationClassToString(this->CLASSIFICATION_CLASSES[c]),
           avgScore);
   }
-  DEBUG(" | avg confidence=%.3f\n", totalConfidence);
+  DEBUG(" | avg confidence=%.3f\n", averageConfidence);
 
   return this->CLASSIFICATION_CLASSES[bestClass];
 }
@@ -5,10 +5,13 @@
  ******************************************************************************
  */
 
+#pragma once
+
 #include <string>
 #include <vector>
 
 #include "classificationLabel.h"
+#include "classifierModel.h"
 #include "matrix.h"
 #include "runtime_audio360.hpp"
 
@@ -16,12 +19,13 @@ struct ldaProjectionData {
   /** @brief Number of LDA components retained. */
   uint16_t numComponents;
 
-  /** @brief LDA class weight matrix. */
+  /** @brief LDA class weight matrix, pointing into the model. */
   matrix classWeights;
-  /** @brief Per-class bias terms for LDA. */
-  float classBiases[NUM_CLASSES];
+  /** @brief Per-class bias terms for LDA, in the model. */
+  const float* classBiases;
 
-  /** @brief Scalings used after data projected into the LDA space */
+  /** @brief Scalings used after data projected into the LDA space. Empty if
+   * the model has none. */
   matrix scalings;
 
   /**
@@ -30,7 +34,10 @@ struct ldaProjectionData {
    * @param components The number of components in LDA.
    */
   ldaProjectionData(uint16_t components)
-      : numComponents(components), classWeights(), classBiases() {}
+      : numComponents(components),
+        classWeights(),
+        classBiases(nullptr),
+        scalings() {}
 };
 
 class LinearDiscriminantAnalysis {
@@ -40,8 +47,20 @@ class LinearDiscriminantAnalysis {
    *
    * @param numEigenvectors The number of eigen vectors.
    * @param numClasses The number of classes.
+   * @param model Weights, read in place. Must outlive the object.
+   * @throws AudioProcessingException if the model is not loaded.
+   */
+  LinearDiscriminantAnalysis(
+      uint16_t numEigenvectors, uint16_t numClasses,
+      const ClassifierModel& model = defaultClassifierModel());
+
+  /**
+   * @brief Use the weights of another model.
+   *
+   * @param model Loaded model, read in place. Must outlive the object.
+   * @throws AudioProcessingException if the model is not loaded.
    */
-  LinearDiscriminantAnalysis(uint16_t numEigenvectors, uint16_t numClasses);
+  void setModel(const ClassifierModel& model);
 
   /**
    * @brief Project a PCA frame onto the LDA projection matrix.
@@ -60,10 +79,46 @@ class LinearDiscriminantAnalysis {
    */
   ClassificationLabel apply(const matrix& pcaFeatureVector);
 
- private:
-  /** @brief Initializes LDA data. */
-  void initializeLDAData();
+  /**
+   * @brief Score a single PCA frame, so that a sliding window only scores its
+   * newest frame.
+   *
+   * @param pcaFrame PCA features of the frame, of size numEigenvectors.
+   * @param [out] scores Class scores of the frame, of size numClasses.
+   * @return float Confidence of the frame, the softmax probability of its best
+   * class.
+   */
+  float scoreFrame(const float* pcaFrame, float* scores) const;
+
+  /**
+   * @brief Decide the class of a window of frames from its summed scores.
+   *
+   * @param scoreSums Sum of the class scores over the window, of size
+   * numClasses.
+   * @param confidenceSum Sum of the frame confidences over the window.
+   * @param numFrames Number of frames in the window.
+   * @return ClassificationLabel The class with the best average score, or
+   * unknown if the average confidence is below CONFIDENCE_THRESHOLD.
+   */
+  ClassificationLabel decide(const float* scoreSums, float confidenceSum,
+                             uint16_t numFrames) const;
 
+  /**
+   * @brief Get the confidence of a frame from its class scores.
+   *
+   * @param scores Class scores of the frame, of size numClasses.
+   * @return float Softmax probability of the best class.
+   */
+  float frameConfidence(const float* scores) const;
+
+  /**
+   * @brief Get the class weights and biases.
+   *
+   * @return const ldaProjectionData& The projection data.
+   */
+  const ldaProjectionData& getProjection() const { return this->ldaProjection; }
+
+ private:
   /** @brief Number of PCA eigenvectors expected as input. */
   uint16_t numEigenvectors;
 
@@ -76,6 +131,10 @@ class LinearDiscriminantAnalysis {
   /** @brief WT data. */
   float wTData[NUM_PCA_COMPONENTS * NUM_CLASSES];
 
+  /** @brief Class weights transposed when the model is set, numEigenvectors x
+   * numClasses. */
+  matrix wT;
+
   /** @brief Array that holds the confidence scores for each classes. */
   float scoresData[CLASSIFICATION_BUFFER_SIZE * NUM_CLASSES];
 
@@ -88,28 +147,6 @@ class LinearDiscriminantAnalysis {
   /** @brief Class prediction array. */
   float classPredictions[NUM_CLASSES];
 
-  /** @brief LDS class weights array. */
-  static float LDA_CLASS_WEIGHTS_DATA[NUM_CLASSES * NUM_PCA_COMPONENTS];
-
-  /** @brief Matrix that holds the LDA weights. */
-  matrix LDA_CLASS_WEIGHTS;
-
-  /** @brief LDA class bias array. */
-  static float LDA_CLASS_BIASES[NUM_CLASSES];
-
-  /** @brief LDA class bias array for when not running on embedded controller.
-   */
-  static float LDA_CLASS_BIASES_NOT_EMBEDDED[NUM_CLASSES];
-
-  /** @brief LDA scaling data array. */
-  static float LDA_SCALINGS_DATA[NUM_PCA_COMPONENTS * (NUM_CLASSES - 1)];
-
-  /** @brief LDA class biases in environment. */
-  static float LDA_CLASS_BIASES_ENV[NUM_CLASSES];
-
-  /** @brief Matrix that holds the LDA scalings. */
-  matrix LDA_SCALINGS;
-
   /** @brief Mapping for class to classification label in form of an array. */
   static ClassificationLabel CLASSIFICATION_CLASSES[NUM_CLASSES];
 };
@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <cstdio>
 
+#include "logging.hpp"
 #include "matrix.h"
 
 // Use float math to reduce code size + CPU (and avoid double temporaries).
@@ -26,82 +27,168 @@ MelFilter::MelFilter(uint16_t numFilters, uint16_t fftSize,
                      uint16_t sampleFrequency)
     : numFilters(numFilters),
       fftSize(fftSize),
-      sampleFrequency(sampleFrequency) {
+      sampleFrequency(sampleFrequency),
+      bands{},
+      numWeights(0) {
+  if (this->numFilters > NUM_MEL_FILTERS) {
+    ERROR("Mel filter bank of %u filters exceeds the %d supported.",
+          static_cast<unsigned>(numFilters), NUM_MEL_FILTERS);
+    this->numFilters = NUM_MEL_FILTERS;
+  }
+
   this->CreateFilterBank();
 }
 
-void MelFilter::CreateFilterBank() {
-  const int numFreq = static_cast<int>(this->fftSize / 2U + 1U);
-
-  memset(this->filterBankTData, 0, sizeof(this->filterBankTData));
-
-  // Store TRANSPOSED filter bank directly: (numFreq x numFilters)
-  // so apply() can do: (numFrames x numFreq) * (numFreq x numFilters)
-
-  matrix_init_f32(&this->filterBankT, static_cast<uint16_t>(numFreq),
-                  this->numFilters, this->filterBankTData);
-
+void MelFilter::computeBreakpoints(float* melHz) const {
   const float fmin = 0.0f;
   const float fmax = static_cast<float>(this->sampleFrequency) * 0.5f;
 
   const float melMin = hz_to_mel_f(fmin);
   const float melMax = hz_to_mel_f(fmax);
 
-  // Mel breakpoints in Hz, size = numFilters + 2
-
-  float* melHz = new float[this->numFilters + 2U];
-  memset(melHz, 0, sizeof(float) * (this->numFilters + 2U));
-
   for (uint16_t i = 0; i < this->numFilters + 2U; ++i) {
     const float mel = melMin + (melMax - melMin) * static_cast<float>(i) /
                                    static_cast<float>(this->numFilters + 1U);
     melHz[i] = mel_to_hz_f(mel);
   }
+}
 
-  // librosa-style triangular weights evaluated at true FFT bin center freqs
-  for (uint16_t m = 0; m < this->numFilters; ++m) {
-    const float leftHz = melHz[m];
-    const float centerHz = melHz[m + 1U];
-    const float rightHz = melHz[m + 2U];
+float MelFilter::filterWeight(const float* melHz, uint16_t filter,
+                              int bin) const {
+  const float leftHz = melHz[filter];
+  const float centerHz = melHz[filter + 1U];
+  const float rightHz = melHz[filter + 2U];
 
-    const float riseDen = centerHz - leftHz;
-    const float fallDen = rightHz - centerHz;
+  const float riseDen = centerHz - leftHz;
+  const float fallDen = rightHz - centerHz;
 
-    if (riseDen <= 0.0f || fallDen <= 0.0f) {
-      continue;
-    }
+  if (riseDen <= 0.0f || fallDen <= 0.0f) {
+    return 0.0f;
+  }
 
-    for (int j = 0; j < numFreq; ++j) {
-      const float fftHz =
-          (static_cast<float>(j) * static_cast<float>(this->sampleFrequency)) /
-          static_cast<float>(this->fftSize);
+  const float fftHz =
+      (static_cast<float>(bin) * static_cast<float>(this->sampleFrequency)) /
+      static_cast<float>(this->fftSize);
 
-      const float lower = (fftHz - leftHz) / riseDen;
-      const float upper = (rightHz - fftHz) / fallDen;
+  const float lower = (fftHz - leftHz) / riseDen;
+  const float upper = (rightHz - fftHz) / fallDen;
 
-      float w = lower;
-      if (upper < w) w = upper;
-      if (w < 0.0f) w = 0.0f;
+  float w = lower;
+  if (upper < w) w = upper;
+  if (w < 0.0f) w = 0.0f;
+  return w;
+}
+
+void MelFilter::CreateFilterBank() {
+  const int numFreq = static_cast<int>(this->fftSize / 2U + 1U);
 
-      // filterBankT row-major: row = bin, col = filter
-      this->filterBankT.pData[static_cast<size_t>(j) * this->numFilters + m] =
-          w;
+  // Mel breakpoints in Hz, size = numFilters + 2
+  std::vector<float> melHz(this->numFilters + 2U);
+  this->computeBreakpoints(melHz.data());
+
+  // Keep the bins between the first and last non-zero weight of each
+  // triangle. Filters are in increasing frequency, so the search for the
+  // next band starts where the previous one started.
+  this->numWeights = 0;
+  int searchStart = 0;
+  for (uint16_t m = 0; m < this->numFilters; ++m) {
+    int first = searchStart;
+    while (first < numFreq &&
+           this->filterWeight(melHz.data(), m, first) <= 0.0f) {
+      first++;
+    }
+    int last = first;
+    while (last + 1 < numFreq &&
+           this->filterWeight(melHz.data(), m, last + 1) > 0.0f) {
+      last++;
+    }
+
+    MelBand& band = this->bands[m];
+    band.startBin = static_cast<uint16_t>(first);
+    band.length = 0;
+    band.weightOffset = static_cast<uint16_t>(this->numWeights);
+    if (first >= numFreq) {
+      continue;
     }
+
+    const size_t length = static_cast<size_t>(last - first + 1);
+    if (this->numWeights + length > MEL_MAX_BAND_WEIGHTS) {
+      ERROR("Mel filter bank needs more than %u weights.",
+            static_cast<unsigned>(MEL_MAX_BAND_WEIGHTS));
+      return;
+    }
+    band.length = static_cast<uint16_t>(length);
+    for (size_t i = 0; i < length; i++) {
+      this->bandWeights[this->numWeights + i] =
+          this->filterWeight(melHz.data(), m, first + static_cast<int>(i));
+    }
+    this->numWeights += length;
+    searchStart = first;
   }
+}
 
-  delete[] melHz;
+void MelFilter::applyFrame(const float* powerSpectrum,
+                           float* melEnergies) const {
+  for (uint16_t m = 0; m < this->numFilters; ++m) {
+    const MelBand& band = this->bands[m];
+    const float* power = &powerSpectrum[band.startBin];
+    const float* weights = &this->bandWeights[band.weightOffset];
+
+    float energy = 0.0f;
+    for (uint16_t i = 0; i < band.length; ++i) {
+      energy += weights[i] * power[i];
+    }
+    melEnergies[m] = energy;
+  }
 }
 
 void MelFilter::apply(matrix& stftMatrix, matrix& melSpectrogram,
                       float* melSpectrogramVector) const {
   const uint16_t numFrames = stftMatrix.numRows;
   // stftMatrix is (numFrames x numFreq)
-  // filterBankT is (numFreq x numFilters)
   // result is (numFrames x numFilters)
 
   matrix_init_f32(&melSpectrogram, numFrames, this->numFilters,
                   melSpectrogramVector);
+  if (stftMatrix.numCols != this->fftSize / 2U + 1U) {
+    return;
+  }
+
+  for (uint16_t frame = 0; frame < numFrames; ++frame) {
+    this->applyFrame(
+        &stftMatrix.pData[static_cast<size_t>(frame) * stftMatrix.numCols],
+        &melSpectrogram.pData[static_cast<size_t>(frame) * this->numFilters]);
+  }
+}
 
-  // No transpose, no heap allocation here.
-  matrix_mult_f32(&stftMatrix, &this->filterBankT, &melSpectrogram);
+void MelFilter::fillDenseFilterBank(float* filterBankTData) const {
+  const int numFreq = static_cast<int>(this->fftSize / 2U + 1U);
+
+  std::vector<float> melHz(this->numFilters + 2U);
+  this->computeBreakpoints(melHz.data());
+
+  for (int j = 0; j < numFreq; ++j) {
+    for (uint16_t m = 0; m < this->numFilters; ++m) {
+      filterBankTData[static_cast<size_t>(j) * this->numFilters + m] =
+          this->filterWeight(melHz.data(), m, j);
+    }
+  }
+}
+
+void MelFilter::applyDense(matrix& stftMatrix, matrix& melSpectrogram,
+                           float* melSpectrogramVector) const {
+  const int numFreq = static_cast<int>(this->fftSize / 2U + 1U);
+  const uint16_t numFrames = stftMatrix.numRows;
+
+  // TRANSPOSED filter bank: (numFreq x numFilters), row = bin, col = filter.
+  std::vector<float> filterBankTData(static_cast<size_t>(numFreq) *
+                                     this->numFilters);
+  this->fillDenseFilterBank(filterBankTData.data());
+
+  matrix filterBankT;
+  matrix_init_f32(&filterBankT, static_cast<uint16_t>(numFreq),
+                  this->numFilters, filterBankTData.data());
+  matrix_init_f32(&melSpectrogram, numFrames, this->numFilters,
+                  melSpectrogramVector);
+  matrix_mult_f32(&stftMatrix, &filterBankT, &melSpectrogram);
 }
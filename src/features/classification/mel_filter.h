@@ -5,6 +5,8 @@
  ******************************************************************************
  */
 
+#pragma once
+
 #include <cstdint>
 #include <vector>
 
@@ -27,6 +29,26 @@ struct ShortTimeFourierTransformDomain {
   ShortTimeFourierTransformDomain(uint16_t size) : numFrames(size), stft() {}
 };
 
+/** @brief Most non-zero weights of a filter bank. The triangles overlap by
+ * half, so every bin has a weight in at most two filters. */
+constexpr inline size_t MEL_MAX_BAND_WEIGHTS = 2 * FREQ_DOMAIN_SIZE;
+
+/** @brief Non-zero span of one triangular mel filter. */
+struct MelBand {
+  /** @brief First FFT bin with a non-zero weight. */
+  uint16_t startBin;
+
+  /** @brief Number of consecutive bins with a non-zero weight. */
+  uint16_t length;
+
+  /** @brief Index of the weight of startBin in the packed weights. */
+  uint16_t weightOffset;
+};
+
+/**
+ * @brief Triangular mel filter bank. Each filter is stored as its band of
+ * non-zero weights, so applying the bank only reads those weights.
+ */
 class MelFilter {
  public:
   /**
@@ -49,10 +71,71 @@ class MelFilter {
   void apply(matrix& stftMatrix, matrix& melSpectrogram,
              float* melSpectrogramVector) const;
 
+  /**
+   * @brief Apply the Mel filter bank to the power spectrum of one frame.
+   *
+   * @param powerSpectrum Power spectrum of (fftSize/2 + 1) bins.
+   * @param [out] melEnergies numFilters mel filter bank energies.
+   */
+  void applyFrame(const float* powerSpectrum, float* melEnergies) const;
+
+  /**
+   * @brief Reference of apply() with the dense (fftSize/2 + 1) x numFilters
+   * filter bank, built on every call. Allocates, for tests only.
+   *
+   * @param stftMatrix Input power spectrum, of size frames x
+   * (fftSize/2 + 1) [nyquist].
+   * @param melSpectrogram Output Mel filter bank energies.
+   * @param melSpectrogramVector Contains the data for @ref melSpectrogram.
+   */
+  void applyDense(matrix& stftMatrix, matrix& melSpectrogram,
+                  float* melSpectrogramVector) const;
+
+  /**
+   * @brief Fill the dense transposed filter bank used by applyDense().
+   *
+   * @param [out] filterBankTData (fftSize/2 + 1) x numFilters weights, row =
+   * bin, col = filter.
+   */
+  void fillDenseFilterBank(float* filterBankTData) const;
+
+  /**
+   * @brief Get the band of one filter.
+   *
+   * @param filter Filter index.
+   * @return const MelBand& The band.
+   */
+  const MelBand& getBand(uint16_t filter) const { return bands[filter]; }
+
+  /**
+   * @brief Get the number of stored non-zero weights.
+   *
+   * @return size_t Number of weights.
+   */
+  size_t getNumWeights() const { return numWeights; }
+
  private:
   /** @brief Create the Mel filter bank. */
   void CreateFilterBank();
 
+  /**
+   * @brief Compute the numFilters + 2 mel breakpoints in Hz.
+   *
+   * @param [out] melHz Breakpoints.
+   */
+  void computeBreakpoints(float* melHz) const;
+
+  /**
+   * @brief librosa-style triangular weight of a filter at the centre
+   * frequency of an FFT bin.
+   *
+   * @param melHz Breakpoints from computeBreakpoints().
+   * @param filter Filter index.
+   * @param bin FFT bin.
+   * @return float The weight, 0 outside the triangle.
+   */
+  float filterWeight(const float* melHz, uint16_t filter, int bin) const;
+
   /** @brief Number of mel filters in the bank. */
   uint16_t numFilters;
 
@@ -62,9 +145,12 @@ class MelFilter {
   /** @brief Sample rate of the input signal (Hz). */
   uint16_t sampleFrequency;
 
-  /** @brief Stores computed mel filter bank that'll be applied to stft */
-  matrix filterBankT;
+  /** @brief Non-zero span of every filter. */
+  MelBand bands[NUM_MEL_FILTERS];
+
+  /** @brief Non-zero weights of every filter, packed band after band. */
+  float bandWeights[MEL_MAX_BAND_WEIGHTS];
 
-  /** @brief Helper of filterBankT, contains the actual data for the matrix */
-  float filterBankTData[FREQ_DOMAIN_SIZE * NUM_MEL_FILTERS];
+  /** @brief Number of used entries of bandWeights. */
+  size_t numWeights;
 };
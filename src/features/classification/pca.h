@@ -4,8 +4,12 @@
  * @brief   Principle Component Analysis (PCA) Header
  ******************************************************************************
  */
+
+#pragma once
+
 #include <vector>
 
+#include "classifierModel.h"
 #include "constants.h"
 #include "matrix.h"
 #include "runtime_audio360.hpp"
@@ -14,11 +18,11 @@ struct pcaProjectionData {
   /** @brief Number of eigenvectors retained in the projection. */
   uint16_t numEigenvectors;
 
-  /** @brief Projection matrix for PCA. */
+  /** @brief Projection matrix for PCA, pointing into the model. */
   matrix projectionMatrix;
 
-  /** @brief Mean vector used to center input features. */
-  float meanVector[NUM_DCT_COEFF];
+  /** @brief Mean vector used to center input features, in the model. */
+  const float* meanVector;
 
   /**
    * @brief Construct a new pca Projection Data object.
@@ -26,7 +30,9 @@ struct pcaProjectionData {
    * @param eigenvectors The number of eigenvectors.
    */
   pcaProjectionData(uint16_t eigenvectors)
-      : numEigenvectors(eigenvectors), projectionMatrix(), meanVector() {}
+      : numEigenvectors(eigenvectors),
+        projectionMatrix(),
+        meanVector(nullptr) {}
 };
 
 class PrincipleComponentAnalysis {
@@ -36,8 +42,20 @@ class PrincipleComponentAnalysis {
    *
    * @param numEigenvectors The number of eigen vectors.
    * @param numMFCCCoeffs The number of MFCC coefficients.
+   * @param model Weights, read in place. Must outlive the object.
+   * @throws AudioProcessingException if the model is not loaded.
+   */
+  PrincipleComponentAnalysis(
+      uint16_t numEigenvectors, uint16_t numMFCCCoeffs,
+      const ClassifierModel& model = defaultClassifierModel());
+
+  /**
+   * @brief Use the weights of another model.
+   *
+   * @param model Loaded model, read in place. Must outlive the object.
+   * @throws AudioProcessingException if the model is not loaded.
    */
-  PrincipleComponentAnalysis(uint16_t numEigenvectors, uint16_t numMFCCCoeffs);
+  void setModel(const ClassifierModel& model);
 
   /**
    * @brief Project a centered frame onto the PCA projection matrix.
@@ -61,10 +79,14 @@ class PrincipleComponentAnalysis {
   void apply(const matrix& mfccFeatureVector, matrix& pcaFeature,
              float* pcaFeatureVector);
 
- private:
-  /** @brief Initialize PCA data. */
-  void initializePCAData();
+  /**
+   * @brief Get the projection matrix and mean vector.
+   *
+   * @return const pcaProjectionData& The projection data.
+   */
+  const pcaProjectionData& getProjection() const { return this->pcaProjection; }
 
+ private:
   /** @brief Number of PCA eigenvectors to keep. */
   uint16_t numEigenvectors;
 
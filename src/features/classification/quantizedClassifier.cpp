@@ -0,0 +1,183 @@
+/**
+ ******************************************************************************
+ * @file    quantizedClassifier.cpp
+ * @brief   Post-training int8 quantisation of the PCA and LDA stages source.
+ ******************************************************************************
+ */
+
+#include "quantizedClassifier.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef STM_BUILD
+#include "arm_math.h"
+// stm32f767xx include must be first include to use CMSIS library.
+#include "stm32f767xx.h"
+#endif
+
+#if defined(STM_BUILD) && defined(__ARM_FEATURE_DSP)
+#define QUANT_SMLAD 1
+#endif
+
+namespace {
+
+/**
+ * @brief Round to the nearest integer, halfway cases away from zero.
+ *
+ * @param value Value in the range of int32_t.
+ * @return int32_t Rounded value.
+ */
+inline int32_t roundToInt(float value) {
+  return static_cast<int32_t>(value < 0.0f ? value - 0.5f : value + 0.5f);
+}
+
+/**
+ * @brief Quantize one output channel of a weight matrix.
+ *
+ * @param weights Float weights of the channel.
+ * @param stride Distance between consecutive weights of the channel.
+ * @param length Number of weights. The row is zero padded up to
+ * quantizedRowLength(length).
+ * @param [out] packed Packed int8 row.
+ * @return float Scale of the channel.
+ */
+float quantizeChannel(const float* weights, size_t stride, size_t length,
+                      int8_t* packed) {
+  float maxAbs = 0.0f;
+  for (size_t i = 0; i < length; ++i) {
+    const float value = weights[i * stride];
+    const float magnitude = value < 0.0f ? -value : value;
+    maxAbs = magnitude > maxAbs ? magnitude : maxAbs;
+  }
+  const float scale = maxAbs > 0.0f ? maxAbs / QUANT_WEIGHT_MAX : 1.0f;
+
+  std::vector<int8_t> row(quantizedRowLength(length), 0);
+  for (size_t i = 0; i < length; ++i) {
+    row[i] = static_cast<int8_t>(roundToInt(weights[i * stride] / scale));
+  }
+  packInt8Weights(row.data(), row.size(), packed);
+  return scale;
+}
+
+}  // namespace
+
+void packInt8Weights(const int8_t* weights, size_t length, int8_t* packed) {
+  for (size_t i = 0; i < length; i += QUANT_BLOCK_SIZE) {
+    packed[i] = weights[i];
+    packed[i + 1] = weights[i + 2];
+    packed[i + 2] = weights[i + 1];
+    packed[i + 3] = weights[i + 3];
+  }
+}
+
+int32_t dotInt8Int16(const int8_t* packed, const int16_t* activations,
+                     size_t length) {
+  int32_t acc = 0;
+#ifdef QUANT_SMLAD
+  for (size_t i = 0; i < length; i += QUANT_BLOCK_SIZE) {
+    uint32_t w;
+    uint32_t x01;
+    uint32_t x23;
+    std::memcpy(&w, &packed[i], sizeof(w));
+    std::memcpy(&x01, &activations[i], sizeof(x01));
+    std::memcpy(&x23, &activations[i + 2], sizeof(x23));
+    // Bytes 0 and 2 of the block hold w0 and w1, bytes 1 and 3 hold w2 and
+    // w3.
+    const uint32_t w01 = __SXTB16(w);
+    const uint32_t w23 = __SXTB16(__ROR(w, 8));
+    acc = static_cast<int32_t>(__SMLAD(w01, x01, static_cast<uint32_t>(acc)));
+    acc = static_cast<int32_t>(__SMLAD(w23, x23, static_cast<uint32_t>(acc)));
+  }
+#else
+  for (size_t i = 0; i < length; i += QUANT_BLOCK_SIZE) {
+    acc += packed[i] * activations[i] + packed[i + 2] * activations[i + 1] +
+           packed[i + 1] * activations[i + 2] +
+           packed[i + 3] * activations[i + 3];
+  }
+#endif
+  return acc;
+}
+
+float quantizeActivations(const float* values, size_t length,
+                          int16_t* quantized) {
+  float maxAbs = 0.0f;
+  for (size_t i = 0; i < length; ++i) {
+    const float magnitude = values[i] < 0.0f ? -values[i] : values[i];
+    maxAbs = magnitude > maxAbs ? magnitude : maxAbs;
+  }
+  const float scale = maxAbs > 0.0f ? maxAbs / QUANT_ACTIVATION_MAX : 1.0f;
+  const float inverse = 1.0f / scale;
+
+  for (size_t i = 0; i < length; ++i) {
+    quantized[i] = static_cast<int16_t>(roundToInt(values[i] * inverse));
+  }
+  for (size_t i = length; i < quantizedRowLength(length); ++i) {
+    quantized[i] = 0;
+  }
+  return scale;
+}
+
+QuantizedClassifier::QuantizedClassifier(const PrincipleComponentAnalysis& pca,
+                                         const LinearDiscriminantAnalysis& lda,
+                                         uint16_t numDCTCoeff,
+                                         uint16_t numPCAComponents,
+                                         uint16_t numClasses)
+    : numDCTCoeff(numDCTCoeff),
+      numPCAComponents(numPCAComponents),
+      numClasses(numClasses),
+      pcaMean(pca.getProjection().meanVector),
+      ldaBiases(lda.getProjection().classBiases),
+      pcaRow(quantizedRowLength(numDCTCoeff)),
+      ldaRow(quantizedRowLength(numPCAComponents)),
+      pcaWeights(numPCAComponents * this->pcaRow),
+      pcaScales(numPCAComponents),
+      ldaWeights(numClasses * this->ldaRow),
+      ldaScales(numClasses),
+      centered(numDCTCoeff),
+      activations(std::max(this->pcaRow, this->ldaRow)) {
+  // The projection is numDCTCoeff x numPCAComponents, so a component is a
+  // column.
+  const matrix& projection = pca.getProjection().projectionMatrix;
+  for (uint16_t j = 0; j < numPCAComponents; ++j) {
+    this->pcaScales[j] =
+        quantizeChannel(&projection.pData[j], projection.numCols, numDCTCoeff,
+                        &this->pcaWeights[j * this->pcaRow]);
+  }
+
+  const matrix& classWeights = lda.getProjection().classWeights;
+  for (uint16_t c = 0; c < numClasses; ++c) {
+    this->ldaScales[c] = quantizeChannel(
+        &classWeights.pData[static_cast<size_t>(c) * classWeights.numCols], 1,
+        numPCAComponents, &this->ldaWeights[c * this->ldaRow]);
+  }
+}
+
+void QuantizedClassifier::projectFrame(const float* mfccFrame,
+                                       float* pcaFrame) {
+  for (uint16_t k = 0; k < this->numDCTCoeff; ++k) {
+    this->centered[k] = mfccFrame[k] - this->pcaMean[k];
+  }
+
+  int16_t* quantized = this->activations.data();
+  const float inputScale =
+      quantizeActivations(this->centered.data(), this->numDCTCoeff, quantized);
+  for (uint16_t j = 0; j < this->numPCAComponents; ++j) {
+    const int32_t acc = dotInt8Int16(&this->pcaWeights[j * this->pcaRow],
+                                     quantized, this->pcaRow);
+    pcaFrame[j] = static_cast<float>(acc) * inputScale * this->pcaScales[j];
+  }
+}
+
+void QuantizedClassifier::scoreFeatures(const float* pcaFrame,
+                                        float* scores) {
+  int16_t* quantized = this->activations.data();
+  const float inputScale =
+      quantizeActivations(pcaFrame, this->numPCAComponents, quantized);
+  for (uint16_t c = 0; c < this->numClasses; ++c) {
+    const int32_t acc = dotInt8Int16(&this->ldaWeights[c * this->ldaRow],
+                                     quantized, this->ldaRow);
+    scores[c] = static_cast<float>(acc) * inputScale * this->ldaScales[c] +
+                this->ldaBiases[c];
+  }
+}
@@ -0,0 +1,167 @@
+/**
+ ******************************************************************************
+ * @file    quantizedClassifier.h
+ * @brief   Post-training int8 quantisation of the PCA and LDA stages, with an
+ *          SMLAD dot product kernel on the target and a portable one on the
+ *          host.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "lda.h"
+#include "pca.h"
+#include "runtime_audio360.hpp"
+
+/** @brief Weights are packed in blocks of four, so that SMLAD consumes two
+ * pairs of each block. Rows are zero padded to a multiple of the block. */
+constexpr inline size_t QUANT_BLOCK_SIZE = 4;
+
+/** @brief Padded length of a quantized row. */
+constexpr size_t quantizedRowLength(size_t length) {
+  return (length + QUANT_BLOCK_SIZE - 1) / QUANT_BLOCK_SIZE * QUANT_BLOCK_SIZE;
+}
+
+/** @brief Padded row lengths of the PCA and LDA weights of the default
+ * model. */
+constexpr inline size_t QUANT_PCA_ROW = quantizedRowLength(NUM_DCT_COEFF);
+constexpr inline size_t QUANT_LDA_ROW = quantizedRowLength(NUM_PCA_COMPONENTS);
+
+/** @brief Largest magnitude of a quantized weight and activation. */
+constexpr inline int32_t QUANT_WEIGHT_MAX = 127;
+constexpr inline int32_t QUANT_ACTIVATION_MAX = 32767;
+
+/**
+ * @brief Reorder a row of int8 weights for dotInt8Int16. Each block
+ * w0 w1 w2 w3 is stored w0 w2 w1 w3, so that sign extending bytes 0 and 2 of
+ * the block, then of the block rotated by 8 bits, gives the pairs (w0, w1) and
+ * (w2, w3).
+ *
+ * @param weights Weights in natural order.
+ * @param length Number of weights, a multiple of QUANT_BLOCK_SIZE.
+ * @param [out] packed Reordered weights.
+ */
+void packInt8Weights(const int8_t* weights, size_t length, int8_t* packed);
+
+/**
+ * @brief Dot product of packed int8 weights and int16 activations, with int32
+ * accumulation. Uses SMLAD on the target.
+ *
+ * @param packed Weights reordered by packInt8Weights.
+ * @param activations Activations in natural order.
+ * @param length Number of values, a multiple of QUANT_BLOCK_SIZE.
+ * @return int32_t The dot product.
+ */
+int32_t dotInt8Int16(const int8_t* packed, const int16_t* activations,
+                     size_t length);
+
+/**
+ * @brief Quantize activations to int16 with one scale for the frame.
+ *
+ * @param values Float activations.
+ * @param length Number of values. The output is zero padded up to
+ * quantizedRowLength(length).
+ * @param [out] quantized Activations, values / scale rounded.
+ * @return float The scale, largest magnitude / QUANT_ACTIVATION_MAX.
+ */
+float quantizeActivations(const float* values, size_t length,
+                          int16_t* quantized);
+
+/**
+ * @brief PCA projection and LDA scores with int8 weights.
+ *
+ * Weights have one scale per output channel, the largest magnitude of the
+ * channel over QUANT_WEIGHT_MAX. Activations are int16 with one scale per
+ * frame, as SMLAD multiplies 16 bit lanes. The accumulators are int32 and are
+ * rescaled to float between the stages. The PCA mean and the LDA biases stay
+ * in float.
+ */
+class QuantizedClassifier {
+ public:
+  /**
+   * @brief Quantize the weights of the float stages.
+   *
+   * @param pca PCA stage, numDCTCoeff -> numPCAComponents.
+   * @param lda LDA stage, numPCAComponents -> numClasses.
+   * @param numDCTCoeff Number of DCT coefficients.
+   * @param numPCAComponents Number of PCA components.
+   * @param numClasses Number of classes.
+   */
+  QuantizedClassifier(const PrincipleComponentAnalysis& pca,
+                      const LinearDiscriminantAnalysis& lda,
+                      uint16_t numDCTCoeff, uint16_t numPCAComponents,
+                      uint16_t numClasses);
+
+  /**
+   * @brief Center a frame of MFCC coefficients and project it onto the PCA
+   * components.
+   *
+   * @param mfccFrame MFCC coefficients, of size numDCTCoeff.
+   * @param [out] pcaFrame PCA features, of size numPCAComponents.
+   */
+  void projectFrame(const float* mfccFrame, float* pcaFrame);
+
+  /**
+   * @brief Score a frame of PCA features.
+   *
+   * @param pcaFrame PCA features, of size numPCAComponents.
+   * @param [out] scores Class scores, of size numClasses.
+   */
+  void scoreFeatures(const float* pcaFrame, float* scores);
+
+  /**
+   * @brief Get the size of the quantized weights and their scales.
+   *
+   * @return size_t Size (bytes).
+   */
+  size_t getWeightBytes() const {
+    return this->pcaWeights.size() * sizeof(int8_t) +
+           this->pcaScales.size() * sizeof(float) +
+           this->ldaWeights.size() * sizeof(int8_t) +
+           this->ldaScales.size() * sizeof(float);
+  }
+
+ private:
+  /** @brief Number of DCT coefficients. */
+  uint16_t numDCTCoeff;
+
+  /** @brief Number of PCA components. */
+  uint16_t numPCAComponents;
+
+  /** @brief Number of classes. */
+  uint16_t numClasses;
+
+  /** @brief PCA mean, in the model. */
+  const float* pcaMean;
+
+  /** @brief LDA biases, in the model. */
+  const float* ldaBiases;
+
+  /** @brief Padded length of a PCA weight row. */
+  size_t pcaRow;
+
+  /** @brief Padded length of an LDA weight row. */
+  size_t ldaRow;
+
+  /** @brief Packed PCA weights, one row of pcaRow per component. */
+  std::vector<int8_t> pcaWeights;
+
+  /** @brief Scale of each PCA component. */
+  std::vector<float> pcaScales;
+
+  /** @brief Packed LDA weights, one row of ldaRow per class. */
+  std::vector<int8_t> ldaWeights;
+
+  /** @brief Scale of each class. */
+  std::vector<float> ldaScales;
+
+  /** @brief Centered MFCC coefficients of the frame, of size numDCTCoeff. */
+  std::vector<float> centered;
+
+  /** @brief Quantized activations of the frame, of the longer padded row. */
+  std::vector<int16_t> activations;
+};
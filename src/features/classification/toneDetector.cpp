@@ -0,0 +1,115 @@
+/**
+ ******************************************************************************
+ * @file    toneDetector.cpp
+ * @brief   Goertzel tone pre-detector source code.
+ ******************************************************************************
+ */
+
+#include "toneDetector.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "constants.h"
+#include "frameLevel.h"
+
+/** @brief Classification::classify reads frames with a peak above 1 as 16 bit
+ * samples, so the silence threshold follows the same rule. */
+constexpr inline float PRE_DETECTOR_INTEGER_SCALE = 32767.0f;
+
+ToneDetector::ToneDetector(const std::vector<ToneBand>& bands,
+                           int sampleFrequency) {
+  const float binSpacing =
+      static_cast<float>(sampleFrequency) / PRE_DETECTOR_BLOCK_SIZE;
+
+  // One filter per bin that overlaps a band. A tone between two bins still
+  // leaves at least 40% of its energy in the nearer one.
+  for (const ToneBand& band : bands) {
+    const int firstBin = static_cast<int>(std::floor(band.lowHz / binSpacing));
+    const int lastBin = static_cast<int>(std::ceil(band.highHz / binSpacing));
+    for (int k = std::max(firstBin, 1);
+         k <= std::min(lastBin, static_cast<int>(PRE_DETECTOR_BLOCK_SIZE / 2));
+         k++) {
+      this->coefficients.push_back(
+          2.0f * std::cos(TWO_PI_32 * k / PRE_DETECTOR_BLOCK_SIZE));
+    }
+  }
+}
+
+bool ToneDetector::isActive(const float* frame, size_t numSamples) {
+  // Energy test over the whole frame, with the DC offset removed.
+  const FrameLevel level = measureFrameLevel(frame, numSamples);
+  const float scale = (level.peak <= 1.0f) ? 1.0f : PRE_DETECTOR_INTEGER_SCALE;
+  const bool loud = level.rms >= PRE_DETECTOR_SILENCE_RMS * scale;
+
+  // During an event the Goertzel bank only needs to run once the hangover is
+  // about to expire.
+  if (loud && this->hangover > 1) {
+    this->hangover--;
+    return true;
+  }
+
+  // Every block of the frame is searched, so a tone that starts late in the
+  // frame is not missed. Requiring consecutive tonal blocks keeps the chance of
+  // a noise block passing from growing with the number of blocks.
+  if (loud) {
+    const size_t numBlocks = numSamples / PRE_DETECTOR_BLOCK_SIZE;
+    const size_t minBlocks =
+        std::min(PRE_DETECTOR_MIN_TONAL_BLOCKS, numBlocks);
+    size_t tonalBlocks = 0;
+    for (size_t block = 0; block < numBlocks && minBlocks > 0; block++) {
+      tonalBlocks = this->isTonal(&frame[block * PRE_DETECTOR_BLOCK_SIZE])
+                        ? tonalBlocks + 1
+                        : 0;
+      if (tonalBlocks == minBlocks) {
+        this->hangover = PRE_DETECTOR_HANGOVER_FRAMES;
+        return true;
+      }
+    }
+  }
+
+  if (this->hangover > 0) {
+    this->hangover--;
+    return true;
+  }
+
+  return false;
+}
+
+void ToneDetector::reset() { this->hangover = 0; }
+
+bool ToneDetector::isTonal(const float* block) const {
+  float mean = 0.0f;
+  for (size_t i = 0; i < PRE_DETECTOR_BLOCK_SIZE; i++) {
+    mean += block[i];
+  }
+  mean /= PRE_DETECTOR_BLOCK_SIZE;
+
+  float energy = 0.0f;
+  for (size_t i = 0; i < PRE_DETECTOR_BLOCK_SIZE; i++) {
+    energy += (block[i] - mean) * (block[i] - mean);
+  }
+
+  if (energy <= FLOAT_EPS) {
+    return false;
+  }
+
+  // A sinusoid centred on a bin gives |X|^2 = N / 2 * energy. Stop at the
+  // first bin above the threshold.
+  const float minPower =
+      PRE_DETECTOR_MIN_TONALITY * 0.5f * PRE_DETECTOR_BLOCK_SIZE * energy;
+  for (float coefficient : this->coefficients) {
+    float s1 = 0.0f;
+    float s2 = 0.0f;
+    for (size_t i = 0; i < PRE_DETECTOR_BLOCK_SIZE; i++) {
+      const float s0 = block[i] + coefficient * s1 - s2;
+      s2 = s1;
+      s1 = s0;
+    }
+    if (s1 * s1 + s2 * s2 - coefficient * s1 * s2 >= minPower) {
+      return true;
+    }
+  }
+
+  return false;
+}
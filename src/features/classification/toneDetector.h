@@ -0,0 +1,114 @@
+/**
+ ******************************************************************************
+ * @file    toneDetector.h
+ * @brief   Goertzel tone pre-detector header. Cheap first stage that decides
+ *          whether a frame needs the full classification pipeline.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** @brief Frames with a mean removed RMS below this value (in normalized
+ * [-1, 1] units) are treated as silence. */
+constexpr inline float PRE_DETECTOR_SILENCE_RMS = 1e-3f;
+
+/** @brief Fraction of the block energy the strongest Goertzel bin must hold
+ * for the frame to be considered tonal. White noise puts 2 / block size of its
+ * energy in each bin on average, so its strongest bin rarely reaches 0.1. */
+constexpr inline float PRE_DETECTOR_MIN_TONALITY = 0.15f;
+
+/** @brief Number of samples each Goertzel filter runs over. Sets the bin
+ * spacing to sampleFrequency / PRE_DETECTOR_BLOCK_SIZE. */
+constexpr inline size_t PRE_DETECTOR_BLOCK_SIZE = 128;
+
+/** @brief Number of consecutive tonal blocks that make a frame tonal. The
+ * watched tones last far longer than two blocks, while noise rarely gives two
+ * tonal blocks in a row. */
+constexpr inline size_t PRE_DETECTOR_MIN_TONAL_BLOCKS = 2;
+
+/** @brief Number of frames the detector stays active after the last tonal
+ * frame, so short pauses inside an event keep the classifier running. */
+constexpr inline uint8_t PRE_DETECTOR_HANGOVER_FRAMES = 3;
+
+/** @brief Frequency band watched by the Goertzel filter bank. */
+struct ToneBand {
+  /** @brief Lowest frequency of the band (Hz). */
+  float lowHz;
+
+  /** @brief Highest frequency of the band (Hz). */
+  float highHz;
+};
+
+/** @brief Smoke alarm tones (T3 pattern around 3.1 kHz). */
+constexpr inline ToneBand SMOKE_ALARM_BAND{2500.0f, 4000.0f};
+
+/** @brief Wail and yelp siren sweeps. */
+constexpr inline ToneBand SIREN_BAND{400.0f, 1900.0f};
+
+/** @brief Voice pitch and first harmonics, so speech still reaches the
+ * classifier. */
+constexpr inline ToneBand VOICE_BAND{100.0f, 400.0f};
+
+/**
+ * @brief Frame energy test followed by a Goertzel filter bank tuned to the
+ * bands of the classified sounds.
+ *
+ * A frame is active when it is louder than PRE_DETECTOR_SILENCE_RMS and, in
+ * PRE_DETECTOR_MIN_TONAL_BLOCKS consecutive blocks of PRE_DETECTOR_BLOCK_SIZE
+ * samples anywhere in the frame, one Goertzel bin in a watched band holds at
+ * least PRE_DETECTOR_MIN_TONALITY of the block energy. Silence and broadband
+ * background fail the test and can skip the FFT, mel, DCT, PCA and LDA stages.
+ * While the hangover of a tonal frame runs, loud frames stay active without
+ * running the filter bank.
+ */
+class ToneDetector {
+ public:
+  /**
+   * @brief Construct a new ToneDetector object.
+   *
+   * @param bands Bands to watch.
+   * @param sampleFrequency The sample frequency of the audio input (Hz).
+   */
+  ToneDetector(const std::vector<ToneBand>& bands, int sampleFrequency);
+
+  /**
+   * @brief Decide whether a frame needs the full classification pipeline.
+   *
+   * @param frame Audio frame, either normalized to [-1, 1] or in 16 bit
+   * integer units.
+   * @param numSamples Number of samples in the frame.
+   * @return true if the frame is loud and tonal, or within the hangover of
+   * such a frame.
+   */
+  bool isActive(const float* frame, size_t numSamples);
+
+  /** @brief Clear the hangover state. */
+  void reset();
+
+  /**
+   * @brief Get the number of Goertzel filters in the bank.
+   *
+   * @return size_t Number of filters.
+   */
+  size_t getNumFilters() const { return this->coefficients.size(); }
+
+ private:
+  /**
+   * @brief Check whether a Goertzel bin holds at least
+   * PRE_DETECTOR_MIN_TONALITY of the block energy.
+   *
+   * @param block PRE_DETECTOR_BLOCK_SIZE samples.
+   * @return true if the block has a dominant tone in a watched band.
+   */
+  bool isTonal(const float* block) const;
+
+  /** @brief Goertzel coefficient 2 * cos(2 * pi * k / N) of every filter. */
+  std::vector<float> coefficients;
+
+  /** @brief Frames left before the detector goes inactive. */
+  uint8_t hangover{0};
+};
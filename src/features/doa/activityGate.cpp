@@ -0,0 +1,64 @@
+/**
+ ******************************************************************************
+ * @file    activityGate.cpp
+ * @brief   Frame energy gate for Direction of Arrival (DoA) source.
+ ******************************************************************************
+ */
+
+#include "activityGate.h"
+
+#include <algorithm>
+
+#include "frameLevel.h"
+
+ActivityGate::ActivityGate(float fullScale, float openRms, float closeRms,
+                           uint8_t holdFrames)
+    : inverseFullScale(1.0f / std::max(fullScale, FLOAT_EPS)),
+      openRms(openRms),
+      closeRms(std::min(closeRms, openRms)),
+      holdFrames(holdFrames) {}
+
+bool ActivityGate::update(const float* const* mics, size_t numMics,
+                          size_t numSamples) {
+  // Mean level over the mics, so one faulty mic cannot hold the gate open on
+  // its own.
+  float rms = 0.0f;
+  for (size_t mic = 0; mic < numMics; mic++) {
+    rms += this->frameRms(mics[mic], numSamples);
+  }
+
+  return this->update((numMics > 0) ? rms / numMics : 0.0f);
+}
+
+bool ActivityGate::update(float rms) {
+  if (!this->open) {
+    if (rms >= this->openRms) {
+      this->open = true;
+      this->hold = this->holdFrames;
+    }
+  } else if (rms >= this->closeRms) {
+    this->hold = this->holdFrames;
+  } else if (this->hold > 0) {
+    this->hold--;
+  } else {
+    this->open = false;
+  }
+
+  this->frames++;
+  if (!this->open) {
+    this->gatedFrames++;
+  }
+
+  return this->open;
+}
+
+float ActivityGate::frameRms(const float* frame, size_t numSamples) const {
+  return measureFrameLevel(frame, numSamples).rms * this->inverseFullScale;
+}
+
+void ActivityGate::reset() {
+  this->open = false;
+  this->hold = 0;
+  this->frames = 0;
+  this->gatedFrames = 0;
+}
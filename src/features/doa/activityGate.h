@@ -0,0 +1,139 @@
+/**
+ ******************************************************************************
+ * @file    activityGate.h
+ * @brief   Frame energy gate for Direction of Arrival (DoA) header. Decides
+ *          whether a frame holds enough sound to be worth locating.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "constants.h"
+
+/** @brief Frames louder than this mean removed RMS (relative to full scale)
+ * open the gate. */
+constexpr inline float DOA_GATE_OPEN_RMS = 3e-3f;
+
+/** @brief Frames quieter than this mean removed RMS start closing an open gate.
+ * Lower than DOA_GATE_OPEN_RMS so a level near the threshold does not toggle
+ * the gate every frame. */
+constexpr inline float DOA_GATE_CLOSE_RMS = 1.5e-3f;
+
+/** @brief Number of quiet frames an open gate still lets through before it
+ * closes, so short pauses inside an event keep DoA running. */
+constexpr inline uint8_t DOA_GATE_HOLD_FRAMES = 3;
+
+/** @brief What a DoA caller reports while the gate is closed. */
+enum class GatedDirection {
+  HOLD,  // Keep the direction of the last active frame.
+  NONE,  // Report DirectionLabel::None.
+};
+
+/**
+ * @brief Energy gate with hysteresis and hold time in front of DoA.
+ *
+ * The gate opens on a frame louder than the open threshold. Once open, it
+ * stays open for holdFrames consecutive frames quieter than the close
+ * threshold and closes on the next quiet one. A closed gate lets the caller
+ * skip the forward transforms and correlations of the DoA algorithm for silent
+ * frames.
+ *
+ * Levels are relative to the full scale of the samples given at construction,
+ * so the thresholds do not depend on the word size of the microphones.
+ */
+class ActivityGate {
+ public:
+  /**
+   * @brief Construct a new ActivityGate object. The gate starts closed.
+   *
+   * @param fullScale Sample value of a full scale signal, e.g. 1 for frames
+   * normalized to [-1, 1] or MIC_SAMPLE_FULL_SCALE for the mic buffers.
+   * @param openRms Mean removed RMS that opens the gate, relative to full
+   * scale.
+   * @param closeRms Mean removed RMS below which the gate starts closing,
+   * relative to full scale.
+   * @param holdFrames Quiet frames an open gate lets through before closing.
+   */
+  ActivityGate(float fullScale = 1.0f, float openRms = DOA_GATE_OPEN_RMS,
+               float closeRms = DOA_GATE_CLOSE_RMS,
+               uint8_t holdFrames = DOA_GATE_HOLD_FRAMES);
+
+  /**
+   * @brief Update the gate with the frames of every mic.
+   *
+   * @param mics Audio frame of each mic, in units of the full scale.
+   * @param numMics Number of mics.
+   * @param numSamples Number of samples in each frame.
+   * @return true if the gate is open and DoA should run on the frame.
+   */
+  bool update(const float* const* mics, size_t numMics, size_t numSamples);
+
+  /**
+   * @brief Update the gate with the level of a frame.
+   *
+   * @param rms Mean removed RMS of the frame, relative to full scale.
+   * @return true if the gate is open and DoA should run on the frame.
+   */
+  bool update(float rms);
+
+  /**
+   * @brief Compute the mean removed RMS of a frame relative to full scale.
+   *
+   * @param frame Audio frame, in units of the full scale.
+   * @param numSamples Number of samples in the frame.
+   * @return float RMS of the frame.
+   */
+  float frameRms(const float* frame, size_t numSamples) const;
+
+  /**
+   * @brief Get whether the gate is open.
+   *
+   * @return true if the last frame was active.
+   */
+  bool isOpen() const { return this->open; }
+
+  /** @brief Close the gate and clear the counters. */
+  void reset();
+
+  /**
+   * @brief Get the number of frames the gate was updated with.
+   *
+   * @return uint32_t Number of frames.
+   */
+  uint32_t getFrameCount() const { return this->frames; }
+
+  /**
+   * @brief Get the number of frames the gate closed off.
+   *
+   * @return uint32_t Number of gated frames.
+   */
+  uint32_t getGatedFrameCount() const { return this->gatedFrames; }
+
+ private:
+  /** @brief Inverse of the sample value of a full scale signal. */
+  float inverseFullScale;
+
+  /** @brief RMS that opens the gate. */
+  float openRms;
+
+  /** @brief RMS below which the gate starts closing. */
+  float closeRms;
+
+  /** @brief Quiet frames an open gate lets through before closing. */
+  uint8_t holdFrames;
+
+  /** @brief Quiet frames the gate still lets through. */
+  uint8_t hold{0};
+
+  /** @brief Whether the gate is open. */
+  bool open{false};
+
+  /** @brief Number of frames the gate was updated with. */
+  uint32_t frames{0};
+
+  /** @brief Number of frames the gate closed off. */
+  uint32_t gatedFrames{0};
+};
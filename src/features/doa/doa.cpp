@@ -12,7 +12,20 @@
 #include "exceptions.hpp"
 #include "logging.hpp"
 
-DOA::DOA(size_t numSamples) : numSamples(numSamples), gccPhaT(numSamples) {}
+DOA::DOA(size_t numSamples, const ArrayGeometry& geometry)
+    : numSamples(numSamples),
+      geometry(geometry),
+      gccPhaT(numSamples, SAMPLE_FREQUENCY, PeakInterpolation::PARABOLIC,
+              CorrelationEvaluator::AUTO, TdoaSolver::PAIR_AVERAGE, geometry) {}
+
+void DOA::setArrayGeometry(const ArrayGeometry& geometry) {
+  this->geometry = geometry;
+  gccPhaT.setArrayGeometry(geometry);
+
+  // Lazily created modules are rebuilt with the new geometry on next use.
+  srpPhaT.reset();
+  gccPhaTQ31.reset();
+}
 
 float DOA::calculateDirection(float* mic1Data, float* mic2Data, float* mic3Data,
                               float* mic4Data, DOA_Algorithms algo) {
@@ -24,6 +37,19 @@ float DOA::calculateDirection(float* mic1Data, float* mic2Data, float* mic3Data,
           gccPhaT.calculateDirection(mic1Data, mic2Data, mic3Data, mic4Data);
       break;
 
+    case SRP_PHAT:
+      if (!srpPhaT) {
+        srpPhaT = std::make_unique<SRPPhaT>(
+            numSamples, SAMPLE_FREQUENCY, geometry,
+            gccPhaT.getPrunedCorrelation());
+      }
+      // Reuse the GCC PhaT forward transforms and spectra.
+      gccPhaT.computeSpectra(mic1Data, mic2Data, mic3Data, mic4Data);
+      angle_rad = srpPhaT->calculateDirection(
+          gccPhaT.getMicSpectrum(0), gccPhaT.getMicSpectrum(1),
+          gccPhaT.getMicSpectrum(2), gccPhaT.getMicSpectrum(3));
+      break;
+
     default:
       ERROR("DOA algorithm is currently not supported.");
       throw AudioProcessingException(
@@ -33,3 +59,54 @@ float DOA::calculateDirection(float* mic1Data, float* mic2Data, float* mic3Data,
 
   return angle_rad;
 }
+
+size_t DOA::calculateDirections(float* mic1Data, float* mic2Data,
+                                float* mic3Data, float* mic4Data,
+                                DoASource* sources, size_t maxSources,
+                                DOA_Algorithms algo) {
+  switch (algo) {
+    case GCC_PHAT:
+      return gccPhaT.calculateDirections(mic1Data, mic2Data, mic3Data,
+                                         mic4Data, sources, maxSources);
+
+    default:
+      // Single source algorithms. Unsupported ones throw.
+      const float angle_rad = this->calculateDirection(
+          mic1Data, mic2Data, mic3Data, mic4Data, algo);
+      if (maxSources == 0) {
+        return 0;
+      }
+      sources[0] = DoASource{angle_rad, 0.0f};
+      return 1;
+  }
+}
+
+void DOA::setCrossSpectrumSmoothing(float smoothing) {
+  gccPhaT.setCrossSpectrumSmoothing(smoothing);
+}
+
+float DOA::calculateDirection(const q31_t* mic1Data, const q31_t* mic2Data,
+                              const q31_t* mic3Data, const q31_t* mic4Data,
+                              DOA_Algorithms algo) {
+  float angle_rad = 0.0;
+
+  switch (algo) {
+    case GCC_PHAT_Q31:
+      if (!gccPhaTQ31) {
+        gccPhaTQ31 = std::make_unique<GCCPhaTQ31>(
+            numSamples, SAMPLE_FREQUENCY, PeakInterpolation::PARABOLIC,
+            geometry);
+      }
+      angle_rad = gccPhaTQ31->calculateDirection(mic1Data, mic2Data, mic3Data,
+                                                 mic4Data);
+      break;
+
+    default:
+      ERROR("DOA algorithm is not supported for fixed-point data.");
+      throw AudioProcessingException(
+          "DOA algorithm is not supported for fixed-point data.");
+      break;
+  }
+
+  return angle_rad;
+}
@@ -7,10 +7,13 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "doaAlgorithm.h"
 #include "gccPhat.h"
+#include "gccPhatQ31.h"
+#include "srpPhat.h"
 
 /** @brief DOA processing module. */
 class DOA {
@@ -20,8 +23,10 @@ class DOA {
    *
    * @param numSamples Number of samples from each source that needs to be
    * processed.
+   * @param geometry Geometry of the microphone array.
    */
-  DOA(size_t numSamples);
+  DOA(size_t numSamples,
+      const ArrayGeometry& geometry = DEFAULT_ARRAY_GEOMETRY);
 
   /**
    * @brief Calculate the direction of audio source.
@@ -38,10 +43,73 @@ class DOA {
                            float* mic4Data,
                            DOA_Algorithms algo = DOA_Algorithms::GCC_PHAT);
 
+  /**
+   * @brief Calculate the directions of up to DOA_MAX_SOURCES audio sources.
+   * Algorithms other than GCC PhaT report their single direction with a
+   * strength of 0.
+   *
+   * @param mic1Data Audio data stream from microphone 1.
+   * @param mic2Data Audio data stream from microphone 2.
+   * @param mic3Data Audio data stream from microphone 3.
+   * @param mic4Data Audio data stream from microphone 4.
+   * @param [out] sources Sources by decreasing strength.
+   * @param maxSources Capacity of sources.
+   * @param algo DOA algorithm to use.
+   * @return size_t Number of sources found.
+   * @throws AudioProcessingException if failure in processing audio data.
+   */
+  size_t calculateDirections(float* mic1Data, float* mic2Data,
+                             float* mic3Data, float* mic4Data,
+                             DoASource* sources, size_t maxSources,
+                             DOA_Algorithms algo = DOA_Algorithms::GCC_PHAT);
+
+  /**
+   * @brief Calculate the direction of audio source from fixed-point samples.
+   *
+   * @param mic1Data q31 audio data stream from microphone 1.
+   * @param mic2Data q31 audio data stream from microphone 2.
+   * @param mic3Data q31 audio data stream from microphone 3.
+   * @param mic4Data q31 audio data stream from microphone 4.
+   * @param algo DOA algorithm to use.
+   * @return float Direction of audio source in radians.
+   * @throws AudioProcessingException if failure in processing audio data.
+   */
+  float calculateDirection(const q31_t* mic1Data, const q31_t* mic2Data,
+                           const q31_t* mic3Data, const q31_t* mic4Data,
+                           DOA_Algorithms algo = DOA_Algorithms::GCC_PHAT_Q31);
+
+  /**
+   * @brief Switch every DoA algorithm to another microphone array geometry,
+   * e.g. the one of the board found at start-up.
+   *
+   * @param geometry Geometry of the microphone array.
+   */
+  void setArrayGeometry(const ArrayGeometry& geometry);
+
+  /**
+   * @brief Set the smoothing of the GCC PhaT cross-power spectra across frames.
+   * See GCCPhaT::setCrossSpectrumSmoothing().
+   *
+   * @param smoothing Weight of the previous frames in [0, 1). 0 disables
+   * smoothing.
+   */
+  void setCrossSpectrumSmoothing(float smoothing);
+
  private:
   /** @brief The number of samples to process for each incoming source. */
   size_t numSamples;
 
+  /** @brief Geometry of the microphone array. */
+  ArrayGeometry geometry;
+
   /** @brief GCC PhaT algorithm module. */
   GCCPhaT gccPhaT;
+
+  /** @brief Fixed-point GCC PhaT algorithm module. Created on first use so
+   * float-only users do not pay for its buffers. */
+  std::unique_ptr<GCCPhaTQ31> gccPhaTQ31;
+
+  /** @brief SRP PhaT algorithm module, fed by the GCC PhaT spectra. Created on
+   * first use so GCC PhaT users do not pay for its steering table. */
+  std::unique_ptr<SRPPhaT> srpPhaT;
 };
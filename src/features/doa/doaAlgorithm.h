@@ -7,12 +7,28 @@
 
 #pragma once
 
+#include <cstddef>
 #include <vector>
 
 /** @brief Enum representing the different DOA algorithms. */
 enum DOA_Algorithms {
   NONE,
   GCC_PHAT,
+  GCC_PHAT_Q31,
+  SRP_PHAT,
+};
+
+/** @brief Largest number of audio sources located in one frame. */
+constexpr inline size_t DOA_MAX_SOURCES = 3;
+
+/** @brief Direction of one of several audio sources. */
+struct DoASource {
+  /** @brief Direction of the audio source in radians. */
+  float angle_rad{0.0f};
+
+  /** @brief Mean GCC PhaT correlation of the source. 1 for a single source
+   * in a perfectly clean recording. */
+  float strength{0.0f};
 };
 
 /** @brief Abstract DOA algorithm class. */
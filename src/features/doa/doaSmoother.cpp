@@ -13,7 +13,50 @@
 #include "angles.hpp"
 #include "constants.h"
 
-DoASmoother::DoASmoother() : currentAvg_(0.0f) {}
+template <size_t Capacity>
+void DoASmoother::AngleRing<Capacity>::push(float angle_rad) {
+  if (count == Capacity) {
+    sumSin -= sines[head];
+    sumCos -= cosines[head];
+  } else {
+    count++;
+  }
+
+  angles[head] = angle_rad;
+  sines[head] = std::sin(angle_rad);
+  cosines[head] = std::cos(angle_rad);
+  sumSin += sines[head];
+  sumCos += cosines[head];
+  head = (head + 1) % Capacity;
+}
+
+template <size_t Capacity>
+void DoASmoother::AngleRing<Capacity>::clear() {
+  sumSin = 0.0f;
+  sumCos = 0.0f;
+  head = 0;
+  count = 0;
+}
+
+template <size_t Capacity>
+float DoASmoother::AngleRing<Capacity>::mean() const {
+  if (count == 0) {
+    return 0.0f;
+  }
+  // Opposite angles cancel out and leave no direction.
+  if (std::hypot(sumSin, sumCos) < 1e-6f * count) {
+    return angles[(head + Capacity - 1) % Capacity];
+  }
+  return normalizeAngleRad(std::atan2(sumSin, sumCos));
+}
+
+DoASmoother::DoASmoother(DoASmootherMode mode)
+    : mode_(mode),
+      currentAvg_(0.0f),
+      velocity_(0.0f),
+      p00_(0.0f),
+      p01_(0.0f),
+      p11_(0.0f) {}
 
 float DoASmoother::shortestAngleDiff(float a, float b) const {
   float diff = a - b;
@@ -32,44 +75,64 @@ bool DoASmoother::isWithinThreshold(float a, float b) const {
   return diffRad <= thresholdRad;
 }
 
-float DoASmoother::averageOf(const std::deque<float>& buf) const {
-  if (buf.empty()) {
-    return 0.0f;
-  }
-  float sum = 0.0f;
-  for (float v : buf) {
-    sum += v;
-  }
-  return sum / static_cast<float>(buf.size());
+void DoASmoother::resetTracker(float angle_rad) {
+  currentAvg_ = angle_rad;
+  velocity_ = 0.0f;
+  p00_ = KALMAN_MEASUREMENT_NOISE;
+  p01_ = 0.0f;
+  p11_ = KALMAN_INITIAL_VELOCITY_VARIANCE;
+}
+
+float DoASmoother::trackAngle(float angle_rad) {
+  // Predict one update ahead with white angular acceleration.
+  const float q = KALMAN_PROCESS_NOISE;
+  const float predicted = currentAvg_ + velocity_;
+  const float p00 = p00_ + 2.0f * p01_ + p11_ + 0.25f * q;
+  const float p01 = p01_ + p11_ + 0.5f * q;
+  const float p11 = p11_ + q;
+
+  // Correct with the innovation taken the short way around the circle.
+  const float innovation = shortestAngleDiff(angle_rad, predicted);
+  const float s = p00 + KALMAN_MEASUREMENT_NOISE;
+  const float k0 = p00 / s;
+  const float k1 = p01 / s;
+  currentAvg_ = normalizeAngleRad(predicted + k0 * innovation);
+  velocity_ += k1 * innovation;
+  p00_ = (1.0f - k0) * p00;
+  p01_ = (1.0f - k0) * p01;
+  p11_ = p11 - k1 * p01;
+
+  return currentAvg_;
 }
 
 float DoASmoother::update(float angle_rad) {
   angle_rad = normalizeAngleRad(angle_rad);
+  const bool tracking = (mode_ == DoASmootherMode::KALMAN);
 
-  if (active_.empty()) {
-    active_.push_back(angle_rad);
-    currentAvg_ = angle_rad;
+  if (active_.count == 0) {
+    active_.push(angle_rad);
+    resetTracker(angle_rad);
     return angle_rad;
   }
 
-  if (isWithinThreshold(angle_rad, currentAvg_)) {
+  // The tracker expects the source to keep moving.
+  const float expected =
+      tracking ? normalizeAngleRad(currentAvg_ + velocity_) : currentAvg_;
+  if (isWithinThreshold(angle_rad, expected)) {
     candidate_.clear();
-    active_.push_front(angle_rad);
-    if (active_.size() > MAX_WINDOW) {
-      active_.pop_back();
-    }
-    currentAvg_ = averageOf(active_);
+    active_.push(angle_rad);
+    currentAvg_ = tracking ? trackAngle(angle_rad) : active_.mean();
     return currentAvg_;
   }
 
-  candidate_.push_back(angle_rad);
-  if (candidate_.size() >= SWITCH_THRESHOLD) {
+  candidate_.push(angle_rad);
+  if (candidate_.count >= SWITCH_THRESHOLD) {
     active_.clear();
-    for (float v : candidate_) {
-      active_.push_back(v);
+    for (size_t i = 0; i < candidate_.count; i++) {
+      active_.push(candidate_.angles[(candidate_.head + i) % SWITCH_THRESHOLD]);
     }
     candidate_.clear();
-    currentAvg_ = averageOf(active_);
+    resetTracker(active_.mean());
     return currentAvg_;
   }
 
@@ -8,15 +8,26 @@
 #pragma once
 
 #include <cstddef>
-#include <deque>
+
+/** @brief How DoASmoother follows the source between jumps. */
+enum class DoASmootherMode {
+  SLIDING_MEAN,  // Circular mean of the last frames.
+  KALMAN,        // Constant angular velocity Kalman tracker.
+};
 
 /**
- * @brief Smooths DOA angle outputs using a sliding average.
+ * @brief Smooths DOA angle outputs using a sliding circular mean or a
+ * constant-velocity Kalman tracker.
  * Ignores 1-2 frame jumps; tracks new locations after 3+ consecutive frames.
+ * Keeps its history in fixed ring buffers, so update() never allocates.
  */
 class DoASmoother {
  public:
-  DoASmoother();
+  /**
+   * @brief Construct a new DoASmoother object.
+   * @param mode How the source is followed between jumps.
+   */
+  DoASmoother(DoASmootherMode mode = DoASmootherMode::SLIDING_MEAN);
 
   /**
    * @brief Update with new angle and return smoothed value.
@@ -25,16 +36,69 @@ class DoASmoother {
    */
   float update(float angle_rad);
 
+  /**
+   * @brief Get the angular velocity estimated by the Kalman tracker.
+   * @return Velocity in radians per update, 0 in sliding mean mode.
+   */
+  float getAngularVelocity() const { return velocity_; }
+
  private:
   static constexpr size_t MAX_WINDOW = 5;
   static constexpr size_t SWITCH_THRESHOLD = 3;
   static constexpr float JUMP_THRESHOLD_DEG = 15.0f;
 
-  std::deque<float> active_;
-  std::deque<float> candidate_;
+  /** @brief Variance of the angular acceleration between updates (rad^2). */
+  static constexpr float KALMAN_PROCESS_NOISE = 1e-4f;
+
+  /** @brief Variance of a measured angle (rad^2), about 5 degrees RMS. */
+  static constexpr float KALMAN_MEASUREMENT_NOISE = 7.6e-3f;
+
+  /** @brief Initial variance of the angular velocity (rad^2). */
+  static constexpr float KALMAN_INITIAL_VELOCITY_VARIANCE = 3e-2f;
+
+  /**
+   * @brief Fixed-capacity ring of angles with running sums of their unit
+   * vectors, so the circular mean costs O(1) per update.
+   */
+  template <size_t Capacity>
+  struct AngleRing {
+    float angles[Capacity]{};
+    float sines[Capacity]{};
+    float cosines[Capacity]{};
+    float sumSin = 0.0f;
+    float sumCos = 0.0f;
+    size_t head = 0;
+    size_t count = 0;
+
+    /** @brief Add an angle, dropping the oldest one when full. */
+    void push(float angle_rad);
+
+    /** @brief Remove every angle. */
+    void clear();
+
+    /** @brief Circular mean in [0, 2*pi), the newest angle if undefined. */
+    float mean() const;
+  };
+
+  DoASmootherMode mode_;
+  AngleRing<MAX_WINDOW> active_;
+  AngleRing<SWITCH_THRESHOLD> candidate_;
   float currentAvg_;
 
+  /** @brief Angular velocity of the Kalman tracker (rad per update). */
+  float velocity_;
+
+  /** @brief Covariance of the Kalman state (angle, velocity). */
+  float p00_;
+  float p01_;
+  float p11_;
+
   bool isWithinThreshold(float a, float b) const;
-  float averageOf(const std::deque<float>& buf) const;
   float shortestAngleDiff(float a, float b) const;
+
+  /** @brief Restart the Kalman tracker at a measured angle. */
+  void resetTracker(float angle_rad);
+
+  /** @brief Predict and correct the Kalman tracker with a measured angle. */
+  float trackAngle(float angle_rad);
 };
@@ -8,127 +8,487 @@
 
 #include "gccPhat.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
-#include "angles.hpp"
+#include "fastmath.h"
 
-constexpr inline float MAX_DELAY_MIC1_2 = MIC1_2_DISTANCE_m / SOUND_AIR_mps;
-constexpr inline float MAX_DELAY_MIC2_3 = MIC2_3_DISTANCE_m / SOUND_AIR_mps;
-constexpr inline float MAX_DELAY_MIC3_4 = MIC3_4_DISTANCE_m / SOUND_AIR_mps;
-constexpr inline float MAX_DELAY_MIC4_1 = MIC4_1_DISTANCE_m / SOUND_AIR_mps;
 
-GCCPhaT::GCCPhaT(size_t numSamples, int sampleFrequency)
+/** @brief Number of adjacent mic pairs at the start of MIC_PAIRS. */
+static constexpr size_t NUM_ADJACENT_PAIRS = 4;
+
+/**
+ * @brief Largest absolute lag the peak search and interpolation read.
+ *
+ * @param numSamples Number of samples of the correlation.
+ * @param sampleFrequency The sample frequency of the audio inputs (Hz).
+ * @param peakInterpolation Method used to refine correlation peaks.
+ * @param maxDelay_s Longest physically allowed delay of the searched pairs.
+ * @return int Lag in samples.
+ */
+static int correlationMaxLag(size_t numSamples, int sampleFrequency,
+                             PeakInterpolation peakInterpolation,
+                             float maxDelay_s) {
+  const int searchRange =
+      std::min(static_cast<int>(std::ceil(maxDelay_s * sampleFrequency)),
+               static_cast<int>(numSamples / 2) - 1);
+
+  // Interpolation reads the neighbours of the peak.
+  const int margin = (peakInterpolation == PeakInterpolation::UPSAMPLED)
+                         ? PEAK_UPSAMPLE_HALF_TAPS
+                         : 1;
+  return searchRange + margin;
+}
+
+/**
+ * @brief Write one bin of two real-signal spectra C1 and C2 into the input of a
+ * paired inverse FFT as Z[k] = C1[k] + j * C2[k], with the upper half
+ * Z[N-k] = conj(C1[k]) + j * conj(C2[k]).
+ *
+ * @param N Number of samples of the inverse transform.
+ * @param k Bin in [0, N / 2].
+ * @param c1Re Real component of C1[k].
+ * @param c1Im Imaginary component of C1[k].
+ * @param c2Re Real component of C2[k].
+ * @param c2Im Imaginary component of C2[k].
+ * @param [out] z Interleaved complex spectrum of N bins.
+ */
+static inline void packPairBin(int N, int k, float c1Re, float c1Im,
+                               float c2Re, float c2Im, float* z) {
+  if (k == 0 || k == N / 2) {
+    // DC and Nyquist bins of real signals are real.
+    z[2 * k] = c1Re;
+    z[2 * k + 1] = c2Re;
+    return;
+  }
+
+  z[2 * k] = c1Re - c2Im;
+  z[2 * k + 1] = c1Im + c2Re;
+  z[2 * (N - k)] = c1Re + c2Im;
+  z[2 * (N - k) + 1] = c2Re - c1Im;
+}
+
+void phatWeight(float* real, float* img, size_t numBins) {
+  // PhaT: removes magnitude information and keeps only phase. This will tell
+  // the timing offset of certain frequencies and remove any noise/echoes.
+  float weights[PHAT_BLOCK_BINS];
+  for (size_t start = 0; start < numBins; start += PHAT_BLOCK_BINS) {
+    const size_t count = std::min(PHAT_BLOCK_BINS, numBins - start);
+    for (size_t k = 0; k < count; k++) {
+      const float re = real[start + k];
+      const float im = img[start + k];
+      // Clamped so that overflowing bins still get a finite weight.
+      weights[k] = std::clamp(re * re + im * im, FLOAT_EPS * FLOAT_EPS,
+                              std::numeric_limits<float>::max());
+    }
+    fastRsqrt(weights, weights, count);
+    for (size_t k = 0; k < count; k++) {
+      real[start + k] *= weights[k];
+      img[start + k] *= weights[k];
+    }
+  }
+}
+
+void phatCrossSpectrum(const FrequencyDomain& freqA,
+                       const FrequencyDomain& freqB, size_t firstBin,
+                       size_t numBins, float* real, float* img) {
+  // GCC: cross correlation of frequencies.
+  for (size_t k = 0; k < numBins; k++) {
+    const size_t bin = firstBin + k;
+    const float aRe = freqA.real[bin];
+    const float aIm = freqA.img[bin];
+    const float bRe = freqB.real[bin];
+    const float bIm = freqB.img[bin];
+    real[k] = aRe * bRe + aIm * bIm;
+    img[k] = aIm * bRe - aRe * bIm;
+  }
+  phatWeight(real, img, numBins);
+}
+
+GCCPhaT::GCCPhaT(size_t numSamples, int sampleFrequency,
+                 PeakInterpolation peakInterpolation,
+                 CorrelationEvaluator correlationEvaluator,
+                 TdoaSolver tdoaSolver, const ArrayGeometry& geometry)
     : numSamples(numSamples),
       sampleFrequency(sampleFrequency),
+      peakInterpolation(peakInterpolation),
+      correlationEvaluator(correlationEvaluator),
+      requestedEvaluator(correlationEvaluator),
+      tdoaSolver(tdoaSolver),
+      geometryTables(geometry, sampleFrequency),
+      prunedCorrelation(numSamples, 0),
       fft(numSamples, sampleFrequency),
-      ifft(numSamples) {}
+      ifft(numSamples) {
+  this->configureLagRange();
+}
+
+void GCCPhaT::setArrayGeometry(const ArrayGeometry& geometry) {
+  this->geometryTables = GeometryTables(geometry, this->sampleFrequency);
+  this->configureLagRange();
+  this->resetCrossSpectra();
+}
+
+void GCCPhaT::configureLagRange() {
+  // The least-squares solver and multi-source association read the diagonal
+  // pairs as well.
+  const int maxLag =
+      correlationMaxLag(this->numSamples, this->sampleFrequency,
+                        this->peakInterpolation,
+                        this->geometryTables.getMaxDelay());
+  this->correlationEvaluator = this->requestedEvaluator;
+  if (this->correlationEvaluator == CorrelationEvaluator::AUTO) {
+    this->correlationEvaluator =
+        chooseCorrelationEvaluator(this->numSamples, maxLag);
+  }
+
+  if (this->correlationEvaluator == CorrelationEvaluator::PRUNED_LAGS) {
+    this->prunedCorrelation = PrunedCorrelation(this->numSamples, maxLag);
+    this->phatSpectrum.resize(2 * (this->numSamples / 2 + 1));
+    this->lagCorrelation.resize(2 * this->prunedCorrelation.getNumLags());
+  }
+}
 
 float GCCPhaT::calculateDirection(float* mic1Data, float* mic2Data,
                                   float* mic3Data, float* mic4Data) {
-  // Compute FT for each input source.
-
-  fft.signalToFrequency(mic1Data, mic1FreqDomain, WindowFunction::HANN_WINDOW);
-  fft.signalToFrequency(mic2Data, mic2FreqDomain, WindowFunction::HANN_WINDOW);
-  fft.signalToFrequency(mic3Data, mic3FreqDomain, WindowFunction::HANN_WINDOW);
-  fft.signalToFrequency(mic4Data, mic4FreqDomain, WindowFunction::HANN_WINDOW);
-
-  // Compute time delay between each microphone. Exclude mics that are diagonal
-  // from each other.
-  float timeDelay1_2_s = this->estimateInterMicDelay(
-      mic1FreqDomain, mic2FreqDomain, MAX_DELAY_MIC1_2);  // Horizontal.
-  float timeDelay3_2_s = this->estimateInterMicDelay(
-      mic3FreqDomain, mic2FreqDomain, MAX_DELAY_MIC2_3);  // Vertical.
-  float timeDelay4_3_s = this->estimateInterMicDelay(
-      mic4FreqDomain, mic3FreqDomain, MAX_DELAY_MIC3_4);  // Horizontal.
-  float timeDelay4_1_s = this->estimateInterMicDelay(
-      mic4FreqDomain, mic1FreqDomain, MAX_DELAY_MIC4_1);  // Vertical.
-
-  return this->estimateAngle(timeDelay1_2_s, timeDelay4_3_s, timeDelay3_2_s,
-                             timeDelay4_1_s);
-}
-
-float GCCPhaT::estimateInterMicDelay(const FrequencyDomain& freqA,
-                                     const FrequencyDomain& freqB,
-                                     float maxDelay_s) {
-  this->computeGccPhatSpectrum(freqA, freqB);
-  size_t crossCorrSize = 0;  // Will be updated by IFFT.
-  float* gccPhatCorrelation =
-      ifft.frequencyToTime(this->phatCrossSpectrum, crossCorrSize);
+  this->computeSpectra(mic1Data, mic2Data, mic3Data, mic4Data);
+
+  // Compute time delay between each microphone, two mic pairs per inverse
+  // transform. The adjacent pairs come first in MIC_PAIRS; the diagonals are
+  // only needed by the least-squares solver.
+  const size_t numPairs = (this->tdoaSolver == TdoaSolver::LEAST_SQUARES)
+                              ? NUM_MIC_PAIRS
+                              : NUM_ADJACENT_PAIRS;
+  float timeDelays_s[NUM_MIC_PAIRS] = {};
+  for (size_t pair = 0; pair < numPairs; pair += 2) {
+    this->estimateInterMicDelays(pair, timeDelays_s[pair],
+                                 timeDelays_s[pair + 1]);
+  }
+
+  if (this->tdoaSolver == TdoaSolver::LEAST_SQUARES) {
+    return this->estimateAngleLeastSquares(timeDelays_s);
+  }
 
-  return this->calculateTimeDelay(gccPhatCorrelation, crossCorrSize,
-                                  maxDelay_s);
+  // Horizontal pairs 1-2 and 4-3, vertical pairs 3-2 and 4-1.
+  return this->estimateAngle(timeDelays_s[0], timeDelays_s[2], timeDelays_s[1],
+                             timeDelays_s[3]);
 }
 
-void GCCPhaT::computeGccPhatSpectrum(const FrequencyDomain& freqA,
-                                     const FrequencyDomain& freqB) {
-  for (size_t i = 0; i < this->phatCrossSpectrum.N; i++) {
-    // GCC: cross correlation of frequencies.
-    float real = freqA.real[i] * freqB.real[i] + freqA.img[i] * freqB.img[i];
-    float img = freqA.img[i] * freqB.real[i] - freqA.real[i] * freqB.img[i];
+size_t GCCPhaT::calculateDirections(float* mic1Data, float* mic2Data,
+                                    float* mic3Data, float* mic4Data,
+                                    DoASource* sources, size_t maxSources) {
+  maxSources = std::min(maxSources, DOA_MAX_SOURCES);
+  if (maxSources == 0) {
+    return 0;
+  }
+
+  this->computeSpectra(mic1Data, mic2Data, mic3Data, mic4Data);
+
+  // Strongest peaks of every adjacent pair, lags in samples.
+  CorrelationPeak peaks[NUM_ADJACENT_PAIRS][DOA_MAX_SOURCES];
+  size_t numPeaks[NUM_ADJACENT_PAIRS] = {};
+  for (size_t pair = 0; pair < NUM_ADJACENT_PAIRS; pair += 2) {
+    size_t crossCorrSize = 0;
+    float* correlation1 = nullptr;
+    float* correlation2 = nullptr;
+    this->computePairCorrelations(pair, correlation1, correlation2,
+                                  crossCorrSize);
+    numPeaks[pair] = this->findDelayPeaks(correlation1, crossCorrSize,
+                                          geometryTables.getPairMaxLag(pair),
+                                          peaks[pair]);
+    numPeaks[pair + 1] = this->findDelayPeaks(
+        correlation2, crossCorrSize, geometryTables.getPairMaxLag(pair + 1),
+        peaks[pair + 1]);
+  }
+
+  // Diagonal correlations, only read at the delays the adjacent peaks imply.
+  size_t diagonalSize = 0;
+  float* diagonal1_3 = nullptr;
+  float* diagonal2_4 = nullptr;
+  this->computePairCorrelations(NUM_ADJACENT_PAIRS, diagonal1_3, diagonal2_4,
+                                diagonalSize);
+  const int maxDiagonalLag = static_cast<int>(diagonalSize / 2) - 1;
+  auto diagonalAt = [&](const float* correlation, float lag) {
+    lag = std::clamp(lag, static_cast<float>(-maxDiagonalLag),
+                     static_cast<float>(maxDiagonalLag));
+    const int base = static_cast<int>(std::floor(lag));
+    const float fraction = lag - base;
+    const int n = static_cast<int>(diagonalSize);
+    const float lower = correlation[(base + n) % n];
+    const float upper = correlation[(base + 1 + n) % n];
+    return lower + fraction * (upper - lower);
+  };
+
+  // Horizontal pairs 1-2 and 4-3, vertical pairs 3-2 and 4-1. A source is
+  // as strong as the mean correlation of every pair at its delays, so peaks
+  // of different sources that happen to agree pairwise score low on the
+  // diagonals.
+  const float fs = static_cast<float>(this->sampleFrequency);
+  auto sourceFrom = [&](const size_t idx[NUM_ADJACENT_PAIRS]) {
+    const float lag1_2 = peaks[0][idx[0]].lag;
+    const float lag3_2 = peaks[1][idx[1]].lag;
+    const float lag4_3 = peaks[2][idx[2]].lag;
+    const float lag4_1 = peaks[3][idx[3]].lag;
+
+    DoASource source;
+    source.angle_rad = this->estimateAngle(lag1_2 / fs, lag4_3 / fs,
+                                           lag3_2 / fs, lag4_1 / fs);
+    for (size_t pair = 0; pair < NUM_ADJACENT_PAIRS; pair++) {
+      source.strength += peaks[pair][idx[pair]].strength;
+    }
+    source.strength +=
+        diagonalAt(diagonal1_3, (lag1_2 - lag3_2 + lag4_3 - lag4_1) / 2.0f);
+    source.strength +=
+        diagonalAt(diagonal2_4, -(lag1_2 + lag3_2 + lag4_3 + lag4_1) / 2.0f);
+    source.strength /= NUM_MIC_PAIRS;
+    return source;
+  };
+
+  // Combinations of one peak per pair where the parallel pairs agree on the
+  // delay, strongest first.
+  constexpr size_t MAX_CANDIDATES =
+      DOA_MAX_SOURCES * DOA_MAX_SOURCES * DOA_MAX_SOURCES * DOA_MAX_SOURCES;
+  DoASource candidates[MAX_CANDIDATES];
+  size_t numCandidates = 0;
+  size_t idx[NUM_ADJACENT_PAIRS];
+  for (idx[0] = 0; idx[0] < numPeaks[0]; idx[0]++) {
+    for (idx[2] = 0; idx[2] < numPeaks[2]; idx[2]++) {
+      if (std::fabs(peaks[0][idx[0]].lag - peaks[2][idx[2]].lag) >
+          GCC_SOURCE_LAG_TOLERANCE) {
+        continue;
+      }
+      for (idx[1] = 0; idx[1] < numPeaks[1]; idx[1]++) {
+        for (idx[3] = 0; idx[3] < numPeaks[3]; idx[3]++) {
+          if (std::fabs(peaks[1][idx[1]].lag - peaks[3][idx[3]].lag) <=
+              GCC_SOURCE_LAG_TOLERANCE) {
+            candidates[numCandidates++] = sourceFrom(idx);
+          }
+        }
+      }
+    }
+  }
+  if (numCandidates == 0) {
+    // No consistent combination: fall back to the strongest peak of every
+    // pair, the single source estimate.
+    const size_t strongest[NUM_ADJACENT_PAIRS] = {};
+    candidates[numCandidates++] = sourceFrom(strongest);
+  }
+  std::sort(candidates, candidates + numCandidates,
+            [](const DoASource& a, const DoASource& b) {
+              return a.strength > b.strength;
+            });
 
-    // PhaT: removes magnitude information and keeps only phase. This will tell
-    // the timing offset of certain frequencies and remove any noise/echoes.
-    float magnitude = std::sqrt(real * real + img * img);
-    if (magnitude < FLOAT_EPS) {
-      magnitude = FLOAT_EPS;
+  // Keep strong candidates that are apart from the sources already kept.
+  sources[0] = candidates[0];
+  size_t numSources = 1;
+  for (size_t c = 1; c < numCandidates && numSources < maxSources; c++) {
+    const DoASource& candidate = candidates[c];
+    if (candidate.strength <
+        GCC_SECONDARY_SOURCE_RATIO * sources[0].strength) {
+      break;
+    }
+    bool separated = true;
+    for (size_t s = 0; s < numSources; s++) {
+      const float distance = std::fabs(std::remainder(
+          candidate.angle_rad - sources[s].angle_rad, TWO_PI_32));
+      separated = separated && distance >= GCC_MIN_SOURCE_SEPARATION_rad;
     }
+    if (separated) {
+      sources[numSources++] = candidate;
+    }
+  }
+
+  return numSources;
+}
+
+void GCCPhaT::computeSpectra(float* mic1Data, float* mic2Data,
+                             float* mic3Data, float* mic4Data) {
+  // Compute FT for each input source, two mics per complex transform.
+  // Cross-correlation only needs the complex spectrum.
+  fft.signalPairToFrequency(mic1Data, mic2Data, mic1FreqDomain, mic2FreqDomain,
+                            WindowFunction::HANN_WINDOW, SPECTRUM_COMPLEX);
+  fft.signalPairToFrequency(mic3Data, mic4Data, mic3FreqDomain, mic4FreqDomain,
+                            WindowFunction::HANN_WINDOW, SPECTRUM_COMPLEX);
+}
+
+const FrequencyDomain& GCCPhaT::getMicSpectrum(size_t mic) const {
+  const FrequencyDomain* spectra[NUM_MICS] = {
+      &mic1FreqDomain, &mic2FreqDomain, &mic3FreqDomain, &mic4FreqDomain};
+  return *spectra[std::min(mic, NUM_MICS - 1)];
+}
 
-    // Store in a frequency domain struct to be processed later.
-    this->phatCrossSpectrum.real[i] = real / magnitude;
-    this->phatCrossSpectrum.img[i] = img / magnitude;
-    this->phatCrossSpectrum.magnitude[i] = magnitude;
-    this->phatCrossSpectrum.powerMagnitude[i] = magnitude * magnitude;
+void GCCPhaT::setCrossSpectrumSmoothing(float smoothing) {
+  this->crossSpectrumSmoothing = std::clamp(smoothing, 0.0f, 0.999f);
+  if (this->crossSpectrumSmoothing > 0.0f) {
+    this->crossSpectra.resize(NUM_MIC_PAIRS * 2 * (this->numSamples / 2 + 1));
+  } else {
+    std::vector<float>().swap(this->crossSpectra);
   }
+  this->resetCrossSpectra();
 }
 
-float GCCPhaT::calculateTimeDelay(const float* correlation,
-                                  size_t crossCorrSize, float maxDelay_s) {
-  const int N = static_cast<int>(crossCorrSize);
-  const int maxLagSamples =
-      static_cast<int>(std::ceil(maxDelay_s * sampleFrequency));
-  const int searchRange = std::min(maxLagSamples, N / 2 - 1);
-
-  int bestLag = 0;
-  float bestVal = -std::numeric_limits<float>::infinity();
-
-  // Search for the strongest positive correlation peak within physical limits.
-  // correlation is circularly indexed:
-  // [0 .. +lags] and [N - lags .. N - 1] correspond to +/- physical delays
-  for (int lag = -searchRange; lag <= searchRange; ++lag) {
-    int idx = (lag >= 0) ? lag : (lag + N);
-    float val = correlation[idx];
-
-    if (val > bestVal) {
-      bestVal = val;
-      bestLag = lag;
+void GCCPhaT::resetCrossSpectra() {
+  std::fill(this->crossSpectrumPrimed,
+            this->crossSpectrumPrimed + NUM_MIC_PAIRS, false);
+}
+
+const float* GCCPhaT::updateCrossSpectrum(size_t pair) {
+  const size_t numBins = this->numSamples / 2 + 1;
+  const FrequencyDomain& freqA = this->getMicSpectrum(MIC_PAIRS[pair][0]);
+  const FrequencyDomain& freqB = this->getMicSpectrum(MIC_PAIRS[pair][1]);
+  float* real = &this->crossSpectra[2 * pair * numBins];
+  float* img = real + numBins;
+
+  // The first frame initializes the average.
+  const float keep =
+      this->crossSpectrumPrimed[pair] ? this->crossSpectrumSmoothing : 0.0f;
+  const float update = 1.0f - keep;
+  for (size_t k = 0; k < numBins; k++) {
+    const float crossRe = freqA.real[k] * freqB.real[k] +
+                          freqA.img[k] * freqB.img[k];
+    const float crossIm = freqA.img[k] * freqB.real[k] -
+                          freqA.real[k] * freqB.img[k];
+    real[k] = keep * real[k] + update * crossRe;
+    img[k] = keep * img[k] + update * crossIm;
+  }
+  this->crossSpectrumPrimed[pair] = true;
+
+  return real;
+}
+
+void GCCPhaT::computePairCorrelations(size_t pair, float*& correlation1,
+                                      float*& correlation2,
+                                      size_t& correlationSize) {
+  const size_t numBins = this->numSamples / 2 + 1;
+  const bool smoothed = !this->crossSpectra.empty();
+  const float* cross[2] = {nullptr, nullptr};
+  if (smoothed) {
+    cross[0] = this->updateCrossSpectrum(pair);
+    cross[1] = this->updateCrossSpectrum(pair + 1);
+  }
+
+  if (this->correlationEvaluator == CorrelationEvaluator::PRUNED_LAGS) {
+    float* real = this->phatSpectrum.data();
+    float* img = real + numBins;
+    correlationSize = this->prunedCorrelation.getNumLags();
+    correlation1 = this->lagCorrelation.data();
+    correlation2 = correlation1 + correlationSize;
+
+    float* correlations[2] = {correlation1, correlation2};
+    for (size_t i = 0; i < 2; i++) {
+      if (smoothed) {
+        std::copy(cross[i], cross[i] + 2 * numBins, real);
+        phatWeight(real, img, numBins);
+      } else {
+        phatCrossSpectrum(this->getMicSpectrum(MIC_PAIRS[pair + i][0]),
+                          this->getMicSpectrum(MIC_PAIRS[pair + i][1]), 0,
+                          numBins, real, img);
+      }
+      this->prunedCorrelation.evaluate(real, img, correlations[i]);
     }
+    return;
   }
 
-  return static_cast<float>(bestLag) / static_cast<float>(sampleFrequency);
+  float* z = ifft.getPairInput();
+  if (smoothed) {
+    const int N = static_cast<int>(this->numSamples);
+    float c1[2][PHAT_BLOCK_BINS];
+    float c2[2][PHAT_BLOCK_BINS];
+    for (size_t start = 0; start < numBins; start += PHAT_BLOCK_BINS) {
+      const size_t count = std::min(PHAT_BLOCK_BINS, numBins - start);
+      for (size_t k = 0; k < count; k++) {
+        c1[0][k] = cross[0][start + k];
+        c1[1][k] = cross[0][numBins + start + k];
+        c2[0][k] = cross[1][start + k];
+        c2[1][k] = cross[1][numBins + start + k];
+      }
+      phatWeight(c1[0], c1[1], count);
+      phatWeight(c2[0], c2[1], count);
+      for (size_t k = 0; k < count; k++) {
+        packPairBin(N, static_cast<int>(start + k), c1[0][k], c1[1][k],
+                    c2[0][k], c2[1][k], z);
+      }
+    }
+  } else {
+    computeGccPhatSpectra(
+        this->numSamples, this->getMicSpectrum(MIC_PAIRS[pair][0]),
+        this->getMicSpectrum(MIC_PAIRS[pair][1]),
+        this->getMicSpectrum(MIC_PAIRS[pair + 1][0]),
+        this->getMicSpectrum(MIC_PAIRS[pair + 1][1]), z);
+  }
+  ifft.pairInputToTime(correlation1, correlation2, correlationSize);
 }
 
-float GCCPhaT::estimateAngle(float timeDelayX1, float timeDelayX2,
-                             float timeDelayY1, float timeDelayY2) {
-  // Calculate average time delays on each axis.
-  float avgTimeDelayX_s = (timeDelayX1 + timeDelayX2) / 2.0;
-  float avgTimeDelayY_s = (timeDelayY1 + timeDelayY2) / 2.0;
+void GCCPhaT::estimateInterMicDelays(size_t pair, float& timeDelay1_s,
+                                     float& timeDelay2_s) {
+  size_t crossCorrSize = 0;  // Will be updated by IFFT.
+  float* gccPhatCorrelation1 = nullptr;
+  float* gccPhatCorrelation2 = nullptr;
+  this->computePairCorrelations(pair, gccPhatCorrelation1, gccPhatCorrelation2,
+                                crossCorrSize);
 
-  // Normalize average time by distange betweeen mics (equivalently max time
-  // delay) since microphone array are not in a perfect square.
-  float dx = avgTimeDelayX_s / MAX_DELAY_MIC1_2;
-  float dy = avgTimeDelayY_s / MAX_DELAY_MIC2_3;
+  timeDelay1_s =
+      this->calculateTimeDelay(gccPhatCorrelation1, crossCorrSize,
+                               this->geometryTables.getPairMaxLag(pair));
+  timeDelay2_s =
+      this->calculateTimeDelay(gccPhatCorrelation2, crossCorrSize,
+                               this->geometryTables.getPairMaxLag(pair + 1));
+}
 
-  // Compute angle and transform to correct coordinate system (FR5.3). We get
-  // the below equation since:
-  float angle = std::atan2(dy, dx);
+size_t GCCPhaT::findDelayPeaks(const float* correlation, size_t crossCorrSize,
+                               int maxLag, CorrelationPeak* peaks) const {
+  const int N = static_cast<int>(crossCorrSize);
+  const int searchRange = std::min(maxLag, N / 2 - 1);
+
+  return findTopPeaks(correlation, crossCorrSize, searchRange,
+                      this->peakInterpolation, DOA_MAX_SOURCES, peaks);
+}
 
-  // Rotate pi/2 counterclock wise so that angle of 0 faces towards the front of
-  // the glasses frame.
-  angle -= PI_32 / 2.0;
+void GCCPhaT::computeGccPhatSpectra(size_t numSamples,
+                                    const FrequencyDomain& freqA1,
+                                    const FrequencyDomain& freqB1,
+                                    const FrequencyDomain& freqA2,
+                                    const FrequencyDomain& freqB2, float* z) {
+  // Both cross spectra are real signals in time, so they share one complex
+  // inverse transform. The spectra are written unscaled, so the correlations
+  // only carry the 1 / N of the inverse transform.
+  const int N = static_cast<int>(numSamples);
+  const int lastIdx = N / 2;
 
-  // Convert angle to be in range of 0 and 2pi.
-  angle = normalizeAngleRad(angle);
+  const size_t numBins = static_cast<size_t>(lastIdx) + 1;
+  float c1[2][PHAT_BLOCK_BINS];
+  float c2[2][PHAT_BLOCK_BINS];
+  for (size_t start = 0; start < numBins; start += PHAT_BLOCK_BINS) {
+    const size_t count = std::min(PHAT_BLOCK_BINS, numBins - start);
+    phatCrossSpectrum(freqA1, freqB1, start, count, c1[0], c1[1]);
+    phatCrossSpectrum(freqA2, freqB2, start, count, c2[0], c2[1]);
+    for (size_t k = 0; k < count; k++) {
+      packPairBin(N, static_cast<int>(start + k), c1[0][k], c1[1][k],
+                  c2[0][k], c2[1][k], z);
+    }
+  }
+}
+
+float GCCPhaT::calculateTimeDelay(const float* correlation,
+                                  size_t crossCorrSize, int maxLag) {
+  const int N = static_cast<int>(crossCorrSize);
+  const int searchRange = std::min(maxLag, N / 2 - 1);
+
+  // Search for the strongest positive correlation peak within physical limits
+  // and refine it to a fractional lag.
+  float lag = findPeakLag(correlation, crossCorrSize, searchRange,
+                          this->peakInterpolation);
+
+  return lag / static_cast<float>(sampleFrequency);
+}
+
+float GCCPhaT::estimateAngle(float timeDelayX1, float timeDelayX2,
+                             float timeDelayY1, float timeDelayY2) const {
+  return this->geometryTables.estimateAngle(timeDelayX1, timeDelayX2,
+                                            timeDelayY1, timeDelayY2);
+}
 
-  return angle;
+float GCCPhaT::estimateAngleLeastSquares(
+    const float timeDelays_s[NUM_MIC_PAIRS]) const {
+  return this->geometryTables.estimateAngleLeastSquares(timeDelays_s);
 }
@@ -8,13 +8,64 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include "constants.h"
 #include "doaAlgorithm.h"
 #include "fft.h"
 #include "frequencyDomain.h"
+#include "geometryTables.h"
 #include "ifft.h"
+#include "micGeometry.h"
+#include "peakInterpolation.h"
+#include "prunedCorrelation.h"
+
+/** @brief Number of bins weighted per fastRsqrt block. Bounds the stack
+ * buffers of the PhaT weighting. */
+constexpr inline size_t PHAT_BLOCK_BINS = 64;
+
+/**
+ * @brief Apply the PhaT weighting to a block of cross spectrum bins.
+ *
+ * @param [in,out] real Real components of the cross spectrum.
+ * @param [in,out] img Imaginary components of the cross spectrum.
+ * @param numBins Number of bins.
+ */
+void phatWeight(float* real, float* img, size_t numBins);
+
+/**
+ * @brief Compute a block of bins of the GCC PhaT cross spectrum A * conj(B).
+ *
+ * @param freqA Frequency domain of the first source.
+ * @param freqB Frequency domain of the second source.
+ * @param firstBin First bin of the block.
+ * @param numBins Number of bins.
+ * @param [out] real numBins real components of the weighted cross spectrum.
+ * @param [out] img numBins imaginary components of the weighted cross
+ * spectrum.
+ */
+void phatCrossSpectrum(const FrequencyDomain& freqA,
+                       const FrequencyDomain& freqB, size_t firstBin,
+                       size_t numBins, float* real, float* img);
+
+/** @brief Largest difference (samples) between the delays of two parallel mic
+ * pairs for their peaks to belong to the same source. */
+constexpr inline float GCC_SOURCE_LAG_TOLERANCE = 1.5f;
+
+/** @brief Smallest angle (rad) between two reported sources. */
+constexpr inline float GCC_MIN_SOURCE_SEPARATION_rad = PI_32 / 6.0f;
+
+/** @brief Smallest strength of a secondary source relative to the strongest
+ * one. */
+constexpr inline float GCC_SECONDARY_SOURCE_RATIO = 0.5f;
+
+/** @brief How the direction is solved from the inter-mic time delays. */
+enum class TdoaSolver {
+  PAIR_AVERAGE,   // Average the horizontal and vertical adjacent pairs.
+  LEAST_SQUARES,  // Least-squares fit over every pair, diagonals included.
+};
 
 /** @brief Module to handle GCC-PhaT DOA algo. */
 class GCCPhaT : DoAAlgo {
@@ -25,8 +76,21 @@ class GCCPhaT : DoAAlgo {
    * @param numSamples Number of samples that will be processed from each input
    * source.
    * @param sampleFrequency The sample frequency of the audio inputs (Hz).
+   * @param peakInterpolation Method used to refine correlation peaks to
+   * fractional lags.
+   * @param correlationEvaluator How correlations are evaluated from the GCC
+   * PhaT spectra. AUTO picks the cheaper one from the frame size and lag range,
+   * and the full IFFT when the pruned twiddles exceed
+   * PRUNED_CORRELATION_MAX_BYTES.
+   * @param tdoaSolver How the direction is solved from the time delays.
+   * @param geometry Geometry of the microphone array.
    */
-  GCCPhaT(size_t numSamples, int sampleFrequency = SAMPLE_FREQUENCY);
+  GCCPhaT(size_t numSamples, int sampleFrequency = SAMPLE_FREQUENCY,
+          PeakInterpolation peakInterpolation = PeakInterpolation::PARABOLIC,
+          CorrelationEvaluator correlationEvaluator =
+              CorrelationEvaluator::AUTO,
+          TdoaSolver tdoaSolver = TdoaSolver::PAIR_AVERAGE,
+          const ArrayGeometry& geometry = DEFAULT_ARRAY_GEOMETRY);
 
   /**
    * @brief Calculate the direction of the audio source.
@@ -40,42 +104,72 @@ class GCCPhaT : DoAAlgo {
   float calculateDirection(float* mic1Data, float* mic2Data, float* mic3Data,
                            float* mic4Data) override;
 
- private:
   /**
-   * @brief Compute the time delay between two audio sources.
+   * @brief Calculate the directions of up to DOA_MAX_SOURCES audio sources.
+   * Keeps the strongest peaks of every adjacent mic pair and groups one peak
+   * per pair into a source when the parallel pairs agree on the delay. Each
+   * group is scored with the correlation of every pair, diagonals included,
+   * at the delays it implies, so peaks of different sources that happen to
+   * agree pairwise score low. For a single source the first direction is the
+   * one calculateDirection() returns with the PAIR_AVERAGE solver.
    *
-   * @param freqA Frequency domain of an audio source.
-   * @param freqB Frequency domain of a different audio source.
-   * @param maxDelay_s The maximum physically allowed time delay between the two
-   * audio sources.
-   * @return float The time delay of audio signal in seconds.
+   * @param mic1Data Microphone 1 audio data.
+   * @param mic2Data Microphone 2 audio data.
+   * @param mic3Data Microphone 3 audio data.
+   * @param mic4Data Microphone 4 audio data.
+   * @param [out] sources Sources by decreasing strength.
+   * @param maxSources Capacity of sources, at most DOA_MAX_SOURCES are used.
+   * @return size_t Number of sources found.
    */
-  float estimateInterMicDelay(const FrequencyDomain& freqA,
-                              const FrequencyDomain& freqB, float maxDelay_s);
+  size_t calculateDirections(float* mic1Data, float* mic2Data, float* mic3Data,
+                             float* mic4Data, DoASource* sources,
+                             size_t maxSources);
 
   /**
-   * @brief Compute the GCC PhaT frequency domain.
+   * @brief Compute the frequency domain of every input source. The spectra
+   * stay available through getMicSpectrum() until the next call, so other DoA
+   * algorithms can reuse them.
    *
-   * @param freqA Frequency domain of an audio source.
-   * @param freqB Frequency domain of a different audio source.
+   * @param mic1Data Microphone 1 audio data.
+   * @param mic2Data Microphone 2 audio data.
+   * @param mic3Data Microphone 3 audio data.
+   * @param mic4Data Microphone 4 audio data.
    */
-  void computeGccPhatSpectrum(const FrequencyDomain& freqA,
-                              const FrequencyDomain& freqB);
+  void computeSpectra(float* mic1Data, float* mic2Data, float* mic3Data,
+                      float* mic4Data);
 
   /**
-   * @brief Calculate the time delay from the peaks of the GCC PhaT time domain.
+   * @brief Get the frequency domain of an input source from the last
+   * computeSpectra() or calculateDirection() call. Only the complex spectrum
+   * is populated.
    *
-   * @param correlation The GCC PhaT cross-correlation in time domain.
-   * @param crossCorrSize Number of samples in the cross-correlation array.
-   * @param maxDelay_s The maximum physically allowed time delay between the two
-   * audio sources.
-   * @return float The time delay of audio signal in seconds.
+   * @param mic Index of the microphone, 0 for mic 1.
+   * @return const FrequencyDomain& Frequency domain of the microphone.
    */
-  float calculateTimeDelay(const float* correlation, size_t crossCorrSize,
-                           float maxDelay_s);
+  const FrequencyDomain& getMicSpectrum(size_t mic) const;
 
   /**
-   * @brief Estimate the angle of direction in radian.
+   * @brief Compute the GCC PhaT cross spectra of two pairs of audio sources
+   * and write them straight into the input of a paired inverse FFT.
+   *
+   * @param numSamples Number of samples of the inverse transform.
+   * @param freqA1 Frequency domain of an audio source of the first pair.
+   * @param freqB1 Frequency domain of the other audio source of the first pair.
+   * @param freqA2 Frequency domain of an audio source of the second pair.
+   * @param freqB2 Frequency domain of the other audio source of the second
+   * pair.
+   * @param [out] z Interleaved complex spectrum of numSamples bins. The first
+   * cross spectrum is the real part and the second the imaginary part.
+   */
+  static void computeGccPhatSpectra(size_t numSamples,
+                                    const FrequencyDomain& freqA1,
+                                    const FrequencyDomain& freqB1,
+                                    const FrequencyDomain& freqA2,
+                                    const FrequencyDomain& freqB2, float* z);
+
+  /**
+   * @brief Estimate the angle of direction in radian. Whole-sample delays are
+   * read from the angle table of the array geometry.
    *
    * @param timeDelayX1 Time delay on x axis from 2 audio sources.
    * @param timeDelayX2 Time delay on x axis from 2 different pairs of audio
@@ -86,7 +180,150 @@ class GCCPhaT : DoAAlgo {
    * @return float The angle of the audio source in radians.
    */
   float estimateAngle(float timeDelayX1, float timeDelayX2, float timeDelayY1,
-                      float timeDelayY2);
+                      float timeDelayY2) const;
+
+  /**
+   * @brief Estimate the angle of direction in radian with the least-squares
+   * solution over every mic pair.
+   *
+   * @param timeDelays_s Time delay of each pair of MIC_PAIRS in seconds.
+   * @return float The angle of the audio source in radians.
+   */
+  float estimateAngleLeastSquares(
+      const float timeDelays_s[NUM_MIC_PAIRS]) const;
+
+  /**
+   * @brief Get the correlation evaluator in use.
+   *
+   * @return CorrelationEvaluator FULL_IFFT or PRUNED_LAGS.
+   */
+  CorrelationEvaluator getCorrelationEvaluator() const {
+    return this->correlationEvaluator;
+  }
+
+  /**
+   * @brief Get the lag-domain evaluator, e.g. to share its twiddles with
+   * SRPPhaT. Rebuilt by setArrayGeometry().
+   *
+   * @return const PrunedCorrelation* The evaluator, or nullptr when the full
+   * IFFT is in use.
+   */
+  const PrunedCorrelation* getPrunedCorrelation() const {
+    return (this->correlationEvaluator == CorrelationEvaluator::PRUNED_LAGS)
+               ? &this->prunedCorrelation
+               : nullptr;
+  }
+
+  /**
+   * @brief Get the time delay solver in use.
+   *
+   * @return TdoaSolver The solver.
+   */
+  TdoaSolver getTdoaSolver() const { return this->tdoaSolver; }
+
+  /**
+   * @brief Switch to another microphone array geometry, e.g. the one of the
+   * board found at start-up. Rebuilds the lag ranges and angle table.
+   *
+   * @param geometry Geometry of the microphone array.
+   */
+  void setArrayGeometry(const ArrayGeometry& geometry);
+
+  /**
+   * @brief Get the tables derived from the array geometry.
+   *
+   * @return const GeometryTables& The tables.
+   */
+  const GeometryTables& getGeometryTables() const {
+    return this->geometryTables;
+  }
+
+  /**
+   * @brief Set the smoothing of the cross-power spectra across frames. Each
+   * frame updates S = smoothing * S + (1 - smoothing) * A * conj(B) for every
+   * mic pair and the PhaT weighting is applied to S, so short frames give
+   * stable delays. Keeps 2 * (numSamples / 2 + 1) floats per mic pair.
+   *
+   * @param smoothing Weight of the previous frames in [0, 1). 0 disables
+   * smoothing, frees the spectra and makes every frame independent.
+   */
+  void setCrossSpectrumSmoothing(float smoothing);
+
+  /**
+   * @brief Get the smoothing of the cross-power spectra across frames.
+   *
+   * @return float Weight of the previous frames, 0 when disabled.
+   */
+  float getCrossSpectrumSmoothing() const {
+    return this->crossSpectrumSmoothing;
+  }
+
+  /** @brief Forget the smoothed cross-power spectra. The next frame starts a
+   * new average. */
+  void resetCrossSpectra();
+
+ private:
+  /** @brief Size the correlation evaluator for the lag range of the current
+   * geometry. */
+  void configureLagRange();
+
+  /**
+   * @brief Compute the GCC PhaT correlations of two consecutive pairs of
+   * MIC_PAIRS, with one paired inverse FFT or with the pruned evaluator.
+   *
+   * @param pair Index into MIC_PAIRS of the first pair.
+   * @param [out] correlation1 Circular correlation of the first pair.
+   * @param [out] correlation2 Circular correlation of the second pair.
+   * @param [out] correlationSize Number of samples of each correlation.
+   */
+  void computePairCorrelations(size_t pair, float*& correlation1,
+                               float*& correlation2, size_t& correlationSize);
+
+  /**
+   * @brief Compute the time delays of two consecutive pairs of MIC_PAIRS.
+   *
+   * @param pair Index into MIC_PAIRS of the first pair.
+   * @param [out] timeDelay1_s The time delay of the first pair in seconds.
+   * @param [out] timeDelay2_s The time delay of the second pair in seconds.
+   */
+  void estimateInterMicDelays(size_t pair, float& timeDelay1_s,
+                              float& timeDelay2_s);
+
+  /**
+   * @brief Add the cross-power spectrum of the current frame to the smoothed
+   * cross-power spectrum of a mic pair.
+   *
+   * @param pair Index into MIC_PAIRS.
+   * @return const float* Smoothed spectrum, real components of every bin
+   * followed by the imaginary components.
+   */
+  const float* updateCrossSpectrum(size_t pair);
+
+  /**
+   * @brief Find the strongest correlation peaks of a mic pair within its
+   * physically allowed delay.
+   *
+   * @param correlation The GCC PhaT cross-correlation in time domain.
+   * @param crossCorrSize Number of samples in the cross-correlation array.
+   * @param maxLag The largest physically allowed lag (samples) between the two
+   * audio sources.
+   * @param [out] peaks DOA_MAX_SOURCES peaks with lags in samples.
+   * @return size_t Number of peaks found.
+   */
+  size_t findDelayPeaks(const float* correlation, size_t crossCorrSize,
+                        int maxLag, CorrelationPeak* peaks) const;
+
+  /**
+   * @brief Calculate the time delay from the peaks of the GCC PhaT time domain.
+   *
+   * @param correlation The GCC PhaT cross-correlation in time domain.
+   * @param crossCorrSize Number of samples in the cross-correlation array.
+   * @param maxLag The largest physically allowed lag (samples) between the two
+   * audio sources.
+   * @return float The time delay of audio signal in seconds.
+   */
+  float calculateTimeDelay(const float* correlation, size_t crossCorrSize,
+                           int maxLag);
 
   /** @brief The number of samples of input audio source data. */
   size_t numSamples{0};
@@ -94,8 +331,41 @@ class GCCPhaT : DoAAlgo {
   /** @brief Sampling frequency of the audio inputs (Hz).  */
   int sampleFrequency{SAMPLE_FREQUENCY};
 
-  /** @brief GCC PhaT cross correlation frequency domain. */
-  FrequencyDomain phatCrossSpectrum;
+  /** @brief Method used to refine correlation peaks to fractional lags. */
+  PeakInterpolation peakInterpolation{PeakInterpolation::PARABOLIC};
+
+  /** @brief How correlations are evaluated. Never AUTO once constructed. */
+  CorrelationEvaluator correlationEvaluator{CorrelationEvaluator::FULL_IFFT};
+
+  /** @brief Evaluator asked for at construction, possibly AUTO. */
+  CorrelationEvaluator requestedEvaluator{CorrelationEvaluator::AUTO};
+
+  /** @brief How the direction is solved from the time delays. */
+  TdoaSolver tdoaSolver{TdoaSolver::PAIR_AVERAGE};
+
+  /** @brief Lag ranges, delay normalization and angle table of the array. */
+  GeometryTables geometryTables;
+
+  /** @brief Weight of the previous frames in the cross-power spectra. */
+  float crossSpectrumSmoothing{0.0f};
+
+  /** @brief Smoothed cross-power spectrum of every mic pair, 2 * (numSamples /
+   * 2 + 1) floats each. Empty when smoothing is disabled. */
+  std::vector<float> crossSpectra;
+
+  /** @brief Whether each pair of crossSpectra holds at least one frame. */
+  bool crossSpectrumPrimed[NUM_MIC_PAIRS]{};
+
+  /** @brief Lag-domain evaluator. Only covers lags when it is in use. */
+  PrunedCorrelation prunedCorrelation;
+
+  /** @brief GCC PhaT spectrum of one mic pair for the pruned evaluator: the
+   * real components of every bin followed by the imaginary components. */
+  std::vector<float> phatSpectrum;
+
+  /** @brief GCC PhaT correlations of two mic pairs at the lags of the pruned
+   * evaluator, one after the other. */
+  std::vector<float> lagCorrelation;
 
   /** @brief Fast Fourier Transform (FFT) instance. */
   FFT fft;
@@ -0,0 +1,223 @@
+/**
+ ******************************************************************************
+ * @file    gccPhatQ31.cpp
+ * @brief   Fixed-point Generalized Cross-Correlation with Phase Transform
+ *          (GCC-PhaT) source.
+ ******************************************************************************
+ */
+
+#include "gccPhatQ31.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+#include "logging.hpp"
+#include "window.hpp"
+
+/** @brief Largest q15 value. Magnitude of a unit phasor. */
+constexpr inline int32_t Q15_ONE = 32767;
+
+/** @brief Bins whose larger component is below this value are dropped from
+ * the PhaT spectrum. With fewer than 7 significant bits the phase is mostly
+ * FFT rounding noise, which the PhaT weighting would otherwise amplify to the
+ * same weight as the strong bins. */
+constexpr inline uint32_t Q31_MIN_BIN_MAGNITUDE = 64;
+
+/** @brief Frames are normalized so the peak sample is below 2^30, leaving one
+ * bit of headroom for the window multiplication. */
+constexpr inline int Q31_FRAME_HEADROOM_BITS = 2;
+
+/**
+ * @brief Integer square root.
+ *
+ * @param value Input value.
+ * @return uint32_t floor(sqrt(value)).
+ */
+static uint32_t integerSqrt(uint32_t value) {
+  uint32_t result = 0;
+  uint32_t bit = 1U << 30;
+
+  while (bit > value) {
+    bit >>= 2;
+  }
+
+  while (bit != 0) {
+    if (value >= result + bit) {
+      value -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Reduce a q31 complex value to a q15 unit phasor with the same phase.
+ *
+ * @param real Real component.
+ * @param img Imaginary component.
+ * @param [out] phasor Real and imaginary component of the unit phasor. Zero if
+ * the input is below Q31_MIN_BIN_MAGNITUDE.
+ */
+static void toUnitPhasor(q31_t real, q31_t img, q15_t* phasor) {
+  // Widen before taking the absolute value so INT32_MIN does not overflow.
+  const uint32_t absMax = static_cast<uint32_t>(
+      std::max(std::llabs(real), std::llabs(img)));
+  if (absMax < Q31_MIN_BIN_MAGNITUDE) {
+    phasor[0] = 0;
+    phasor[1] = 0;
+    return;
+  }
+
+  // Keep 15 significant bits of the larger component so the squared magnitude
+  // fits 32 bits.
+  const int shift = (32 - __builtin_clz(absMax)) - 15;
+  const int32_t re = (shift > 0) ? (real >> shift) : (real * (1 << -shift));
+  const int32_t im = (shift > 0) ? (img >> shift) : (img * (1 << -shift));
+
+  // |re| <= magnitude, so the quotient is a q15 value.
+  const int32_t magnitude = static_cast<int32_t>(integerSqrt(
+      static_cast<uint32_t>(re * re) + static_cast<uint32_t>(im * im)));
+  phasor[0] = static_cast<q15_t>((re * Q15_ONE) / magnitude);
+  phasor[1] = static_cast<q15_t>((im * Q15_ONE) / magnitude);
+}
+
+GCCPhaTQ31::GCCPhaTQ31(size_t numSamples, int sampleFrequency,
+                       PeakInterpolation peakInterpolation,
+                       const ArrayGeometry& geometry)
+    : numSamples(numSamples),
+      sampleFrequency(sampleFrequency),
+      peakInterpolation(peakInterpolation),
+      geometryTables(geometry, sampleFrequency),
+      window(numSamples),
+      frame(numSamples),
+      spectrum(2 * numSamples),
+      crossSpectrum(numSamples + 2),
+      correlation(numSamples) {
+  const size_t numBins = numSamples / 2 + 1;
+  for (std::vector<q15_t>& phasors : this->micPhasors) {
+    phasors.resize(2 * numBins);
+  }
+
+  // Hann window in q31. The peak of 1.0 saturates to the largest q31 value.
+  HannWindow<float> hann;
+  for (size_t i = 0; i < numSamples; i++) {
+    const double w =
+        hann.coefficient(i, numSamples) * static_cast<double>(1U << 31);
+    this->window[i] = static_cast<q31_t>(
+        std::min(w, static_cast<double>(std::numeric_limits<q31_t>::max())));
+  }
+
+  arm_status status =
+      arm_rfft_init_q31(&this->rfftInstance, numSamples, 0U, 1U);
+  status = (status == ARM_MATH_SUCCESS)
+               ? arm_rfft_init_q31(&this->rifftInstance, numSamples, 1U, 1U)
+               : status;
+  if (status != arm_status::ARM_MATH_SUCCESS) {
+    ERROR("Error in initializing CMSIS DSP q31 FFT. Error status code %d",
+          status);
+  }
+}
+
+float GCCPhaTQ31::calculateDirection(const q31_t* mic1Data,
+                                     const q31_t* mic2Data,
+                                     const q31_t* mic3Data,
+                                     const q31_t* mic4Data) {
+  // PhaT weighted spectrum of each input source.
+  const q31_t* micData[NUM_MICS] = {mic1Data, mic2Data, mic3Data, mic4Data};
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    this->computePhatSpectrum(micData[mic], this->micPhasors[mic].data());
+  }
+
+  // Same mic pairs as the float GCC-PhaT. Exclude mics that are diagonal from
+  // each other.
+  const q15_t* mic1 = this->micPhasors[0].data();
+  const q15_t* mic2 = this->micPhasors[1].data();
+  const q15_t* mic3 = this->micPhasors[2].data();
+  const q15_t* mic4 = this->micPhasors[3].data();
+  const GeometryTables& tables = this->geometryTables;
+  float timeDelay1_2_s = this->estimateInterMicDelay(
+      mic1, mic2, tables.getPairMaxLag(0));  // Horizontal.
+  float timeDelay3_2_s = this->estimateInterMicDelay(
+      mic3, mic2, tables.getPairMaxLag(1));  // Vertical.
+  float timeDelay4_3_s = this->estimateInterMicDelay(
+      mic4, mic3, tables.getPairMaxLag(2));  // Horizontal.
+  float timeDelay4_1_s = this->estimateInterMicDelay(
+      mic4, mic1, tables.getPairMaxLag(3));  // Vertical.
+
+  return tables.estimateAngle(timeDelay1_2_s, timeDelay4_3_s, timeDelay3_2_s,
+                              timeDelay4_1_s);
+}
+
+size_t GCCPhaTQ31::getMemoryUsage() const {
+  size_t bytes = sizeof(*this);
+  bytes += this->geometryTables.getAngleTableSize() * sizeof(float);
+  bytes += this->window.capacity() * sizeof(q31_t);
+  bytes += this->frame.capacity() * sizeof(q31_t);
+  bytes += this->spectrum.capacity() * sizeof(q31_t);
+  bytes += this->crossSpectrum.capacity() * sizeof(q31_t);
+  bytes += this->correlation.capacity() * sizeof(q31_t);
+  for (const std::vector<q15_t>& phasors : this->micPhasors) {
+    bytes += phasors.capacity() * sizeof(q15_t);
+  }
+  return bytes;
+}
+
+void GCCPhaTQ31::computePhatSpectrum(const q31_t* micData, q15_t* phasors) {
+  // Block floating point: scale the frame so its peak uses the q31 range. The
+  // common scale of a frame does not change its phase.
+  uint32_t peak = 0;
+  for (size_t i = 0; i < this->numSamples; i++) {
+    peak = std::max(peak, static_cast<uint32_t>(std::llabs(micData[i])));
+  }
+
+  const int shift =
+      (peak == 0) ? 0 : __builtin_clz(peak) - Q31_FRAME_HEADROOM_BITS;
+  for (size_t i = 0; i < this->numSamples; i++) {
+    const q31_t sample = (shift >= 0) ? (micData[i] * (1 << shift))
+                                      : (micData[i] >> -shift);
+    this->frame[i] = static_cast<q31_t>(
+        (static_cast<q63_t>(sample) * this->window[i]) >> 31);
+  }
+
+  arm_rfft_q31(&this->rfftInstance, this->frame.data(), this->spectrum.data());
+
+  const size_t numBins = this->numSamples / 2 + 1;
+  for (size_t k = 0; k < numBins; k++) {
+    toUnitPhasor(this->spectrum[2 * k], this->spectrum[2 * k + 1],
+                 &phasors[2 * k]);
+  }
+}
+
+float GCCPhaTQ31::estimateInterMicDelay(const q15_t* phasorsA,
+                                        const q15_t* phasorsB,
+                                        int maxLag) {
+  // GCC: cross correlation of unit phasors is already PhaT weighted. Products
+  // of q15 values are q30 and fit 32 bits.
+  const size_t numBins = this->numSamples / 2 + 1;
+  for (size_t k = 0; k < numBins; k++) {
+    const int32_t aRe = phasorsA[2 * k];
+    const int32_t aIm = phasorsA[2 * k + 1];
+    const int32_t bRe = phasorsB[2 * k];
+    const int32_t bIm = phasorsB[2 * k + 1];
+    this->crossSpectrum[2 * k] = aRe * bRe + aIm * bIm;
+    this->crossSpectrum[2 * k + 1] = aIm * bRe - aRe * bIm;
+  }
+
+  arm_rfft_q31(&this->rifftInstance, this->crossSpectrum.data(),
+               this->correlation.data());
+
+  // Search for the strongest positive correlation peak within physical limits
+  // and refine it to a fractional lag.
+  const int N = static_cast<int>(this->numSamples);
+  const int searchRange = std::min(maxLag, N / 2 - 1);
+  float lag = findPeakLag(this->correlation.data(), this->numSamples,
+                          searchRange, this->peakInterpolation);
+
+  return lag / static_cast<float>(this->sampleFrequency);
+}
@@ -0,0 +1,126 @@
+/**
+ ******************************************************************************
+ * @file    gccPhatQ31.h
+ * @brief   Fixed-point Generalized Cross-Correlation with Phase Transform
+ *          (GCC-PhaT) header.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include "arm_math.h"
+
+#ifdef STM_BUILD
+// stm32f767xx include must be first include to use CMSIS library.
+#include "stm32f767xx.h"
+
+#endif
+#include <cstdint>
+#include <vector>
+
+#include "constants.h"
+#include "geometryTables.h"
+#include "peakInterpolation.h"
+
+/**
+ * @brief Fixed-point GCC-PhaT DOA algo. Works directly on the (shifted) q31
+ * microphone samples so no float conversion or float spectra are needed.
+ *
+ * Each frame is normalized to the full q31 range (block floating point) before
+ * the q31 real FFT. The PhaT weighting is applied per microphone by reducing
+ * every bin to a q15 unit phasor, so the cross spectrum of any pair is a
+ * product of unit phasors and needs no square root or division.
+ */
+class GCCPhaTQ31 {
+ public:
+  /**
+   * @brief Construct a new GCCPhaTQ31 object.
+   *
+   * @param numSamples Number of samples that will be processed from each input
+   * source. Must be a size supported by the CMSIS q31 real FFT.
+   * @param sampleFrequency The sample frequency of the audio inputs (Hz).
+   * @param peakInterpolation Method used to refine correlation peaks to
+   * fractional lags.
+   * @param geometry Geometry of the microphone array.
+   */
+  GCCPhaTQ31(size_t numSamples, int sampleFrequency = SAMPLE_FREQUENCY,
+             PeakInterpolation peakInterpolation = PeakInterpolation::PARABOLIC,
+             const ArrayGeometry& geometry = DEFAULT_ARRAY_GEOMETRY);
+
+  /**
+   * @brief Calculate the direction of the audio source.
+   *
+   * @param mic1Data Microphone 1 audio data.
+   * @param mic2Data Microphone 2 audio data.
+   * @param mic3Data Microphone 3 audio data.
+   * @param mic4Data Microphone 4 audio data.
+   * @return float Angle of audio source in radian.
+   */
+  float calculateDirection(const q31_t* mic1Data, const q31_t* mic2Data,
+                           const q31_t* mic3Data, const q31_t* mic4Data);
+
+  /**
+   * @brief Get the number of bytes of working memory used by this instance.
+   *
+   * @return size_t Working memory in bytes.
+   */
+  size_t getMemoryUsage() const;
+
+ private:
+  /**
+   * @brief Compute the PhaT weighted spectrum (q15 unit phasors) of one mic.
+   *
+   * @param micData Microphone audio data.
+   * @param [out] phasors Interleaved real and imaginary unit phasors of the
+   * numSamples / 2 + 1 bins.
+   */
+  void computePhatSpectrum(const q31_t* micData, q15_t* phasors);
+
+  /**
+   * @brief Compute the time delay between two audio sources.
+   *
+   * @param phasorsA PhaT weighted spectrum of an audio source.
+   * @param phasorsB PhaT weighted spectrum of a different audio source.
+   * @param maxLag The largest physically allowed lag (samples) between the two
+   * audio sources.
+   * @return float The time delay of audio signal in seconds.
+   */
+  float estimateInterMicDelay(const q15_t* phasorsA, const q15_t* phasorsB,
+                              int maxLag);
+
+  /** @brief The number of samples of input audio source data. */
+  size_t numSamples{0};
+
+  /** @brief Sampling frequency of the audio inputs (Hz). */
+  int sampleFrequency{SAMPLE_FREQUENCY};
+
+  /** @brief Method used to refine correlation peaks to fractional lags. */
+  PeakInterpolation peakInterpolation{PeakInterpolation::PARABOLIC};
+
+  /** @brief Lag ranges and angle table of the array geometry. */
+  GeometryTables geometryTables;
+
+  /** @brief q31 Hann window coefficients. */
+  std::vector<q31_t> window;
+
+  /** @brief Windowed input frame. Used as scratch by the FFT. */
+  std::vector<q31_t> frame;
+
+  /** @brief FFT output. The q31 real FFT writes the full complex spectrum. */
+  std::vector<q31_t> spectrum;
+
+  /** @brief PhaT weighted spectra of every microphone. */
+  std::vector<q15_t> micPhasors[NUM_MICS];
+
+  /** @brief GCC PhaT cross spectrum. Input to the inverse FFT. */
+  std::vector<q31_t> crossSpectrum;
+
+  /** @brief GCC PhaT cross correlation in time domain. */
+  std::vector<q31_t> correlation;
+
+  /** @brief Forward real FFT instance for using CMSIS DSP library. */
+  arm_rfft_instance_q31 rfftInstance;
+
+  /** @brief Inverse real FFT instance for using CMSIS DSP library. */
+  arm_rfft_instance_q31 rifftInstance;
+};
@@ -0,0 +1,119 @@
+/**
+ ******************************************************************************
+ * @file    geometryTables.cpp
+ * @brief   Tables derived from the microphone array geometry source.
+ ******************************************************************************
+ */
+
+#include "geometryTables.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "angles.hpp"
+#include "fastmath.h"
+
+/** @brief Horizontal pairs 1-2 and 4-3 and vertical pairs 3-2 and 4-1 in
+ * MIC_PAIRS. */
+static constexpr size_t HORIZONTAL_PAIRS[2] = {0, 2};
+static constexpr size_t VERTICAL_PAIRS[2] = {1, 3};
+
+GeometryTables::GeometryTables(const ArrayGeometry& geometry,
+                               int sampleFrequency)
+    : geometry(geometry),
+      sampleFrequency(sampleFrequency),
+      pseudoInverse(makeTdoaPseudoInverse(geometry)) {
+  for (size_t pair = 0; pair < NUM_MIC_PAIRS; pair++) {
+    this->pairMaxDelay_s[pair] =
+        std::hypot(micPairBaseline(pair, geometry.positionX_m),
+                   micPairBaseline(pair, geometry.positionY_m)) /
+        SOUND_AIR_mps;
+    this->pairMaxLag[pair] = static_cast<int>(
+        std::ceil(this->pairMaxDelay_s[pair] * sampleFrequency));
+    this->maxDelay_s = std::max(this->maxDelay_s, this->pairMaxDelay_s[pair]);
+  }
+
+  // Normalize the mean delay of each axis by its mean spacing, since the
+  // array is not a perfect square. Sums of two lags are twice the mean.
+  const float fs = static_cast<float>(sampleFrequency);
+  const float maxDelayX_s = (this->pairMaxDelay_s[HORIZONTAL_PAIRS[0]] +
+                             this->pairMaxDelay_s[HORIZONTAL_PAIRS[1]]) /
+                            2.0f;
+  const float maxDelayY_s = (this->pairMaxDelay_s[VERTICAL_PAIRS[0]] +
+                             this->pairMaxDelay_s[VERTICAL_PAIRS[1]]) /
+                            2.0f;
+  this->lagScaleX = 1.0f / (2.0f * fs * std::max(maxDelayX_s, FLOAT_EPS));
+  this->lagScaleY = 1.0f / (2.0f * fs * std::max(maxDelayY_s, FLOAT_EPS));
+
+  this->maxLagSumX = this->pairMaxLag[HORIZONTAL_PAIRS[0]] +
+                     this->pairMaxLag[HORIZONTAL_PAIRS[1]];
+  this->maxLagSumY = this->pairMaxLag[VERTICAL_PAIRS[0]] +
+                     this->pairMaxLag[VERTICAL_PAIRS[1]];
+  const int width = 2 * this->maxLagSumX + 1;
+  const int height = 2 * this->maxLagSumY + 1;
+  this->angleTable.resize(static_cast<size_t>(width) * height);
+  for (int sumY = -this->maxLagSumY; sumY <= this->maxLagSumY; sumY++) {
+    for (int sumX = -this->maxLagSumX; sumX <= this->maxLagSumX; sumX++) {
+      this->angleTable[(sumY + this->maxLagSumY) * width + sumX +
+                       this->maxLagSumX] =
+          this->angleFromLagSums(static_cast<float>(sumX),
+                                 static_cast<float>(sumY));
+    }
+  }
+}
+
+float GeometryTables::estimateAngle(float timeDelayX1, float timeDelayX2,
+                                    float timeDelayY1,
+                                    float timeDelayY2) const {
+  const float fs = static_cast<float>(this->sampleFrequency);
+  const float lagSumX = (timeDelayX1 + timeDelayX2) * fs;
+  const float lagSumY = (timeDelayY1 + timeDelayY2) * fs;
+
+  const float roundX = std::round(lagSumX);
+  const float roundY = std::round(lagSumY);
+  if (std::fabs(lagSumX - roundX) <= GEOMETRY_TABLE_LAG_TOLERANCE &&
+      std::fabs(lagSumY - roundY) <= GEOMETRY_TABLE_LAG_TOLERANCE) {
+    return this->estimateAngleFromLags(static_cast<int>(roundX), 0,
+                                       static_cast<int>(roundY), 0);
+  }
+
+  // Fractional lags from peak interpolation.
+  return this->angleFromLagSums(lagSumX, lagSumY);
+}
+
+float GeometryTables::estimateAngleFromLags(int lagX1, int lagX2, int lagY1,
+                                            int lagY2) const {
+  const int sumX = lagX1 + lagX2;
+  const int sumY = lagY1 + lagY2;
+  if (std::abs(sumX) > this->maxLagSumX || std::abs(sumY) > this->maxLagSumY) {
+    return this->angleFromLagSums(static_cast<float>(sumX),
+                                  static_cast<float>(sumY));
+  }
+
+  const int width = 2 * this->maxLagSumX + 1;
+  return this->angleTable[(sumY + this->maxLagSumY) * width + sumX +
+                          this->maxLagSumX];
+}
+
+float GeometryTables::estimateAngleLeastSquares(
+    const float timeDelays_s[NUM_MIC_PAIRS]) const {
+  // Direction vector u = (-sin(angle), cos(angle)) scaled by 1 / c, from the
+  // pseudo-inverse of the pair baselines.
+  float ux = 0.0f;
+  float uy = 0.0f;
+  for (size_t pair = 0; pair < NUM_MIC_PAIRS; pair++) {
+    ux += this->pseudoInverse.x[pair] * timeDelays_s[pair];
+    uy += this->pseudoInverse.y[pair] * timeDelays_s[pair];
+  }
+
+  return normalizeAngleRad(std::atan2(-ux, uy));
+}
+
+float GeometryTables::angleFromLagSums(float lagSumX, float lagSumY) const {
+  const float dx = lagSumX * this->lagScaleX;
+  const float dy = lagSumY * this->lagScaleY;
+
+  // Rotate pi/2 counterclock wise so that angle of 0 faces towards the front
+  // of the glasses frame (FR5.3), then convert to the range of 0 and 2pi.
+  return normalizeAngleRad(fastAtan2(dy, dx) - PI_32 / 2.0f);
+}
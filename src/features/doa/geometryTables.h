@@ -0,0 +1,160 @@
+/**
+ ******************************************************************************
+ * @file    geometryTables.h
+ * @brief   Tables derived from the microphone array geometry at start-up:
+ *          lag search ranges, delay normalization and a lag to angle lookup.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "constants.h"
+#include "micGeometry.h"
+
+/** @brief Largest distance (samples) of a summed lag from an integer for it to
+ * be read from the angle table. */
+constexpr inline float GEOMETRY_TABLE_LAG_TOLERANCE = 1e-3f;
+
+/**
+ * @brief Everything DoA needs from the array geometry, computed once.
+ *
+ * The pair delay limits and the least-squares solution follow the geometry
+ * given at construction, so one binary can serve several frame revisions. The
+ * angle of every pair of integer lag sums on the horizontal and vertical axes
+ * is tabulated, so integer lags cost one lookup. Fractional lags from peak
+ * interpolation fall between the entries and use fastAtan2 instead of atan2.
+ */
+class GeometryTables {
+ public:
+  /**
+   * @brief Construct a new GeometryTables object.
+   *
+   * @param geometry The array geometry.
+   * @param sampleFrequency Sample frequency of the audio inputs (Hz).
+   */
+  GeometryTables(const ArrayGeometry& geometry = DEFAULT_ARRAY_GEOMETRY,
+                 int sampleFrequency = SAMPLE_FREQUENCY);
+
+  /**
+   * @brief Estimate the angle of direction in radian from the delays of the
+   * horizontal pairs 1-2 and 4-3 and the vertical pairs 3-2 and 4-1. Delays
+   * that are whole samples are read from the angle table.
+   *
+   * @param timeDelayX1 Time delay (s) of the first horizontal pair.
+   * @param timeDelayX2 Time delay (s) of the second horizontal pair.
+   * @param timeDelayY1 Time delay (s) of the first vertical pair.
+   * @param timeDelayY2 Time delay (s) of the second vertical pair.
+   * @return float The angle of the audio source in radians.
+   */
+  float estimateAngle(float timeDelayX1, float timeDelayX2, float timeDelayY1,
+                      float timeDelayY2) const;
+
+  /**
+   * @brief Estimate the angle of direction in radian from integer lags of the
+   * horizontal pairs 1-2 and 4-3 and the vertical pairs 3-2 and 4-1.
+   *
+   * @param lagX1 Lag (samples) of the first horizontal pair.
+   * @param lagX2 Lag (samples) of the second horizontal pair.
+   * @param lagY1 Lag (samples) of the first vertical pair.
+   * @param lagY2 Lag (samples) of the second vertical pair.
+   * @return float The angle of the audio source in radians.
+   */
+  float estimateAngleFromLags(int lagX1, int lagX2, int lagY1,
+                              int lagY2) const;
+
+  /**
+   * @brief Estimate the angle of direction in radian with the least-squares
+   * solution over every mic pair.
+   *
+   * @param timeDelays_s Time delay of each pair of MIC_PAIRS in seconds.
+   * @return float The angle of the audio source in radians.
+   */
+  float estimateAngleLeastSquares(
+      const float timeDelays_s[NUM_MIC_PAIRS]) const;
+
+  /**
+   * @brief Get the geometry the tables were built from.
+   *
+   * @return const ArrayGeometry& The geometry.
+   */
+  const ArrayGeometry& getGeometry() const { return this->geometry; }
+
+  /**
+   * @brief Get the maximum physically allowed time delay of a pair.
+   *
+   * @param pair Index into MIC_PAIRS.
+   * @return float Delay in seconds.
+   */
+  float getPairMaxDelay(size_t pair) const {
+    return this->pairMaxDelay_s[pair];
+  }
+
+  /**
+   * @brief Get the lag search range of a pair.
+   *
+   * @param pair Index into MIC_PAIRS.
+   * @return int Largest lag (samples) the pair can physically reach, rounded
+   * up.
+   */
+  int getPairMaxLag(size_t pair) const { return this->pairMaxLag[pair]; }
+
+  /**
+   * @brief Get the largest time delay over every pair.
+   *
+   * @return float Delay in seconds.
+   */
+  float getMaxDelay() const { return this->maxDelay_s; }
+
+  /**
+   * @brief Get the number of entries of the angle table.
+   *
+   * @return size_t Number of angles.
+   */
+  size_t getAngleTableSize() const { return this->angleTable.size(); }
+
+ private:
+  /**
+   * @brief Compute the angle of summed horizontal and vertical lags.
+   *
+   * @param lagSumX Sum of the lags of the horizontal pairs (samples).
+   * @param lagSumY Sum of the lags of the vertical pairs (samples).
+   * @return float The angle of the audio source in radians.
+   */
+  float angleFromLagSums(float lagSumX, float lagSumY) const;
+
+  /** @brief The array geometry. */
+  ArrayGeometry geometry;
+
+  /** @brief Sample frequency of the audio inputs (Hz). */
+  int sampleFrequency;
+
+  /** @brief Maximum physically allowed time delay (s) of each pair. */
+  float pairMaxDelay_s[NUM_MIC_PAIRS]{};
+
+  /** @brief Lag search range (samples) of each pair. */
+  int pairMaxLag[NUM_MIC_PAIRS]{};
+
+  /** @brief Largest time delay (s) over every pair. */
+  float maxDelay_s{0.0f};
+
+  /** @brief Scale from a summed horizontal lag to the normalized delay. */
+  float lagScaleX{0.0f};
+
+  /** @brief Scale from a summed vertical lag to the normalized delay. */
+  float lagScaleY{0.0f};
+
+  /** @brief Largest magnitude of a tabulated horizontal lag sum. */
+  int maxLagSumX{0};
+
+  /** @brief Largest magnitude of a tabulated vertical lag sum. */
+  int maxLagSumY{0};
+
+  /** @brief Least-squares TDOA solution of the geometry. */
+  TdoaPseudoInverse pseudoInverse;
+
+  /** @brief Angle of every integer lag sum pair, row by vertical lag sum. */
+  std::vector<float> angleTable;
+};
@@ -0,0 +1,125 @@
+/**
+ ******************************************************************************
+ * @file    micGeometry.h
+ * @brief   Microphone array geometry descriptor and the least-squares time
+ *          difference of arrival (TDOA) solution derived from it.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "constants.h"
+
+/** @brief Number of distinct microphone pairs. */
+constexpr inline size_t NUM_MIC_PAIRS = NUM_MICS * (NUM_MICS - 1) / 2;
+
+/** @brief Microphones (A, B) of each pair. The adjacent pairs come first, two
+ * at a time so they share paired inverse transforms, then the diagonals. */
+constexpr inline size_t MIC_PAIRS[NUM_MIC_PAIRS][2] = {
+    {0, 1}, {2, 1}, {3, 2}, {3, 0}, {0, 2}, {1, 3}};
+
+/**
+ * @brief Position (m) of each microphone relative to the array centre. Mic 1
+ * is top left, mic 2 is top right, mic 3 is bottom right and mic 4 is bottom
+ * left, with y pointing towards 0 rad.
+ */
+struct ArrayGeometry {
+  float positionX_m[NUM_MICS]{};
+  float positionY_m[NUM_MICS]{};
+};
+
+/**
+ * @brief Describe a rectangular-ish array from the spacing of its adjacent
+ * microphones, centred on the origin.
+ *
+ * @param mic1_2_m Distance between mic 1 and mic 2 (top edge).
+ * @param mic2_3_m Distance between mic 2 and mic 3 (right edge).
+ * @param mic3_4_m Distance between mic 3 and mic 4 (bottom edge).
+ * @param mic4_1_m Distance between mic 4 and mic 1 (left edge).
+ * @return constexpr ArrayGeometry The geometry.
+ */
+constexpr ArrayGeometry makeArrayGeometry(float mic1_2_m, float mic2_3_m,
+                                          float mic3_4_m, float mic4_1_m) {
+  const float halfHeight = (mic2_3_m + mic4_1_m) / 4.0f;
+  return ArrayGeometry{
+      {-mic1_2_m / 2.0f, mic1_2_m / 2.0f, mic3_4_m / 2.0f, -mic3_4_m / 2.0f},
+      {halfHeight, halfHeight, -halfHeight, -halfHeight}};
+}
+
+/** @brief Geometry of the PCB frame. */
+constexpr inline ArrayGeometry PCB_ARRAY_GEOMETRY =
+    makeArrayGeometry(PCB_MIC1_2_DISTANCE_m, PCB_MIC2_3_DISTANCE_m,
+                      PCB_MIC3_4_DISTANCE_m, PCB_MIC4_1_DISTANCE_m);
+
+/** @brief Geometry of the Rev 0 frame. */
+constexpr inline ArrayGeometry REV0_ARRAY_GEOMETRY =
+    makeArrayGeometry(REV0_MIC1_2_DISTANCE_m, REV0_MIC2_3_DISTANCE_m,
+                      REV0_MIC3_4_DISTANCE_m, REV0_MIC4_1_DISTANCE_m);
+
+/** @brief Geometry the DoA modules use unless told otherwise. */
+constexpr inline ArrayGeometry DEFAULT_ARRAY_GEOMETRY =
+    makeArrayGeometry(MIC1_2_DISTANCE_m, MIC2_3_DISTANCE_m, MIC3_4_DISTANCE_m,
+                      MIC4_1_DISTANCE_m);
+
+/** @brief Position (m) of each microphone of the default geometry. */
+constexpr inline const float (&MIC_POSITION_X_m)[NUM_MICS] =
+    DEFAULT_ARRAY_GEOMETRY.positionX_m;
+constexpr inline const float (&MIC_POSITION_Y_m)[NUM_MICS] =
+    DEFAULT_ARRAY_GEOMETRY.positionY_m;
+
+/**
+ * @brief Baseline p_B - p_A (m) of a microphone pair along one axis. A source
+ * in direction u = (-sin(angle), cos(angle)) reaches A later than B by
+ * (p_B - p_A) . u / c.
+ *
+ * @param pair Index into MIC_PAIRS.
+ * @param positions positionX_m or positionY_m of a geometry.
+ * @return constexpr float Baseline component.
+ */
+constexpr float micPairBaseline(size_t pair, const float* positions) {
+  return positions[MIC_PAIRS[pair][1]] - positions[MIC_PAIRS[pair][0]];
+}
+
+/** @brief 2 x NUM_MIC_PAIRS pseudo-inverse of the pair baselines, mapping pair
+ * delays (s) to the direction vector u scaled by 1 / c. */
+struct TdoaPseudoInverse {
+  float x[NUM_MIC_PAIRS]{};
+  float y[NUM_MIC_PAIRS]{};
+};
+
+/**
+ * @brief Compute (G^T G)^-1 G^T for the baseline matrix G with one row per
+ * pair, so that u / c = P d for the delays d of every pair.
+ *
+ * @param geometry The array geometry.
+ * @return constexpr TdoaPseudoInverse The pseudo-inverse.
+ */
+constexpr TdoaPseudoInverse makeTdoaPseudoInverse(
+    const ArrayGeometry& geometry = DEFAULT_ARRAY_GEOMETRY) {
+  float gxx = 0.0f;
+  float gxy = 0.0f;
+  float gyy = 0.0f;
+  for (size_t pair = 0; pair < NUM_MIC_PAIRS; pair++) {
+    const float gx = micPairBaseline(pair, geometry.positionX_m);
+    const float gy = micPairBaseline(pair, geometry.positionY_m);
+    gxx += gx * gx;
+    gxy += gx * gy;
+    gyy += gy * gy;
+  }
+
+  const float det = gxx * gyy - gxy * gxy;
+  TdoaPseudoInverse inverse{};
+  for (size_t pair = 0; pair < NUM_MIC_PAIRS; pair++) {
+    const float gx = micPairBaseline(pair, geometry.positionX_m);
+    const float gy = micPairBaseline(pair, geometry.positionY_m);
+    inverse.x[pair] = (gyy * gx - gxy * gy) / det;
+    inverse.y[pair] = (gxx * gy - gxy * gx) / det;
+  }
+  return inverse;
+}
+
+/** @brief Least-squares TDOA solution of the default geometry. */
+constexpr inline TdoaPseudoInverse TDOA_PSEUDO_INVERSE =
+    makeTdoaPseudoInverse();
@@ -0,0 +1,122 @@
+/**
+ ******************************************************************************
+ * @file    peakInterpolation.cpp
+ * @brief   Sub-sample cross-correlation peak interpolation source.
+ ******************************************************************************
+ */
+
+#include "peakInterpolation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "constants.h"
+
+/**
+ * @brief Vertex of the parabola through three equally spaced samples.
+ *
+ * @param left Sample before the peak.
+ * @param centre Peak sample.
+ * @param right Sample after the peak.
+ * @return float Offset of the vertex from the centre sample. 0 if the samples
+ * do not form a maximum.
+ */
+static float parabolicOffset(float left, float centre, float right) {
+  const float denominator = left - 2.0f * centre + right;
+  if (denominator >= 0.0f) {
+    return 0.0f;
+  }
+
+  return std::clamp(0.5f * (left - right) / denominator, -0.5f, 0.5f);
+}
+
+/**
+ * @brief Vertex of the Gaussian through three equally spaced samples. Falls
+ * back to the parabola when a sample is not positive.
+ *
+ * @param left Sample before the peak.
+ * @param centre Peak sample.
+ * @param right Sample after the peak.
+ * @return float Offset of the vertex from the centre sample.
+ */
+static float gaussianOffset(float left, float centre, float right) {
+  if (left <= 0.0f || centre <= 0.0f || right <= 0.0f) {
+    return parabolicOffset(left, centre, right);
+  }
+
+  return parabolicOffset(std::log(left), std::log(centre), std::log(right));
+}
+
+/**
+ * @brief Evaluate the band-limited (Hann windowed sinc) interpolation of the
+ * taps at a fractional position.
+ *
+ * @param taps 2 * PEAK_UPSAMPLE_HALF_TAPS + 1 samples centred on position 0.
+ * @param t Position relative to the centre tap, in samples.
+ * @return float Interpolated value.
+ */
+static float sincInterpolate(const float* taps, float t) {
+  const float windowHalfWidth = PEAK_UPSAMPLE_HALF_TAPS + 1.0f;
+  // sin(pi * (t - n)) = (-1)^n * sin(pi * t) for integer n.
+  const float sinPiT = std::sin(PI_32 * t);
+
+  float value = 0.0f;
+  for (int n = -PEAK_UPSAMPLE_HALF_TAPS; n <= PEAK_UPSAMPLE_HALF_TAPS; n++) {
+    const float x = t - n;
+    float sinc = 1.0f;
+    if (std::fabs(x) > FLOAT_EPS) {
+      const float sign = (n % 2 == 0) ? 1.0f : -1.0f;
+      sinc = sign * sinPiT / (PI_32 * x);
+    }
+    const float window = 0.5f + 0.5f * std::cos(PI_32 * x / windowHalfWidth);
+    value += taps[n + PEAK_UPSAMPLE_HALF_TAPS] * sinc * window;
+  }
+
+  return value;
+}
+
+/**
+ * @brief Peak of the band-limited interpolation of the taps between the
+ * neighbours of the centre tap.
+ *
+ * @param taps 2 * PEAK_UPSAMPLE_HALF_TAPS + 1 samples centred on the peak.
+ * @return float Offset of the peak from the centre tap.
+ */
+static float upsampledOffset(const float* taps) {
+  constexpr int numPoints = 2 * PEAK_UPSAMPLE_FACTOR + 1;
+  const float step = 1.0f / PEAK_UPSAMPLE_FACTOR;
+
+  float values[numPoints];
+  int best = 0;
+  for (int i = 0; i < numPoints; i++) {
+    values[i] = sincInterpolate(taps, (i - PEAK_UPSAMPLE_FACTOR) * step);
+    if (values[i] > values[best]) {
+      best = i;
+    }
+  }
+
+  // Refine between the upsampled points.
+  float offset = 0.0f;
+  if (best > 0 && best < numPoints - 1) {
+    offset = parabolicOffset(values[best - 1], values[best], values[best + 1]);
+  }
+
+  return (best - PEAK_UPSAMPLE_FACTOR + offset) * step;
+}
+
+float interpolatePeakOffset(const float* taps, PeakInterpolation method) {
+  const float left = taps[PEAK_UPSAMPLE_HALF_TAPS - 1];
+  const float centre = taps[PEAK_UPSAMPLE_HALF_TAPS];
+  const float right = taps[PEAK_UPSAMPLE_HALF_TAPS + 1];
+
+  switch (method) {
+    case PeakInterpolation::PARABOLIC:
+      return parabolicOffset(left, centre, right);
+    case PeakInterpolation::GAUSSIAN:
+      return gaussianOffset(left, centre, right);
+    case PeakInterpolation::UPSAMPLED:
+      return upsampledOffset(taps);
+    default:
+      return 0.0f;
+  }
+}
@@ -0,0 +1,151 @@
+/**
+ ******************************************************************************
+ * @file    peakInterpolation.h
+ * @brief   Sub-sample cross-correlation peak interpolation header.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/** @brief Methods to refine an integer correlation peak to a fractional lag. */
+enum class PeakInterpolation {
+  NONE,       // Integer lag of the largest sample.
+  PARABOLIC,  // Parabola through the peak and its two neighbours.
+  GAUSSIAN,   // Gaussian through the peak and its two neighbours.
+  UPSAMPLED   // Band-limited (windowed sinc) upsampling around the peak.
+};
+
+/** @brief Number of correlation samples on each side of the peak used for
+ * band-limited upsampling. */
+constexpr inline int PEAK_UPSAMPLE_HALF_TAPS = 8;
+
+/** @brief Upsampling factor of band-limited peak interpolation. */
+constexpr inline int PEAK_UPSAMPLE_FACTOR = 8;
+
+/** @brief A correlation peak refined to a fractional lag. */
+struct CorrelationPeak {
+  /** @brief Lag of the peak in (fractional) samples. */
+  float lag{0.0f};
+
+  /** @brief Correlation value at the integer peak. */
+  float strength{0.0f};
+};
+
+/**
+ * @brief Fractional offset of a peak from the centre of a window of
+ * correlation samples.
+ *
+ * @param taps 2 * PEAK_UPSAMPLE_HALF_TAPS + 1 correlation samples centred on
+ * the integer peak.
+ * @param method Interpolation method.
+ * @return float Offset of the peak from the centre tap, in samples. In range
+ * [-1, 1].
+ */
+float interpolatePeakOffset(const float* taps, PeakInterpolation method);
+
+/**
+ * @brief Find the lag of the highest peak of a circular cross-correlation
+ * within the physically allowed range.
+ *
+ * @tparam T Sample type of the correlation (float or fixed-point).
+ * @param correlation Circularly indexed correlation: [0 .. +lags] and
+ * [N - lags .. N - 1] correspond to +/- delays.
+ * @param N Number of samples in the correlation.
+ * @param searchRange Largest absolute lag to search, in samples.
+ * @param method Interpolation method used to refine the integer peak.
+ * @return float Lag of the peak in (fractional) samples.
+ */
+template <typename T>
+float findPeakLag(const T* correlation, size_t N, int searchRange,
+                  PeakInterpolation method) {
+  const int n = static_cast<int>(N);
+  auto at = [&](int lag) { return correlation[((lag % n) + n) % n]; };
+
+  int bestLag = 0;
+  T bestVal = std::numeric_limits<T>::lowest();
+  for (int lag = -searchRange; lag <= searchRange; ++lag) {
+    if (at(lag) > bestVal) {
+      bestVal = at(lag);
+      bestLag = lag;
+    }
+  }
+
+  if (method == PeakInterpolation::NONE) {
+    return static_cast<float>(bestLag);
+  }
+
+  float taps[2 * PEAK_UPSAMPLE_HALF_TAPS + 1];
+  for (int i = -PEAK_UPSAMPLE_HALF_TAPS; i <= PEAK_UPSAMPLE_HALF_TAPS; i++) {
+    taps[i + PEAK_UPSAMPLE_HALF_TAPS] = static_cast<float>(at(bestLag + i));
+  }
+
+  return static_cast<float>(bestLag) + interpolatePeakOffset(taps, method);
+}
+
+/**
+ * @brief Find the lags of the highest local maxima of a circular
+ * cross-correlation within the physically allowed range. Samples just outside
+ * the range do not count as neighbours, so the first peak is always the one
+ * findPeakLag() returns.
+ *
+ * @tparam T Sample type of the correlation (float or fixed-point).
+ * @param correlation Circularly indexed correlation: [0 .. +lags] and
+ * [N - lags .. N - 1] correspond to +/- delays.
+ * @param N Number of samples in the correlation.
+ * @param searchRange Largest absolute lag to search, in samples.
+ * @param method Interpolation method used to refine the integer peaks.
+ * @param maxPeaks Capacity of peaks.
+ * @param [out] peaks Peaks by decreasing strength.
+ * @return size_t Number of peaks found, at most maxPeaks.
+ */
+template <typename T>
+size_t findTopPeaks(const T* correlation, size_t N, int searchRange,
+                    PeakInterpolation method, size_t maxPeaks,
+                    CorrelationPeak* peaks) {
+  const int n = static_cast<int>(N);
+  auto at = [&](int lag) { return correlation[((lag % n) + n) % n]; };
+
+  // Insertion into a sorted list of at most maxPeaks integer peaks. Ties keep
+  // the lowest lag first, as in findPeakLag().
+  size_t numPeaks = 0;
+  for (int lag = -searchRange; lag <= searchRange; ++lag) {
+    const T value = at(lag);
+    if ((lag > -searchRange && at(lag - 1) >= value) ||
+        (lag < searchRange && at(lag + 1) > value)) {
+      continue;
+    }
+
+    size_t slot = numPeaks;
+    while (slot > 0 && static_cast<float>(value) > peaks[slot - 1].strength) {
+      slot--;
+    }
+    if (slot >= maxPeaks) {
+      continue;
+    }
+    for (size_t i = std::min(numPeaks, maxPeaks - 1); i > slot; i--) {
+      peaks[i] = peaks[i - 1];
+    }
+    peaks[slot] = {static_cast<float>(lag), static_cast<float>(value)};
+    numPeaks = std::min(numPeaks + 1, maxPeaks);
+  }
+
+  if (method == PeakInterpolation::NONE) {
+    return numPeaks;
+  }
+
+  float taps[2 * PEAK_UPSAMPLE_HALF_TAPS + 1];
+  for (size_t peak = 0; peak < numPeaks; peak++) {
+    const int peakLag = static_cast<int>(peaks[peak].lag);
+    for (int i = -PEAK_UPSAMPLE_HALF_TAPS; i <= PEAK_UPSAMPLE_HALF_TAPS; i++) {
+      taps[i + PEAK_UPSAMPLE_HALF_TAPS] = static_cast<float>(at(peakLag + i));
+    }
+    peaks[peak].lag += interpolatePeakOffset(taps, method);
+  }
+
+  return numPeaks;
+}
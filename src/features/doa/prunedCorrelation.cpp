@@ -0,0 +1,85 @@
+/**
+ ******************************************************************************
+ * @file    prunedCorrelation.cpp
+ * @brief   Lag-domain cross-correlation evaluator source.
+ ******************************************************************************
+ */
+
+#include "prunedCorrelation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "constants.h"
+
+float prunedCorrelationCost(size_t numSamples, int maxLag) {
+  // One dot product for lag 0 and two for every other lag, each a multiply
+  // and an add per bin.
+  const float numBins = numSamples / 2 + 1;
+  return 2.0f * (2 * maxLag + 1) * numBins;
+}
+
+float fullCorrelationCost(size_t numSamples) {
+  // 5 N log2(N) flops of a complex radix-2 FFT, shared by two correlations,
+  // plus packing the spectrum and de-interleaving the output.
+  const float N = static_cast<float>(numSamples);
+  return 2.5f * N * std::log2(N) + 2.0f * N;
+}
+
+size_t prunedCorrelationMemory(size_t numSamples, int maxLag) {
+  // A cosine row for every lag from 0 and a sine row for every lag from 1.
+  return (2 * maxLag + 1) * (numSamples / 2 + 1) * sizeof(float32_t);
+}
+
+CorrelationEvaluator chooseCorrelationEvaluator(size_t numSamples, int maxLag,
+                                                float fftFlopWeight,
+                                                size_t maxTableBytes) {
+  if (prunedCorrelationMemory(numSamples, maxLag) > maxTableBytes) {
+    return CorrelationEvaluator::FULL_IFFT;
+  }
+  return (prunedCorrelationCost(numSamples, maxLag) <
+          fftFlopWeight * fullCorrelationCost(numSamples))
+             ? CorrelationEvaluator::PRUNED_LAGS
+             : CorrelationEvaluator::FULL_IFFT;
+}
+
+PrunedCorrelation::PrunedCorrelation(size_t numSamples, int maxLag)
+    : numBins(numSamples / 2 + 1),
+      maxLag(std::clamp(maxLag, 0, static_cast<int>(numSamples / 2) - 1)),
+      cosRows((this->maxLag + 1) * this->numBins),
+      sinRows(this->maxLag * this->numBins) {
+  const double N = static_cast<double>(numSamples);
+  for (int lag = 0; lag <= this->maxLag; lag++) {
+    float32_t* cosRow = &this->cosRows[lag * this->numBins];
+    float32_t* sinRow =
+        (lag > 0) ? &this->sinRows[(lag - 1) * this->numBins] : nullptr;
+
+    for (size_t k = 0; k < this->numBins; k++) {
+      // Bins other than DC and Nyquist stand for their conjugate as well.
+      const double weight = (k == 0 || k == this->numBins - 1) ? 1.0 : 2.0;
+      // Reduce k * lag modulo N first to keep the phase exact.
+      const double phase = 2.0 * PI_64 * ((k * lag) % numSamples) / N;
+      cosRow[k] = static_cast<float32_t>(weight / N * std::cos(phase));
+      if (sinRow != nullptr) {
+        sinRow[k] = static_cast<float32_t>(weight / N * std::sin(phase));
+      }
+    }
+  }
+}
+
+void PrunedCorrelation::evaluate(const float* real, const float* img,
+                                 float* correlation) const {
+  const size_t numLags = this->getNumLags();
+
+  arm_dot_prod_f32(real, this->cosRows.data(), this->numBins, &correlation[0]);
+  for (int lag = 1; lag <= this->maxLag; lag++) {
+    float32_t even = 0.0f;
+    float32_t odd = 0.0f;
+    arm_dot_prod_f32(real, &this->cosRows[lag * this->numBins], this->numBins,
+                     &even);
+    arm_dot_prod_f32(img, &this->sinRows[(lag - 1) * this->numBins],
+                     this->numBins, &odd);
+    correlation[lag] = even - odd;
+    correlation[numLags - lag] = even + odd;
+  }
+}
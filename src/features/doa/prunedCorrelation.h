@@ -0,0 +1,150 @@
+/**
+ ******************************************************************************
+ * @file    prunedCorrelation.h
+ * @brief   Lag-domain cross-correlation evaluator header. Computes a
+ *          correlation only at the lags that are physically possible.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include "arm_math.h"
+
+#ifdef STM_BUILD
+// stm32f767xx include must be first include to use CMSIS library.
+#include "stm32f767xx.h"
+
+#endif
+#include <cstddef>
+#include <vector>
+
+/** @brief How the GCC PhaT correlation is evaluated from its spectrum. */
+enum class CorrelationEvaluator {
+  AUTO,         // Cheaper of the two within the twiddle memory budget.
+  FULL_IFFT,    // Inverse FFT of the whole spectrum.
+  PRUNED_LAGS,  // Direct evaluation at the searched lags only.
+};
+
+/** @brief Cost of one flop of the inverse FFT relative to one flop of the
+ * pruned dot products. The FFT strides through memory and reorders its
+ * output, while the dot products stream through contiguous rows. Measured by
+ * PrunedCorrelationTest.CrossoverReport, where the pruned evaluator wins up to
+ * about +-32 lags at every frame size from 256 to 4096. */
+constexpr inline float CORRELATION_FFT_FLOP_WEIGHT = 2.0f;
+
+/** @brief Largest twiddle table (bytes) AUTO accepts for the pruned evaluator.
+ * The table grows with both the frame size and the lag range, e.g. 86 KB for
+ * +-10 lags at 2048 samples, which the 512 KB of SRAM of the target cannot
+ * spare next to the audio buffers. Allows +-3 lags at 2048 samples and +-15
+ * at 512. */
+constexpr inline size_t PRUNED_CORRELATION_MAX_BYTES = 32 * 1024;
+
+/**
+ * @brief Estimated cost (flops) of one correlation from the pruned evaluator.
+ *
+ * @param numSamples Number of samples of the transform.
+ * @param maxLag Largest absolute lag evaluated.
+ * @return float Estimated flops.
+ */
+float prunedCorrelationCost(size_t numSamples, int maxLag);
+
+/**
+ * @brief Estimated cost (flops) of one correlation from the paired inverse FFT,
+ * which transforms two correlations at once.
+ *
+ * @param numSamples Number of samples of the transform.
+ * @return float Estimated flops.
+ */
+float fullCorrelationCost(size_t numSamples);
+
+/**
+ * @brief Twiddle memory (bytes) of the pruned evaluator.
+ *
+ * @param numSamples Number of samples of the transform.
+ * @param maxLag Largest absolute lag evaluated.
+ * @return size_t Bytes of cosine and sine rows.
+ */
+size_t prunedCorrelationMemory(size_t numSamples, int maxLag);
+
+/**
+ * @brief Choose the correlation evaluator with the lower estimated cost, among
+ * those whose tables fit the memory budget.
+ *
+ * @param numSamples Number of samples of the transform.
+ * @param maxLag Largest absolute lag that must be evaluated.
+ * @param fftFlopWeight Cost of an inverse FFT flop relative to a pruned one,
+ * to recalibrate the choice for another FFT backend.
+ * @param maxTableBytes Largest twiddle table of the pruned evaluator.
+ * @return CorrelationEvaluator FULL_IFFT or PRUNED_LAGS.
+ */
+CorrelationEvaluator chooseCorrelationEvaluator(
+    size_t numSamples, int maxLag,
+    float fftFlopWeight = CORRELATION_FFT_FLOP_WEIGHT,
+    size_t maxTableBytes = PRUNED_CORRELATION_MAX_BYTES);
+
+/**
+ * @brief Evaluates the inverse DFT of a real signal's spectrum at the lags
+ * -maxLag .. maxLag only.
+ *
+ * For a real correlation r with spectrum C,
+ * r[+-l] = 1/N * sum_k w_k * (Re C[k] * cos(2 pi k l / N)
+ *                             -+ Im C[k] * sin(2 pi k l / N)),
+ * where w_k is 1 for the DC and Nyquist bins and 2 otherwise. The weighted
+ * cosine and sine rows of every lag are precomputed, so each lag is two dot
+ * products over the numSamples / 2 + 1 bins and serves both signs.
+ */
+class PrunedCorrelation {
+ public:
+  /**
+   * @brief Construct a new PrunedCorrelation object.
+   *
+   * @param numSamples Number of samples of the correlation (inverse transform
+   * size).
+   * @param maxLag Largest absolute lag to evaluate. Clamped to
+   * numSamples / 2 - 1.
+   */
+  PrunedCorrelation(size_t numSamples, int maxLag);
+
+  /**
+   * @brief Evaluate the correlation at the lags -maxLag .. maxLag.
+   *
+   * @param real Real components of the numSamples / 2 + 1 bins.
+   * @param img Imaginary components of the numSamples / 2 + 1 bins.
+   * @param [out] correlation Circularly indexed correlation of getNumLags()
+   * samples: [0 .. maxLag] and [numLags - maxLag .. numLags - 1] are the
+   * positive and negative lags.
+   */
+  void evaluate(const float* real, const float* img, float* correlation) const;
+
+  /**
+   * @brief Get the number of evaluated lags.
+   *
+   * @return size_t 2 * maxLag + 1.
+   */
+  size_t getNumLags() const { return 2 * this->maxLag + 1; }
+
+  /**
+   * @brief Get the number of bytes of twiddle rows.
+   *
+   * @return size_t Twiddle memory in bytes.
+   */
+  size_t getMemoryUsage() const {
+    return (this->cosRows.capacity() + this->sinRows.capacity()) *
+           sizeof(float32_t);
+  }
+
+ private:
+  /** @brief Number of bins of the spectrum. */
+  size_t numBins{0};
+
+  /** @brief Largest absolute lag evaluated. */
+  int maxLag{0};
+
+  /** @brief w_k / N * cos(2 pi k l / N) of the lags 0 .. maxLag, one row of
+   * numBins per lag. */
+  std::vector<float32_t> cosRows;
+
+  /** @brief w_k / N * sin(2 pi k l / N) of the lags 1 .. maxLag, one row of
+   * numBins per lag. */
+  std::vector<float32_t> sinRows;
+};
@@ -0,0 +1,204 @@
+/**
+ ******************************************************************************
+ * @file    srpPhat.cpp
+ * @brief   Steered Response Power with Phase Transform (SRP-PhaT) source.
+ ******************************************************************************
+ */
+
+#include "srpPhat.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "angles.hpp"
+
+SRPPhaT::SRPPhaT(size_t numSamples, int sampleFrequency,
+                 const ArrayGeometry& geometry,
+                 const PrunedCorrelation* sharedCorrelation)
+    : numSamples(numSamples),
+      numLags(1),
+      correlationEvaluator(CorrelationEvaluator::FULL_IFFT),
+      lagIndex(SRP_NUM_ANGLES * NUM_MIC_PAIRS),
+      lagFraction(SRP_NUM_ANGLES * NUM_MIC_PAIRS),
+      prunedCorrelation(numSamples, 0),
+      sharedCorrelation(nullptr),
+      ifft(numSamples),
+      sampleFrequency(sampleFrequency),
+      geometry(geometry) {
+  // Longest pair delay, with one extra lag to interpolate past it.
+  double maxDelay = 0.0;
+  for (size_t pair = 0; pair < NUM_MIC_PAIRS; pair++) {
+    const double distance =
+        std::hypot(micPairBaseline(pair, geometry.positionX_m),
+                   micPairBaseline(pair, geometry.positionY_m));
+    maxDelay = std::max(maxDelay, distance / SOUND_AIR_mps * sampleFrequency);
+  }
+  const int maxLag = std::min(static_cast<int>(std::ceil(maxDelay)) + 1,
+                              static_cast<int>(numSamples / 2) - 1);
+  this->numLags = 2 * maxLag + 1;
+
+  if (sharedCorrelation != nullptr &&
+      sharedCorrelation->getNumLags() >= this->numLags) {
+    // Steer over every lag of the shared evaluator rather than keep a second
+    // table of twiddles.
+    this->sharedCorrelation = sharedCorrelation;
+    this->numLags = sharedCorrelation->getNumLags();
+    this->correlationEvaluator = CorrelationEvaluator::PRUNED_LAGS;
+  } else {
+    this->correlationEvaluator =
+        chooseCorrelationEvaluator(numSamples, maxLag);
+    if (this->correlationEvaluator == CorrelationEvaluator::PRUNED_LAGS) {
+      this->prunedCorrelation = PrunedCorrelation(numSamples, maxLag);
+    }
+  }
+  if (this->correlationEvaluator == CorrelationEvaluator::PRUNED_LAGS) {
+    this->phatSpectrum.resize(2 * (numSamples / 2 + 1));
+  }
+  this->pairCorrelations.resize(NUM_MIC_PAIRS * this->numLags);
+
+  // Steering table. Pair (A, B) correlates at lag (p_B - p_A) . u * fs / c for
+  // a source in direction u = (-sin(angle), cos(angle)).
+  for (size_t angleIdx = 0; angleIdx < SRP_NUM_ANGLES; angleIdx++) {
+    const double angle = 2.0 * PI_64 * angleIdx / SRP_NUM_ANGLES;
+    const double ux = -std::sin(angle);
+    const double uy = std::cos(angle);
+
+    for (size_t pair = 0; pair < NUM_MIC_PAIRS; pair++) {
+      const double lag = (micPairBaseline(pair, geometry.positionX_m) * ux +
+                          micPairBaseline(pair, geometry.positionY_m) * uy) *
+                         sampleFrequency / SOUND_AIR_mps;
+      const double base = std::floor(lag);
+
+      const size_t entry = angleIdx * NUM_MIC_PAIRS + pair;
+      this->lagIndex[entry] = static_cast<uint16_t>(
+          (static_cast<int>(base) + this->numLags) % this->numLags);
+      this->lagFraction[entry] = static_cast<float>(lag - base);
+    }
+  }
+}
+
+float SRPPhaT::calculateDirection(float* mic1Data, float* mic2Data,
+                                  float* mic3Data, float* mic4Data) {
+  if (!this->spectrumSource) {
+    this->spectrumSource = std::make_unique<GCCPhaT>(
+        this->numSamples, this->sampleFrequency, PeakInterpolation::PARABOLIC,
+        CorrelationEvaluator::FULL_IFFT, TdoaSolver::PAIR_AVERAGE,
+        this->geometry);
+  }
+  this->spectrumSource->computeSpectra(mic1Data, mic2Data, mic3Data, mic4Data);
+
+  return this->calculateDirection(this->spectrumSource->getMicSpectrum(0),
+                                  this->spectrumSource->getMicSpectrum(1),
+                                  this->spectrumSource->getMicSpectrum(2),
+                                  this->spectrumSource->getMicSpectrum(3));
+}
+
+float SRPPhaT::calculateDirection(const FrequencyDomain& mic1Freq,
+                                  const FrequencyDomain& mic2Freq,
+                                  const FrequencyDomain& mic3Freq,
+                                  const FrequencyDomain& mic4Freq) {
+  const FrequencyDomain* spectra[NUM_MICS] = {&mic1Freq, &mic2Freq, &mic3Freq,
+                                              &mic4Freq};
+  this->computePairCorrelations(spectra);
+
+  return this->searchDirection();
+}
+
+void SRPPhaT::computePairCorrelations(
+    const FrequencyDomain* spectra[NUM_MICS]) {
+  if (this->correlationEvaluator == CorrelationEvaluator::PRUNED_LAGS) {
+    const size_t numBins = this->numSamples / 2 + 1;
+    float* real = this->phatSpectrum.data();
+    float* img = real + numBins;
+    const PrunedCorrelation& evaluator =
+        (this->sharedCorrelation != nullptr) ? *this->sharedCorrelation
+                                             : this->prunedCorrelation;
+
+    for (size_t pair = 0; pair < NUM_MIC_PAIRS; pair++) {
+      phatCrossSpectrum(*spectra[MIC_PAIRS[pair][0]],
+                        *spectra[MIC_PAIRS[pair][1]], 0, numBins, real, img);
+      evaluator.evaluate(real, img,
+                         &this->pairCorrelations[pair * this->numLags]);
+    }
+    return;
+  }
+
+  // Two pairs per paired inverse FFT, keeping only the steered lags.
+  const int maxLag = static_cast<int>(this->numLags / 2);
+  for (size_t pair = 0; pair < NUM_MIC_PAIRS; pair += 2) {
+    GCCPhaT::computeGccPhatSpectra(
+        this->numSamples, *spectra[MIC_PAIRS[pair][0]],
+        *spectra[MIC_PAIRS[pair][1]], *spectra[MIC_PAIRS[pair + 1][0]],
+        *spectra[MIC_PAIRS[pair + 1][1]], this->ifft.getPairInput());
+
+    float* correlationA = nullptr;
+    float* correlationB = nullptr;
+    size_t correlationSize = 0;
+    this->ifft.pairInputToTime(correlationA, correlationB, correlationSize);
+
+    float* compactA = &this->pairCorrelations[pair * this->numLags];
+    float* compactB = compactA + this->numLags;
+    for (int lag = -maxLag; lag <= maxLag; lag++) {
+      const size_t full = (lag + correlationSize) % correlationSize;
+      const size_t compact = (lag + this->numLags) % this->numLags;
+      compactA[compact] = correlationA[full];
+      compactB[compact] = correlationB[full];
+    }
+  }
+}
+
+float SRPPhaT::steeredPower(size_t angleIdx) const {
+  const uint16_t* index = &this->lagIndex[angleIdx * NUM_MIC_PAIRS];
+  const float* fraction = &this->lagFraction[angleIdx * NUM_MIC_PAIRS];
+
+  float power = 0.0f;
+  for (size_t pair = 0; pair < NUM_MIC_PAIRS; pair++) {
+    const float* correlation = &this->pairCorrelations[pair * this->numLags];
+    const size_t lag = index[pair];
+    const size_t next = (lag + 1 == this->numLags) ? 0 : lag + 1;
+    const float lower = correlation[lag];
+    power += lower + fraction[pair] * (correlation[next] - lower);
+  }
+
+  return power;
+}
+
+float SRPPhaT::searchDirection() const {
+  // Coarse search over every SRP_COARSE_STEP direction.
+  size_t bestIdx = 0;
+  float bestPower = -FLOAT_MAX;
+  for (size_t angleIdx = 0; angleIdx < SRP_NUM_ANGLES;
+       angleIdx += SRP_COARSE_STEP) {
+    const float power = this->steeredPower(angleIdx);
+    if (power > bestPower) {
+      bestPower = power;
+      bestIdx = angleIdx;
+    }
+  }
+
+  // Fine search between the neighbouring coarse directions.
+  const size_t coarseIdx = bestIdx;
+  for (size_t offset = 1; offset < SRP_COARSE_STEP; offset++) {
+    for (size_t angleIdx :
+         {(coarseIdx + offset) % SRP_NUM_ANGLES,
+          (coarseIdx + SRP_NUM_ANGLES - offset) % SRP_NUM_ANGLES}) {
+      const float power = this->steeredPower(angleIdx);
+      if (power > bestPower) {
+        bestPower = power;
+        bestIdx = angleIdx;
+      }
+    }
+  }
+
+  // Parabolic refinement between the fine directions.
+  const float left =
+      this->steeredPower((bestIdx + SRP_NUM_ANGLES - 1) % SRP_NUM_ANGLES);
+  const float right = this->steeredPower((bestIdx + 1) % SRP_NUM_ANGLES);
+  const float curvature = left - 2.0f * bestPower + right;
+  float offset = 0.0f;
+  if (curvature < 0.0f) {
+    offset = std::clamp(0.5f * (left - right) / curvature, -0.5f, 0.5f);
+  }
+
+  return normalizeAngleRad(TWO_PI_32 * (bestIdx + offset) / SRP_NUM_ANGLES);
+}
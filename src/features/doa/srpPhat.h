@@ -0,0 +1,176 @@
+/**
+ ******************************************************************************
+ * @file    srpPhat.h
+ * @brief   Steered Response Power with Phase Transform (SRP-PhaT) header.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "constants.h"
+#include "doaAlgorithm.h"
+#include "frequencyDomain.h"
+#include "gccPhat.h"
+#include "ifft.h"
+#include "micGeometry.h"
+#include "prunedCorrelation.h"
+
+/** @brief Number of steering directions, one per degree. */
+constexpr inline size_t SRP_NUM_ANGLES = 360;
+
+/** @brief Steering directions between two directions of the coarse search. */
+constexpr inline size_t SRP_COARSE_STEP = 10;
+
+/**
+ * @brief Module to handle SRP-PhaT DOA algo.
+ *
+ * Steers the array over a grid of directions and sums the GCC PhaT correlation
+ * of every microphone pair at the delay each direction implies. The delays are
+ * tabulated at construction from the microphone geometry, so a frame only
+ * costs the pair correlations and table lookups. The grid is searched every
+ * SRP_COARSE_STEP directions first, then at full resolution around the best
+ * coarse direction.
+ */
+class SRPPhaT : public DoAAlgo {
+ public:
+  /**
+   * @brief Construct a new SRPPhaT object.
+   *
+   * @param numSamples Number of samples from each source that needs to be
+   * processed.
+   * @param sampleFrequency Sample frequency of the sources (Hz).
+   * @param geometry Geometry of the microphone array.
+   * @param sharedCorrelation Lag-domain evaluator of the spectrum source, e.g.
+   * GCCPhaT::getPrunedCorrelation(), or nullptr. Used instead of a table of
+   * this object when it covers the steered lags. Must outlive this object.
+   */
+  SRPPhaT(size_t numSamples, int sampleFrequency = SAMPLE_FREQUENCY,
+          const ArrayGeometry& geometry = DEFAULT_ARRAY_GEOMETRY,
+          const PrunedCorrelation* sharedCorrelation = nullptr);
+
+  /**
+   * @brief Calculate the direction (angle in radians) of audio source.
+   *
+   * @param mic1Data Audio data stream from microphone 1.
+   * @param mic2Data Audio data stream from microphone 2.
+   * @param mic3Data Audio data stream from microphone 3.
+   * @param mic4Data Audio data stream from microphone 4.
+   * @return float Direction of audio source in radians.
+   */
+  float calculateDirection(float* mic1Data, float* mic2Data, float* mic3Data,
+                           float* mic4Data) override;
+
+  /**
+   * @brief Calculate the direction (angle in radians) of audio source from
+   * spectra computed elsewhere, e.g. by GCCPhaT::computeSpectra().
+   *
+   * @param mic1Freq Frequency domain of microphone 1.
+   * @param mic2Freq Frequency domain of microphone 2.
+   * @param mic3Freq Frequency domain of microphone 3.
+   * @param mic4Freq Frequency domain of microphone 4.
+   * @return float Direction of audio source in radians.
+   */
+  float calculateDirection(const FrequencyDomain& mic1Freq,
+                           const FrequencyDomain& mic2Freq,
+                           const FrequencyDomain& mic3Freq,
+                           const FrequencyDomain& mic4Freq);
+
+  /**
+   * @brief Get the correlation evaluator in use.
+   *
+   * @return CorrelationEvaluator Never AUTO.
+   */
+  CorrelationEvaluator getCorrelationEvaluator() const {
+    return this->correlationEvaluator;
+  }
+
+  /**
+   * @brief Get the number of lags evaluated per microphone pair.
+   *
+   * @return size_t Number of lags, centred on lag 0.
+   */
+  size_t getNumLags() const { return this->numLags; }
+
+  /**
+   * @brief Whether the pair correlations use the evaluator of the spectrum
+   * source.
+   *
+   * @return true if the lag-domain twiddles are shared.
+   */
+  bool isCorrelationShared() const {
+    return this->sharedCorrelation != nullptr;
+  }
+
+ private:
+  /**
+   * @brief Compute the GCC PhaT correlation of every microphone pair at the
+   * lags the steering table refers to.
+   *
+   * @param spectra Frequency domain of each microphone.
+   */
+  void computePairCorrelations(const FrequencyDomain* spectra[NUM_MICS]);
+
+  /**
+   * @brief Sum the pair correlations at the delays of a steering direction.
+   *
+   * @param angleIdx Index of the steering direction.
+   * @return float Steered response power.
+   */
+  float steeredPower(size_t angleIdx) const;
+
+  /**
+   * @brief Search the steering grid for the direction of highest power.
+   *
+   * @return float Direction of audio source in radians.
+   */
+  float searchDirection() const;
+
+  /** @brief The number of samples to process for each incoming source. */
+  size_t numSamples;
+
+  /** @brief Number of lags evaluated per microphone pair, centred on lag 0 and
+   * stored circularly: lag l at index (l + numLags) % numLags. */
+  size_t numLags;
+
+  /** @brief How the pair correlations are evaluated. */
+  CorrelationEvaluator correlationEvaluator;
+
+  /** @brief Index of the correlation sample at or below the delay of each
+   * direction and pair, NUM_MIC_PAIRS entries per direction. */
+  std::vector<uint16_t> lagIndex;
+
+  /** @brief Fractional part of the delay of each direction and pair, used to
+   * interpolate to the next correlation sample. */
+  std::vector<float> lagFraction;
+
+  /** @brief Correlation of every pair, numLags values per pair. */
+  std::vector<float> pairCorrelations;
+
+  /** @brief Lag-domain correlation evaluator. Only sized when the pruned
+   * evaluator is in use and not shared. */
+  PrunedCorrelation prunedCorrelation;
+
+  /** @brief Lag-domain evaluator of the spectrum source, or nullptr. */
+  const PrunedCorrelation* sharedCorrelation;
+
+  /** @brief PhaT weighted cross spectrum, real then imaginary components.
+   * Only sized when the pruned evaluator is in use. */
+  std::vector<float> phatSpectrum;
+
+  /** @brief IFFT module for the full correlation evaluator. */
+  IFFT ifft;
+
+  /** @brief Spectrum source when used on its own. Created on first use so
+   * callers sharing GCC PhaT spectra do not pay for its buffers. */
+  std::unique_ptr<GCCPhaT> spectrumSource;
+
+  /** @brief Sample frequency of the sources (Hz). */
+  int sampleFrequency;
+
+  /** @brief Geometry of the microphone array. */
+  ArrayGeometry geometry;
+};
@@ -12,9 +12,11 @@
 
 #include "classificationLabel.h"
 #include "directionLabel.h"
+#include "doaAlgorithm.h"
 #include "system_fault_states.h"
 
 const size_t PACKET_BYTE_SIZE = 5;
+const size_t SOURCES_PACKET_BYTE_SIZE = 2 + DOA_MAX_SOURCES;
 
 /** @brief Struct for representing the packet being sent to the visualization
  * module. */
@@ -50,3 +52,34 @@ inline std::array<uint8_t, PACKET_BYTE_SIZE> createPacket(
       static_cast<uint8_t>(vizPacket.systemFaultState), vizPacket.priority};
   return packet;
 }
+
+/** @brief Struct for representing the directions of every located audio
+ * source, sent to the visualization module after the main packet. */
+struct SourcesPacket {
+  /** @brief Starting byte of packet. */
+  const uint8_t startByte = 0xAB;
+
+  /** @brief Number of located audio sources. */
+  uint8_t numSources{0U};
+
+  /** @brief Direction of each audio source by decreasing strength. Unused
+   * entries are None. */
+  DirectionLabel directions[DOA_MAX_SOURCES]{};
+};
+
+/**
+ * @brief Create a packet buffer of the located audio sources that can be sent
+ * to visualization module.
+ *
+ * @param sourcesPacket Sources packet struct.
+ * @return std::array<uint8_t, SOURCES_PACKET_BYTE_SIZE>
+ */
+inline std::array<uint8_t, SOURCES_PACKET_BYTE_SIZE> createSourcesPacket(
+    const SourcesPacket& sourcesPacket) {
+  std::array<uint8_t, SOURCES_PACKET_BYTE_SIZE> packet = {
+      sourcesPacket.startByte, sourcesPacket.numSources};
+  for (size_t i = 0; i < DOA_MAX_SOURCES; i++) {
+    packet[2 + i] = static_cast<uint8_t>(sourcesPacket.directions[i]);
+  }
+  return packet;
+}
@@ -0,0 +1,60 @@
+/**
+ ******************************************************************************
+ * @file    cmsisCfft.h
+ * @brief   CMSIS-DSP complex FFT instance lookup
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include "arm_const_structs.h"
+#include "arm_math.h"
+
+/**
+ * @brief Initializes a CMSIS complex FFT instance from the constant
+ * arm_cfft_sR_f32_lenN structures in arm_const_structs.c.
+ *
+ * Used instead of arm_cfft_init_f32, which is not part of the CMSIS-DSP
+ * sources built for the target.
+ *
+ * @param instance The instance to initialize.
+ * @param fftLen The number of complex samples, a power of two from 16 to
+ * 4096.
+ * @return ARM_MATH_SUCCESS, or ARM_MATH_ARGUMENT_ERROR if fftLen has no
+ * constant instance.
+ */
+inline arm_status initializeCfftInstance(arm_cfft_instance_f32* instance,
+                                         uint32_t fftLen) {
+  switch (fftLen) {
+    case 16:
+      *instance = arm_cfft_sR_f32_len16;
+      break;
+    case 32:
+      *instance = arm_cfft_sR_f32_len32;
+      break;
+    case 64:
+      *instance = arm_cfft_sR_f32_len64;
+      break;
+    case 128:
+      *instance = arm_cfft_sR_f32_len128;
+      break;
+    case 256:
+      *instance = arm_cfft_sR_f32_len256;
+      break;
+    case 512:
+      *instance = arm_cfft_sR_f32_len512;
+      break;
+    case 1024:
+      *instance = arm_cfft_sR_f32_len1024;
+      break;
+    case 2048:
+      *instance = arm_cfft_sR_f32_len2048;
+      break;
+    case 4096:
+      *instance = arm_cfft_sR_f32_len4096;
+      break;
+    default:
+      return arm_status::ARM_MATH_ARGUMENT_ERROR;
+  }
+  return arm_status::ARM_MATH_SUCCESS;
+}
@@ -14,39 +14,119 @@
 #include <cmath>
 
 #include "constants.h"
-
-/** @brief input signal. This memory is declared in fft.h. */
-float32_t FFT::in[FFT_BUFFER_SIZE_IN] = {0.0f};
-
-/** @brief output signal. This memory is declared in fft.h. */
-float32_t FFT::out[FFT_BUFFER_SIZE_OUT] = {0.0f};
+#include "fastmath.h"
+#include "windowTable.h"
 
 FFT::FFT(uint16_t inputSize, int sampleFrequency)
     : inputSize(inputSize),
       sampleFrequency(sampleFrequency),
-      outputSize(inputSize) {
+      outputSize(inputSize),
+      frequencyBinSize(sampleFrequency / static_cast<float>(inputSize)),
+      in(inputSize, 0.0f),
+      out(inputSize, 0.0f),
+      scratch(std::max(FFT_MAX_CHANNELS, size_t{2}) * inputSize, 0.0f) {
   this->initializeFFTInstance();
 }
 
 FFT::FFT(const FFT& other)
     : inputSize(other.inputSize),
       sampleFrequency(other.sampleFrequency),
-      outputSize(other.outputSize) {
+      outputSize(other.outputSize),
+      frequencyBinSize(other.frequencyBinSize),
+      in(other.inputSize, 0.0f),
+      out(other.inputSize, 0.0f),
+      scratch(other.scratch.size(), 0.0f) {
   this->initializeFFTInstance();
 }
 
 FFT::~FFT() = default;
 
-void FFT::signalToFrequency(
-    float* signal, FrequencyDomain& outFreq,
-    WindowFunction windowFunction = WindowFunction::NONE) {
-  this->insertSignal(signal);
-  this->applyWindow(in, windowFunction);  // dont modify input buffer.
+void FFT::signalToFrequency(float* signal, FrequencyDomain& outFreq,
+                            WindowFunction windowFunction, uint8_t fields) {
+  // Window is fused into the copy so the input buffer is not modified.
+  const float* window = WindowTable::get(windowFunction, this->inputSize);
+  this->insertSignal(signal, window);
+  if (window == nullptr) {
+    this->applyWindow(in.data(), windowFunction);
+  }
 
-  uint8_t ARM_RFFT_FAST_FORWARD = 0U;  // Discrete Fourier Transform.
-  arm_rfft_fast_f32(&rfft_instance, in, out, ARM_RFFT_FAST_FORWARD);
+  this->realForward(in.data());
 
-  this->createOutput(outFreq);
+  this->createOutput(outFreq, fields);
+}
+
+void FFT::signalsToFrequency(const float* const* channels,
+                             size_t numChannels,
+                             FrequencyDomain* const* outFreqs,
+                             WindowFunction windowFunction,
+                             uint8_t fields) {
+  const float* window = WindowTable::get(windowFunction, this->inputSize);
+
+  for (size_t first = 0; first < numChannels; first += FFT_MAX_CHANNELS) {
+    const size_t groupSize = std::min(numChannels - first, FFT_MAX_CHANNELS);
+    this->insertSignals(&channels[first], groupSize, window);
+
+    for (size_t c = 0; c < groupSize; c++) {
+      float32_t* channelIn = &scratch[c * this->inputSize];
+      if (window == nullptr) {
+        this->applyWindow(channelIn, windowFunction);
+      }
+
+      this->realForward(channelIn);
+      this->createOutput(*outFreqs[first + c], fields);
+    }
+  }
+}
+
+void FFT::signalPairToFrequency(const float* signalA, const float* signalB,
+                                FrequencyDomain& outFreqA,
+                                FrequencyDomain& outFreqB,
+                                WindowFunction windowFunction,
+                                uint8_t fields) {
+  const uint16_t N = this->inputSize;
+
+  // z[n] = a[n] + j * b[n]. Window is fused into the interleaving copy.
+  const float* window = WindowTable::get(windowFunction, N);
+  if (window == nullptr) {
+    std::copy(signalA, signalA + N, in.begin());
+    this->applyWindow(in.data(), windowFunction);
+    for (uint16_t i = 0; i < N; i++) {
+      scratch[2 * i] = in[i];
+    }
+    std::copy(signalB, signalB + N, in.begin());
+    this->applyWindow(in.data(), windowFunction);
+    for (uint16_t i = 0; i < N; i++) {
+      scratch[2 * i + 1] = in[i];
+    }
+  } else {
+    for (uint16_t i = 0; i < N; i++) {
+      scratch[2 * i] = signalA[i] * window[i];
+      scratch[2 * i + 1] = signalB[i] * window[i];
+    }
+  }
+
+  this->complexForward(scratch.data());
+
+  // Separate with A[k] = (Z[k] + conj(Z[N-k])) / 2 and
+  // B[k] = (Z[k] - conj(Z[N-k])) / 2j. Each spectrum is written to the output
+  // buffer in the packed layout of the real FFT so createOutput is shared. DC
+  // and Nyquist of Z are real for A and imaginary for B.
+  const float* z = scratch.data();
+  out[0] = z[0];
+  out[1] = z[N];
+  for (uint16_t k = 1; k < N / 2; k++) {
+    out[2 * k] = 0.5f * (z[2 * k] + z[2 * (N - k)]);
+    out[2 * k + 1] = 0.5f * (z[2 * k + 1] - z[2 * (N - k) + 1]);
+  }
+  this->createOutput(outFreqA, fields);
+
+  out[0] = z[1];
+  out[1] = z[N + 1];
+  for (uint16_t k = 1; k < N / 2; k++) {
+    out[2 * k] = 0.5f * (z[2 * k + 1] + z[2 * (N - k) + 1]);
+    out[2 * k + 1] = 0.5f * (z[2 * (N - k)] - z[2 * k]);
+  }
+  this->createOutput(outFreqB, fields);
 }
 
 void FFT::applyWindow(float* signal, WindowFunction windowFunction) {
@@ -57,37 +137,96 @@ void FFT::applyWindow(float* signal, WindowFunction windowFunction) {
     case WindowFunction::HANN_WINDOW:
       HannWindow<float>().applyWindow(signal, inputSize);
       break;
+    case WindowFunction::HAMMING_WINDOW:
+      HammingWindow<float>().applyWindow(signal, inputSize);
+      break;
+    case WindowFunction::BLACKMAN_HARRIS_WINDOW:
+      BlackmanHarrisWindow<float>().applyWindow(signal, inputSize);
+      break;
+    case WindowFunction::SQRT_HANN_WINDOW:
+      SqrtHannWindow<float>().applyWindow(signal, inputSize);
+      break;
     default:
       WARN("Window function is not supported. Signal remain the same.");
   }
 }
 
-void FFT::insertSignal(float* signal) const {
-  std::copy(signal, signal + inputSize, in);
+void FFT::insertSignal(float* signal, const float* window) {
+  if (window == nullptr) {
+    std::copy(signal, signal + inputSize, in.begin());
+    return;
+  }
+
+  arm_mult_f32(signal, window, in.data(), inputSize);
 }
 
-void FFT::createOutput(FrequencyDomain& outFreq) {
-  uint16_t N = (this->inputSize / 2) + 1;
-  uint16_t lastIdx = N - 1;
-  float frequency = 0.0f;
-  float frequencyBinSize =
-      this->sampleFrequency / static_cast<float>(this->inputSize);
+void FFT::insertSignals(const float* const* channels, size_t numChannels,
+                        const float* window) {
+  if (window == nullptr) {
+    for (size_t c = 0; c < numChannels; c++) {
+      std::copy(channels[c], channels[c] + inputSize,
+                scratch.begin() + c * inputSize);
+    }
+    return;
+  }
+
+  // Single pass over the samples so each window coefficient is loaded once
+  // for all channels.
+  for (size_t i = 0; i < inputSize; i++) {
+    const float w = window[i];
+    for (size_t c = 0; c < numChannels; c++) {
+      scratch[c * inputSize + i] = channels[c][i] * w;
+    }
+  }
+}
+
+void FFT::createOutput(FrequencyDomain& outFreq, uint8_t fields) {
+  const uint16_t N = (this->inputSize / 2) + 1;
+  const uint16_t lastIdx = N - 1;
+  outFreq.fields = fields;
 
   // Since first FFT output is DC, there is no imaginary part. Thus CMSIS-DSP
   // library stores the last real value in the place of the first complex value.
   // Reference:
   // https://arm-software.github.io/CMSIS-DSP/main/group__RealFFT.html
+  const float dc = out[0];
+  const float nyquist = out[1];
+
+  // The axis costs one multiply per bin, so it is not kept per instance.
+  if (fields & SPECTRUM_FREQUENCY) {
+    for (uint16_t i = 0; i < N; i++) {
+      outFreq.frequency[i] = i * this->frequencyBinSize;
+    }
+  }
 
-  // DC.
-  insertFrequencyEntry(outFreq, 0, frequency, out[0], 0.0f);
-  frequency += frequencyBinSize;
+  if (fields & SPECTRUM_COMPLEX) {
+    outFreq.real[0] = dc;
+    outFreq.img[0] = 0.0f;
+    for (uint16_t i = 1; i < lastIdx; i++) {
+      outFreq.real[i] = out[2 * i];
+      outFreq.img[i] = out[2 * i + 1];
+    }
+    outFreq.real[lastIdx] = nyquist;
+    outFreq.img[lastIdx] = 0.0f;
+  }
 
-  // Middle real and complex values.
-  for (int i = 1; i < lastIdx; i++) {
-    insertFrequencyEntry(outFreq, i, frequency, out[2 * i], out[2 * i + 1]);
-    frequency += frequencyBinSize;
+  // Power is computed directly so the square root is only paid for magnitude.
+  if (fields & SPECTRUM_POWER) {
+    outFreq.powerMagnitude[0] = dc * dc;
+    for (uint16_t i = 1; i < lastIdx; i++) {
+      outFreq.powerMagnitude[i] =
+          out[2 * i] * out[2 * i] + out[2 * i + 1] * out[2 * i + 1];
+    }
+    outFreq.powerMagnitude[lastIdx] = nyquist * nyquist;
   }
 
-  // Last real.
-  insertFrequencyEntry(outFreq, lastIdx, frequency, out[1], 0.0f);
+  if (fields & SPECTRUM_MAGNITUDE) {
+    outFreq.magnitude[0] = std::fabs(dc);
+    for (uint16_t i = 1; i < lastIdx; i++) {
+      outFreq.magnitude[i] =
+          out[2 * i] * out[2 * i] + out[2 * i + 1] * out[2 * i + 1];
+    }
+    fastSqrt(&outFreq.magnitude[1], &outFreq.magnitude[1], lastIdx - 1);
+    outFreq.magnitude[lastIdx] = std::fabs(nyquist);
+  }
 }
@@ -15,11 +15,18 @@
 
 #endif
 #include <cmath>
+#include <vector>
 
 #include "frequencyDomain.h"
 #include "logging.hpp"
 #include "window.hpp"
 
+#ifdef HOST_NATIVE_FFT
+#include "hostFft.h"
+#else
+#include "cmsisCfft.h"
+#endif
+
 /** @brief Fast Fourier Transform (FFT) class. */
 class FFT {
  public:
@@ -45,24 +52,110 @@ class FFT {
    * info.
    * @param windowFunction The type of window function to apply to the input
    * signal.
+   * @param fields The @ref SpectrumField flags of the output fields to
+   * populate. Other fields are left untouched.
    * @return FrequencyDomain The signal represented in the frequency domain.
    */
   void signalToFrequency(float* signal, FrequencyDomain& outFreq,
-                         WindowFunction windowFunction);
+                         WindowFunction windowFunction,
+                         uint8_t fields = SPECTRUM_ALL);
+
+  /**
+   * @brief Converts several input signals of inputSize samples to the
+   * frequency domain in one batch. All channels are windowed in a single pass
+   * into a channel-major scratch buffer, then transformed back to back so the
+   * window and twiddle tables stay in cache. Used by StreamingSTFT, whose
+   * spectra must match signalToFrequency exactly. GCC PhaT transforms its mics
+   * with signalPairToFrequency instead, two per complex FFT.
+   *
+   * @param channels Array of numChannels input signals.
+   * @param numChannels The number of input signals. Batches larger than
+   * FFT_MAX_CHANNELS are processed in groups.
+   * @param [out] outFreqs Array of numChannels frequency domain structs to be
+   * populated, one per input signal.
+   * @param windowFunction The type of window function to apply to the input
+   * signals.
+   * @param fields The @ref SpectrumField flags of the output fields to
+   * populate. Other fields are left untouched.
+   */
+  void signalsToFrequency(const float* const* channels, size_t numChannels,
+                          FrequencyDomain* const* outFreqs,
+                          WindowFunction windowFunction,
+                          uint8_t fields = SPECTRUM_ALL);
+
+  /**
+   * @brief Converts two real input signals to the frequency domain with one
+   * complex FFT. The signals are packed into the real and imaginary parts of
+   * the complex input and separated afterwards using the conjugate symmetry of
+   * real signal spectra.
+   *
+   * @param signalA First input signal.
+   * @param signalB Second input signal.
+   * @param [out] outFreqA Frequency domain struct of the first signal.
+   * @param [out] outFreqB Frequency domain struct of the second signal.
+   * @param windowFunction The type of window function to apply to both input
+   * signals.
+   * @param fields The @ref SpectrumField flags of the output fields to
+   * populate. Other fields are left untouched.
+   */
+  void signalPairToFrequency(const float* signalA, const float* signalB,
+                             FrequencyDomain& outFreqA,
+                             FrequencyDomain& outFreqB,
+                             WindowFunction windowFunction,
+                             uint8_t fields = SPECTRUM_ALL);
 
  private:
-  /** @brief Initializes FFT instance from CMSIS-DSP lib. */
+  /** @brief Initializes FFT instance from CMSIS-DSP lib, or the native host
+   * backend when HOST_NATIVE_FFT is defined. */
   void initializeFFTInstance() {
+#ifdef HOST_NATIVE_FFT
+    this->hostFft = HostFFT(this->inputSize);
+#else
     arm_status status = arm_rfft_fast_init_f32(&rfft_instance, this->inputSize);
+    if (status == arm_status::ARM_MATH_SUCCESS) {
+      status = initializeCfftInstance(&cfft_instance, this->inputSize);
+    }
 
     if (status != arm_status::ARM_MATH_SUCCESS) {
       ERROR("Error in initializing CMSIS DSP FFT. Error status code %d",
             status);
     }
+#endif
+  }
+
+  /**
+   * @brief Forward real FFT of inputSize samples into the output buffer, in
+   * the packed layout of the CMSIS real FFT.
+   *
+   * @param input Input samples. May be modified.
+   */
+  void realForward(float32_t* input) {
+#ifdef HOST_NATIVE_FFT
+    this->hostFft.rfft(input, out.data(), false);
+#else
+    uint8_t ARM_RFFT_FAST_FORWARD = 0U;  // Discrete Fourier Transform.
+    arm_rfft_fast_f32(&rfft_instance, input, out.data(), ARM_RFFT_FAST_FORWARD);
+#endif
   }
 
   /**
-   * @brief Applies the window function on the input signal.
+   * @brief In-place forward complex FFT of inputSize points.
+   *
+   * @param data Interleaved complex values.
+   */
+  void complexForward(float32_t* data) {
+#ifdef HOST_NATIVE_FFT
+    this->hostFft.cfft(data, false);
+#else
+    uint8_t ARM_CFFT_FORWARD = 0U;      // Discrete Fourier Transform.
+    uint8_t ARM_CFFT_BIT_REVERSE = 1U;  // Output in natural order.
+    arm_cfft_f32(&cfft_instance, data, ARM_CFFT_FORWARD, ARM_CFFT_BIT_REVERSE);
+#endif
+  }
+
+  /**
+   * @brief Applies the window function on the input signal. Only used when a
+   * precomputed window table is not available.
    *
    * @param signal input signal.
    * @param windowFunction Window function.
@@ -70,30 +163,36 @@ class FFT {
   void applyWindow(float* signal, WindowFunction windowFunction);
 
   /**
-   * @brief Inserts signal to internal memory of this class.
+   * @brief Inserts signal to internal memory of this class, multiplying by the
+   * window coefficients on copy.
    *
    * @param signal input signal.
+   * @param window Precomputed window table of inputSize coefficients. nullptr
+   * to copy the signal unmodified.
    */
-  void insertSignal(float* signal) const;
-
-  void insertFrequencyEntry(FrequencyDomain& frequencyDomain, size_t pos,
-                            float frequency, float real, float img) {
-    frequencyDomain.frequency[pos] = frequency;
-    frequencyDomain.real[pos] = real;
-    frequencyDomain.img[pos] = img;
-    frequencyDomain.magnitude[pos] = std::sqrt(real * real + img * img);
-    frequencyDomain.powerMagnitude[pos] =
-        frequencyDomain.magnitude[pos] * frequencyDomain.magnitude[pos];
-  }
+  void insertSignal(float* signal, const float* window);
+
+  /**
+   * @brief Inserts a group of signals into the batch memory of this class,
+   * multiplying by the window coefficients on copy.
+   *
+   * @param channels Array of numChannels input signals.
+   * @param numChannels The number of signals. At most FFT_MAX_CHANNELS.
+   * @param window Precomputed window table of inputSize coefficients. nullptr
+   * to copy the signals unmodified.
+   */
+  void insertSignals(const float* const* channels, size_t numChannels,
+                     const float* window);
 
   /**
    * @brief Translate FFT algo's output to a portable output to return.
    *
    * @param [out] outFreq Frequency domain struct to be populated with frequency
    * info.
-   * @return FrequencyDomain frequency output.
+   * @param fields The @ref SpectrumField flags of the output fields to
+   * populate.
    */
-  void createOutput(FrequencyDomain& outFreq);
+  void createOutput(FrequencyDomain& outFreq, uint8_t fields);
 
   /** @brief The size of the input signal. */
   uint16_t inputSize{0U};
@@ -104,12 +203,29 @@ class FFT {
   /** @brief The size of the output signal. */
   uint16_t outputSize;
 
-  /** @brief input signal. This memory is statically allocated. */
-  static float32_t in[FFT_BUFFER_SIZE_IN];
+  /** @brief Frequency spacing between output bins (Hz). */
+  float frequencyBinSize{0.0f};
 
-  /** @brief output signal. This memory is statically allocated */
-  static float32_t out[FFT_BUFFER_SIZE_OUT];
+  /** @brief input signal. Owned by this instance so that independent
+   * instances can transform concurrently. */
+  std::vector<float32_t> in;
 
+  /** @brief output signal. Owned by this instance. */
+  std::vector<float32_t> out;
+
+  /** @brief Channel-major input signals of a batch, or the interleaved
+   * complex input and output of a paired transform. Sized at construction for
+   * FFT_MAX_CHANNELS signals so that no transform allocates. */
+  std::vector<float32_t> scratch;
+
+#ifdef HOST_NATIVE_FFT
+  /** @brief Native host FFT backend. */
+  HostFFT hostFft;
+#else
   /** @brief Real FFT instance for using CMSIS DSP library */
   arm_rfft_fast_instance_f32 rfft_instance;
+
+  /** @brief Complex FFT instance of inputSize points for paired transforms. */
+  arm_cfft_instance_f32 cfft_instance;
+#endif
 };
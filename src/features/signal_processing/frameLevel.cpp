@@ -0,0 +1,35 @@
+/**
+ ******************************************************************************
+ * @file    frameLevel.cpp
+ * @brief   Level of an audio frame source.
+ ******************************************************************************
+ */
+
+#include "frameLevel.h"
+
+#include <algorithm>
+#include <cmath>
+
+FrameLevel measureFrameLevel(const float* frame, size_t numSamples) {
+  if (numSamples == 0) {
+    return FrameLevel{0.0f, 0.0f};
+  }
+
+  float sum = 0.0f;
+  float peak = 0.0f;
+  for (size_t i = 0; i < numSamples; i++) {
+    sum += frame[i];
+    peak = std::max(peak, std::fabs(frame[i]));
+  }
+  const float mean = sum / numSamples;
+
+  // Sum the squared deviations rather than subtract mean^2 from the mean
+  // square, which cancels when the DC offset is large next to the signal.
+  float sumSq = 0.0f;
+  for (size_t i = 0; i < numSamples; i++) {
+    const float deviation = frame[i] - mean;
+    sumSq += deviation * deviation;
+  }
+
+  return FrameLevel{std::sqrt(std::max(sumSq / numSamples, 0.0f)), peak};
+}
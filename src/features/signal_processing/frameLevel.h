@@ -0,0 +1,27 @@
+/**
+ ******************************************************************************
+ * @file    frameLevel.h
+ * @brief   Level of an audio frame header.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <cstddef>
+
+/** @brief Level of an audio frame, in the units of its samples. */
+struct FrameLevel {
+  float rms;   // RMS with the DC offset removed.
+  float peak;  // Largest sample magnitude, DC offset included.
+};
+
+/**
+ * @brief Measure the mean removed RMS and the peak of a frame. The mean is
+ * found first, so a DC offset far larger than the signal does not cancel the
+ * RMS.
+ *
+ * @param frame Audio frame.
+ * @param numSamples Number of samples in the frame.
+ * @return FrameLevel Level of the frame, zero for an empty frame.
+ */
+FrameLevel measureFrameLevel(const float* frame, size_t numSamples);
@@ -11,11 +11,28 @@
 
 #include "constants.h"
 
+/**
+ * @brief Bit flags selecting which fields of a FrequencyDomain are populated by
+ * a transform. Fields that are not requested are neither computed nor written.
+ */
+enum SpectrumField : uint8_t {
+  SPECTRUM_NONE = 0U,
+  SPECTRUM_FREQUENCY = 1U << 0,
+  SPECTRUM_COMPLEX = 1U << 1,  // real and img.
+  SPECTRUM_MAGNITUDE = 1U << 2,
+  SPECTRUM_POWER = 1U << 3,
+  SPECTRUM_ALL = SPECTRUM_FREQUENCY | SPECTRUM_COMPLEX | SPECTRUM_MAGNITUDE |
+                 SPECTRUM_POWER
+};
+
 /** @brief Struct for representing FFT output in the frequency domain. */
 struct FrequencyDomain {
   /** @brief The number of the data in the FFT output. */
   uint16_t N = FREQ_DOMAIN_SIZE;
 
+  /** @brief The @ref SpectrumField flags populated by the last transform. */
+  uint8_t fields = SPECTRUM_NONE;
+
   /** @brief The frequency (Hz) */
   float frequency[FREQ_DOMAIN_SIZE];
 
@@ -0,0 +1,326 @@
+/**
+ ******************************************************************************
+ * @file    hostFft.cpp
+ * @brief   Native host Fast Fourier Transform (FFT) backend source.
+ ******************************************************************************
+ */
+
+#include "hostFft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "constants.h"
+#include "logging.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HOST_FFT_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief One radix-2 decimation in time stage over all blocks.
+ *
+ * @param data Interleaved complex values.
+ * @param twiddles Interleaved twiddles w^j of the stage, j < half.
+ * @param numPoints Number of complex points.
+ * @param half Half the block size of the stage.
+ */
+using StageKernel = void (*)(float* data, const float* twiddles,
+                             size_t numPoints, size_t half);
+
+/** @brief Portable stage kernel. */
+static void stageScalar(float* data, const float* twiddles, size_t numPoints,
+                        size_t half) {
+  for (size_t start = 0; start < numPoints; start += 2 * half) {
+    float* u = &data[2 * start];
+    float* v = &data[2 * (start + half)];
+    for (size_t j = 0; j < half; j++) {
+      const float wr = twiddles[2 * j];
+      const float wi = twiddles[2 * j + 1];
+      const float tr = v[2 * j] * wr - v[2 * j + 1] * wi;
+      const float ti = v[2 * j] * wi + v[2 * j + 1] * wr;
+      v[2 * j] = u[2 * j] - tr;
+      v[2 * j + 1] = u[2 * j + 1] - ti;
+      u[2 * j] += tr;
+      u[2 * j + 1] += ti;
+    }
+  }
+}
+
+#ifdef HOST_FFT_X86
+/** @brief SSE3 stage kernel. Two complex values per vector, half >= 2. */
+__attribute__((target("sse3"))) static void stageSse3(float* data,
+                                                      const float* twiddles,
+                                                      size_t numPoints,
+                                                      size_t half) {
+  for (size_t start = 0; start < numPoints; start += 2 * half) {
+    float* u = &data[2 * start];
+    float* v = &data[2 * (start + half)];
+    for (size_t j = 0; j < half; j += 2) {
+      const __m128 w = _mm_loadu_ps(&twiddles[2 * j]);
+      const __m128 b = _mm_loadu_ps(&v[2 * j]);
+      const __m128 a = _mm_loadu_ps(&u[2 * j]);
+
+      // (br + j bi) * (wr + j wi) with addsub on the real lanes.
+      const __m128 bSwap = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1));
+      const __m128 t = _mm_addsub_ps(_mm_mul_ps(b, _mm_moveldup_ps(w)),
+                                     _mm_mul_ps(bSwap, _mm_movehdup_ps(w)));
+
+      _mm_storeu_ps(&u[2 * j], _mm_add_ps(a, t));
+      _mm_storeu_ps(&v[2 * j], _mm_sub_ps(a, t));
+    }
+  }
+}
+
+/** @brief AVX2 stage kernel. Four complex values per vector, half >= 4. */
+__attribute__((target("avx2,fma"))) static void stageAvx2(
+    float* data, const float* twiddles, size_t numPoints, size_t half) {
+  for (size_t start = 0; start < numPoints; start += 2 * half) {
+    float* u = &data[2 * start];
+    float* v = &data[2 * (start + half)];
+    for (size_t j = 0; j < half; j += 4) {
+      const __m256 w = _mm256_loadu_ps(&twiddles[2 * j]);
+      const __m256 b = _mm256_loadu_ps(&v[2 * j]);
+      const __m256 a = _mm256_loadu_ps(&u[2 * j]);
+
+      const __m256 bSwap = _mm256_permute_ps(b, _MM_SHUFFLE(2, 3, 0, 1));
+      const __m256 t =
+          _mm256_fmaddsub_ps(b, _mm256_moveldup_ps(w),
+                             _mm256_mul_ps(bSwap, _mm256_movehdup_ps(w)));
+
+      _mm256_storeu_ps(&u[2 * j], _mm256_add_ps(a, t));
+      _mm256_storeu_ps(&v[2 * j], _mm256_sub_ps(a, t));
+    }
+  }
+}
+#endif
+
+/**
+ * @brief Get the stage function of a kernel.
+ *
+ * @param kernel Butterfly kernel other than AUTO.
+ * @return StageKernel The stage function.
+ */
+static StageKernel stageKernel(HostFFTKernel kernel) {
+  switch (kernel) {
+#ifdef HOST_FFT_X86
+    case HostFFTKernel::SSE3:
+      return stageSse3;
+    case HostFFTKernel::AVX2:
+      return stageAvx2;
+#endif
+    default:
+      return stageScalar;
+  }
+}
+
+/**
+ * @brief First two stages as one radix-4 pass. Their twiddles are 1 and
+ * -j (forward) or +j (inverse), so no multiplications are needed.
+ *
+ * @param data Interleaved complex values in bit reversed order.
+ * @param numPoints Number of complex points. Multiple of 4.
+ * @param inverse true for the inverse transform.
+ */
+static void radix4FirstPass(float* data, size_t numPoints, bool inverse) {
+  for (size_t start = 0; start < numPoints; start += 4) {
+    float* x = &data[2 * start];
+    const float s0r = x[0] + x[2], s0i = x[1] + x[3];
+    const float d0r = x[0] - x[2], d0i = x[1] - x[3];
+    const float s1r = x[4] + x[6], s1i = x[5] + x[7];
+    const float d1r = x[4] - x[6], d1i = x[5] - x[7];
+
+    // d1 rotated by -j (forward) or +j (inverse).
+    const float rr = inverse ? -d1i : d1i;
+    const float ri = inverse ? d1r : -d1r;
+
+    x[0] = s0r + s1r;
+    x[1] = s0i + s1i;
+    x[4] = s0r - s1r;
+    x[5] = s0i - s1i;
+    x[2] = d0r + rr;
+    x[3] = d0i + ri;
+    x[6] = d0r - rr;
+    x[7] = d0i - ri;
+  }
+}
+
+HostFFT::HostFFT(size_t numSamples, HostFFTKernel kernel)
+    : numSamples(numSamples) {
+  if (numSamples < 8 || (numSamples & (numSamples - 1)) != 0) {
+    ERROR("Host FFT size %u is not a power of two of at least 8.",
+          static_cast<unsigned>(numSamples));
+    return;
+  }
+
+  if (kernel == HostFFTKernel::AUTO || !isSupported(kernel)) {
+    kernel = isSupported(HostFFTKernel::AVX2)   ? HostFFTKernel::AVX2
+             : isSupported(HostFFTKernel::SSE3) ? HostFFTKernel::SSE3
+                                                : HostFFTKernel::SCALAR;
+  }
+  this->kernel = kernel;
+
+  this->complexPlan = makePlan(numSamples);
+  this->halfPlan = makePlan(numSamples / 2);
+
+  this->realTwiddles.resize(numSamples);
+  for (size_t k = 0; k < numSamples / 2; k++) {
+    const double phase = -2.0 * PI_64 * k / numSamples;
+    this->realTwiddles[2 * k] = static_cast<float>(std::cos(phase));
+    this->realTwiddles[2 * k + 1] = static_cast<float>(std::sin(phase));
+  }
+}
+
+bool HostFFT::isSupported(HostFFTKernel kernel) {
+  switch (kernel) {
+    case HostFFTKernel::AUTO:
+    case HostFFTKernel::SCALAR:
+      return true;
+#ifdef HOST_FFT_X86
+    case HostFFTKernel::SSE3:
+      return __builtin_cpu_supports("sse3");
+    case HostFFTKernel::AVX2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    default:
+      return false;
+  }
+}
+
+const char* HostFFT::kernelName(HostFFTKernel kernel) {
+  switch (kernel) {
+    case HostFFTKernel::AUTO:
+      return "auto";
+    case HostFFTKernel::SCALAR:
+      return "scalar";
+    case HostFFTKernel::SSE3:
+      return "sse3";
+    case HostFFTKernel::AVX2:
+      return "avx2";
+    default:
+      return "unknown";
+  }
+}
+
+HostFFT::Plan HostFFT::makePlan(size_t numPoints) {
+  Plan plan;
+  plan.numPoints = numPoints;
+
+  size_t numBits = 0;
+  while ((1U << numBits) < numPoints) {
+    numBits++;
+  }
+  for (uint32_t i = 0; i < numPoints; i++) {
+    uint32_t reversed = 0;
+    for (size_t b = 0; b < numBits; b++) {
+      reversed |= ((i >> b) & 1U) << (numBits - 1 - b);
+    }
+    if (i < reversed) {
+      plan.swaps.push_back(i);
+      plan.swaps.push_back(reversed);
+    }
+  }
+
+  // Stage with half size h starts at complex offset h - 4.
+  for (int direction = 0; direction < 2; direction++) {
+    const double sign = (direction == 0) ? -1.0 : 1.0;
+    std::vector<float>& twiddles = plan.twiddles[direction];
+    twiddles.reserve(2 * (numPoints - 4));
+    for (size_t half = 4; half < numPoints; half *= 2) {
+      for (size_t j = 0; j < half; j++) {
+        const double phase = sign * PI_64 * j / half;
+        twiddles.push_back(static_cast<float>(std::cos(phase)));
+        twiddles.push_back(static_cast<float>(std::sin(phase)));
+      }
+    }
+  }
+
+  return plan;
+}
+
+void HostFFT::transform(const Plan& plan, float* data, bool inverse) const {
+  for (size_t i = 0; i < plan.swaps.size(); i += 2) {
+    const size_t a = 2 * plan.swaps[i];
+    const size_t b = 2 * plan.swaps[i + 1];
+    std::swap(data[a], data[b]);
+    std::swap(data[a + 1], data[b + 1]);
+  }
+
+  radix4FirstPass(data, plan.numPoints, inverse);
+
+  const StageKernel stage = stageKernel(this->kernel);
+  const float* twiddles = plan.twiddles[inverse ? 1 : 0].data();
+  for (size_t half = 4; half < plan.numPoints; half *= 2) {
+    stage(data, &twiddles[2 * (half - 4)], plan.numPoints, half);
+  }
+}
+
+void HostFFT::cfft(float* data, bool inverse) const {
+  this->transform(this->complexPlan, data, inverse);
+
+  if (inverse) {
+    const float scale = 1.0f / this->numSamples;
+    for (size_t i = 0; i < 2 * this->numSamples; i++) {
+      data[i] *= scale;
+    }
+  }
+}
+
+void HostFFT::rfft(const float* input, float* output, bool inverse) const {
+  const size_t M = this->numSamples / 2;
+  const float* w = this->realTwiddles.data();
+
+  if (!inverse) {
+    // Even and odd samples are the real and imaginary parts of a half size
+    // complex signal z.
+    std::copy(input, input + this->numSamples, output);
+    this->transform(this->halfPlan, output, false);
+
+    // X[k] = Xe + W^k Xo and X[M-k] = conj(Xe - W^k Xo) with
+    // Xe = (Z[k] + conj(Z[M-k])) / 2 and Xo = -j (Z[k] - conj(Z[M-k])) / 2.
+    const float z0r = output[0];
+    const float z0i = output[1];
+    output[0] = z0r + z0i;
+    output[1] = z0r - z0i;
+    for (size_t k = 1; k <= M / 2; k++) {
+      float* p = &output[2 * k];
+      float* q = &output[2 * (M - k)];
+      const float er = 0.5f * (p[0] + q[0]);
+      const float ei = 0.5f * (p[1] - q[1]);
+      const float or_ = 0.5f * (p[1] + q[1]);
+      const float oi = -0.5f * (p[0] - q[0]);
+      const float tr = w[2 * k] * or_ - w[2 * k + 1] * oi;
+      const float ti = w[2 * k] * oi + w[2 * k + 1] * or_;
+      q[0] = er - tr;
+      q[1] = ti - ei;
+      p[0] = er + tr;
+      p[1] = ei + ti;
+    }
+    return;
+  }
+
+  // Z[k] = Xe + j Xo with Xe = (X[k] + conj(X[M-k])) / 2 and
+  // Xo = (X[k] - conj(X[M-k])) / 2 * conj(W^k). The 2 / N scale of the half
+  // size inverse is folded in.
+  const float scale = 1.0f / this->numSamples;
+  output[0] = (input[0] + input[1]) * scale;
+  output[1] = (input[0] - input[1]) * scale;
+  for (size_t k = 1; k <= M / 2; k++) {
+    const float* a = &input[2 * k];
+    const float* b = &input[2 * (M - k)];
+    const float er = (a[0] + b[0]) * scale;
+    const float ei = (a[1] - b[1]) * scale;
+    const float dr = (a[0] - b[0]) * scale;
+    const float di = (a[1] + b[1]) * scale;
+    const float or_ = dr * w[2 * k] + di * w[2 * k + 1];
+    const float oi = di * w[2 * k] - dr * w[2 * k + 1];
+    output[2 * (M - k)] = er + oi;
+    output[2 * (M - k) + 1] = or_ - ei;
+    output[2 * k] = er - oi;
+    output[2 * k + 1] = ei + or_;
+  }
+
+  this->transform(this->halfPlan, output, true);
+}
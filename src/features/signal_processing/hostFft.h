@@ -0,0 +1,138 @@
+/**
+ ******************************************************************************
+ * @file    hostFft.h
+ * @brief   Native host Fast Fourier Transform (FFT) backend header. SIMD
+ *          replacement for the CMSIS-DSP C reference on x86 hosts.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** @brief Butterfly kernels of the host FFT. */
+enum class HostFFTKernel {
+  AUTO,    // Best kernel supported by the CPU, chosen at runtime.
+  SCALAR,  // Portable C++.
+  SSE3,    // Two complex values per 128 bit vector.
+  AVX2,    // Four complex values per 256 bit vector, with FMA.
+};
+
+/**
+ * @brief Power of two FFT with the same data layouts and scaling as the CMSIS
+ * functions it replaces: arm_cfft_f32 (interleaved complex, natural order,
+ * inverse scaled by 1 / N) and arm_rfft_fast_f32 (packed real spectrum with
+ * the Nyquist value in place of the imaginary part of DC).
+ *
+ * Complex transforms are iterative decimation in time. The first two stages
+ * have trivial twiddles and run as one multiply-free radix-4 pass, the other
+ * stages run in the selected SIMD kernel. Real transforms of N samples use a
+ * complex transform of N / 2 points.
+ */
+class HostFFT {
+ public:
+  /** @brief Construct an empty HostFFT. Assign a sized instance before use. */
+  HostFFT() = default;
+
+  /**
+   * @brief Construct a new HostFFT object.
+   *
+   * @param numSamples Number of points of the complex transform and samples
+   * of the real transform. Power of two, at least 8.
+   * @param kernel Butterfly kernel. Falls back to AUTO if the CPU does not
+   * support it.
+   */
+  HostFFT(size_t numSamples, HostFFTKernel kernel = HostFFTKernel::AUTO);
+
+  /**
+   * @brief In-place complex FFT, matching arm_cfft_f32 with bit reversal.
+   *
+   * @param data numSamples interleaved complex values.
+   * @param inverse true for the inverse transform, scaled by 1 / numSamples.
+   */
+  void cfft(float* data, bool inverse) const;
+
+  /**
+   * @brief Real FFT, matching arm_rfft_fast_f32.
+   *
+   * @param input numSamples real samples (forward) or packed spectrum
+   * (inverse). Left unmodified.
+   * @param [out] output Packed spectrum (forward) or numSamples real samples
+   * (inverse), scaled by 1 / numSamples. Must not alias input.
+   * @param inverse true for the inverse transform.
+   */
+  void rfft(const float* input, float* output, bool inverse) const;
+
+  /**
+   * @brief Get the butterfly kernel in use.
+   *
+   * @return HostFFTKernel Never AUTO.
+   */
+  HostFFTKernel getKernel() const { return this->kernel; }
+
+  /**
+   * @brief Check whether the CPU supports a kernel.
+   *
+   * @param kernel Butterfly kernel.
+   * @return true if the kernel can run on this CPU.
+   */
+  static bool isSupported(HostFFTKernel kernel);
+
+  /**
+   * @brief Get the printable name of a kernel.
+   *
+   * @param kernel Butterfly kernel.
+   * @return const char* Name of the kernel.
+   */
+  static const char* kernelName(HostFFTKernel kernel);
+
+ private:
+  /** @brief Tables of one complex transform size. */
+  struct Plan {
+    /** @brief Number of complex points. */
+    size_t numPoints{0};
+
+    /** @brief Index pairs swapped by the bit reversal permutation. */
+    std::vector<uint32_t> swaps;
+
+    /** @brief Twiddles of every stage from half size 4 upwards, stored
+     * contiguously per stage. Index 0 forward, 1 inverse. */
+    std::vector<float> twiddles[2];
+  };
+
+  /**
+   * @brief Build the tables of a complex transform.
+   *
+   * @param numPoints Number of complex points. Power of two, at least 4.
+   * @return Plan The tables.
+   */
+  static Plan makePlan(size_t numPoints);
+
+  /**
+   * @brief Unscaled in-place complex FFT.
+   *
+   * @param plan Tables of the transform size.
+   * @param data Interleaved complex values.
+   * @param inverse true for the inverse transform.
+   */
+  void transform(const Plan& plan, float* data, bool inverse) const;
+
+  /** @brief Number of points of the complex transform. */
+  size_t numSamples{0};
+
+  /** @brief Butterfly kernel in use. */
+  HostFFTKernel kernel{HostFFTKernel::SCALAR};
+
+  /** @brief Tables of the numSamples point complex transform. */
+  Plan complexPlan;
+
+  /** @brief Tables of the numSamples / 2 point complex transform behind the
+   * real transform. */
+  Plan halfPlan;
+
+  /** @brief e^(-2 pi j k / numSamples) for k < numSamples / 2, interleaved.
+   * Splits the spectrum of the half size transform. */
+  std::vector<float> realTwiddles;
+};
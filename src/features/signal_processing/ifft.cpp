@@ -15,17 +15,19 @@
 
 #include "constants.h"
 
-/** @brief input frequency. This memory is statically allocated. */
-float32_t IFFT::in[FFT_BUFFER_SIZE_IN] = {0.0f};
-
-/** @brief output signal. This memory is statically allocated. */
-float32_t IFFT::out[FFT_BUFFER_SIZE_OUT] = {0.0f};
-
-IFFT::IFFT(uint16_t numSamples) : numSamples(numSamples) {
+IFFT::IFFT(uint16_t numSamples)
+    : numSamples(numSamples),
+      in(numSamples, 0.0f),
+      out(numSamples, 0.0f),
+      pairBuffer(2 * numSamples, 0.0f) {
   this->initializeFFTInstance();
 }
 
-IFFT::IFFT(const IFFT& other) : numSamples(other.numSamples) {
+IFFT::IFFT(const IFFT& other)
+    : numSamples(other.numSamples),
+      in(other.numSamples, 0.0f),
+      out(other.numSamples, 0.0f),
+      pairBuffer(2 * other.numSamples, 0.0f) {
   this->initializeFFTInstance();
 }
 
@@ -35,14 +37,67 @@ float* IFFT::frequencyToTime(const FrequencyDomain& frequencyDomain,
                              size_t& outSize) {
   this->insertSignal(frequencyDomain);
 
-  uint8_t ARM_RFFT_FAST_FORWARD = 1U;  // Discrete Inverse Fourier Transform.
-  arm_rfft_fast_f32(&rfft_instance, in, out, ARM_RFFT_FAST_FORWARD);
+  this->realInverse();
 
   this->scaleOutput();
 
   // Copy output data into vector and return.
   outSize = this->numSamples;
-  return out;
+  return out.data();
+}
+
+void IFFT::frequencyPairToTime(const FrequencyDomain& frequencyDomainA,
+                               const FrequencyDomain& frequencyDomainB,
+                               float*& outA, float*& outB, size_t& outSize) {
+  const int N = this->numSamples;
+  float* z = this->getPairInput();
+
+  // Z[k] = A[k] + j * B[k] over the full spectrum. The upper half follows from
+  // the conjugate symmetry of real signals:
+  // Z[N-k] = conj(A[k]) + j * conj(B[k]). The extra 1 / N of frequencyToTime
+  // is applied here, on top of the 1 / N of the inverse transform, so both
+  // paths give the same 1 / N^2 scale without a pass over the output.
+  const int lastIdx =
+      std::min<int>({frequencyDomainA.N, frequencyDomainB.N, N / 2 + 1}) - 1;
+  const float* aRe = frequencyDomainA.real;
+  const float* aIm = frequencyDomainA.img;
+  const float* bRe = frequencyDomainB.real;
+  const float* bIm = frequencyDomainB.img;
+  const float scale = 1.0f / N;
+
+  z[0] = aRe[0] * scale;
+  z[1] = bRe[0] * scale;
+  for (int k = 1; k < lastIdx; k++) {
+    z[2 * k] = (aRe[k] - bIm[k]) * scale;
+    z[2 * k + 1] = (aIm[k] + bRe[k]) * scale;
+    z[2 * (N - k)] = (aRe[k] + bIm[k]) * scale;
+    z[2 * (N - k) + 1] = (bRe[k] - aIm[k]) * scale;
+  }
+  z[N] = aRe[lastIdx] * scale;
+  z[N + 1] = bRe[lastIdx] * scale;
+
+  this->pairInputToTime(outA, outB, outSize);
+}
+
+float* IFFT::getPairInput() {
+  return pairBuffer.data();
+}
+
+void IFFT::pairInputToTime(float*& outA, float*& outB, size_t& outSize) {
+  float* z = this->getPairInput();
+
+  this->complexInverse(z);
+
+  // De-interleave. The input buffer of the real transform is free and holds
+  // the second signal.
+  for (int i = 0; i < this->numSamples; i++) {
+    out[i] = z[2 * i];
+    in[i] = z[2 * i + 1];
+  }
+
+  outA = out.data();
+  outB = in.data();
+  outSize = this->numSamples;
 }
 
 void IFFT::insertSignal(const FrequencyDomain& frequencyDomain) {
@@ -53,10 +108,13 @@ void IFFT::insertSignal(const FrequencyDomain& frequencyDomain) {
   // Reference:
   // https://arm-software.github.io/CMSIS-DSP/main/group__RealFFT.html
 
+  // The number of bins is bounded by the transform size so that a frequency
+  // domain sized for a larger FFT does not overrun the instance buffer.
+  const int lastIdx = std::min<int>(frequencyDomain.N, numSamples / 2 + 1) - 1;
   in[0] = frequencyDomain.real[0];
-  in[1] = frequencyDomain.real[frequencyDomain.N - 1];
+  in[1] = frequencyDomain.real[lastIdx];
 
-  for (int i = 1; i < frequencyDomain.N - 1; i++) {
+  for (int i = 1; i < lastIdx; i++) {
     in[i * 2] = frequencyDomain.real[i];
     in[i * 2 + 1] = frequencyDomain.img[i];
   }
@@ -21,6 +21,12 @@
 #include "frequencyDomain.h"
 #include "logging.hpp"
 
+#ifdef HOST_NATIVE_FFT
+#include "hostFft.h"
+#else
+#include "cmsisCfft.h"
+#endif
+
 /** @brief Inverse Fast Fourier Transform (IFFT) class. */
 class IFFT {
  public:
@@ -39,25 +45,108 @@ class IFFT {
   ~IFFT();
 
   /**
-   * @brief Converts input frequency to the time domain.
+   * @brief Converts input frequency to the time domain. The output is the
+   * inverse DFT scaled by 1 / numSamples^2: the inverse transform scales by
+   * 1 / numSamples and scaleOutput() divides by numSamples again. Existing
+   * callers and tests are calibrated to that scale, so it is kept.
    *
    * @param frequency Frequency.
    * @param outSize The number of frequencies after IFFT.
-   * @return  The signal represented in the frequency domain.
+   * @return  The signal represented in the time domain. The memory is owned by
+   * this instance and is valid until the next call.
    */
   float* frequencyToTime(const FrequencyDomain& frequencyDomain,
                          size_t& outSize);
 
+  /**
+   * @brief Converts two frequency domains of real signals to the time domain
+   * with one complex inverse FFT. The first spectrum becomes the real part and
+   * the second the imaginary part of the complex time signal. Both outputs
+   * have the 1 / numSamples^2 scale of frequencyToTime(): the spectrum is
+   * written scaled by 1 / numSamples and the complex inverse scales by
+   * 1 / numSamples again.
+   *
+   * @param frequencyDomainA Frequency of the first signal.
+   * @param frequencyDomainB Frequency of the second signal.
+   * @param [out] outA The first signal in the time domain.
+   * @param [out] outB The second signal in the time domain.
+   * @param outSize The number of samples of each signal after IFFT. The
+   * memory of both signals is owned by this instance and is valid until the
+   * next call.
+   */
+  void frequencyPairToTime(const FrequencyDomain& frequencyDomainA,
+                           const FrequencyDomain& frequencyDomainB,
+                           float*& outA, float*& outB, size_t& outSize);
+
+  /**
+   * @brief Get the input of a paired transform so that callers can write the
+   * spectrum Z[k] = A[k] + j * B[k] directly, without building frequency
+   * domains first.
+   *
+   * @return float* Interleaved real and imaginary values of all numSamples
+   * bins. The memory is owned by this instance.
+   */
+  float* getPairInput();
+
+  /**
+   * @brief Converts the spectrum written to getPairInput() to the time domain.
+   * The only scaling is the 1 / numSamples of the complex inverse transform,
+   * so an unscaled spectrum gives the inverse DFT, unlike frequencyToTime().
+   *
+   * @param [out] outA The real part of the complex time signal.
+   * @param [out] outB The imaginary part of the complex time signal.
+   * @param outSize The number of samples of each signal after IFFT. The
+   * memory of both signals is owned by this instance and is valid until the
+   * next call.
+   */
+  void pairInputToTime(float*& outA, float*& outB, size_t& outSize);
+
  private:
-  /** @brief Initializes FFT instance from CMSIS-DSP lib. */
+  /** @brief Initializes FFT instance from CMSIS-DSP lib, or the native host
+   * backend when HOST_NATIVE_FFT is defined. */
   inline void initializeFFTInstance() {
+#ifdef HOST_NATIVE_FFT
+    this->hostFft = HostFFT(this->numSamples);
+#else
     arm_status status =
         arm_rfft_fast_init_f32(&rfft_instance, this->numSamples);
+    if (status == arm_status::ARM_MATH_SUCCESS) {
+      status = initializeCfftInstance(&cfft_instance, this->numSamples);
+    }
 
     if (status != arm_status::ARM_MATH_SUCCESS) {
       ERROR("Error in initializing CMSIS DSP FFT. Error status code %d",
             status);
     }
+#endif
+  }
+
+  /** @brief Inverse real FFT of the packed input buffer into the output
+   * buffer. */
+  inline void realInverse() {
+#ifdef HOST_NATIVE_FFT
+    this->hostFft.rfft(in.data(), out.data(), true);
+#else
+    uint8_t ARM_RFFT_FAST_FORWARD = 1U;  // Discrete Inverse Fourier Transform.
+    arm_rfft_fast_f32(&rfft_instance, in.data(), out.data(),
+                      ARM_RFFT_FAST_FORWARD);
+#endif
+  }
+
+  /**
+   * @brief In-place inverse complex FFT of numSamples points, scaled by
+   * 1 / numSamples.
+   *
+   * @param data Interleaved complex values.
+   */
+  inline void complexInverse(float32_t* data) {
+#ifdef HOST_NATIVE_FFT
+    this->hostFft.cfft(data, true);
+#else
+    uint8_t ARM_CFFT_INVERSE = 1U;      // Discrete Inverse Fourier Transform.
+    uint8_t ARM_CFFT_BIT_REVERSE = 1U;  // Output in natural order.
+    arm_cfft_f32(&cfft_instance, data, ARM_CFFT_INVERSE, ARM_CFFT_BIT_REVERSE);
+#endif
   }
 
   /**
@@ -67,18 +156,33 @@ class IFFT {
    */
   void insertSignal(const FrequencyDomain& frequencyDomain);
 
-  /** Scale the output time domain signal since CMSIS does not do it. */
+  /** @brief Divide the output by numSamples. The inverse transform already
+   * scales by 1 / numSamples, so this is the second factor of the
+   * 1 / numSamples^2 scale of frequencyToTime(). */
   void scaleOutput();
 
   /** @brief The number of time samples after IFFT.*/
   uint16_t numSamples{0U};
 
-  /** @brief input frequency. This memory is statically allocated. */
-  static float32_t in[FFT_BUFFER_SIZE_IN];
+  /** @brief input frequency. Owned by this instance so that independent
+   * instances can transform concurrently. */
+  std::vector<float32_t> in;
 
-  /** @brief output signal. This memory is statically allocated. */
-  static float32_t out[FFT_BUFFER_SIZE_OUT];
+  /** @brief output signal. Owned by this instance. */
+  std::vector<float32_t> out;
 
+  /** @brief Interleaved complex input and output of a paired transform.
+   * Sized at construction so that no transform allocates. */
+  std::vector<float32_t> pairBuffer;
+
+#ifdef HOST_NATIVE_FFT
+  /** @brief Native host FFT backend. */
+  HostFFT hostFft;
+#else
   /** @brief Real FFT instance for using CMSIS DSP library */
   arm_rfft_fast_instance_f32 rfft_instance;
+
+  /** @brief Complex FFT instance of numSamples points for paired transforms. */
+  arm_cfft_instance_f32 cfft_instance;
+#endif
 };
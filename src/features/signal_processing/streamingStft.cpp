@@ -0,0 +1,73 @@
+/**
+ ******************************************************************************
+ * @file    streamingStft.cpp
+ * @brief   Streaming Short-Time Fourier Transform (STFT) source code.
+ ******************************************************************************
+ */
+
+#include "streamingStft.h"
+
+#include "logging.hpp"
+
+StreamingSTFT::StreamingSTFT(uint16_t frameSize, uint16_t hopSize,
+                             size_t numChannels, int sampleFrequency)
+    : frameSize(frameSize),
+      hopSize(hopSize),
+      numChannels(numChannels),
+      history(numChannels * 2 * frameSize, 0.0f),
+      samplesUntilFrame(frameSize),
+      fft(frameSize, sampleFrequency) {
+  if (hopSize == 0 || hopSize > frameSize) {
+    WARN("STFT hop size %u out of range. Using the frame size.", hopSize);
+    this->hopSize = frameSize;
+  }
+}
+
+float* StreamingSTFT::frame(size_t channel) {
+  return &this->history[channel * 2 * this->frameSize + this->writePos];
+}
+
+void StreamingSTFT::transform(FrequencyDomain* const* outFreqs,
+                              WindowFunction windowFunction, uint8_t fields) {
+  const float* frames[FFT_MAX_CHANNELS];
+
+  for (size_t first = 0; first < this->numChannels;
+       first += FFT_MAX_CHANNELS) {
+    const size_t groupSize =
+        std::min(this->numChannels - first, FFT_MAX_CHANNELS);
+    for (size_t c = 0; c < groupSize; c++) {
+      frames[c] = this->frame(first + c);
+    }
+
+    this->fft.signalsToFrequency(frames, groupSize, &outFreqs[first],
+                                 windowFunction, fields);
+  }
+}
+
+void StreamingSTFT::reset() {
+  std::fill(this->history.begin(), this->history.end(), 0.0f);
+  this->writePos = 0;
+  this->samplesUntilFrame = this->frameSize;
+  this->framesEmitted = 0;
+}
+
+void StreamingSTFT::write(const float* const* channels, size_t offset,
+                          size_t count) {
+  // Split at the end of the ring so each part is a contiguous copy.
+  const size_t first = std::min(count, this->frameSize - this->writePos);
+  const size_t second = count - first;
+
+  for (size_t c = 0; c < this->numChannels; c++) {
+    float* ring = &this->history[c * 2 * this->frameSize];
+    const float* src = channels[c] + offset;
+
+    // Store each sample twice so [writePos, writePos + frameSize) is always
+    // the latest frame.
+    std::copy(src, src + first, ring + this->writePos);
+    std::copy(src, src + first, ring + this->writePos + this->frameSize);
+    std::copy(src + first, src + first + second, ring);
+    std::copy(src + first, src + first + second, ring + this->frameSize);
+  }
+
+  this->writePos = (this->writePos + count) % this->frameSize;
+}
@@ -0,0 +1,145 @@
+/**
+ ******************************************************************************
+ * @file    streamingStft.h
+ * @brief   Streaming Short-Time Fourier Transform (STFT) header.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "constants.h"
+#include "fft.h"
+#include "frequencyDomain.h"
+#include "window.hpp"
+
+/**
+ * @brief Streaming STFT stage. Samples of several synchronized channels are
+ * pushed in blocks of any size and a frame of the latest frameSize samples is
+ * emitted every hopSize samples.
+ *
+ * History is kept in a mirrored ring buffer: every sample is stored at its
+ * ring position and again frameSize samples later, so the latest frame is
+ * always contiguous in memory and no history is shifted or copied when a
+ * frame is emitted.
+ */
+class StreamingSTFT {
+ public:
+  /**
+   * @brief Construct a new StreamingSTFT object.
+   *
+   * @param frameSize The number of samples in a frame. Must be a supported FFT
+   * size.
+   * @param hopSize The number of new samples between two frames. In range
+   * [1, frameSize].
+   * @param numChannels The number of synchronized input channels.
+   * @param sampleFrequency The sample frequency of the inputs (Hz).
+   */
+  StreamingSTFT(uint16_t frameSize, uint16_t hopSize, size_t numChannels,
+                int sampleFrequency = SAMPLE_FREQUENCY);
+
+  /**
+   * @brief Push new samples of every channel. The frame handler is called
+   * once for each frame completed by the samples, while the frame is the
+   * latest one in the history.
+   *
+   * @param channels Array of numChannels input blocks.
+   * @param numSamples The number of samples in each input block.
+   * @param onFrame Callable taking a StreamingSTFT& invoked for each frame.
+   * @return size_t The number of frames emitted.
+   */
+  template <typename FrameHandler>
+  size_t push(const float* const* channels, size_t numSamples,
+              FrameHandler&& onFrame) {
+    size_t numFrames = 0;
+    size_t pos = 0;
+
+    while (pos < numSamples) {
+      const size_t count = std::min(numSamples - pos, this->samplesUntilFrame);
+      this->write(channels, pos, count);
+      pos += count;
+      this->samplesUntilFrame -= count;
+
+      if (this->samplesUntilFrame == 0) {
+        this->samplesUntilFrame = this->hopSize;
+        this->framesEmitted++;
+        numFrames++;
+        onFrame(*this);
+      }
+    }
+
+    return numFrames;
+  }
+
+  /**
+   * @brief Get the latest frame of a channel.
+   *
+   * @param channel Channel index.
+   * @return float* frameSize contiguous samples, oldest first. Valid until the
+   * next push.
+   */
+  float* frame(size_t channel);
+
+  /**
+   * @brief Transform the latest frame of every channel to the frequency domain
+   * with one batched FFT.
+   *
+   * @param [out] outFreqs Array of numChannels frequency domain structs.
+   * @param windowFunction The window applied to each frame.
+   * @param fields The @ref SpectrumField flags of the output fields to
+   * populate.
+   */
+  void transform(FrequencyDomain* const* outFreqs,
+                 WindowFunction windowFunction = WindowFunction::HANN_WINDOW,
+                 uint8_t fields = SPECTRUM_ALL);
+
+  /** @brief Clears the history so the next frame needs a full frameSize. */
+  void reset();
+
+  /** @brief Get the number of samples in a frame. */
+  uint16_t getFrameSize() const { return this->frameSize; }
+
+  /** @brief Get the number of new samples between two frames. */
+  uint16_t getHopSize() const { return this->hopSize; }
+
+  /** @brief Get the number of frames emitted since construction or reset. */
+  size_t getFramesEmitted() const { return this->framesEmitted; }
+
+ private:
+  /**
+   * @brief Write samples of every channel into the mirrored ring buffer.
+   *
+   * @param channels Array of numChannels input blocks.
+   * @param offset Index of the first sample to write in each block.
+   * @param count The number of samples to write. At most frameSize.
+   */
+  void write(const float* const* channels, size_t offset, size_t count);
+
+  /** @brief The number of samples in a frame. */
+  uint16_t frameSize;
+
+  /** @brief The number of new samples between two frames. */
+  uint16_t hopSize;
+
+  /** @brief The number of synchronized input channels. */
+  size_t numChannels;
+
+  /** @brief Mirrored ring buffer of 2 * frameSize samples per channel. */
+  std::vector<float> history;
+
+  /** @brief Ring position of the next sample, in range [0, frameSize). */
+  size_t writePos{0};
+
+  /** @brief Samples to push before the next frame is emitted. */
+  size_t samplesUntilFrame;
+
+  /** @brief Frames emitted since construction or reset. */
+  size_t framesEmitted{0};
+
+  /** @brief Fast Fourier Transform (FFT) instance. */
+  FFT fft;
+};
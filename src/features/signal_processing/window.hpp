@@ -7,10 +7,18 @@
 
 #pragma once
 
+#include <cmath>
+
 #include "constants.h"
 
 /** @brief Enum for representing the available window functions. */
-enum class WindowFunction { NONE, HANN_WINDOW };
+enum class WindowFunction {
+  NONE,
+  HANN_WINDOW,
+  HAMMING_WINDOW,
+  BLACKMAN_HARRIS_WINDOW,
+  SQRT_HANN_WINDOW
+};
 
 /** @brief Abstract class for windowing functions. */
 template <typename T>
@@ -19,22 +27,66 @@ class Window {
   /** @brief Destroy the Window object */
   virtual ~Window() = default;
 
+  /**
+   * @brief Computes a single window coefficient.
+   *
+   * @param i Sample index in range [0, size).
+   * @param size The number of samples in the window.
+   * @return T The window coefficient at sample @ref i.
+   */
+  virtual T coefficient(size_t i, uint32_t size) const = 0;
+
   /**
    * @brief Applies a windowing function for the input signal. function applied
    * directly on input.
    *
    * @param signal signal to apply window function on.
    */
-  virtual void applyWindow(T* signal, uint32_t size) = 0;
+  void applyWindow(T* signal, uint32_t size) const {
+    for (size_t i = 0; i < size; i++) {
+      signal[i] *= this->coefficient(i, size);
+    }
+  }
 };
 
+/** @brief Hann window. w[n] = sin^2(pi * n / (N - 1)). */
 template <typename T>
 class HannWindow : public Window<T> {
  public:
-  void applyWindow(T* signal, uint32_t size) override {
-    for (size_t i = 0; i < size; i++) {
-      T w = static_cast<T>(std::pow(std::sin(PI_32 * i / (size - 1.0f)), 2.0));
-      signal[i] *= w;
-    }
+  T coefficient(size_t i, uint32_t size) const override {
+    return static_cast<T>(std::pow(std::sin(PI_32 * i / (size - 1.0f)), 2.0));
+  }
+};
+
+/** @brief Hamming window. w[n] = 0.54 - 0.46 * cos(2 * pi * n / (N - 1)). */
+template <typename T>
+class HammingWindow : public Window<T> {
+ public:
+  T coefficient(size_t i, uint32_t size) const override {
+    return static_cast<T>(0.54 - 0.46 * std::cos(TWO_PI_32 * i / (size - 1.0)));
+  }
+};
+
+/** @brief 4-term Blackman-Harris window (-92 dB side lobes). */
+template <typename T>
+class BlackmanHarrisWindow : public Window<T> {
+ public:
+  T coefficient(size_t i, uint32_t size) const override {
+    const double x = TWO_PI_32 * i / (size - 1.0);
+    return static_cast<T>(0.35875 - 0.48829 * std::cos(x) +
+                          0.14128 * std::cos(2.0 * x) -
+                          0.01168 * std::cos(3.0 * x));
+  }
+};
+
+/**
+ * @brief Square root Hann window. w[n] = sin(pi * n / (N - 1)). Applying it on
+ * both analysis and synthesis gives a Hann window overall.
+ */
+template <typename T>
+class SqrtHannWindow : public Window<T> {
+ public:
+  T coefficient(size_t i, uint32_t size) const override {
+    return static_cast<T>(std::sin(PI_32 * i / (size - 1.0f)));
   }
 };
@@ -0,0 +1,156 @@
+/**
+ ******************************************************************************
+ * @file    windowTable.cpp
+ * @brief   Precomputed window function tables source code.
+ ******************************************************************************
+ */
+
+#include "windowTable.h"
+
+#include <array>
+
+#ifndef STM_BUILD
+#include <mutex>
+#endif
+
+#include "logging.hpp"
+
+/** @brief Cached tables. This memory is declared in windowTable.h. */
+WindowTable::Entry WindowTable::entries[WINDOW_TABLE_CAPACITY] = {};
+
+std::atomic<size_t> WindowTable::numEntries{0};
+
+#ifndef STM_BUILD
+/** @brief Serializes table generation when transforms run on several host
+ * threads. The firmware runs the pipeline from a single context. */
+static std::mutex cacheMutex;
+#endif
+
+/**
+ * @brief Evaluate sin(x) at compile time, where std::sin is not constexpr.
+ *
+ * @param x Angle in [0, pi] (rad).
+ * @return double sin(x), to double precision.
+ */
+static constexpr double constexprSin(double x) {
+  // sin(x) = sin(pi - x) keeps the series within [0, pi / 2], where 12 terms
+  // converge to double precision.
+  if (x > PI_64 / 2.0) {
+    x = PI_64 - x;
+  }
+  double term = x;
+  double sum = x;
+  for (int n = 1; n < 12; n++) {
+    term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+    sum += term;
+  }
+  return sum;
+}
+
+/**
+ * @brief Build a Hann window table at compile time.
+ *
+ * @tparam N The number of samples in the window.
+ * @return std::array<float, N> The coefficients sin^2(pi * n / (N - 1)).
+ */
+template <size_t N>
+static constexpr std::array<float, N> makeHannTable() {
+  std::array<float, N> table{};
+  for (size_t i = 0; i < N; i++) {
+    const double s = constexprSin(PI_64 * i / (N - 1.0));
+    table[i] = static_cast<float>(s * s);
+  }
+  return table;
+}
+
+/** @brief Hann window of DOA_SAMPLES, applied to every DoA and classification
+ * frame of the runtime. Built by the compiler, so it is stored in flash. */
+static constexpr std::array<float, DOA_SAMPLES> HANN_DOA_TABLE =
+    makeHannTable<DOA_SAMPLES>();
+
+/**
+ * @brief Evaluate every coefficient of a window into a table.
+ *
+ * @param window Window function.
+ * @param size The number of samples in the window.
+ * @param [out] table Table of at least @ref size elements.
+ */
+static void fillTable(const Window<float>& window, uint16_t size,
+                      float* table) {
+  for (size_t i = 0; i < size; i++) {
+    table[i] = window.coefficient(i, size);
+  }
+}
+
+const float* WindowTable::get(WindowFunction windowFunction, uint16_t size) {
+  if (windowFunction == WindowFunction::NONE || size > FFT_BUFFER_SIZE_IN) {
+    return nullptr;
+  }
+  if (windowFunction == WindowFunction::HANN_WINDOW && size == DOA_SAMPLES) {
+    return HANN_DOA_TABLE.data();
+  }
+
+  const float* table = find(windowFunction, size,
+                            numEntries.load(std::memory_order_acquire));
+  if (table != nullptr) {
+    return table;
+  }
+
+#ifndef STM_BUILD
+  std::lock_guard<std::mutex> lock(cacheMutex);
+#endif
+
+  // Another thread may have generated the table while this one waited.
+  const size_t count = numEntries.load(std::memory_order_relaxed);
+  table = find(windowFunction, size, count);
+  if (table != nullptr) {
+    return table;
+  }
+
+  if (count >= WINDOW_TABLE_CAPACITY) {
+    WARN("Window table cache is full. Window computed on the fly.");
+    return nullptr;
+  }
+
+  Entry& entry = entries[count];
+  if (!generate(windowFunction, size, entry.coefficients)) {
+    return nullptr;
+  }
+
+  entry.windowFunction = windowFunction;
+  entry.size = size;
+  numEntries.store(count + 1, std::memory_order_release);
+
+  return entry.coefficients;
+}
+
+const float* WindowTable::find(WindowFunction windowFunction, uint16_t size,
+                               size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    if (entries[i].windowFunction == windowFunction &&
+        entries[i].size == size) {
+      return entries[i].coefficients;
+    }
+  }
+  return nullptr;
+}
+
+bool WindowTable::generate(WindowFunction windowFunction, uint16_t size,
+                           float* table) {
+  switch (windowFunction) {
+    case WindowFunction::HANN_WINDOW:
+      fillTable(HannWindow<float>(), size, table);
+      return true;
+    case WindowFunction::HAMMING_WINDOW:
+      fillTable(HammingWindow<float>(), size, table);
+      return true;
+    case WindowFunction::BLACKMAN_HARRIS_WINDOW:
+      fillTable(BlackmanHarrisWindow<float>(), size, table);
+      return true;
+    case WindowFunction::SQRT_HANN_WINDOW:
+      fillTable(SqrtHannWindow<float>(), size, table);
+      return true;
+    default:
+      return false;
+  }
+}
@@ -0,0 +1,82 @@
+/**
+ ******************************************************************************
+ * @file    windowTable.h
+ * @brief   Precomputed window function tables header.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "constants.h"
+#include "window.hpp"
+
+/**
+ * @brief Cache of precomputed window coefficients, so applying a window costs
+ * one multiply per sample instead of evaluating trigonometric functions.
+ *
+ * The Hann window of DOA_SAMPLES, the only window the runtime applies, is a
+ * constant table built at compile time and stored in flash. Other windows are
+ * generated once per (window type, size) pair into static memory. Lookups of
+ * generated tables take no lock; generating one is serialized on host builds
+ * so transforms may run on several threads.
+ */
+class WindowTable {
+ public:
+  /**
+   * @brief Get the precomputed coefficients of a window. Tables other than the
+   * Hann window of DOA_SAMPLES are generated on first request.
+   *
+   * @param windowFunction The type of window.
+   * @param size The number of samples in the window.
+   * @return const float* Table of @ref size coefficients. nullptr if no window
+   * is applied, the size is larger than FFT_BUFFER_SIZE_IN or all
+   * WINDOW_TABLE_CAPACITY tables are in use.
+   */
+  static const float* get(WindowFunction windowFunction, uint16_t size);
+
+  /**
+   * @brief Compute window coefficients into a caller provided table.
+   *
+   * @param windowFunction The type of window.
+   * @param size The number of samples in the window.
+   * @param [out] table Table of at least @ref size elements.
+   * @return bool True if the window type is supported.
+   */
+  static bool generate(WindowFunction windowFunction, uint16_t size,
+                       float* table);
+
+ private:
+  /**
+   * @brief Find a generated table.
+   *
+   * @param windowFunction The type of window.
+   * @param size The number of samples in the window.
+   * @param count The number of published tables to search.
+   * @return const float* Coefficients, or nullptr if not generated.
+   */
+  static const float* find(WindowFunction windowFunction, uint16_t size,
+                           size_t count);
+
+  /** @brief A single cached window table. */
+  struct Entry {
+    /** @brief The type of window stored. */
+    WindowFunction windowFunction;
+
+    /** @brief The number of valid coefficients. */
+    uint16_t size;
+
+    /** @brief Window coefficients. */
+    float coefficients[FFT_BUFFER_SIZE_IN];
+  };
+
+  /** @brief Cached tables. This memory is statically allocated. */
+  static Entry entries[WINDOW_TABLE_CAPACITY];
+
+  /** @brief The number of tables generated in @ref entries. A table is
+   * complete before it is counted and never changes afterwards. */
+  static std::atomic<size_t> numEntries;
+};
@@ -27,6 +27,10 @@ DMA_HandleTypeDef hdma_sai1_b;
 DMA_HandleTypeDef hdma_sai2_a;
 DMA_HandleTypeDef hdma_sai2_b;
 
+// SAI data size of the microphones in bits, set from the board revision at
+// start-up.
+static uint8_t mic_word_bits = 32;
+
 void init_mic_a1();
 void init_mic_a2();
 void init_mic_b1();
@@ -52,12 +56,12 @@ void embedded_mic_start(embedded_mic_t* mic_handle) {
   }
 }
 
+void embedded_mic_set_word_size(uint8_t word_bits) {
+  mic_word_bits = word_bits;
+}
+
 uint32_t get_mic_config_sai_size() {
-#ifdef PCB_BUILD
-  return SAI_DATASIZE_32;
-#else
-  return SAI_DATASIZE_24;
-#endif
+  return (mic_word_bits == 32) ? SAI_DATASIZE_32 : SAI_DATASIZE_24;
 }
 
 void init_mic_a1() {
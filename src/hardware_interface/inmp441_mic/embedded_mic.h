@@ -59,6 +59,14 @@ typedef struct embedded_mic_t {
   volatile uint8_t full_rx_compl;
 } embedded_mic_t;
 
+/**
+ * @brief Set the SAI data size of the microphones, which depends on the board.
+ * Must be called before embedded_mic_init to take effect.
+ * @param word_bits Data size in bits, 24 or 32.
+ * @return None
+ */
+void embedded_mic_set_word_size(uint8_t word_bits);
+
 /**
  * @brief Initialize all four microphones. This includes
  * SAI setup, synchronization setup and DMA setup.
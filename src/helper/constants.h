@@ -31,21 +31,27 @@ constexpr inline float FLOAT_EPS = std::numeric_limits<float>::epsilon();
 constexpr inline float FLOAT_MAX = std::numeric_limits<float>::max();
 constexpr inline float PI_32 = 3.14159265358979f;
 constexpr inline float TWO_PI_32 = 2.0 * PI_32;
+constexpr inline double PI_64 = 3.14159265358979323846;
 
 // Hardware constants.
+constexpr inline size_t NUM_MICS = 4;
+
+// Mic spacing of each frame revision. The DoA modules take the geometry at
+// construction; the runtime switches to the one of the detected board.
+constexpr inline float PCB_MIC1_2_DISTANCE_m = 0.134f;
+constexpr inline float PCB_MIC2_3_DISTANCE_m = 0.13f;
+constexpr inline float PCB_MIC3_4_DISTANCE_m = 0.134f;
+constexpr inline float PCB_MIC4_1_DISTANCE_m = 0.13f;
+constexpr inline float REV0_MIC1_2_DISTANCE_m = 0.14f;
+constexpr inline float REV0_MIC2_3_DISTANCE_m = 0.127f;
+constexpr inline float REV0_MIC3_4_DISTANCE_m = 0.14f;
+constexpr inline float REV0_MIC4_1_DISTANCE_m = 0.127f;
+
 #ifndef BUILD_TESTS
-#ifdef PCB_BUILD
-constexpr inline float MIC1_2_DISTANCE_m = 0.134f;
-constexpr inline float MIC2_3_DISTANCE_m = 0.13f;
-constexpr inline float MIC3_4_DISTANCE_m = 0.134f;
-constexpr inline float MIC4_1_DISTANCE_m = 0.13f;
-#else
-// Rev 0 build
-constexpr inline float MIC1_2_DISTANCE_m = 0.14f;
-constexpr inline float MIC2_3_DISTANCE_m = 0.127f;
-constexpr inline float MIC3_4_DISTANCE_m = 0.14f;
-constexpr inline float MIC4_1_DISTANCE_m = 0.127f;
-#endif  // PCB_BUILD
+constexpr inline float MIC1_2_DISTANCE_m = PCB_MIC1_2_DISTANCE_m;
+constexpr inline float MIC2_3_DISTANCE_m = PCB_MIC2_3_DISTANCE_m;
+constexpr inline float MIC3_4_DISTANCE_m = PCB_MIC3_4_DISTANCE_m;
+constexpr inline float MIC4_1_DISTANCE_m = PCB_MIC4_1_DISTANCE_m;
 #else
 constexpr inline float MIC1_2_DISTANCE_m = 0.10f;
 constexpr inline float MIC2_3_DISTANCE_m = 0.10f;
@@ -59,6 +65,11 @@ constexpr inline int32_t MIN_AUDIO_SAMPLE_DATA = -8388608;
 // 24 bit maximum: 2^23-1
 constexpr inline int32_t MAX_AUDIO_SAMPLE_DATA = 8388607;
 
+// Full scale of the mic samples DoA reads: 2^23. Rev 0 receives 24 bit SAI
+// words and the PCB shifts its 32 bit words down by 8, so both boards give
+// 24 bit samples.
+constexpr inline float MIC_SAMPLE_FULL_SCALE = 8388608.0f;
+
 constexpr inline uint8_t BLUTOOTH_CONNECTED = 1U;
 
 // Physics constants.
@@ -78,4 +89,16 @@ constexpr inline uint16_t FFT_BUFFER_SIZE_OUT = WAVEFORM_SAMPLES / 2;
 constexpr inline uint16_t FREQ_DOMAIN_SIZE = WAVEFORM_SAMPLES / 2 + 1;
 #else
 constexpr inline uint16_t FREQ_DOMAIN_SIZE = DOA_SAMPLES / 2 + 1;
+#endif
+
+// Maximum number of channels transformed in one FFT batch.
+constexpr inline size_t FFT_MAX_CHANNELS = NUM_MICS;
+
+// Number of precomputed window tables kept in static memory. Each table holds
+// FFT_BUFFER_SIZE_IN coefficients. Runtime only applies the Hann window of
+// DOA_SAMPLES, which is a constant table in flash, so one slot is spare.
+#ifdef BUILD_TESTS
+constexpr inline size_t WINDOW_TABLE_CAPACITY = 16;
+#else
+constexpr inline size_t WINDOW_TABLE_CAPACITY = 1;
 #endif
\ No newline at end of file
@@ -0,0 +1,383 @@
+/**
+ ******************************************************************************
+ * @file    fastmath.cpp
+ * @brief   Block approximations of tanh, log, exp, sqrt and 1 / sqrt source.
+ ******************************************************************************
+ */
+
+#include "fastmath.h"
+
+#ifdef STM_BUILD
+#include "arm_math.h"
+// stm32f767xx include must be first include to use CMSIS library.
+#include "stm32f767xx.h"
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define FASTMATH_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#define FASTMATH_NEON 1
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Block function of one kernel.
+ *
+ * @param input Input values.
+ * @param output Output values. May alias input.
+ * @param numValues Number of values.
+ */
+using BlockKernel = void (*)(const float* input, float* output,
+                             size_t numValues);
+
+/** @brief Block functions of one kernel. */
+struct KernelTable {
+  FastMathKernel kernel;
+  BlockKernel exp;
+  BlockKernel log;
+  BlockKernel tanh;
+  BlockKernel sqrt;
+  BlockKernel rsqrt;
+};
+
+static void expScalar(const float* input, float* output, size_t numValues) {
+  for (size_t i = 0; i < numValues; i++) {
+    output[i] = fastExp(input[i]);
+  }
+}
+
+static void logScalar(const float* input, float* output, size_t numValues) {
+  for (size_t i = 0; i < numValues; i++) {
+    output[i] = fastLog(input[i]);
+  }
+}
+
+static void tanhScalar(const float* input, float* output, size_t numValues) {
+  for (size_t i = 0; i < numValues; i++) {
+    output[i] = fastTanh(input[i]);
+  }
+}
+
+static void sqrtScalar(const float* input, float* output, size_t numValues) {
+  for (size_t i = 0; i < numValues; i++) {
+#ifdef STM_BUILD
+    // Single VSQRT without the errno check of std::sqrt.
+    arm_sqrt_f32(input[i], &output[i]);
+#else
+    output[i] = std::sqrt(input[i]);
+#endif
+  }
+}
+
+static void rsqrtScalar(const float* input, float* output, size_t numValues) {
+  sqrtScalar(input, output, numValues);
+  for (size_t i = 0; i < numValues; i++) {
+    output[i] = 1.0f / output[i];
+  }
+}
+
+#ifdef FASTMATH_X86
+/** @brief Eight values of fastExp(float). */
+__attribute__((target("avx2,fma"))) static inline __m256 expAvx2(__m256 x) {
+  x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(FASTMATH_EXP_MIN_INPUT)),
+                    _mm256_set1_ps(FASTMATH_EXP_MAX_INPUT));
+
+  const __m256 n = _mm256_floor_ps(_mm256_fmadd_ps(
+      x, _mm256_set1_ps(FASTMATH_LOG2E), _mm256_set1_ps(0.5f)));
+  __m256 r = _mm256_fnmadd_ps(n, _mm256_set1_ps(FASTMATH_LN2_HIGH), x);
+  r = _mm256_fnmadd_ps(n, _mm256_set1_ps(FASTMATH_LN2_LOW), r);
+
+  __m256 p = _mm256_set1_ps(FASTMATH_EXP_POLY[0]);
+  for (size_t i = 1; i < 6; i++) {
+    p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(FASTMATH_EXP_POLY[i]));
+  }
+  const __m256 y = _mm256_add_ps(
+      _mm256_fmadd_ps(p, _mm256_mul_ps(r, r), r), _mm256_set1_ps(1.0f));
+
+  const __m256i bits = _mm256_slli_epi32(
+      _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+  return _mm256_mul_ps(y, _mm256_castsi256_ps(bits));
+}
+
+/** @brief Eight values of fastLog(float). */
+__attribute__((target("avx2,fma"))) static inline __m256 logAvx2(__m256 x) {
+  x = _mm256_max_ps(x, _mm256_set1_ps(FLT_MIN));
+
+  const __m256i bits = _mm256_castps_si256(x);
+  __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23),
+                                                 _mm256_set1_epi32(126)));
+  __m256 m = _mm256_castsi256_ps(
+      _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+                      _mm256_set1_epi32(0x3f000000)));
+
+  const __m256 small =
+      _mm256_cmp_ps(m, _mm256_set1_ps(FASTMATH_SQRT_HALF), _CMP_LT_OQ);
+  e = _mm256_sub_ps(e, _mm256_and_ps(small, _mm256_set1_ps(1.0f)));
+  m = _mm256_add_ps(_mm256_sub_ps(m, _mm256_set1_ps(1.0f)),
+                    _mm256_and_ps(small, m));
+
+  const __m256 z = _mm256_mul_ps(m, m);
+  __m256 p = _mm256_set1_ps(FASTMATH_LOG_POLY[0]);
+  for (size_t i = 1; i < 9; i++) {
+    p = _mm256_fmadd_ps(p, m, _mm256_set1_ps(FASTMATH_LOG_POLY[i]));
+  }
+  __m256 y = _mm256_mul_ps(_mm256_mul_ps(p, m), z);
+  y = _mm256_fmadd_ps(e, _mm256_set1_ps(FASTMATH_LN2_LOW), y);
+  y = _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, y);
+  return _mm256_fmadd_ps(e, _mm256_set1_ps(FASTMATH_LN2_HIGH),
+                         _mm256_add_ps(m, y));
+}
+
+/** @brief Eight values of fastTanh(float). */
+__attribute__((target("avx2,fma"))) static inline __m256 tanhAvx2(__m256 x) {
+  const __m256 signMask = _mm256_set1_ps(-0.0f);
+  const __m256 a = _mm256_andnot_ps(signMask, x);
+
+  const __m256 z = _mm256_mul_ps(x, x);
+  __m256 p = _mm256_set1_ps(FASTMATH_TANH_POLY[0]);
+  for (size_t i = 1; i < 5; i++) {
+    p = _mm256_fmadd_ps(p, z, _mm256_set1_ps(FASTMATH_TANH_POLY[i]));
+  }
+  const __m256 polynomial = _mm256_fmadd_ps(_mm256_mul_ps(p, z), x, x);
+
+  const __m256 e = expAvx2(_mm256_mul_ps(
+      _mm256_set1_ps(2.0f),
+      _mm256_min_ps(a, _mm256_set1_ps(FASTMATH_TANH_SATURATION))));
+  const __m256 t = _mm256_sub_ps(
+      _mm256_set1_ps(1.0f),
+      _mm256_div_ps(_mm256_set1_ps(2.0f),
+                    _mm256_add_ps(e, _mm256_set1_ps(1.0f))));
+  const __m256 large = _mm256_or_ps(t, _mm256_and_ps(signMask, x));
+
+  const __m256 usePolynomial = _mm256_cmp_ps(
+      a, _mm256_set1_ps(FASTMATH_TANH_POLYNOMIAL_LIMIT), _CMP_LT_OQ);
+  return _mm256_blendv_ps(large, polynomial, usePolynomial);
+}
+
+/** @brief Eight values of 1 / sqrt(x), estimate refined by one Newton step. */
+__attribute__((target("avx2,fma"))) static inline __m256 rsqrtAvx2(__m256 x) {
+  const __m256 y = _mm256_rsqrt_ps(x);
+  const __m256 halfXyy = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), x),
+                                       _mm256_mul_ps(y, y));
+  return _mm256_mul_ps(y, _mm256_sub_ps(_mm256_set1_ps(1.5f), halfXyy));
+}
+
+/** @brief Apply an AVX2 function to a block, the tail in the scalar kernel. */
+#define FASTMATH_AVX2_BLOCK(name, vectorFunction, scalarKernel)          \
+  __attribute__((target("avx2,fma"))) static void name(                  \
+      const float* input, float* output, size_t numValues) {             \
+    size_t i = 0;                                                        \
+    for (; i + 8 <= numValues; i += 8) {                                 \
+      _mm256_storeu_ps(&output[i],                                       \
+                       vectorFunction(_mm256_loadu_ps(&input[i])));      \
+    }                                                                    \
+    scalarKernel(&input[i], &output[i], numValues - i);                  \
+  }
+
+FASTMATH_AVX2_BLOCK(expBlockAvx2, expAvx2, expScalar)
+FASTMATH_AVX2_BLOCK(logBlockAvx2, logAvx2, logScalar)
+FASTMATH_AVX2_BLOCK(tanhBlockAvx2, tanhAvx2, tanhScalar)
+FASTMATH_AVX2_BLOCK(sqrtBlockAvx2, _mm256_sqrt_ps, sqrtScalar)
+FASTMATH_AVX2_BLOCK(rsqrtBlockAvx2, rsqrtAvx2, rsqrtScalar)
+#endif
+
+#ifdef FASTMATH_NEON
+/** @brief Four values of fastExp(float). */
+static inline float32x4_t expNeon(float32x4_t x) {
+  x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(FASTMATH_EXP_MIN_INPUT)),
+                vdupq_n_f32(FASTMATH_EXP_MAX_INPUT));
+
+  const float32x4_t n = vrndmq_f32(
+      vfmaq_f32(vdupq_n_f32(0.5f), x, vdupq_n_f32(FASTMATH_LOG2E)));
+  float32x4_t r = vfmsq_f32(x, n, vdupq_n_f32(FASTMATH_LN2_HIGH));
+  r = vfmsq_f32(r, n, vdupq_n_f32(FASTMATH_LN2_LOW));
+
+  float32x4_t p = vdupq_n_f32(FASTMATH_EXP_POLY[0]);
+  for (size_t i = 1; i < 6; i++) {
+    p = vfmaq_f32(vdupq_n_f32(FASTMATH_EXP_POLY[i]), p, r);
+  }
+  const float32x4_t y =
+      vaddq_f32(vfmaq_f32(r, p, vmulq_f32(r, r)), vdupq_n_f32(1.0f));
+
+  const int32x4_t bits =
+      vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23);
+  return vmulq_f32(y, vreinterpretq_f32_s32(bits));
+}
+
+/** @brief Four values of fastLog(float). */
+static inline float32x4_t logNeon(float32x4_t x) {
+  x = vmaxq_f32(x, vdupq_n_f32(FLT_MIN));
+
+  const uint32x4_t bits = vreinterpretq_u32_f32(x);
+  float32x4_t e = vcvtq_f32_s32(vsubq_s32(
+      vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(126)));
+  float32x4_t m = vreinterpretq_f32_u32(vorrq_u32(
+      vandq_u32(bits, vdupq_n_u32(0x007fffffU)), vdupq_n_u32(0x3f000000U)));
+
+  const uint32x4_t small = vcltq_f32(m, vdupq_n_f32(FASTMATH_SQRT_HALF));
+  e = vsubq_f32(e, vreinterpretq_f32_u32(vandq_u32(
+                       small, vreinterpretq_u32_f32(vdupq_n_f32(1.0f)))));
+  m = vaddq_f32(vsubq_f32(m, vdupq_n_f32(1.0f)),
+                vreinterpretq_f32_u32(
+                    vandq_u32(small, vreinterpretq_u32_f32(m))));
+
+  const float32x4_t z = vmulq_f32(m, m);
+  float32x4_t p = vdupq_n_f32(FASTMATH_LOG_POLY[0]);
+  for (size_t i = 1; i < 9; i++) {
+    p = vfmaq_f32(vdupq_n_f32(FASTMATH_LOG_POLY[i]), p, m);
+  }
+  float32x4_t y = vmulq_f32(vmulq_f32(p, m), z);
+  y = vfmaq_f32(y, e, vdupq_n_f32(FASTMATH_LN2_LOW));
+  y = vfmsq_f32(y, vdupq_n_f32(0.5f), z);
+  return vfmaq_f32(vaddq_f32(m, y), e, vdupq_n_f32(FASTMATH_LN2_HIGH));
+}
+
+/** @brief Four values of fastTanh(float). */
+static inline float32x4_t tanhNeon(float32x4_t x) {
+  const float32x4_t a = vabsq_f32(x);
+
+  const float32x4_t z = vmulq_f32(x, x);
+  float32x4_t p = vdupq_n_f32(FASTMATH_TANH_POLY[0]);
+  for (size_t i = 1; i < 5; i++) {
+    p = vfmaq_f32(vdupq_n_f32(FASTMATH_TANH_POLY[i]), p, z);
+  }
+  const float32x4_t polynomial = vfmaq_f32(x, vmulq_f32(p, z), x);
+
+  const float32x4_t e = expNeon(vmulq_f32(
+      vdupq_n_f32(2.0f), vminq_f32(a, vdupq_n_f32(FASTMATH_TANH_SATURATION))));
+  const float32x4_t t =
+      vsubq_f32(vdupq_n_f32(1.0f),
+                vdivq_f32(vdupq_n_f32(2.0f), vaddq_f32(e, vdupq_n_f32(1.0f))));
+  // Copy the sign of x onto t.
+  const uint32x4_t signMask = vdupq_n_u32(0x80000000U);
+  const float32x4_t large = vbslq_f32(signMask, x, t);
+
+  const uint32x4_t usePolynomial =
+      vcltq_f32(a, vdupq_n_f32(FASTMATH_TANH_POLYNOMIAL_LIMIT));
+  return vbslq_f32(usePolynomial, polynomial, large);
+}
+
+/** @brief Four values of 1 / sqrt(x), estimate refined by two Newton steps. */
+static inline float32x4_t rsqrtNeon(float32x4_t x) {
+  float32x4_t y = vrsqrteq_f32(x);
+  y = vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(x, y), y));
+  return vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(x, y), y));
+}
+
+/** @brief Apply a NEON function to a block, the tail in the scalar kernel. */
+#define FASTMATH_NEON_BLOCK(name, vectorFunction, scalarKernel)          \
+  static void name(const float* input, float* output, size_t numValues) { \
+    size_t i = 0;                                                        \
+    for (; i + 4 <= numValues; i += 4) {                                 \
+      vst1q_f32(&output[i], vectorFunction(vld1q_f32(&input[i])));       \
+    }                                                                    \
+    scalarKernel(&input[i], &output[i], numValues - i);                  \
+  }
+
+FASTMATH_NEON_BLOCK(expBlockNeon, expNeon, expScalar)
+FASTMATH_NEON_BLOCK(logBlockNeon, logNeon, logScalar)
+FASTMATH_NEON_BLOCK(tanhBlockNeon, tanhNeon, tanhScalar)
+FASTMATH_NEON_BLOCK(sqrtBlockNeon, vsqrtq_f32, sqrtScalar)
+FASTMATH_NEON_BLOCK(rsqrtBlockNeon, rsqrtNeon, rsqrtScalar)
+#endif
+
+/**
+ * @brief Get the block functions of a kernel.
+ *
+ * @param kernel Kernel. Falls back to AUTO if the CPU does not support it.
+ * @return KernelTable The block functions.
+ */
+static KernelTable makeKernelTable(FastMathKernel kernel) {
+  if (kernel == FastMathKernel::AUTO || !isFastMathKernelSupported(kernel)) {
+    kernel = isFastMathKernelSupported(FastMathKernel::AVX2)
+                 ? FastMathKernel::AVX2
+             : isFastMathKernelSupported(FastMathKernel::NEON)
+                 ? FastMathKernel::NEON
+                 : FastMathKernel::SCALAR;
+  }
+
+  switch (kernel) {
+#ifdef FASTMATH_X86
+    case FastMathKernel::AVX2:
+      return {kernel,        expBlockAvx2,   logBlockAvx2,
+              tanhBlockAvx2, sqrtBlockAvx2, rsqrtBlockAvx2};
+#endif
+#ifdef FASTMATH_NEON
+    case FastMathKernel::NEON:
+      return {kernel,        expBlockNeon,   logBlockNeon,
+              tanhBlockNeon, sqrtBlockNeon, rsqrtBlockNeon};
+#endif
+    default:
+      return {FastMathKernel::SCALAR, expScalar, logScalar, tanhScalar,
+              sqrtScalar, rsqrtScalar};
+  }
+}
+
+/** @brief Block functions in use, the best supported kernel by default. */
+static KernelTable& activeKernels() {
+  static KernelTable table = makeKernelTable(FastMathKernel::AUTO);
+  return table;
+}
+
+FastMathKernel setFastMathKernel(FastMathKernel kernel) {
+  activeKernels() = makeKernelTable(kernel);
+  return activeKernels().kernel;
+}
+
+FastMathKernel getFastMathKernel() { return activeKernels().kernel; }
+
+bool isFastMathKernelSupported(FastMathKernel kernel) {
+  switch (kernel) {
+    case FastMathKernel::AUTO:
+    case FastMathKernel::SCALAR:
+      return true;
+#ifdef FASTMATH_X86
+    case FastMathKernel::AVX2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+#ifdef FASTMATH_NEON
+    case FastMathKernel::NEON:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+const char* fastMathKernelName(FastMathKernel kernel) {
+  switch (kernel) {
+    case FastMathKernel::AUTO:
+      return "auto";
+    case FastMathKernel::SCALAR:
+      return "scalar";
+    case FastMathKernel::AVX2:
+      return "avx2";
+    case FastMathKernel::NEON:
+      return "neon";
+    default:
+      return "unknown";
+  }
+}
+
+void fastExp(const float* input, float* output, size_t numValues) {
+  activeKernels().exp(input, output, numValues);
+}
+
+void fastLog(const float* input, float* output, size_t numValues) {
+  activeKernels().log(input, output, numValues);
+}
+
+void fastTanh(const float* input, float* output, size_t numValues) {
+  activeKernels().tanh(input, output, numValues);
+}
+
+void fastSqrt(const float* input, float* output, size_t numValues) {
+  activeKernels().sqrt(input, output, numValues);
+}
+
+void fastRsqrt(const float* input, float* output, size_t numValues) {
+  activeKernels().rsqrt(input, output, numValues);
+}
@@ -0,0 +1,280 @@
+/**
+ ******************************************************************************
+ * @file    fastmath.h
+ * @brief   Block approximations of tanh, log, exp, sqrt and 1 / sqrt for the
+ *          hot DSP loops, with scalar, AVX2 and NEON kernels, and a scalar
+ *          atan2.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/** @brief Kernels of the block functions. */
+enum class FastMathKernel {
+  AUTO,    // Best kernel supported by the CPU, chosen at runtime.
+  SCALAR,  // Portable C++. Compiles to VFMA and VSQRT on the Cortex-M7.
+  AVX2,    // Eight values per 256 bit vector, with FMA.
+  NEON,    // Four values per 128 bit vector, AArch64 only.
+};
+
+/** @brief Largest relative error of fastExp. */
+constexpr inline float FASTMATH_EXP_MAX_REL_ERROR = 3e-7f;
+
+/** @brief Largest error of fastLog, absolute near 1 and relative elsewhere. */
+constexpr inline float FASTMATH_LOG_MAX_ABS_ERROR = 2e-7f;
+constexpr inline float FASTMATH_LOG_MAX_REL_ERROR = 3e-7f;
+
+/** @brief Largest absolute error of fastTanh. */
+constexpr inline float FASTMATH_TANH_MAX_ABS_ERROR = 5e-7f;
+
+/** @brief Largest absolute error (rad) of fastAtan2. */
+constexpr inline float FASTMATH_ATAN2_MAX_ABS_ERROR = 5e-7f;
+
+/** @brief Largest relative error of fastRsqrt. fastSqrt is exact. */
+constexpr inline float FASTMATH_RSQRT_MAX_REL_ERROR = 1e-6f;
+
+/** @brief Inputs of fastExp are clamped to this range, so that the result is
+ * a normal float. */
+constexpr inline float FASTMATH_EXP_MIN_INPUT = -87.3f;
+constexpr inline float FASTMATH_EXP_MAX_INPUT = 88.0f;
+
+/** @brief Above this magnitude fastTanh is +-1 to float precision. */
+constexpr inline float FASTMATH_TANH_SATURATION = 9.0f;
+
+/** @brief Below this magnitude fastTanh uses its odd polynomial. */
+constexpr inline float FASTMATH_TANH_POLYNOMIAL_LIMIT = 0.625f;
+
+// Range reduction and polynomial coefficients of the Cephes single precision
+// expf, logf and tanhf.
+constexpr inline float FASTMATH_LOG2E = 1.44269504088896341f;
+constexpr inline float FASTMATH_LN2_HIGH = 0.693359375f;
+constexpr inline float FASTMATH_LN2_LOW = -2.12194440e-4f;
+constexpr inline float FASTMATH_SQRT_HALF = 0.707106781186547524f;
+constexpr inline float FASTMATH_EXP_POLY[6] = {
+    1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f,
+    4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f};
+constexpr inline float FASTMATH_LOG_POLY[9] = {
+    7.0376836292e-2f,  -1.1514610310e-1f, 1.1676998740e-1f,
+    -1.2420140846e-1f, 1.4249322787e-1f,  -1.6668057665e-1f,
+    2.0000714765e-1f,  -2.4999993993e-1f, 3.3333331174e-1f};
+constexpr inline float FASTMATH_TANH_POLY[5] = {
+    -5.70498872745e-3f, 2.06390887954e-2f, -5.37397155531e-2f,
+    1.33314422036e-1f, -3.33332819422e-1f};
+
+// Range reduction and polynomial of the Cephes single precision atanf.
+constexpr inline float FASTMATH_TAN_PI_8 = 0.4142135623730950f;
+constexpr inline float FASTMATH_PI = 3.14159265358979f;
+constexpr inline float FASTMATH_ATAN_POLY[4] = {
+    8.05374449538e-2f, -1.38776856032e-1f, 1.99777106478e-1f,
+    -3.33329491539e-1f};
+
+/**
+ * @brief Approximate e^x. See FASTMATH_EXP_MAX_REL_ERROR.
+ *
+ * @param x Exponent, clamped to [FASTMATH_EXP_MIN_INPUT,
+ * FASTMATH_EXP_MAX_INPUT].
+ * @return float e^x.
+ */
+inline float fastExp(float x) {
+  x = std::min(std::max(x, FASTMATH_EXP_MIN_INPUT), FASTMATH_EXP_MAX_INPUT);
+
+  // e^x = 2^n e^r with |r| <= ln(2) / 2. Floor by truncation, which avoids a
+  // libm call on targets without a rounding instruction.
+  const float t = x * FASTMATH_LOG2E + 0.5f;
+  int32_t exponent = static_cast<int32_t>(t);
+  exponent -= (t < static_cast<float>(exponent)) ? 1 : 0;
+  const float n = static_cast<float>(exponent);
+  float r = x - n * FASTMATH_LN2_HIGH;
+  r = r - n * FASTMATH_LN2_LOW;
+
+  float p = FASTMATH_EXP_POLY[0];
+  for (size_t i = 1; i < 6; i++) {
+    p = p * r + FASTMATH_EXP_POLY[i];
+  }
+  const float y = p * r * r + r + 1.0f;
+
+  const uint32_t bits = static_cast<uint32_t>(exponent + 127) << 23;
+  float scale;
+  std::memcpy(&scale, &bits, sizeof(scale));
+  return y * scale;
+}
+
+/**
+ * @brief Approximate the natural logarithm. See FASTMATH_LOG_MAX_ABS_ERROR.
+ *
+ * @param x Value. Values below FLT_MIN, including 0, are treated as FLT_MIN.
+ * @return float ln(x).
+ */
+inline float fastLog(float x) {
+  x = std::max(x, FLT_MIN);
+
+  // x = 2^e m with m in [sqrt(1/2), sqrt(2)).
+  uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  float e = static_cast<float>(static_cast<int32_t>(bits >> 23) - 126);
+  bits = (bits & 0x007fffffU) | 0x3f000000U;
+  float m;
+  std::memcpy(&m, &bits, sizeof(m));
+  if (m < FASTMATH_SQRT_HALF) {
+    e -= 1.0f;
+    m = m + m - 1.0f;
+  } else {
+    m = m - 1.0f;
+  }
+
+  const float z = m * m;
+  float p = FASTMATH_LOG_POLY[0];
+  for (size_t i = 1; i < 9; i++) {
+    p = p * m + FASTMATH_LOG_POLY[i];
+  }
+  float y = p * m * z;
+  y += e * FASTMATH_LN2_LOW;
+  y -= 0.5f * z;
+  return m + y + e * FASTMATH_LN2_HIGH;
+}
+
+/**
+ * @brief Approximate the hyperbolic tangent. See FASTMATH_TANH_MAX_ABS_ERROR.
+ *
+ * @param x Value.
+ * @return float tanh(x), always in [-1, 1].
+ */
+inline float fastTanh(float x) {
+  const float a = std::fabs(x);
+  if (a < FASTMATH_TANH_POLYNOMIAL_LIMIT) {
+    const float z = x * x;
+    float p = FASTMATH_TANH_POLY[0];
+    for (size_t i = 1; i < 5; i++) {
+      p = p * z + FASTMATH_TANH_POLY[i];
+    }
+    return p * z * x + x;
+  }
+
+  const float t =
+      1.0f - 2.0f / (fastExp(2.0f * std::min(a, FASTMATH_TANH_SATURATION)) +
+                     1.0f);
+  return std::copysign(t, x);
+}
+
+/**
+ * @brief Approximate the angle of the point (x, y). See
+ * FASTMATH_ATAN2_MAX_ABS_ERROR.
+ *
+ * @param y Ordinate.
+ * @param x Abscissa.
+ * @return float Angle in [-pi, pi], 0 at the origin.
+ */
+inline float fastAtan2(float y, float x) {
+  const float ax = std::fabs(x);
+  const float ay = std::fabs(y);
+  if (ax == 0.0f && ay == 0.0f) {
+    return 0.0f;
+  }
+
+  // atan of t = min / max in [0, 1], reduced to |t| <= tan(pi / 8).
+  const float t = std::min(ax, ay) / std::max(ax, ay);
+  float offset = 0.0f;
+  float r = t;
+  if (t > FASTMATH_TAN_PI_8) {
+    offset = FASTMATH_PI / 4.0f;
+    r = (t - 1.0f) / (t + 1.0f);
+  }
+  const float z = r * r;
+  float p = FASTMATH_ATAN_POLY[0];
+  for (size_t i = 1; i < 4; i++) {
+    p = p * z + FASTMATH_ATAN_POLY[i];
+  }
+  float angle = offset + p * z * r + r;
+
+  if (ay > ax) {
+    angle = FASTMATH_PI / 2.0f - angle;
+  }
+  if (x < 0.0f) {
+    angle = FASTMATH_PI - angle;
+  }
+  return std::copysign(angle, y);
+}
+
+/**
+ * @brief Set the kernel of the block functions.
+ *
+ * @param kernel Kernel. Falls back to AUTO if the CPU does not support it.
+ * @return FastMathKernel The kernel in use, never AUTO.
+ */
+FastMathKernel setFastMathKernel(FastMathKernel kernel);
+
+/**
+ * @brief Get the kernel of the block functions.
+ *
+ * @return FastMathKernel Never AUTO.
+ */
+FastMathKernel getFastMathKernel();
+
+/**
+ * @brief Check whether the CPU supports a kernel.
+ *
+ * @param kernel Kernel.
+ * @return true if the kernel can run on this CPU.
+ */
+bool isFastMathKernelSupported(FastMathKernel kernel);
+
+/**
+ * @brief Get the printable name of a kernel.
+ *
+ * @param kernel Kernel.
+ * @return const char* Name of the kernel.
+ */
+const char* fastMathKernelName(FastMathKernel kernel);
+
+/**
+ * @brief Block e^x, see fastExp(float). Output may alias input.
+ *
+ * @param input Exponents.
+ * @param [out] output Results.
+ * @param numValues Number of values.
+ */
+void fastExp(const float* input, float* output, size_t numValues);
+
+/**
+ * @brief Block ln(x), see fastLog(float). Output may alias input.
+ *
+ * @param input Values.
+ * @param [out] output Results.
+ * @param numValues Number of values.
+ */
+void fastLog(const float* input, float* output, size_t numValues);
+
+/**
+ * @brief Block tanh(x), see fastTanh(float). Output may alias input.
+ *
+ * @param input Values.
+ * @param [out] output Results.
+ * @param numValues Number of values.
+ */
+void fastTanh(const float* input, float* output, size_t numValues);
+
+/**
+ * @brief Block square root. Exact on every kernel. Output may alias input.
+ *
+ * @param input Non-negative values.
+ * @param [out] output Results.
+ * @param numValues Number of values.
+ */
+void fastSqrt(const float* input, float* output, size_t numValues);
+
+/**
+ * @brief Block 1 / sqrt(x). See FASTMATH_RSQRT_MAX_REL_ERROR. Output may alias
+ * input.
+ *
+ * @param input Positive normal values.
+ * @param [out] output Results.
+ * @param numValues Number of values.
+ */
+void fastRsqrt(const float* input, float* output, size_t numValues);
@@ -0,0 +1,105 @@
+/**
+ ******************************************************************************
+ * @file    mappedFile.cpp
+ * @brief   Read-only memory-mapped file.
+ ******************************************************************************
+ */
+
+#include "mappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() { this->close(); }
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path) {
+  this->close();
+
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0) {
+    CloseHandle(file);
+    return false;
+  }
+
+  // The view stays valid after both handles are closed.
+  HANDLE mapping =
+      CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    return false;
+  }
+  const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (view == nullptr) {
+    return false;
+  }
+
+  this->data = static_cast<const uint8_t*>(view);
+  this->size = static_cast<size_t>(fileSize.QuadPart);
+  return true;
+}
+
+void MappedFile::close() {
+  if (this->data != nullptr) {
+    UnmapViewOfFile(this->data);
+  }
+  this->data = nullptr;
+  this->size = 0;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path) {
+  this->close();
+
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+
+  // The mapping stays valid after the descriptor is closed.
+  void* mapping = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ,
+                       MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  this->data = static_cast<const uint8_t*>(mapping);
+  this->size = static_cast<size_t>(info.st_size);
+  return true;
+}
+
+void MappedFile::close() {
+  if (this->data != nullptr) {
+    munmap(const_cast<uint8_t*>(this->data), this->size);
+  }
+  this->data = nullptr;
+  this->size = 0;
+}
+
+#endif
@@ -0,0 +1,57 @@
+/**
+ ******************************************************************************
+ * @file    mappedFile.h
+ * @brief   Read-only memory-mapped file, so that model containers are read in
+ *          place on the host (POSIX mmap or Win32 file mappings). Not built
+ *          for the target.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/** @brief Read-only mapping of a whole file, unmapped on destruction. */
+class MappedFile {
+ public:
+  MappedFile() = default;
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /**
+   * @brief Map a file, replacing any previous mapping. The mapping is page
+   * aligned.
+   *
+   * @param path Path of the file.
+   * @return true if the file was mapped.
+   */
+  bool open(const std::string& path);
+
+  /** @brief Unmap the file. */
+  void close();
+
+  /**
+   * @brief Get the start of the mapping.
+   *
+   * @return const uint8_t* The bytes of the file, nullptr if none is mapped.
+   */
+  const uint8_t* getData() const { return this->data; }
+
+  /**
+   * @brief Get the size of the mapping.
+   *
+   * @return size_t Size (bytes) of the file.
+   */
+  size_t getSize() const { return this->size; }
+
+ private:
+  /** @brief Start of the mapping. */
+  const uint8_t* data = nullptr;
+
+  /** @brief Size (bytes) of the mapping. */
+  size_t size = 0;
+};
@@ -0,0 +1,143 @@
+/**
+ ******************************************************************************
+ * @file    modelContainer.cpp
+ * @brief   Validation of the flat binary model container.
+ ******************************************************************************
+ */
+
+#include "modelContainer.h"
+
+/** @brief Reflected polynomial of CRC-32. */
+static constexpr uint32_t CRC32_POLYNOMIAL = 0xEDB88320U;
+
+/**
+ * @brief Size (bytes) of an element of a section.
+ *
+ * @param type ModelSectionType.
+ * @return size_t Element size, 0 for unknown types.
+ */
+static size_t sectionElementSize(uint16_t type) {
+  switch (type) {
+    case MODEL_SECTION_F32:
+      return sizeof(float);
+    default:
+      return 0;
+  }
+}
+
+const char* modelStatusName(ModelStatus status) {
+  switch (status) {
+    case ModelStatus::OK:
+      return "ok";
+    case ModelStatus::TOO_SMALL:
+      return "too small";
+    case ModelStatus::MISALIGNED:
+      return "misaligned";
+    case ModelStatus::BAD_MAGIC:
+      return "bad magic";
+    case ModelStatus::BAD_VERSION:
+      return "bad version";
+    case ModelStatus::BAD_CHECKSUM:
+      return "bad checksum";
+    case ModelStatus::BAD_SECTION:
+      return "bad section";
+    case ModelStatus::MISSING_SECTION:
+      return "missing section";
+    case ModelStatus::BAD_SHAPE:
+      return "bad shape";
+    case ModelStatus::IO_ERROR:
+      return "io error";
+  }
+  return "unknown";
+}
+
+uint32_t modelChecksum(const uint8_t* data, size_t size) {
+  // Bitwise rather than table driven. Models are checked once at load.
+  uint32_t crc = 0xFFFFFFFFU;
+  for (size_t i = 0; i < size; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (CRC32_POLYNOMIAL & (0U - (crc & 1U)));
+    }
+  }
+  return ~crc;
+}
+
+ModelStatus ModelContainer::open(const void* data, size_t size) {
+  this->data = nullptr;
+  this->header = nullptr;
+  this->sections = nullptr;
+
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  if (bytes == nullptr || size < sizeof(ModelHeader)) {
+    return ModelStatus::TOO_SMALL;
+  }
+  if (reinterpret_cast<uintptr_t>(bytes) % MODEL_ALIGNMENT != 0) {
+    return ModelStatus::MISALIGNED;
+  }
+
+  const ModelHeader* header = reinterpret_cast<const ModelHeader*>(bytes);
+  if (header->magic != MODEL_MAGIC) {
+    return ModelStatus::BAD_MAGIC;
+  }
+  if (header->version != MODEL_FORMAT_VERSION) {
+    return ModelStatus::BAD_VERSION;
+  }
+  const size_t tableEnd =
+      sizeof(ModelHeader) + header->numSections * sizeof(ModelSection);
+  if (header->totalSize > size || header->totalSize < tableEnd) {
+    return ModelStatus::TOO_SMALL;
+  }
+  if (modelChecksum(bytes + sizeof(ModelHeader),
+                    header->totalSize - sizeof(ModelHeader)) !=
+      header->checksum) {
+    return ModelStatus::BAD_CHECKSUM;
+  }
+
+  const ModelSection* sections =
+      reinterpret_cast<const ModelSection*>(bytes + sizeof(ModelHeader));
+  for (uint16_t i = 0; i < header->numSections; i++) {
+    const ModelSection& section = sections[i];
+    const size_t elementSize = sectionElementSize(section.type);
+    const size_t sectionSize =
+        static_cast<size_t>(section.rows) * section.cols * elementSize;
+    if (elementSize == 0 || section.offset % MODEL_ALIGNMENT != 0 ||
+        section.offset < tableEnd ||
+        section.offset + sectionSize > header->totalSize) {
+      return ModelStatus::BAD_SECTION;
+    }
+  }
+
+  this->data = bytes;
+  this->header = header;
+  this->sections = sections;
+  return ModelStatus::OK;
+}
+
+const ModelSection* ModelContainer::findSection(uint32_t id) const {
+  if (!this->isOpen()) {
+    return nullptr;
+  }
+  for (uint16_t i = 0; i < this->header->numSections; i++) {
+    if (this->sections[i].id == id) {
+      return &this->sections[i];
+    }
+  }
+  return nullptr;
+}
+
+const float* ModelContainer::getFloatSection(uint32_t id, uint16_t rows,
+                                             uint16_t cols,
+                                             ModelStatus& status) const {
+  const ModelSection* section = this->findSection(id);
+  if (section == nullptr) {
+    status = ModelStatus::MISSING_SECTION;
+    return nullptr;
+  }
+  if (section->type != MODEL_SECTION_F32 || section->rows != rows ||
+      section->cols != cols) {
+    status = ModelStatus::BAD_SHAPE;
+    return nullptr;
+  }
+  return reinterpret_cast<const float*>(this->data + section->offset);
+}
@@ -0,0 +1,171 @@
+/**
+ ******************************************************************************
+ * @file    modelContainer.h
+ * @brief   Versioned, aligned and checksummed flat binary container of model
+ *          weights, read in place without parsing or copying.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// The container is little-endian and read in place. Compilers without
+// __BYTE_ORDER__ rely on the magic check, which fails on a big-endian host.
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__)
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "The model container is little-endian.");
+#endif
+
+/** @brief "A36M" read as a little-endian word. */
+constexpr inline uint32_t MODEL_MAGIC = 0x4D363341U;
+
+/** @brief Layout version. Containers of any other version are rejected. */
+constexpr inline uint16_t MODEL_FORMAT_VERSION = 1;
+
+/** @brief Alignment (bytes) of the container and of every section. */
+constexpr inline size_t MODEL_ALIGNMENT = 16;
+
+/** @brief Element types of a section. */
+enum ModelSectionType : uint16_t {
+  MODEL_SECTION_F32 = 0,
+};
+
+/** @brief Container header, at offset 0. */
+struct ModelHeader {
+  /** @brief MODEL_MAGIC. */
+  uint32_t magic;
+
+  /** @brief MODEL_FORMAT_VERSION. */
+  uint16_t version;
+
+  /** @brief Number of entries in the section table. */
+  uint16_t numSections;
+
+  /** @brief Size (bytes) of the container, header included. */
+  uint32_t totalSize;
+
+  /** @brief CRC-32 of every byte after the header. */
+  uint32_t checksum;
+};
+
+/** @brief Entry of the section table, which follows the header. */
+struct ModelSection {
+  /** @brief Identifier of the section, defined by the model that uses it. */
+  uint32_t id;
+
+  /** @brief Offset (bytes) of the data from the start of the container. */
+  uint32_t offset;
+
+  /** @brief Number of rows of the row-major data. */
+  uint16_t rows;
+
+  /** @brief Number of columns of the row-major data. */
+  uint16_t cols;
+
+  /** @brief ModelSectionType of the elements. */
+  uint16_t type;
+
+  /** @brief Zero. */
+  uint16_t reserved;
+};
+
+static_assert(sizeof(ModelHeader) == 16, "ModelHeader must be packed.");
+static_assert(sizeof(ModelSection) == 16, "ModelSection must be packed.");
+
+/** @brief Result of opening a container or looking up a section. */
+enum class ModelStatus {
+  OK,
+  TOO_SMALL,        // Shorter than its header, table or totalSize.
+  MISALIGNED,       // Not aligned to MODEL_ALIGNMENT.
+  BAD_MAGIC,        // Not a model container.
+  BAD_VERSION,      // Written for another layout version.
+  BAD_CHECKSUM,     // Corrupted.
+  BAD_SECTION,      // A section lies outside the container or is misaligned.
+  MISSING_SECTION,  // A required section is absent.
+  BAD_SHAPE,        // A section does not have the expected type or shape.
+  IO_ERROR,         // The file could not be read.
+};
+
+/**
+ * @brief Get the printable name of a status.
+ *
+ * @param status Status.
+ * @return const char* Name of the status.
+ */
+const char* modelStatusName(ModelStatus status);
+
+/**
+ * @brief CRC-32 (IEEE 802.3, as zlib.crc32) of a block of bytes.
+ *
+ * @param data Bytes.
+ * @param size Number of bytes.
+ * @return uint32_t The checksum.
+ */
+uint32_t modelChecksum(const uint8_t* data, size_t size);
+
+/**
+ * @brief View of a container held in memory, a memory-mapped file on the host
+ * or a const array in flash on the target. The container must outlive the
+ * view and every pointer it returns.
+ */
+class ModelContainer {
+ public:
+  /**
+   * @brief Validate a container and make its sections available.
+   *
+   * @param data Start of the container, aligned to MODEL_ALIGNMENT.
+   * @param size Number of readable bytes.
+   * @return ModelStatus OK, or why the container was rejected. The view is
+   * empty unless OK.
+   */
+  ModelStatus open(const void* data, size_t size);
+
+  /**
+   * @brief Check whether a container was opened.
+   *
+   * @return true if open() succeeded.
+   */
+  bool isOpen() const { return this->header != nullptr; }
+
+  /**
+   * @brief Get the version of the open container.
+   *
+   * @return uint16_t Layout version, 0 if no container is open.
+   */
+  uint16_t getVersion() const {
+    return this->isOpen() ? this->header->version : 0;
+  }
+
+  /**
+   * @brief Find a section.
+   *
+   * @param id Section identifier.
+   * @return const ModelSection* The section, or nullptr if it is absent.
+   */
+  const ModelSection* findSection(uint32_t id) const;
+
+  /**
+   * @brief Find a float section and check its shape.
+   *
+   * @param id Section identifier.
+   * @param rows Expected number of rows.
+   * @param cols Expected number of columns.
+   * @param [out] status MISSING_SECTION or BAD_SHAPE on failure, untouched
+   * otherwise.
+   * @return const float* rows x cols values in place, or nullptr.
+   */
+  const float* getFloatSection(uint32_t id, uint16_t rows, uint16_t cols,
+                               ModelStatus& status) const;
+
+ private:
+  /** @brief Start of the container. */
+  const uint8_t* data = nullptr;
+
+  /** @brief Header of the open container, nullptr if none is open. */
+  const ModelHeader* header = nullptr;
+
+  /** @brief Section table of the open container. */
+  const ModelSection* sections = nullptr;
+};
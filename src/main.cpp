@@ -27,7 +27,7 @@
 
 int main() {
 #ifdef RUNTIME_AUDIO360
-  mainAudio360();
+  mainAudio360(detectBoardRevision());
 #endif
 
 #ifdef RUNTIME_USB_TX
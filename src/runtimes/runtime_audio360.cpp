@@ -8,6 +8,7 @@
 
 #include <cstdint>
 
+#include "activityGate.h"
 #include "audio_anomaly_detection.h"
 #include "bluetooth_manager.h"
 #include "classification.h"
@@ -16,6 +17,7 @@
 #include "exceptions.hpp"
 #include "filter.hpp"
 #include "logging.hpp"
+#include "micGeometry.h"
 #include "packet.h"
 #include "peripheral.h"
 #include "peripheral_error.hpp"
@@ -47,6 +49,37 @@ static float32_t micB1BufferFloat[MIC_HALF_BUFFER_SIZE];
 static float32_t micA2BufferFloat[MIC_HALF_BUFFER_SIZE];
 static float32_t micB2BufferFloat[MIC_HALF_BUFFER_SIZE];
 
+// Buffers of each mic, indexed by embedded_mic_index.
+static int32_t* const micBuffers[NUM_MICS] = {micA1Buffer, micA2Buffer,
+                                              micB1Buffer, micB2Buffer};
+static float32_t* const micBuffersFloat[NUM_MICS] = {
+    micA1BufferFloat, micA2BufferFloat, micB1BufferFloat, micB2BufferFloat};
+
+/** @brief What the runtime needs to know about a frame revision. */
+struct BoardConfig {
+  // Positions of the mics.
+  ArrayGeometry geometry;
+  // Mic at each position of the geometry: 1 top left, 2 top right, 3 bottom
+  // right and 4 bottom left.
+  embedded_mic_index micOrder[NUM_MICS];
+  // SAI data size of the mics (bits).
+  uint8_t micWordBits;
+  // Right shift from a received word to a 24 bit sample.
+  int8_t sampleShift;
+};
+
+static constexpr BoardConfig REV0_BOARD{
+    REV0_ARRAY_GEOMETRY, {MIC_A1, MIC_A2, MIC_B2, MIC_B1}, 24, 0};
+static constexpr BoardConfig PCB_BOARD{
+    PCB_ARRAY_GEOMETRY, {MIC_A1, MIC_B1, MIC_A2, MIC_B2}, 32, 8};
+static const BoardConfig* board{&PCB_BOARD};
+
+// Board config word, e.g. 0xA3600000 for a Rev 0 frame, programmed with
+// STM32CubeProgrammer. The upper 24 bits mark it as programmed and the low
+// byte holds the BoardRevision.
+static const uint32_t BOARD_CONFIG_ADDRESS = FLASH_OTP_BASE;
+static const uint32_t BOARD_CONFIG_MAGIC = 0xA36000U;
+
 static int micBufferStartPos{0};
 static uint8_t micMainHalf{0}, micMainFull{0}, micDummyHalf{0}, micDummyFull{0};
 
@@ -54,6 +87,12 @@ static uint8_t micMainHalf{0}, micMainFull{0}, micDummyHalf{0}, micDummyFull{0};
 static SystemFaultManager systemFaultManager{};
 static AudioAnomalyDectection audioAnomalyDectection{};
 static DOA doa{DOA_SAMPLES};
+static DOA_Algorithms doaAlgorithm{DOA_Algorithms::GCC_PHAT};
+static DoASource doaSources[DOA_MAX_SOURCES];
+static size_t numDoaSources{0};
+static ActivityGate doaActivityGate{MIC_SAMPLE_FULL_SCALE};
+static GatedDirection gatedDirection{GatedDirection::HOLD};
+static float lastDoaAngle_rad{0.0f};
 static Classification classifier{MIC_BUFFER_SIZE / 2, NUM_MEL_FILTERS,
                                  NUM_DCT_COEFF, NUM_PCA_COMPONENTS,
                                  NUM_CLASSES};
@@ -62,9 +101,25 @@ static ModeFilter<DirectionLabel> directionModeFilter(
 static ModeFilter<ClassificationLabel> classificationModeFilter(
     CLASSIFICATION_BUFFER_SIZE);
 
-void mainAudio360() {
+BoardRevision detectBoardRevision() {
+  const uint32_t word =
+      *reinterpret_cast<const volatile uint32_t*>(BOARD_CONFIG_ADDRESS);
+  if ((word >> 8) == BOARD_CONFIG_MAGIC &&
+      (word & 0xFFU) == static_cast<uint8_t>(BoardRevision::REV0)) {
+    return BoardRevision::REV0;
+  }
+  return BoardRevision::PCB;
+}
+
+void mainAudio360(BoardRevision revision) {
   INFO("Running Audio360.");
 
+  // The mic word size must be set before the peripherals are set up.
+  board = (revision == BoardRevision::PCB) ? &PCB_BOARD : &REV0_BOARD;
+  INFO("Board revision %d.", static_cast<int>(revision));
+  embedded_mic_set_word_size(board->micWordBits);
+  doa.setArrayGeometry(board->geometry);
+
   INFO("Setting up Peripherals.");
   // Set-up peripherals. Must call before any hardware function calls.
   setupPeripherals();
@@ -99,7 +154,10 @@ void mainAudio360() {
       INFO("Running DoA estimation.");
       float angle_rad = runDoA(newData);
       INFO("DoA angle: %f rad.", angle_rad);
-      DirectionLabel direction = angleToDirection(angle_rad);
+      DirectionLabel direction =
+          (doaActivityGate.isOpen() || gatedDirection == GatedDirection::HOLD)
+              ? angleToDirection(angle_rad)
+              : DirectionLabel::None;
       directionModeFilter.update(direction);
 
       INFO("Running Audio classification.");
@@ -121,6 +179,18 @@ void mainAudio360() {
       Bluetooth_Manager_Send(packet.data(),
                              static_cast<uint16_t>(packet.size()));
 
+      // Directions of every located source, strongest first.
+      SourcesPacket sourcesPacket{};
+      sourcesPacket.numSources = static_cast<uint8_t>(numDoaSources);
+      for (size_t i = 0; i < numDoaSources; i++) {
+        sourcesPacket.directions[i] =
+            angleToDirection(doaSources[i].angle_rad);
+      }
+      std::array<uint8_t, SOURCES_PACKET_BYTE_SIZE> sourcesBytes =
+          createSourcesPacket(sourcesPacket);
+      Bluetooth_Manager_Send(sourcesBytes.data(),
+                             static_cast<uint16_t>(sourcesBytes.size()));
+
       // Reset half and full bool flags.
       if (micMainFull == 1U) {
         micMainHalf = 0U;
@@ -186,17 +256,14 @@ bool extractMicData() {
       SCB_CleanDCache_by_Addr((uint32_t*)&micA2Buffer[startPos], numBytes);
       SCB_CleanDCache_by_Addr((uint32_t*)&micB2Buffer[startPos], numBytes);
 
-#ifdef PCB_BUILD
-      // we shift down by 8 on the ics434 build to get actual magnitude
-      arm_shift_q31(&micA1Buffer[startPos], -8, &micA1Buffer[startPos],
-                    MIC_HALF_BUFFER_SIZE);
-      arm_shift_q31(&micB1Buffer[startPos], -8, &micB1Buffer[startPos],
-                    MIC_HALF_BUFFER_SIZE);
-      arm_shift_q31(&micA2Buffer[startPos], -8, &micA2Buffer[startPos],
-                    MIC_HALF_BUFFER_SIZE);
-      arm_shift_q31(&micB2Buffer[startPos], -8, &micB2Buffer[startPos],
-                    MIC_HALF_BUFFER_SIZE);
-#endif
+      // The ICS-43434 words are 32 bit, shift them down to get the actual
+      // magnitude.
+      if (board->sampleShift > 0) {
+        for (int32_t* buffer : micBuffers) {
+          arm_shift_q31(&buffer[startPos], -board->sampleShift,
+                        &buffer[startPos], MIC_HALF_BUFFER_SIZE);
+        }
+      }
 
       // Check audio anomalies.
       std::vector<int32_t*> audioStreams{
@@ -217,6 +284,12 @@ bool extractMicData() {
   return newData;
 }
 
+void setDoaAlgorithm(DOA_Algorithms algo) { doaAlgorithm = algo; }
+
+void setGatedDirection(GatedDirection mode) { gatedDirection = mode; }
+
+const ActivityGate& getDoaActivityGate() { return doaActivityGate; }
+
 float runDoA(bool newData) {
   if (!newData) {
     INFO("There is no new data. Skipping DoA.");
@@ -238,24 +311,48 @@ float runDoA(bool newData) {
     micB2BufferFloat[i] = static_cast<float>(micB2Buffer[start + i]);
   }
 
-  float angle{0.0};
+  // Skip the transforms and correlations while the room is quiet.
+  const float* mics[NUM_MICS] = {micA1BufferFloat, micB1BufferFloat,
+                                 micA2BufferFloat, micB2BufferFloat};
+  if (!doaActivityGate.update(mics, NUM_MICS, MIC_HALF_BUFFER_SIZE)) {
+    INFO("No sound activity. Skipping DoA.");
+    if (gatedDirection == GatedDirection::NONE) {
+      numDoaSources = 0;
+    }
+    return lastDoaAngle_rad;
+  }
+
+  // Mics in the order of the array geometry, as float and as q31 samples.
+  float* floatMics[NUM_MICS];
+  const q31_t* q31Mics[NUM_MICS];
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    const embedded_mic_index index = board->micOrder[mic];
+    floatMics[mic] = micBuffersFloat[index];
+    q31Mics[mic] = &micBuffers[index][start];
+  }
+
+  numDoaSources = 0;
   try {
-#ifdef PCB_BUILD
-    angle = doa.calculateDirection(micA1BufferFloat, micB1BufferFloat,
-                                   micA2BufferFloat, micB2BufferFloat,
-                                   DOA_Algorithms::GCC_PHAT);
-#else
-    // Rev0 build.
-    angle = doa.calculateDirection(micA1BufferFloat, micA2BufferFloat,
-                                   micB2BufferFloat, micB1BufferFloat,
-                                   DOA_Algorithms::GCC_PHAT);
-#endif
+    if (doaAlgorithm == DOA_Algorithms::GCC_PHAT_Q31) {
+      // The int32 mic samples are already q31, so the fixed-point path reads
+      // them without conversion.
+      doaSources[0] = DoASource{
+          doa.calculateDirection(q31Mics[0], q31Mics[1], q31Mics[2],
+                                 q31Mics[3], doaAlgorithm),
+          0.0f};
+      numDoaSources = 1;
+    } else {
+      numDoaSources = doa.calculateDirections(
+          floatMics[0], floatMics[1], floatMics[2], floatMics[3], doaSources,
+          DOA_MAX_SOURCES, doaAlgorithm);
+    }
     systemFaultManager.clearDoaError();
   } catch (const AudioProcessingException& e) {
     systemFaultManager.reportDoaError();
   }
 
-  return angle;
+  lastDoaAngle_rad = (numDoaSources > 0) ? doaSources[0].angle_rad : 0.0f;
+  return lastDoaAngle_rad;
 }
 
 std::string runClassification(bool newData) {
@@ -7,7 +7,11 @@
 
 #pragma once
 
+#include <cstdint>
+
+#include "activityGate.h"
 #include "constants.h"
+#include "doaAlgorithm.h"
 
 const int MIC_BUFFER_SIZE = 4096;
 const int MIC_HALF_BUFFER_SIZE = WAVEFORM_SAMPLES / 2;
@@ -22,8 +26,32 @@ const int NUM_DCT_COEFF = 13;
 const int NUM_PCA_COMPONENTS = 6;
 const int NUM_CLASSES = 3;
 
-/** @brief Main entry code. */
-void mainAudio360();
+/** @brief Frame revisions the firmware runs on. The value is the low byte of
+ * the board config word. */
+enum class BoardRevision : uint8_t {
+  REV0 = 0,  // Glasses frame with INMP441 mics on 24 bit SAI words.
+  PCB = 1,   // Glasses PCB with ICS-43434 mics on 32 bit SAI words.
+};
+
+/**
+ * @brief Detect the frame revision from the board config word, the first word
+ * of the OTP area, written once when the frame is assembled. Needs no
+ * peripheral, so it can run before mainAudio360.
+ *
+ * @return BoardRevision The revision in the word, or PCB when the word is
+ * erased or not a board config word, as PCB frames are the ones built without
+ * it.
+ */
+BoardRevision detectBoardRevision();
+
+/**
+ * @brief Main entry code.
+ *
+ * @param board Frame revision, from detectBoardRevision(). Sets the SAI word
+ * size of the mics, the shift to 24 bit samples, the order of the mics and the
+ * array geometry of DoA.
+ */
+void mainAudio360(BoardRevision board);
 
 /**
  * @brief Extract mic data from dynamic memory when ready and store in a
@@ -37,10 +65,35 @@ void mainAudio360();
 bool extractMicData();
 
 /**
- * @brief Run Direction of Arrival feature.
+ * @brief Select the Direction of Arrival algorithm used by runDoA. Takes
+ * effect on the next frame.
+ *
+ * @param algo DOA algorithm to use.
+ */
+void setDoaAlgorithm(DOA_Algorithms algo);
+
+/**
+ * @brief Select what runDoA reports while the activity gate is closed. Takes
+ * effect on the next frame.
+ *
+ * @param mode Hold the last direction or report no direction.
+ */
+void setGatedDirection(GatedDirection mode);
+
+/**
+ * @brief Get the activity gate in front of DoA, with its frame counters.
+ *
+ * @return const ActivityGate& The gate.
+ */
+const ActivityGate& getDoaActivityGate();
+
+/**
+ * @brief Run Direction of Arrival feature. Every located source is kept for
+ * the sources packet. Skipped while the activity gate is closed.
  *
  * @param newData True if there is new microphone data in the buffer.
- * @return float Angle of audio source in radian.
+ * @return float Angle of the strongest audio source in radian, or of the
+ * last active frame when the gate is closed.
  */
 float runDoA(bool newData);
 
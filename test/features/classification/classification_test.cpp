@@ -9,13 +9,21 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <iostream>
 #include <vector>
 
 #include "constants.h"
+#include "dct.h"
+#include "fusedClassifier.h"
+#include "lda.h"
+#include "matrix.h"
+#include "mel_filter.h"
 #include "mp3.h"
-
+#include "pca.h"
 
 namespace {
 
@@ -73,6 +81,25 @@ float RunClassificationOverMp3(const std::string& filename,
   return static_cast<float>(matchCount) / static_cast<float>(processedFrames);
 }
 
+/**
+ * @brief Synthetic power spectrum of a tone over a noise floor. The tone moves
+ * with the frame index so that consecutive frames differ.
+ *
+ * @param frame Frame index.
+ * @param numFreqBins Number of frequency bins.
+ * @return std::vector<float> The power spectrum.
+ */
+std::vector<float> TonePowerSpectrum(size_t frame, uint16_t numFreqBins) {
+  const float peakBin = 20.0f + static_cast<float>((frame * 37) % 300);
+  std::vector<float> power(numFreqBins);
+  for (uint16_t bin = 0; bin < numFreqBins; ++bin) {
+    const float d = (static_cast<float>(bin) - peakBin) / 4.0f;
+    power[bin] = 1e-3f * (1.0f + 0.5f * std::sin(0.3f * (bin + frame))) +
+                 50.0f * std::exp(-d * d);
+  }
+  return power;
+}
+
 }  // namespace
 
 /** @brief Silent frames should be labeled unknown. */
@@ -140,3 +167,195 @@ TEST(ClassificationTest, AlarmMp3IsAlarm) {
   float ratio = RunClassificationOverMp3("audio/alarm.mp3", "smoke_alarm");
   EXPECT_GE(ratio, 0.9f);
 }
+
+/** @brief Given a stream of spectra, assert that the cached per-frame features
+ * and the running score sums give the features and labels of the staged
+ * pipeline recomputed over the last CLASSIFICATION_BUFFER_SIZE frames. */
+TEST(ClassificationTest, IncrementalMatchesBatchWindow) {
+  const uint16_t fftSize = WAVEFORM_SAMPLES / 2;
+  const uint16_t numFreqBins = fftSize / 2 + 1;
+  const uint16_t numMelFilters = 13;
+  const uint16_t numDCTCoeff = 13;
+  const uint16_t numPCAComponents = 6;
+  const uint16_t numClasses = 3;
+
+  Classification classifier(fftSize, numMelFilters, numDCTCoeff,
+                            numPCAComponents, numClasses, false);
+  ASSERT_EQ(classifier.getContextFrames(), CLASSIFICATION_BUFFER_SIZE);
+  classifier.setBackend(ClassifierBackend::STAGED);
+
+  MelFilter melFilter(numMelFilters, fftSize, SAMPLE_FREQUENCY);
+  DiscreteCosineTransform dct(numDCTCoeff, numMelFilters);
+  PrincipleComponentAnalysis pca(numPCAComponents, numDCTCoeff);
+  LinearDiscriminantAnalysis lda(numPCAComponents, numClasses);
+
+  std::vector<std::vector<float>> history;
+  for (size_t frame = 0; frame < 40; ++frame) {
+    history.push_back(TonePowerSpectrum(frame, numFreqBins));
+    classifier.classifyPowerSpectrum(history.back().data());
+    if (history.size() < CLASSIFICATION_BUFFER_SIZE) {
+      EXPECT_EQ(classifier.getClassificationLabel(), "unknown");
+      EXPECT_EQ(classifier.getFeatureRow(history.size()), nullptr);
+      continue;
+    }
+
+    std::vector<float> stftData;
+    for (size_t i = history.size() - CLASSIFICATION_BUFFER_SIZE;
+         i < history.size(); ++i) {
+      stftData.insert(stftData.end(), history[i].begin(), history[i].end());
+    }
+    matrix stftSpec;
+    matrix_init_f32(&stftSpec, CLASSIFICATION_BUFFER_SIZE, numFreqBins,
+                    stftData.data());
+    matrix melSpec;
+    float melData[CLASSIFICATION_BUFFER_SIZE * NUM_MEL_FILTERS];
+    melFilter.apply(stftSpec, melSpec, melData);
+    matrix mfccSpec;
+    float mfccData[CLASSIFICATION_BUFFER_SIZE * NUM_DCT_COEFF];
+    dct.apply(melSpec, mfccSpec, mfccData);
+    matrix pcaSpec;
+    float pcaData[CLASSIFICATION_BUFFER_SIZE * NUM_PCA_COMPONENTS];
+    pca.apply(mfccSpec, pcaSpec, pcaData);
+
+    for (uint16_t age = 0; age < CLASSIFICATION_BUFFER_SIZE; ++age) {
+      const float* row = classifier.getFeatureRow(age);
+      ASSERT_NE(row, nullptr);
+      const size_t batchRow = CLASSIFICATION_BUFFER_SIZE - 1 - age;
+      for (uint16_t i = 0; i < numPCAComponents; ++i) {
+        EXPECT_NEAR(row[i], pcaData[batchRow * numPCAComponents + i], 1e-3f)
+            << "frame " << frame << ", age " << age;
+      }
+    }
+    EXPECT_EQ(classifier.getClassificationLabel(),
+              ClassificationClassToString(lda.apply(pcaSpec)))
+        << "frame " << frame;
+  }
+}
+
+/** @brief Report the time per frame of the incremental pipeline for growing
+ * context lengths, and the memory of its feature cache. */
+TEST(ClassificationTest, ContextLengthCostReport) {
+  const uint16_t fftSize = WAVEFORM_SAMPLES / 2;
+  const uint16_t numFreqBins = fftSize / 2 + 1;
+  const int iterations = 2000;
+
+  std::vector<std::vector<float>> spectra;
+  for (size_t frame = 0; frame < 16; ++frame) {
+    spectra.push_back(TonePowerSpectrum(frame, numFreqBins));
+  }
+
+  for (uint16_t contextFrames : {4, 64, 1024}) {
+    Classification classifier(fftSize, 13, 13, 6, 3, false, contextFrames);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      classifier.classifyPowerSpectrum(spectra[i % spectra.size()].data());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::micro> elapsed = end - start;
+    std::cout << "  Context of " << contextFrames << " frames: "
+              << elapsed.count() / iterations << " us per frame, cache "
+              << contextFrames * (6 + 3 + 1) * sizeof(float) << " bytes"
+              << std::endl;
+  }
+  std::cout << "  Power spectrum history replaced: "
+            << CLASSIFICATION_BUFFER_SIZE * ((DOA_SAMPLES / 2) + 1) *
+                   sizeof(float)
+            << " bytes" << std::endl;
+}
+
+/** @brief Given a stream of spectra, assert that the fused classifier gives
+ * the class scores of the staged DCT, PCA and LDA. */
+TEST(ClassificationTest, FusedScoresMatchStaged) {
+  const uint16_t fftSize = WAVEFORM_SAMPLES / 2;
+  const uint16_t numFreqBins = fftSize / 2 + 1;
+  const uint16_t numMelFilters = 13;
+  const uint16_t numDCTCoeff = 13;
+  const uint16_t numPCAComponents = 6;
+  const uint16_t numClasses = 3;
+
+  MelFilter melFilter(numMelFilters, fftSize, SAMPLE_FREQUENCY);
+  DiscreteCosineTransform dct(numDCTCoeff, numMelFilters);
+  PrincipleComponentAnalysis pca(numPCAComponents, numDCTCoeff);
+  LinearDiscriminantAnalysis lda(numPCAComponents, numClasses);
+  FusedLinearClassifier fused(dct, pca, lda, numMelFilters, numDCTCoeff,
+                              numPCAComponents, numClasses);
+
+  for (size_t frame = 0; frame < 64; ++frame) {
+    const std::vector<float> power = TonePowerSpectrum(frame, numFreqBins);
+    float mel[NUM_MEL_FILTERS];
+    melFilter.applyFrame(power.data(), mel);
+
+    matrix melSpec;
+    matrix_init_f32(&melSpec, 1, numMelFilters, mel);
+    matrix mfccSpec;
+    float mfcc[NUM_DCT_COEFF];
+    dct.apply(melSpec, mfccSpec, mfcc);
+    matrix pcaSpec;
+    float features[NUM_PCA_COMPONENTS];
+    pca.apply(mfccSpec, pcaSpec, features);
+    float staged[NUM_CLASSES];
+    lda.scoreFrame(features, staged);
+
+    float scores[NUM_CLASSES];
+    fused.scoreFrame(mel, scores);
+    for (uint16_t c = 0; c < numClasses; ++c) {
+      const float tolerance = 1e-4f * std::max(1.0f, std::fabs(staged[c]));
+      EXPECT_NEAR(scores[c], staged[c], tolerance)
+          << "frame " << frame << ", class " << c;
+    }
+  }
+}
+
+/** @brief Given recordings of each class, assert that the fused and the staged
+ * classifiers give the same label on every frame. */
+TEST(ClassificationTest, FusedLabelsMatchStaged) {
+  const size_t frameLen = 2048;
+  for (const char* filename : {"audio/hello.mp3", "audio/alarm.mp3"}) {
+    Classification fused(WAVEFORM_SAMPLES / 2, 13, 13, 6, 3);
+    Classification staged(WAVEFORM_SAMPLES / 2, 13, 13, 6, 3);
+    ASSERT_EQ(fused.getBackend(), ClassifierBackend::FUSED);
+    staged.setBackend(ClassifierBackend::STAGED);
+
+    MP3Data data = readMP3File(filename, true);
+    ASSERT_FALSE(data.channel1.empty()) << filename;
+    std::vector<float> audio(frameLen);
+    for (size_t start = 0; start + frameLen <= data.channel1.size();
+         start += frameLen) {
+      for (size_t i = 0; i < frameLen; ++i) {
+        audio[i] = static_cast<float>(data.channel1[start + i]);
+      }
+      fused.classify(audio.data());
+      staged.classify(audio.data());
+      EXPECT_EQ(fused.getClassificationLabel(),
+                staged.getClassificationLabel())
+          << filename << " at sample " << start;
+    }
+  }
+}
+
+/** @brief Report the time per frame of the fused and the staged pipelines,
+ * from power spectrum to decision. */
+TEST(ClassificationTest, FusedCostReport) {
+  const uint16_t fftSize = WAVEFORM_SAMPLES / 2;
+  const uint16_t numFreqBins = fftSize / 2 + 1;
+  const int iterations = 5000;
+
+  std::vector<std::vector<float>> spectra;
+  for (size_t frame = 0; frame < 16; ++frame) {
+    spectra.push_back(TonePowerSpectrum(frame, numFreqBins));
+  }
+
+  for (bool staged : {true, false}) {
+    Classification classifier(fftSize, 13, 13, 6, 3, false);
+    classifier.setBackend(staged ? ClassifierBackend::STAGED
+                                 : ClassifierBackend::FUSED);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      classifier.classifyPowerSpectrum(spectra[i % spectra.size()].data());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> elapsed = end - start;
+    std::cout << "  " << (staged ? "Staged" : "Fused") << " pipeline: "
+              << elapsed.count() / iterations << " ns per frame" << std::endl;
+  }
+}
@@ -0,0 +1,169 @@
+/**
+ ******************************************************************************
+ * @file    classifierModel_test.cpp
+ * @brief   Unit tests for the classifier weights read from a model container.
+ ******************************************************************************
+ */
+
+#include "classifierModel.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "classification.h"
+#include "exceptions.hpp"
+#include "mappedFile.h"
+#include "model_test_helper.h"
+
+/**
+ * @brief Copy the sections of the default model, so that tests can change
+ * them.
+ *
+ * @return std::vector<TestModelSection> The sections.
+ */
+static std::vector<TestModelSection> defaultSections() {
+  const ClassifierModel& model = defaultClassifierModel();
+  auto copy = [](const float* values, size_t count) {
+    return std::vector<float>(values, values + count);
+  };
+  return {
+      {PCA_MEAN_SECTION, 1, NUM_DCT_COEFF,
+       copy(model.getPCAMean(), NUM_DCT_COEFF)},
+      {PCA_PROJECTION_SECTION, NUM_DCT_COEFF, NUM_PCA_COMPONENTS,
+       copy(model.getPCAProjection(), NUM_DCT_COEFF * NUM_PCA_COMPONENTS)},
+      {LDA_WEIGHTS_SECTION, NUM_CLASSES, NUM_PCA_COMPONENTS,
+       copy(model.getLDAWeights(), NUM_CLASSES * NUM_PCA_COMPONENTS)},
+      {LDA_BIASES_SECTION, 1, NUM_CLASSES,
+       copy(model.getLDABiases(), NUM_CLASSES)},
+  };
+}
+
+/** @brief Given the default model, assert that it loads from flash and holds
+ * the trained weights in place. */
+TEST(ClassifierModelTest, DefaultModelLoadsInPlace) {
+  const ClassifierModel& model = defaultClassifierModel();
+  ASSERT_TRUE(model.isLoaded());
+
+  EXPECT_FLOAT_EQ(model.getPCAMean()[0], 11.54753685f);
+  EXPECT_FLOAT_EQ(model.getPCAProjection()[0], 0.99090934f);
+  EXPECT_FLOAT_EQ(model.getPCAProjection()[77], 0.07770912f);
+  EXPECT_FLOAT_EQ(model.getLDAWeights()[17], -1.27706242f);
+  EXPECT_FLOAT_EQ(model.getLDAScalings()[0], -0.06232077f);
+  // Test builds use the host biases.
+  EXPECT_FLOAT_EQ(model.getLDABiases()[1], 11.38645935f);
+
+  const uint8_t* begin = DEFAULT_CLASSIFIER_MODEL_DATA;
+  const uint8_t* end = begin + DEFAULT_CLASSIFIER_MODEL_SIZE;
+  for (const float* weights :
+       {model.getPCAMean(), model.getPCAProjection(), model.getLDAWeights(),
+        model.getLDABiases()}) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(weights);
+    EXPECT_GE(bytes, begin);
+    EXPECT_LT(bytes, end);
+  }
+}
+
+/** @brief Given sections whose shape differs from the NUM_* constants, or a
+ * missing section, assert that the model is rejected. */
+TEST(ClassifierModelTest, ShapesAreValidatedAtLoad) {
+  ClassifierModel model;
+
+  std::vector<TestModelSection> sections = defaultSections();
+  sections[0].cols = NUM_DCT_COEFF - 1;
+  sections[0].values.pop_back();
+  TestModelImage image = buildTestModel(sections);
+  EXPECT_EQ(model.load(image.bytes, image.size), ModelStatus::BAD_SHAPE);
+  EXPECT_FALSE(model.isLoaded());
+
+  sections = defaultSections();
+  sections.pop_back();
+  image = buildTestModel(sections);
+  EXPECT_EQ(model.load(image.bytes, image.size),
+            ModelStatus::MISSING_SECTION);
+
+  sections = defaultSections();
+  image = buildTestModel(sections);
+  EXPECT_EQ(model.load(image.bytes, image.size), ModelStatus::OK);
+  EXPECT_EQ(model.getLDAScalings(), nullptr);
+}
+
+/** @brief Given a model that failed to load, assert that PCA and LDA refuse
+ * to construct rather than keep null weights. */
+TEST(ClassifierModelTest, UnloadedModelIsRejected) {
+  const ClassifierModel unloaded;
+  ASSERT_FALSE(unloaded.isLoaded());
+  EXPECT_THROW(PrincipleComponentAnalysis(6, 13, unloaded),
+               AudioProcessingException);
+  EXPECT_THROW(LinearDiscriminantAnalysis(6, 3, unloaded),
+               AudioProcessingException);
+
+  LinearDiscriminantAnalysis lda(6, 3);
+  EXPECT_THROW(lda.setModel(unloaded), AudioProcessingException);
+}
+
+/** @brief Given a model whose biases favour the smoke alarm, assert that a
+ * classifier switched to it labels any sound a smoke alarm, and that switching
+ * back to the default model restores its labels. */
+TEST(ClassifierModelTest, ClassifierUsesSwappedModel) {
+  std::vector<TestModelSection> sections = defaultSections();
+  sections[3].values = {-100.0f, -100.0f, 100.0f};
+  const TestModelImage image = buildTestModel(sections);
+  ClassifierModel alarmModel;
+  ASSERT_EQ(alarmModel.load(image.bytes, image.size), ModelStatus::OK);
+
+  const uint16_t fftSize = WAVEFORM_SAMPLES / 2;
+  std::vector<float> audio(fftSize);
+  for (size_t i = 0; i < audio.size(); i++) {
+    audio[i] = 0.5f * std::sin(0.07f * i);
+  }
+
+  Classification reference(fftSize, 13, 13, 6, 3, false);
+  Classification classifier(fftSize, 13, 13, 6, 3, false);
+  ASSERT_TRUE(classifier.setModel(alarmModel));
+  for (int frame = 0; frame < CLASSIFICATION_BUFFER_SIZE; frame++) {
+    classifier.classify(audio.data());
+    reference.classify(audio.data());
+  }
+  EXPECT_EQ(classifier.getClassificationLabel(), "smoke_alarm");
+
+  ASSERT_TRUE(classifier.setModel(defaultClassifierModel()));
+  EXPECT_EQ(classifier.getClassificationLabel(), "unknown");
+  for (int frame = 0; frame < CLASSIFICATION_BUFFER_SIZE; frame++) {
+    classifier.classify(audio.data());
+  }
+  EXPECT_EQ(classifier.getClassificationLabel(),
+            reference.getClassificationLabel());
+
+  EXPECT_FALSE(classifier.setModel(ClassifierModel()));
+}
+
+/** @brief Given the default model written to a file, assert that the mapped
+ * copy loads and points into the mapping. */
+TEST(ClassifierModelTest, MappedModelMatchesDefault) {
+  const std::string path = ::testing::TempDir() + "classifier_model_test.bin";
+  FILE* file = std::fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(std::fwrite(DEFAULT_CLASSIFIER_MODEL_DATA, 1,
+                        DEFAULT_CLASSIFIER_MODEL_SIZE, file),
+            DEFAULT_CLASSIFIER_MODEL_SIZE);
+  std::fclose(file);
+
+  MappedFile mapped;
+  ASSERT_TRUE(mapped.open(path));
+  ClassifierModel model;
+  ASSERT_EQ(model.load(mapped.getData(), mapped.getSize()), ModelStatus::OK);
+  EXPECT_EQ(reinterpret_cast<const uint8_t*>(model.getPCAMean()) -
+                mapped.getData(),
+            reinterpret_cast<const uint8_t*>(
+                defaultClassifierModel().getPCAMean()) -
+                DEFAULT_CLASSIFIER_MODEL_DATA);
+  for (size_t i = 0; i < NUM_CLASSES * NUM_PCA_COMPONENTS; i++) {
+    EXPECT_EQ(model.getLDAWeights()[i],
+              defaultClassifierModel().getLDAWeights()[i]);
+  }
+  std::remove(path.c_str());
+}
@@ -8,9 +8,12 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <cstdlib>
 #include <fstream>
+#include <iostream>
 #include <vector>
 #include <window.hpp>
 
@@ -143,3 +146,120 @@ TEST(MelFilterTest, CreateFilterBankImpulseBinContributesToAtMostTwoMelBands) {
   const int melPositives = CountPositiveRow(melSpec, 1, 0.5f);
   EXPECT_LE(melPositives, stftPositives);
 }
+
+/**
+ * @brief Builds a matrix of random positive power spectra.
+ *
+ * @param numFrames Number of frames.
+ * @param numFreqBins Number of bins per frame.
+ * @param stftData Output matrix.
+ * @param stftDataVector Contains the data for @ref stftData.
+ */
+static void MakeRandomSTFT(uint16_t numFrames, uint16_t numFreqBins,
+                           matrix& stftData,
+                           std::vector<float>& stftDataVector) {
+  srand(360);
+  stftDataVector.resize(static_cast<size_t>(numFrames) * numFreqBins);
+  for (float& value : stftDataVector) {
+    value = static_cast<float>(rand()) / RAND_MAX;
+  }
+  matrix_init_f32(&stftData, numFrames, numFreqBins, stftDataVector.data());
+}
+
+/** @brief Given random power spectra, so that every non-zero weight counts,
+ * assert that the banded filter bank matches the dense reference. */
+TEST(MelFilterTest, BandedMatchesDenseReference) {
+  const uint16_t fftSize = WAVEFORM_SAMPLES;
+  const uint16_t numFreqBins = fftSize / 2 + 1;
+  MelFilter mel(NUM_MEL_FILTERS, fftSize, SAMPLE_FREQUENCY);
+
+  matrix stft;
+  std::vector<float> stftDataVector;
+  MakeRandomSTFT(CLASSIFICATION_BUFFER_SIZE, numFreqBins, stft,
+                 stftDataVector);
+
+  matrix banded;
+  matrix dense;
+  float bandedVector[CLASSIFICATION_BUFFER_SIZE * NUM_MEL_FILTERS];
+  float denseVector[CLASSIFICATION_BUFFER_SIZE * NUM_MEL_FILTERS];
+  mel.apply(stft, banded, bandedVector);
+  mel.applyDense(stft, dense, denseVector);
+
+  ASSERT_EQ(banded.numRows, dense.numRows);
+  ASSERT_EQ(banded.numCols, dense.numCols);
+  for (size_t i = 0; i < CLASSIFICATION_BUFFER_SIZE * NUM_MEL_FILTERS; i++) {
+    EXPECT_NEAR(bandedVector[i], denseVector[i], 1e-5f * denseVector[i])
+        << "value " << i;
+  }
+}
+
+/** @brief Given the dense filter bank, assert that every non-zero weight lies
+ * in the band of its filter and that the bands fit the packed weights. */
+TEST(MelFilterTest, BandsHoldEveryNonZeroWeight) {
+  const uint16_t fftSize = WAVEFORM_SAMPLES;
+  const uint16_t numFreqBins = fftSize / 2 + 1;
+  MelFilter mel(NUM_MEL_FILTERS, fftSize, SAMPLE_FREQUENCY);
+
+  std::vector<float> dense(static_cast<size_t>(numFreqBins) * NUM_MEL_FILTERS);
+  mel.fillDenseFilterBank(dense.data());
+
+  size_t totalLength = 0;
+  for (uint16_t m = 0; m < NUM_MEL_FILTERS; m++) {
+    const MelBand& band = mel.getBand(m);
+    EXPECT_GT(band.length, 0U) << "filter " << m;
+    EXPECT_EQ(band.weightOffset, totalLength) << "filter " << m;
+    totalLength += band.length;
+
+    for (uint16_t bin = 0; bin < numFreqBins; bin++) {
+      const float weight =
+          dense[static_cast<size_t>(bin) * NUM_MEL_FILTERS + m];
+      const bool inBand =
+          bin >= band.startBin && bin < band.startBin + band.length;
+      EXPECT_EQ(weight > 0.0f, inBand) << "filter " << m << ", bin " << bin;
+    }
+  }
+  EXPECT_EQ(mel.getNumWeights(), totalLength);
+  EXPECT_LE(totalLength, MEL_MAX_BAND_WEIGHTS);
+}
+
+/** @brief Report the cost of the banded and dense filter banks over a full
+ * classification buffer, and the memory of their weights. */
+TEST(MelFilterTest, BandedCostReport) {
+  const uint16_t fftSize = WAVEFORM_SAMPLES;
+  const uint16_t numFreqBins = fftSize / 2 + 1;
+  const int iterations = 200;
+  MelFilter mel(NUM_MEL_FILTERS, fftSize, SAMPLE_FREQUENCY);
+
+  matrix stft;
+  std::vector<float> stftDataVector;
+  MakeRandomSTFT(CLASSIFICATION_BUFFER_SIZE, numFreqBins, stft,
+                 stftDataVector);
+  matrix melSpec;
+  float melSpectrogramVector[CLASSIFICATION_BUFFER_SIZE * NUM_MEL_FILTERS];
+
+  std::vector<float> dense(static_cast<size_t>(numFreqBins) * NUM_MEL_FILTERS);
+  mel.fillDenseFilterBank(dense.data());
+  matrix filterBankT;
+  matrix_init_f32(&filterBankT, numFreqBins, NUM_MEL_FILTERS, dense.data());
+  matrix_init_f32(&melSpec, CLASSIFICATION_BUFFER_SIZE, NUM_MEL_FILTERS,
+                  melSpectrogramVector);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    matrix_mult_f32(&stft, &filterBankT, &melSpec);
+  }
+  auto mid = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    mel.apply(stft, melSpec, melSpectrogramVector);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  std::chrono::duration<double, std::micro> denseTime = mid - start;
+  std::chrono::duration<double, std::micro> bandedTime = end - mid;
+  std::cout << "  Mel filter bank of " << CLASSIFICATION_BUFFER_SIZE
+            << " frames: dense " << denseTime.count() / iterations
+            << " us, banded " << bandedTime.count() / iterations
+            << " us; weights dense " << dense.size() * sizeof(float)
+            << " bytes, banded " << sizeof(MelFilter) << " bytes ("
+            << mel.getNumWeights() << " non-zero)" << std::endl;
+}
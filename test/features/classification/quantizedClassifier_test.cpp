@@ -0,0 +1,263 @@
+/**
+ ******************************************************************************
+ * @file    quantizedClassifier_test.cpp
+ * @brief   Unit tests for the int8 PCA and LDA stages against the float ones.
+ ******************************************************************************
+ */
+
+#include "quantizedClassifier.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "classification.h"
+#include "dct.h"
+#include "matrix.h"
+#include "mel_filter.h"
+#include "mp3.h"
+
+namespace {
+
+/**
+ * @brief MFCC coefficients of a tone over a noise floor, as the classifier
+ * computes them. The tone moves with the frame index.
+ *
+ * @param frame Frame index.
+ * @param [out] mfcc NUM_DCT_COEFF coefficients.
+ */
+void ToneMFCC(size_t frame, float* mfcc) {
+  const uint16_t fftSize = WAVEFORM_SAMPLES / 2;
+  const uint16_t numFreqBins = fftSize / 2 + 1;
+  static MelFilter melFilter(13, fftSize, SAMPLE_FREQUENCY);
+  static DiscreteCosineTransform dct(13, 13);
+
+  const float peakBin = 20.0f + static_cast<float>((frame * 37) % 300);
+  std::vector<float> power(numFreqBins);
+  for (uint16_t bin = 0; bin < numFreqBins; ++bin) {
+    const float d = (static_cast<float>(bin) - peakBin) / 4.0f;
+    power[bin] = 1e-3f * (1.0f + 0.5f * std::sin(0.3f * (bin + frame))) +
+                 50.0f * std::exp(-d * d);
+  }
+
+  float mel[NUM_MEL_FILTERS];
+  melFilter.applyFrame(power.data(), mel);
+  matrix melSpec;
+  matrix_init_f32(&melSpec, 1, 13, mel);
+  matrix mfccSpec;
+  dct.apply(melSpec, mfccSpec, mfcc);
+}
+
+/** @brief Largest magnitude of a vector. */
+float MaxAbs(const float* values, size_t length) {
+  float maxAbs = 0.0f;
+  for (size_t i = 0; i < length; ++i) {
+    maxAbs = std::max(maxAbs, std::fabs(values[i]));
+  }
+  return maxAbs;
+}
+
+}  // namespace
+
+/** @brief Given random int8 weights and int16 activations, including the
+ * extremes of both ranges, assert that the packed kernel gives the exact dot
+ * product. */
+TEST(QuantizedClassifierTest, DotProductMatchesReference) {
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> weight(-QUANT_WEIGHT_MAX,
+                                            QUANT_WEIGHT_MAX);
+  std::uniform_int_distribution<int> activation(-QUANT_ACTIVATION_MAX,
+                                                QUANT_ACTIVATION_MAX);
+
+  for (size_t length : {4, 8, 16, 64}) {
+    std::vector<int8_t> weights(length);
+    std::vector<int16_t> activations(length);
+    for (int trial = 0; trial < 50; ++trial) {
+      for (size_t i = 0; i < length; ++i) {
+        weights[i] = static_cast<int8_t>(weight(rng));
+        activations[i] = static_cast<int16_t>(activation(rng));
+      }
+      if (trial == 0) {
+        std::fill(weights.begin(), weights.end(), -QUANT_WEIGHT_MAX);
+        std::fill(activations.begin(), activations.end(),
+                  -QUANT_ACTIVATION_MAX);
+      }
+
+      int64_t expected = 0;
+      for (size_t i = 0; i < length; ++i) {
+        expected += static_cast<int64_t>(weights[i]) * activations[i];
+      }
+      std::vector<int8_t> packed(length);
+      packInt8Weights(weights.data(), length, packed.data());
+      EXPECT_EQ(dotInt8Int16(packed.data(), activations.data(), length),
+                expected)
+          << "length " << length << ", trial " << trial;
+    }
+  }
+}
+
+/** @brief Given a frame, assert that the quantized activations are zero
+ * padded and within half a step of the input. */
+TEST(QuantizedClassifierTest, ActivationsRoundToScale) {
+  const float values[NUM_DCT_COEFF] = {0.0f,  -3.5f, 12.25f, 7.0f,  -0.01f,
+                                       1.0f,  2.0f,  -8.0f,  0.5f,  4.0f,
+                                       -6.0f, 3.0f,  -12.5f};
+  int16_t quantized[QUANT_PCA_ROW];
+  std::fill(std::begin(quantized), std::end(quantized), 1);
+  const float scale = quantizeActivations(values, NUM_DCT_COEFF, quantized);
+
+  EXPECT_FLOAT_EQ(scale, 12.5f / QUANT_ACTIVATION_MAX);
+  EXPECT_EQ(quantized[12], -QUANT_ACTIVATION_MAX);
+  for (size_t i = 0; i < NUM_DCT_COEFF; ++i) {
+    EXPECT_NEAR(quantized[i] * scale, values[i], 0.5f * scale) << i;
+  }
+  for (size_t i = NUM_DCT_COEFF; i < QUANT_PCA_ROW; ++i) {
+    EXPECT_EQ(quantized[i], 0);
+  }
+
+  const float zeros[NUM_PCA_COMPONENTS] = {};
+  int16_t zeroQuantized[QUANT_LDA_ROW];
+  EXPECT_EQ(quantizeActivations(zeros, NUM_PCA_COMPONENTS, zeroQuantized),
+            1.0f);
+  EXPECT_EQ(zeroQuantized[0], 0);
+}
+
+/** @brief Given a stream of frames, assert that the int8 features and scores
+ * stay within 2% of the range of the float PCA and LDA. */
+TEST(QuantizedClassifierTest, FeaturesAndScoresMatchFloat) {
+  PrincipleComponentAnalysis pca(6, 13);
+  LinearDiscriminantAnalysis lda(6, 3);
+  QuantizedClassifier quantized(pca, lda, 13, 6, 3);
+
+  for (size_t frame = 0; frame < 64; ++frame) {
+    float mfcc[NUM_DCT_COEFF];
+    ToneMFCC(frame, mfcc);
+    matrix mfccSpec;
+    matrix_init_f32(&mfccSpec, 1, 13, mfcc);
+    matrix pcaSpec;
+    float features[NUM_PCA_COMPONENTS];
+    pca.apply(mfccSpec, pcaSpec, features);
+    float scores[NUM_CLASSES];
+    lda.scoreFrame(features, scores);
+
+    float quantizedFeatures[NUM_PCA_COMPONENTS];
+    quantized.projectFrame(mfcc, quantizedFeatures);
+    const float featureRange = MaxAbs(features, NUM_PCA_COMPONENTS);
+    for (uint16_t j = 0; j < 6; ++j) {
+      EXPECT_NEAR(quantizedFeatures[j], features[j], 0.02f * featureRange)
+          << "frame " << frame << ", component " << j;
+    }
+
+    // Scores from the float features, so that the LDA error is not mixed with
+    // the PCA error.
+    float quantizedScores[NUM_CLASSES];
+    quantized.scoreFeatures(features, quantizedScores);
+    const float scoreRange = MaxAbs(scores, NUM_CLASSES);
+    for (uint16_t c = 0; c < 3; ++c) {
+      EXPECT_NEAR(quantizedScores[c], scores[c], 0.02f * scoreRange)
+          << "frame " << frame << ", class " << c;
+    }
+  }
+}
+
+/** @brief Given recordings of each class, assert that the int8 backend gives
+ * the label of the float backend on at least 98% of the frames. */
+TEST(QuantizedClassifierTest, LabelsMatchFloat) {
+  const size_t frameLen = 2048;
+  for (const char* filename : {"audio/hello.mp3", "audio/alarm.mp3"}) {
+    Classification reference(WAVEFORM_SAMPLES / 2, 13, 13, 6, 3);
+    Classification quantized(WAVEFORM_SAMPLES / 2, 13, 13, 6, 3);
+    reference.setBackend(ClassifierBackend::STAGED);
+    quantized.setBackend(ClassifierBackend::INT8);
+
+    MP3Data data = readMP3File(filename, true);
+    ASSERT_FALSE(data.channel1.empty()) << filename;
+    std::vector<float> audio(frameLen);
+    size_t frames = 0;
+    size_t matches = 0;
+    for (size_t start = 0; start + frameLen <= data.channel1.size();
+         start += frameLen) {
+      for (size_t i = 0; i < frameLen; ++i) {
+        audio[i] = static_cast<float>(data.channel1[start + i]);
+      }
+      reference.classify(audio.data());
+      quantized.classify(audio.data());
+      frames++;
+      if (quantized.getClassificationLabel() ==
+          reference.getClassificationLabel()) {
+        matches++;
+      }
+    }
+    ASSERT_GT(frames, 0U) << filename;
+    EXPECT_GE(static_cast<float>(matches) / frames, 0.98f) << filename;
+  }
+}
+
+/** @brief Given the int8 backend, assert that it keeps the PCA features of
+ * the context, and that switching backends clears it. */
+TEST(QuantizedClassifierTest, BackendKeepsFeatureRows) {
+  const uint16_t fftSize = WAVEFORM_SAMPLES / 2;
+  std::vector<float> power(fftSize / 2 + 1, 1e-3f);
+  power[100] = 50.0f;
+
+  Classification classifier(fftSize, 13, 13, 6, 3, false);
+  classifier.classifyPowerSpectrum(power.data());
+  EXPECT_EQ(classifier.getFeatureRow(0), nullptr);
+
+  classifier.setBackend(ClassifierBackend::INT8);
+  EXPECT_EQ(classifier.getBackend(), ClassifierBackend::INT8);
+  EXPECT_EQ(classifier.getFeatureRow(0), nullptr);
+  classifier.classifyPowerSpectrum(power.data());
+  EXPECT_NE(classifier.getFeatureRow(0), nullptr);
+  EXPECT_EQ(classifier.getFeatureRow(1), nullptr);
+}
+
+/** @brief Report the memory of the PCA and LDA weights and the time per frame
+ * of each backend, from power spectrum to decision. */
+TEST(QuantizedClassifierTest, QuantizedCostReport) {
+  PrincipleComponentAnalysis pca(6, 13);
+  LinearDiscriminantAnalysis lda(6, 3);
+  QuantizedClassifier quantized(pca, lda, 13, 6, 3);
+  std::cout << "  Float PCA and LDA weights: "
+            << (NUM_DCT_COEFF * NUM_PCA_COMPONENTS +
+                NUM_PCA_COMPONENTS * NUM_CLASSES) *
+                   sizeof(float)
+            << " bytes" << std::endl;
+  std::cout << "  Int8 PCA and LDA weights and scales: "
+            << quantized.getWeightBytes() << " bytes" << std::endl;
+
+  const uint16_t fftSize = WAVEFORM_SAMPLES / 2;
+  const uint16_t numFreqBins = fftSize / 2 + 1;
+  const int iterations = 5000;
+  std::vector<std::vector<float>> spectra;
+  for (size_t frame = 0; frame < 16; ++frame) {
+    std::vector<float> power(numFreqBins, 1e-3f);
+    power[20 + (frame * 37) % 300] = 50.0f;
+    spectra.push_back(power);
+  }
+
+  const struct {
+    ClassifierBackend backend;
+    const char* name;
+  } backends[] = {{ClassifierBackend::STAGED, "Staged"},
+                  {ClassifierBackend::FUSED, "Fused"},
+                  {ClassifierBackend::INT8, "Int8"}};
+  for (const auto& entry : backends) {
+    Classification classifier(fftSize, 13, 13, 6, 3, false);
+    classifier.setBackend(entry.backend);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      classifier.classifyPowerSpectrum(spectra[i % spectra.size()].data());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::nano> elapsed = end - start;
+    std::cout << "  " << entry.name << " backend: "
+              << elapsed.count() / iterations << " ns per frame" << std::endl;
+  }
+}
@@ -0,0 +1,202 @@
+/**
+ ******************************************************************************
+ * @file    toneDetector_test.cpp
+ * @brief   Unit tests for the Goertzel tone pre-detector and a report of the
+ *          classification work it saves on the test audio corpus.
+ ******************************************************************************
+ */
+
+#include "toneDetector.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "classification.h"
+#include "constants.h"
+#include "mp3.h"
+
+/** @brief Frame size the classifier runs on. */
+constexpr size_t FRAME_SIZE = WAVEFORM_SAMPLES / 2;
+
+/**
+ * @brief Generate a sine frame.
+ *
+ * @param frequency Frequency of the sine (Hz).
+ * @param amplitude Amplitude of the sine.
+ * @return std::vector<float> FRAME_SIZE samples.
+ */
+static std::vector<float> generateSine(float frequency, float amplitude) {
+  std::vector<float> frame(FRAME_SIZE);
+  for (size_t i = 0; i < FRAME_SIZE; i++) {
+    frame[i] = amplitude * std::sin(TWO_PI_32 * frequency * i /
+                                    static_cast<float>(SAMPLE_FREQUENCY));
+  }
+  return frame;
+}
+
+/** @brief Struct for parameterized testing. */
+struct ToneParamType {
+  float frequency;  // Frequency of the tone (Hz).
+  float amplitude;  // Amplitude of the tone.
+  bool active;      // Expected detector decision.
+};
+
+/** @brief Parameterized test class for the tone pre-detector. */
+class ToneDetectorTest : public ::testing::TestWithParam<ToneParamType> {};
+
+/** @brief Given a tone, assert that the detector is only active for loud tones
+ * in the watched bands. */
+TEST_P(ToneDetectorTest, DetectsTonesInBands) {
+  ToneParamType param = GetParam();
+  ToneDetector detector({SMOKE_ALARM_BAND, SIREN_BAND, VOICE_BAND},
+                        SAMPLE_FREQUENCY);
+
+  std::vector<float> frame = generateSine(param.frequency, param.amplitude);
+  EXPECT_EQ(detector.isActive(frame.data(), frame.size()), param.active);
+}
+
+/** @brief Parametized options. */
+INSTANTIATE_TEST_SUITE_P(
+    ToneValues, ToneDetectorTest,
+    ::testing::Values(ToneParamType{3100.0f, 0.5f, true},    // Smoke alarm.
+                      ToneParamType{960.0f, 0.5f, true},     // Siren.
+                      ToneParamType{180.0f, 0.5f, true},     // Voice pitch.
+                      ToneParamType{3100.0f, 8000.0f, true},  // 16 bit units.
+                      ToneParamType{6000.0f, 0.5f, false},   // Out of band.
+                      ToneParamType{3100.0f, 1e-4f, false},  // Too quiet.
+                      ToneParamType{3100.0f, 1.0f, true}));
+
+/** @brief Loud white noise has no dominant bin and is rejected. */
+TEST(ToneDetectorTest, RejectsWhiteNoise) {
+  ToneDetector detector({SMOKE_ALARM_BAND, SIREN_BAND, VOICE_BAND},
+                        SAMPLE_FREQUENCY);
+  std::vector<float> frame(FRAME_SIZE);
+
+  srand(360);
+  int activeFrames = 0;
+  for (int i = 0; i < 100; i++) {
+    for (float& sample : frame) {
+      sample = (static_cast<float>(rand()) / RAND_MAX) * 2.0f - 1.0f;
+    }
+    detector.reset();
+    activeFrames += detector.isActive(frame.data(), frame.size());
+  }
+
+  EXPECT_EQ(activeFrames, 0);
+}
+
+/** @brief A tone that only starts in the second half of the frame is found. */
+TEST(ToneDetectorTest, DetectsToneInSecondHalf) {
+  ToneDetector detector({SMOKE_ALARM_BAND, SIREN_BAND, VOICE_BAND},
+                        SAMPLE_FREQUENCY);
+  std::vector<float> frame = generateSine(3100.0f, 0.5f);
+  std::fill(frame.begin(), frame.begin() + FRAME_SIZE / 2, 0.0f);
+
+  EXPECT_TRUE(detector.isActive(frame.data(), frame.size()));
+}
+
+/** @brief The detector stays active for the hangover after a tonal frame. */
+TEST(ToneDetectorTest, HangoverAfterTone) {
+  ToneDetector detector({SMOKE_ALARM_BAND}, SAMPLE_FREQUENCY);
+  std::vector<float> tone = generateSine(3100.0f, 0.5f);
+  std::vector<float> silence(FRAME_SIZE, 0.0f);
+
+  ASSERT_TRUE(detector.isActive(tone.data(), tone.size()));
+  for (uint8_t i = 0; i < PRE_DETECTOR_HANGOVER_FRAMES; i++) {
+    EXPECT_TRUE(detector.isActive(silence.data(), silence.size()));
+  }
+  EXPECT_FALSE(detector.isActive(silence.data(), silence.size()));
+}
+
+/** @brief Report the fraction of frames skipped and the classification time
+ * saved on the test audio corpus. Frames the detector lets through keep the
+ * label of the ungated classifier once their context holds no skipped frame,
+ * so skipping never produces a different known class from the same frames. */
+TEST(ToneDetectorTest, CorpusSkipReport) {
+  const std::vector<std::string> files = {
+      "alarm",        "hello",      "silence",  "long_siren_16k",
+      "car_horn_16k", "jackhammer", "285_sine", "long_jackhammer_16k",
+      "three_tone",   "reverse"};
+
+  size_t totalFrames = 0;
+  uint32_t totalSkipped = 0;
+  double totalGated_us = 0.0;
+  double totalUngated_us = 0.0;
+
+  for (const std::string& file : files) {
+    MP3Data data = readMP3File("audio/" + file + ".mp3", true);
+    const size_t numFrames = data.channel1.size() / FRAME_SIZE;
+
+    Classification gated(FRAME_SIZE, 13, 13, 6, 3, true);
+    Classification ungated(FRAME_SIZE, 13, 13, 6, 3, false);
+    ToneDetector detector({SMOKE_ALARM_BAND, SIREN_BAND, VOICE_BAND},
+                          SAMPLE_FREQUENCY);
+    std::vector<float> audio(FRAME_SIZE);
+    double detector_us = 0.0;
+    double classify_us = 0.0;
+    size_t framesSinceSkip = gated.getContextFrames();
+
+    for (size_t frame = 0; frame < numFrames; frame++) {
+      for (size_t i = 0; i < FRAME_SIZE; i++) {
+        audio[i] = static_cast<float>(data.channel1[frame * FRAME_SIZE + i]);
+      }
+
+      auto start = std::chrono::high_resolution_clock::now();
+      detector.isActive(audio.data(), audio.size());
+      auto mid = std::chrono::high_resolution_clock::now();
+      ungated.classify(audio.data());
+      auto end = std::chrono::high_resolution_clock::now();
+      detector_us +=
+          std::chrono::duration<double, std::micro>(mid - start).count();
+      classify_us +=
+          std::chrono::duration<double, std::micro>(end - mid).count();
+
+      const uint32_t skippedBefore = gated.getSkippedFrameCount();
+      gated.classify(audio.data());
+      if (gated.getSkippedFrameCount() != skippedBefore) {
+        framesSinceSkip = 0;
+        continue;
+      }
+
+      // The gated classifier votes over the latest active frames, so it only
+      // sees the same context as the ungated one once a whole context has
+      // passed since the last skipped frame.
+      framesSinceSkip++;
+      const std::string label = gated.getClassificationLabel();
+      if (label != "unknown" && framesSinceSkip >= gated.getContextFrames()) {
+        EXPECT_EQ(label, ungated.getClassificationLabel())
+            << file << " frame " << frame;
+      }
+    }
+
+    const uint32_t skipped = gated.getSkippedFrameCount();
+    std::cout << "  " << file << ": skipped " << skipped << " / " << numFrames
+              << " frames" << std::endl;
+
+    if (file == "silence") {
+      EXPECT_EQ(skipped, numFrames);
+    }
+
+    // Gated cost: the detector on every frame plus the pipeline on the frames
+    // it lets through.
+    totalFrames += numFrames;
+    totalSkipped += skipped;
+    totalGated_us +=
+        detector_us + classify_us * (numFrames - skipped) / numFrames;
+    totalUngated_us += classify_us;
+  }
+
+  std::cout << "  Corpus: skipped "
+            << 100.0 * totalSkipped / static_cast<double>(totalFrames)
+            << "% of frames, " << totalGated_us / totalFrames << " us vs "
+            << totalUngated_us / totalFrames << " us per frame ("
+            << 100.0 * (1.0 - totalGated_us / totalUngated_us) << "% saved)"
+            << std::endl;
+}
@@ -0,0 +1,179 @@
+/**
+ ******************************************************************************
+ * @file    activityGate_test.cpp
+ * @brief   Unit tests for the DoA activity gate and a report of its duty cycle
+ *          and the DoA work it saves on the test audio corpus.
+ ******************************************************************************
+ */
+
+#include "activityGate.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "constants.h"
+#include "doa.h"
+#include "mp3.h"
+
+/**
+ * @brief Generate a sine frame.
+ *
+ * @param amplitude Amplitude of the sine.
+ * @param numSamples Number of samples.
+ * @return std::vector<float> The frame.
+ */
+static std::vector<float> generateSine(float amplitude, size_t numSamples) {
+  std::vector<float> frame(numSamples);
+  for (size_t i = 0; i < numSamples; i++) {
+    frame[i] = amplitude * std::sin(TWO_PI_32 * 440.0f * i /
+                                    static_cast<float>(SAMPLE_FREQUENCY));
+  }
+  return frame;
+}
+
+/** @brief Given frames in normalized and 24 bit units, assert that the RMS is
+ * relative to the full scale of the gate and ignores the DC offset. */
+TEST(ActivityGateTest, FrameRms) {
+  std::vector<float> sine = generateSine(0.5f, DOA_SAMPLES);
+  ActivityGate normalized;
+  EXPECT_NEAR(normalized.frameRms(sine.data(), sine.size()),
+              0.5f / std::sqrt(2.0f), 1e-3f);
+
+  for (float& sample : sine) {
+    sample = sample * MIC_SAMPLE_FULL_SCALE + 1000.0f;
+  }
+  ActivityGate mic(MIC_SAMPLE_FULL_SCALE);
+  EXPECT_NEAR(mic.frameRms(sine.data(), sine.size()), 0.5f / std::sqrt(2.0f),
+              1e-3f);
+
+  std::vector<float> constant(DOA_SAMPLES, 0.25f);
+  EXPECT_NEAR(normalized.frameRms(constant.data(), constant.size()), 0.0f,
+              1e-6f);
+}
+
+/** @brief Given 24 bit mic frames, assert that a gate at the mic full scale
+ * opens on a -40 dBFS tone and stays closed on a -80 dBFS one, which a gate at
+ * 16 bit scale would take for sound. */
+TEST(ActivityGateTest, MicFullScale) {
+  std::vector<float> loud =
+      generateSine(1e-2f * MIC_SAMPLE_FULL_SCALE, DOA_SAMPLES);
+  std::vector<float> quiet =
+      generateSine(1e-4f * MIC_SAMPLE_FULL_SCALE, DOA_SAMPLES);
+  const float* loudMics[NUM_MICS] = {loud.data(), loud.data(), loud.data(),
+                                     loud.data()};
+  const float* quietMics[NUM_MICS] = {quiet.data(), quiet.data(),
+                                      quiet.data(), quiet.data()};
+
+  ActivityGate loudGate(MIC_SAMPLE_FULL_SCALE);
+  EXPECT_TRUE(loudGate.update(loudMics, NUM_MICS, DOA_SAMPLES));
+  ActivityGate quietGate(MIC_SAMPLE_FULL_SCALE);
+  EXPECT_FALSE(quietGate.update(quietMics, NUM_MICS, DOA_SAMPLES));
+  ActivityGate sixteenBitGate(32768.0f);
+  EXPECT_TRUE(sixteenBitGate.update(quietMics, NUM_MICS, DOA_SAMPLES));
+}
+
+/** @brief Given levels between the close and open thresholds, assert that they
+ * keep the current state of the gate. */
+TEST(ActivityGateTest, Hysteresis) {
+  ActivityGate gate;
+  const float between = 0.5f * (DOA_GATE_OPEN_RMS + DOA_GATE_CLOSE_RMS);
+
+  EXPECT_FALSE(gate.update(between));
+  EXPECT_TRUE(gate.update(DOA_GATE_OPEN_RMS));
+  for (int i = 0; i < 10; i++) {
+    EXPECT_TRUE(gate.update(between));
+  }
+}
+
+/** @brief Given quiet frames after an active one, assert that the gate lets
+ * DOA_GATE_HOLD_FRAMES of them through and closes on the next. */
+TEST(ActivityGateTest, HoldTime) {
+  ActivityGate gate;
+  ASSERT_TRUE(gate.update(1.0f));
+  for (uint8_t i = 0; i < DOA_GATE_HOLD_FRAMES; i++) {
+    EXPECT_TRUE(gate.update(0.0f));
+  }
+  EXPECT_FALSE(gate.update(0.0f));
+  EXPECT_FALSE(gate.isOpen());
+}
+
+/** @brief Given a sequence of frames, assert that the counters track the
+ * frames and the gated frames, and that reset clears them. */
+TEST(ActivityGateTest, Counters) {
+  std::vector<float> silence(DOA_SAMPLES, 0.0f);
+  std::vector<float> tone = generateSine(0.1f, DOA_SAMPLES);
+  const float* silentMics[NUM_MICS] = {silence.data(), silence.data(),
+                                       silence.data(), silence.data()};
+  const float* toneMics[NUM_MICS] = {tone.data(), tone.data(), tone.data(),
+                                     tone.data()};
+
+  ActivityGate gate;
+  EXPECT_FALSE(gate.update(silentMics, NUM_MICS, DOA_SAMPLES));
+  EXPECT_FALSE(gate.update(silentMics, NUM_MICS, DOA_SAMPLES));
+  EXPECT_TRUE(gate.update(toneMics, NUM_MICS, DOA_SAMPLES));
+  EXPECT_EQ(gate.getFrameCount(), 3U);
+  EXPECT_EQ(gate.getGatedFrameCount(), 2U);
+
+  gate.reset();
+  EXPECT_FALSE(gate.isOpen());
+  EXPECT_EQ(gate.getFrameCount(), 0U);
+  EXPECT_EQ(gate.getGatedFrameCount(), 0U);
+}
+
+/** @brief Report the duty cycle of DoA behind the gate and the time per frame
+ * saved on silence and long recordings. Silence never opens the gate. */
+TEST(ActivityGateTest, DutyCycleReport) {
+  const std::vector<std::string> files = {"silence", "long_jackhammer_16k",
+                                          "long_siren_16k"};
+  DOA doa(DOA_SAMPLES);
+  std::vector<float> audio(DOA_SAMPLES);
+  const float* mics[NUM_MICS] = {audio.data(), audio.data(), audio.data(),
+                                 audio.data()};
+
+  for (const std::string& file : files) {
+    MP3Data data = readMP3File("audio/" + file + ".mp3", true);
+    const size_t numFrames = data.channel1.size() / DOA_SAMPLES;
+    ASSERT_GT(numFrames, 0U);
+
+    // The decoded MP3 samples are normalized to [-1, 1].
+    ActivityGate gate;
+    double gate_us = 0.0;
+    double doa_us = 0.0;
+    for (size_t frame = 0; frame < numFrames; frame++) {
+      for (size_t i = 0; i < DOA_SAMPLES; i++) {
+        audio[i] = static_cast<float>(data.channel1[frame * DOA_SAMPLES + i]);
+      }
+
+      // The same audio on every mic. The DoA cost does not depend on it.
+      auto start = std::chrono::high_resolution_clock::now();
+      gate.update(mics, NUM_MICS, DOA_SAMPLES);
+      auto mid = std::chrono::high_resolution_clock::now();
+      doa.calculateDirection(audio.data(), audio.data(), audio.data(),
+                             audio.data());
+      auto end = std::chrono::high_resolution_clock::now();
+      gate_us += std::chrono::duration<double, std::micro>(mid - start).count();
+      doa_us += std::chrono::duration<double, std::micro>(end - mid).count();
+    }
+
+    const uint32_t gated = gate.getGatedFrameCount();
+    EXPECT_EQ(gate.getFrameCount(), numFrames);
+    if (file == "silence") {
+      EXPECT_EQ(gated, numFrames);
+    }
+
+    // Gated cost: the gate on every frame plus DoA on the frames it lets
+    // through.
+    const double ungatedFrame_us = doa_us / numFrames;
+    const double gatedFrame_us =
+        (gate_us + doa_us * (numFrames - gated) / numFrames) / numFrames;
+    std::cout << "  " << file << ": DoA ran on "
+              << 100.0 * (numFrames - gated) / numFrames << "% of "
+              << numFrames << " frames, " << gatedFrame_us << " us vs "
+              << ungatedFrame_us << " us per frame" << std::endl;
+  }
+}
@@ -8,10 +8,36 @@
 #include "doaSmoother.h"
 
 #include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdlib>
+#include <new>
 
 #include "angles.hpp"
 
+/** @brief Whether the global allocator counts allocations. */
+static std::atomic<bool> countAllocations{false};
+
+/** @brief Number of allocations made while counting. */
+static std::atomic<size_t> numAllocations{0};
+
+void* operator new(size_t size) {
+  if (countAllocations) {
+    numAllocations++;
+  }
+  void* ptr = std::malloc(size ? size : 1);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
 static float angularErrorRad(float a, float b) {
   float diff = std::abs(a - b);
   if (diff > 3.14159265f) {
@@ -86,3 +112,88 @@ TEST(DoASmootherTest, GradualChange_WithinThreshold) {
         << "Gradual change within ±15° should be tracked";
   }
 }
+
+TEST(DoASmootherTest, WrapAround_CircularMean) {
+  DoASmoother smoother;
+  smoother.update(degreeToRad(355.0f));
+  smoother.update(degreeToRad(5.0f));
+  smoother.update(degreeToRad(358.0f));
+  float out = smoother.update(degreeToRad(2.0f));
+  EXPECT_TRUE(withinDeg(out, 0.0f, 1.0f))
+      << "Mean across 0/360 should stay near 0°, got " << radToDegree(out);
+}
+
+TEST(DoASmootherTest, SlidingWindow_DropsOldestAngle) {
+  DoASmoother smoother;
+  for (int i = 0; i < 5; i++) {
+    smoother.update(0.0f);
+  }
+  float out = 0.0f;
+  for (int i = 0; i < 5; i++) {
+    out = smoother.update(degreeToRad(10.0f));
+  }
+  EXPECT_TRUE(withinDeg(out, degreeToRad(10.0f), 0.01f))
+      << "Window of 5 should only hold the last 5 angles";
+}
+
+TEST(DoASmootherTest, Kalman_TracksConstantVelocityAcrossWrap) {
+  DoASmoother smoother(DoASmootherMode::KALMAN);
+  const float step = degreeToRad(4.0f);
+  float truth = degreeToRad(300.0f);
+  float out = 0.0f;
+  for (int i = 0; i < 40; i++) {
+    out = smoother.update(truth);
+    truth = normalizeAngleRad(truth + step);
+  }
+  // 40 steps of 4° crosses 0° at step 15.
+  EXPECT_TRUE(withinDeg(out, normalizeAngleRad(truth - step), 1.0f))
+      << "Tracker should follow a steady sweep, got " << radToDegree(out);
+  EXPECT_NEAR(smoother.getAngularVelocity(), step, degreeToRad(0.5f));
+}
+
+TEST(DoASmootherTest, Kalman_ReducesJitter) {
+  DoASmoother smoother(DoASmootherMode::KALMAN);
+  const float jitter[] = {4.0f, -3.0f, 5.0f, -4.0f, 2.0f, -5.0f, 3.0f, -2.0f};
+  float maxError = 0.0f;
+  for (int i = 0; i < 48; i++) {
+    float out = smoother.update(degreeToRad(90.0f + jitter[i % 8]));
+    if (i >= 16) {
+      maxError = std::max(maxError, angularErrorRad(out, degreeToRad(90.0f)));
+    }
+  }
+  EXPECT_LT(radToDegree(maxError), 3.0f);
+}
+
+TEST(DoASmootherTest, Kalman_IgnoresShortJumpsAndFollowsNewSource) {
+  DoASmoother smoother(DoASmootherMode::KALMAN);
+  for (int i = 0; i < 5; i++) {
+    smoother.update(degreeToRad(45.0f));
+  }
+  smoother.update(degreeToRad(200.0f));
+  float out = smoother.update(degreeToRad(45.0f));
+  EXPECT_TRUE(withinDeg(out, degreeToRad(45.0f), 2.0f));
+
+  for (int i = 0; i < 3; i++) {
+    out = smoother.update(degreeToRad(200.0f));
+  }
+  EXPECT_TRUE(withinDeg(out, degreeToRad(200.0f), 1.0f));
+}
+
+TEST(DoASmootherTest, Update_DoesNotAllocate) {
+  for (DoASmootherMode mode :
+       {DoASmootherMode::SLIDING_MEAN, DoASmootherMode::KALMAN}) {
+    DoASmoother smoother(mode);
+    numAllocations = 0;
+    countAllocations = true;
+    for (int i = 0; i < 200; i++) {
+      // Steady source, single-frame outliers and source switches.
+      float deg = (i % 40 < 20) ? 30.0f : 250.0f;
+      if (i % 7 == 3) {
+        deg += 90.0f;
+      }
+      smoother.update(degreeToRad(deg + (i % 3)));
+    }
+    countAllocations = false;
+    EXPECT_EQ(numAllocations, 0U);
+  }
+}
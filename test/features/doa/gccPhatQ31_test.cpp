@@ -0,0 +1,180 @@
+/**
+ ******************************************************************************
+ * @file    gccPhatQ31_test.cpp
+ * @brief   Unit tests and benchmark for the fixed-point GCC-PhaT algo.
+ ******************************************************************************
+ */
+
+#include "gccPhatQ31.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AudioFile.h"
+#include "angles.hpp"
+#include "constants.h"
+#include "doa.h"
+#include "gccPhat.h"
+
+/** @brief Scale of the microphone samples after the 8 bit shift (24 bit). */
+const static double MIC_SAMPLE_SCALE = 8388607.0;
+
+/** @brief Microphone frames of one recording in both sample formats. The
+ * float frames hold the same quantized samples normalized to [-1, 1]. */
+struct MicFrames {
+  std::vector<q31_t> fixed[NUM_MICS];
+  std::vector<float> floating[NUM_MICS];
+};
+
+/**
+ * @brief Read a frame of each mic recording for a source at the given angle,
+ * quantized the same way as the shifted microphone data of the runtime.
+ *
+ * @param angle Angle in degree of the audio source.
+ * @param numSamples The number of samples in the frame.
+ * @return MicFrames The frames of every microphone.
+ */
+static MicFrames readMicFrames(int angle, size_t numSamples) {
+  std::string folder = "audio/mic_recordings/";
+  const int OFFSET = 1500;
+  MicFrames frames;
+
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    AudioFile<double> audioFile(folder + "mic" + std::to_string(mic) +
+                                "_angle_" + std::to_string(angle) + ".wav");
+    for (size_t i = 0; i < numSamples; i++) {
+      const q31_t sample = static_cast<q31_t>(
+          audioFile.samples[0][OFFSET + i] * MIC_SAMPLE_SCALE);
+      frames.fixed[mic].push_back(sample);
+      frames.floating[mic].push_back(static_cast<float>(sample /
+                                                        MIC_SAMPLE_SCALE));
+    }
+  }
+
+  return frames;
+}
+
+/** @brief Struct for parameterized testing. */
+struct GCCPhatQ31ParamType {
+  int angle;  // Angle in degree with 0 degrees being North and 90 to West.
+};
+
+/** @brief Parameterized test class for fixed-point GCC PhaT. */
+class GCCPhatQ31Test : public ::testing::TestWithParam<GCCPhatQ31ParamType> {
+};
+
+/** @brief Given the recorded microphone data, assert that the fixed-point
+ * GCC-PhaT picks the same lags (and therefore angle) as the float path. */
+TEST_P(GCCPhatQ31Test, MatchesFloatPath) {
+  const int angle = GetParam().angle;
+  MicFrames frames = readMicFrames(angle, DOA_SAMPLES);
+
+  GCCPhaT floatPath{DOA_SAMPLES, SAMPLE_FREQUENCY, PeakInterpolation::NONE};
+  const float floatAngle = floatPath.calculateDirection(
+      frames.floating[0].data(), frames.floating[1].data(),
+      frames.floating[2].data(), frames.floating[3].data());
+
+  GCCPhaTQ31 fixedPath{DOA_SAMPLES, SAMPLE_FREQUENCY, PeakInterpolation::NONE};
+  const float fixedAngle = fixedPath.calculateDirection(
+      frames.fixed[0].data(), frames.fixed[1].data(), frames.fixed[2].data(),
+      frames.fixed[3].data());
+
+  // Both paths share the angle estimation, so equal lags on all four mic pairs
+  // give equal angles.
+  EXPECT_FLOAT_EQ(fixedAngle, floatAngle);
+
+  // Fractional lags are interpolated from differently rounded correlations.
+  GCCPhaT floatInterpolated{DOA_SAMPLES};
+  GCCPhaTQ31 fixedInterpolated{DOA_SAMPLES};
+  EXPECT_NEAR(fixedInterpolated.calculateDirection(
+                  frames.fixed[0].data(), frames.fixed[1].data(),
+                  frames.fixed[2].data(), frames.fixed[3].data()),
+              floatInterpolated.calculateDirection(
+                  frames.floating[0].data(), frames.floating[1].data(),
+                  frames.floating[2].data(), frames.floating[3].data()),
+              degreeToRad(1.0f));
+}
+
+/** @brief Parametized options. */
+INSTANTIATE_TEST_SUITE_P(
+    AngleValues, GCCPhatQ31Test,
+    ::testing::Values(GCCPhatQ31ParamType{0}, GCCPhatQ31ParamType{45},
+                      GCCPhatQ31ParamType{90}, GCCPhatQ31ParamType{135},
+                      GCCPhatQ31ParamType{180}, GCCPhatQ31ParamType{225},
+                      GCCPhatQ31ParamType{270}, GCCPhatQ31ParamType{315}));
+
+/** @brief The fixed-point path is selectable through the DOA module and
+ * silent input does not fail. */
+TEST(GCCPhatQ31Test, SelectableThroughDOA) {
+  std::vector<q31_t> silence(DOA_SAMPLES, 0);
+  DOA doa(DOA_SAMPLES);
+
+  float angle = doa.calculateDirection(silence.data(), silence.data(),
+                                       silence.data(), silence.data(),
+                                       DOA_Algorithms::GCC_PHAT_Q31);
+  EXPECT_GE(angle, 0.0f);
+  EXPECT_LE(angle, TWO_PI_32);
+}
+
+/** @brief Benchmark of the float and fixed-point GCC-PhaT on one DoA update,
+ * including the int to float conversion the runtime does for the float path.
+ * Host timings only indicate the relative cost; cycle counts need the
+ * target. */
+TEST(GCCPhatQ31Test, BenchmarkAgainstFloat) {
+  const int iterations = 20;
+  MicFrames frames = readMicFrames(90, DOA_SAMPLES);
+  std::vector<float> converted[NUM_MICS];
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    converted[mic].resize(DOA_SAMPLES);
+  }
+
+  GCCPhaT floatPath{DOA_SAMPLES};
+  float sink = 0.0f;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    for (size_t mic = 0; mic < NUM_MICS; mic++) {
+      for (size_t i = 0; i < DOA_SAMPLES; i++) {
+        converted[mic][i] =
+            static_cast<float>(frames.fixed[mic][i] / MIC_SAMPLE_SCALE);
+      }
+    }
+    sink += floatPath.calculateDirection(
+        converted[0].data(), converted[1].data(), converted[2].data(),
+        converted[3].data());
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::micro> floatTime = end - start;
+
+  GCCPhaTQ31 fixedPath{DOA_SAMPLES};
+  start = std::chrono::high_resolution_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    sink += fixedPath.calculateDirection(
+        frames.fixed[0].data(), frames.fixed[1].data(), frames.fixed[2].data(),
+        frames.fixed[3].data());
+  }
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::micro> fixedTime = end - start;
+
+  // Float path working memory: the GCC-PhaT object (five frequency domains),
+  // FFT input/output/batch and IFFT input/output scratch, and the four float
+  // frames the runtime converts into.
+  const size_t floatBytes =
+      sizeof(GCCPhaT) +
+      (2 + FFT_MAX_CHANNELS) * DOA_SAMPLES * sizeof(float) +
+      2 * DOA_SAMPLES * sizeof(float) + NUM_MICS * DOA_SAMPLES * sizeof(float);
+  const size_t fixedBytes = fixedPath.getMemoryUsage();
+
+  std::cout << "  GCC-PhaT " << NUM_MICS << " x " << DOA_SAMPLES
+            << ": float " << floatTime.count() / iterations << " us, "
+            << floatBytes / 1024 << " KiB; q31 "
+            << fixedTime.count() / iterations << " us, " << fixedBytes / 1024
+            << " KiB (" << (floatBytes - fixedBytes) / 1024 << " KiB saved)"
+            << std::endl;
+
+  EXPECT_GT(sink, -1.0f);  // Keep results alive.
+  EXPECT_LT(fixedBytes, floatBytes);
+}
@@ -9,6 +9,16 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "AudioFile.h"
 #include "angles.hpp"
 #include "constants.h"
@@ -26,50 +36,78 @@ struct GCCPhatAngleParamType {
 class GCCPhatAngleTest
     : public ::testing::TestWithParam<GCCPhatAngleParamType> {};
 
+/** @brief Microphone inputs recorded from a single audio source. */
+struct MicRecording {
+  std::vector<float> mics[NUM_MICS];
+  int sampleFrequency;
+};
+
+/**
+ * @brief Read an arbitrary window in the middle of the recording of each mic
+ * for an audio source at the given angle.
+ *
+ * @param angle Angle in degree of the audio source.
+ * @return MicRecording The microphone inputs.
+ */
+static MicRecording readMicRecording(int angle) {
+  std::string folder = "audio/mic_recordings/";
+  const int OFFSET = 1500;
+  MicRecording recording;
+
+  // Files use 0-indexed naming for consistency.
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    AudioFile<double> audioFile(folder + "mic" + std::to_string(mic) +
+                                "_angle_" + std::to_string(angle) + ".wav");
+    recording.sampleFrequency = audioFile.getSampleRate();
+    recording.mics[mic].assign(
+        audioFile.samples[0].begin() + OFFSET,
+        audioFile.samples[0].begin() + OFFSET + WAVEFORM_SAMPLES);
+  }
+
+  return recording;
+}
+
 /** @brief Given an audio input from a single audio source from a room, assert
  * that the GCC-PhaT can estimate the direction of sound source correctly. */
 TEST_P(GCCPhatAngleTest, SingleAudioSourceAngle) {
   GCCPhatAngleParamType param = GetParam();
   int angle = param.angle;
 
-  // Read in audio data for each mic (using 0-indexed naming for consistency).
-  std::string folder = "audio/mic_recordings/";
-  AudioFile<double> audioFile1(folder + "mic0_angle_" + std::to_string(angle) +
-                               ".wav");
-  AudioFile<double> audioFile2(folder + "mic1_angle_" + std::to_string(angle) +
-                               ".wav");
-  AudioFile<double> audioFile3(folder + "mic2_angle_" + std::to_string(angle) +
-                               ".wav");
-  AudioFile<double> audioFile4(folder + "mic3_angle_" + std::to_string(angle) +
-                               ".wav");
-
-  const int sampleFrequency = audioFile1.getSampleRate();
-
-  // Choose an arbitray window in the middle of the audio data.
-  const int OFFSET = 1500;
-  std::vector<float> mic1Input(
-      audioFile1.samples[0].begin() + OFFSET,
-      audioFile1.samples[0].begin() + OFFSET + WAVEFORM_SAMPLES);
-  std::vector<float> mic2Input(
-      audioFile2.samples[0].begin() + OFFSET,
-      audioFile2.samples[0].begin() + OFFSET + WAVEFORM_SAMPLES);
-  std::vector<float> mic3Input(
-      audioFile3.samples[0].begin() + OFFSET,
-      audioFile3.samples[0].begin() + OFFSET + WAVEFORM_SAMPLES);
-  std::vector<float> mic4Input(
-      audioFile4.samples[0].begin() + OFFSET,
-      audioFile4.samples[0].begin() + OFFSET + WAVEFORM_SAMPLES);
+  // Read in audio data for each mic.
+  MicRecording recording = readMicRecording(angle);
 
   // Run GCC-PhaT on the audio sample input.
-  GCCPhaT gccPhat{WAVEFORM_SAMPLES, sampleFrequency};
+  GCCPhaT gccPhat{WAVEFORM_SAMPLES, recording.sampleFrequency};
   float angle_rad = gccPhat.calculateDirection(
-      mic1Input.data(), mic2Input.data(), mic3Input.data(), mic4Input.data());
+      recording.mics[0].data(), recording.mics[1].data(),
+      recording.mics[2].data(), recording.mics[3].data());
 
   // Assert that the angle is approximately 0 degrees from the origin.
   float expectedAngle_rad = degreeToRad(static_cast<float>(angle));
   EXPECT_NEAR(angle_rad, expectedAngle_rad, TOLERABLE_ERROR_RAD);
 }
 
+/** @brief Given an audio input from a single audio source from a room, assert
+ * that the least-squares solver over every mic pair estimates the direction of
+ * sound source correctly. */
+TEST_P(GCCPhatAngleTest, LeastSquaresAngle) {
+  int angle = GetParam().angle;
+  MicRecording recording = readMicRecording(angle);
+
+  GCCPhaT gccPhat{WAVEFORM_SAMPLES, recording.sampleFrequency,
+                  PeakInterpolation::PARABOLIC, CorrelationEvaluator::AUTO,
+                  TdoaSolver::LEAST_SQUARES};
+  ASSERT_EQ(gccPhat.getTdoaSolver(), TdoaSolver::LEAST_SQUARES);
+  float angle_rad = gccPhat.calculateDirection(
+      recording.mics[0].data(), recording.mics[1].data(),
+      recording.mics[2].data(), recording.mics[3].data());
+
+  // Angles wrap at 2 pi.
+  float expectedAngle_rad = degreeToRad(static_cast<float>(angle));
+  EXPECT_NEAR(std::remainder(angle_rad - expectedAngle_rad, TWO_PI_32), 0.0f,
+              TOLERABLE_ERROR_RAD);
+}
+
 /** @brief Parametized options. */
 INSTANTIATE_TEST_SUITE_P(
     AngleValues, GCCPhatAngleTest,
@@ -77,3 +115,390 @@ INSTANTIATE_TEST_SUITE_P(
                       GCCPhatAngleParamType{90}, GCCPhatAngleParamType{135},
                       GCCPhatAngleParamType{180}, GCCPhatAngleParamType{225},
                       GCCPhatAngleParamType{270}, GCCPhatAngleParamType{315}));
+
+/** @brief Given independent GCC-PhaT instances running on several threads,
+ * assert that each produces the same directions as a single-threaded run. */
+TEST(GCCPhatThreadTest, ConcurrentInstancesMatchSingleThreaded) {
+  const std::vector<int> angles = {0, 45, 90, 135, 180, 225, 270, 315};
+  const int numThreads = 4;
+  const int repetitions = 3;
+
+  std::vector<MicRecording> recordings;
+  for (int angle : angles) {
+    recordings.push_back(readMicRecording(angle));
+  }
+
+  // Golden output from a single thread.
+  std::vector<float> golden;
+  GCCPhaT reference{WAVEFORM_SAMPLES, recordings[0].sampleFrequency};
+  for (MicRecording& recording : recordings) {
+    golden.push_back(reference.calculateDirection(
+        recording.mics[0].data(), recording.mics[1].data(),
+        recording.mics[2].data(), recording.mics[3].data()));
+  }
+
+  // Each thread owns its instance but reads the shared (read only) inputs.
+  std::vector<std::vector<float>> results(numThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; t++) {
+    threads.emplace_back([&, t]() {
+      GCCPhaT gccPhat{WAVEFORM_SAMPLES, recordings[0].sampleFrequency};
+      for (int rep = 0; rep < repetitions; rep++) {
+        // Offset the start so threads work on different angles at once.
+        for (size_t i = 0; i < recordings.size(); i++) {
+          MicRecording& recording = recordings[(i + t) % recordings.size()];
+          results[t].push_back(gccPhat.calculateDirection(
+              recording.mics[0].data(), recording.mics[1].data(),
+              recording.mics[2].data(), recording.mics[3].data()));
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (int t = 0; t < numThreads; t++) {
+    ASSERT_EQ(results[t].size(), repetitions * recordings.size());
+    for (size_t i = 0; i < results[t].size(); i++) {
+      const size_t angleIdx = (i % recordings.size() + t) % recordings.size();
+      EXPECT_EQ(results[t][i], golden[angleIdx])
+          << "thread " << t << ", angle " << angles[angleIdx];
+    }
+  }
+}
+
+/** @brief Given the exact delays of every mic pair for a direction, assert
+ * that the least-squares solution of each array geometry recovers that
+ * direction. */
+TEST(GCCPhatLeastSquaresTest, ExactDelaysGiveExactAngle) {
+  for (const ArrayGeometry* geometry :
+       {&DEFAULT_ARRAY_GEOMETRY, &REV0_ARRAY_GEOMETRY, &PCB_ARRAY_GEOMETRY}) {
+    GCCPhaT gccPhat{DOA_SAMPLES,
+                    SAMPLE_FREQUENCY,
+                    PeakInterpolation::PARABOLIC,
+                    CorrelationEvaluator::AUTO,
+                    TdoaSolver::LEAST_SQUARES,
+                    *geometry};
+    for (int angle = 0; angle < 360; angle += 15) {
+      const float angle_rad = degreeToRad(static_cast<float>(angle));
+      const float ux = -std::sin(angle_rad);
+      const float uy = std::cos(angle_rad);
+
+      float timeDelays_s[NUM_MIC_PAIRS];
+      for (size_t pair = 0; pair < NUM_MIC_PAIRS; pair++) {
+        timeDelays_s[pair] =
+            (micPairBaseline(pair, geometry->positionX_m) * ux +
+             micPairBaseline(pair, geometry->positionY_m) * uy) /
+            SOUND_AIR_mps;
+      }
+
+      const float estimate = gccPhat.estimateAngleLeastSquares(timeDelays_s);
+      EXPECT_NEAR(std::remainder(estimate - angle_rad, TWO_PI_32), 0.0f, 1e-4f)
+          << "angle " << angle;
+    }
+  }
+}
+
+/** @brief The pseudo-inverse is a left inverse of the pair baselines. */
+TEST(GCCPhatLeastSquaresTest, PseudoInverseIsLeftInverse) {
+  float xx = 0.0f;
+  float xy = 0.0f;
+  float yx = 0.0f;
+  float yy = 0.0f;
+  for (size_t pair = 0; pair < NUM_MIC_PAIRS; pair++) {
+    const float gx = micPairBaseline(pair, MIC_POSITION_X_m);
+    const float gy = micPairBaseline(pair, MIC_POSITION_Y_m);
+    xx += TDOA_PSEUDO_INVERSE.x[pair] * gx;
+    xy += TDOA_PSEUDO_INVERSE.x[pair] * gy;
+    yx += TDOA_PSEUDO_INVERSE.y[pair] * gx;
+    yy += TDOA_PSEUDO_INVERSE.y[pair] * gy;
+  }
+
+  EXPECT_NEAR(xx, 1.0f, 1e-5f);
+  EXPECT_NEAR(xy, 0.0f, 1e-5f);
+  EXPECT_NEAR(yx, 0.0f, 1e-5f);
+  EXPECT_NEAR(yy, 1.0f, 1e-5f);
+}
+
+/** @brief Given a single audio source, assert that the strongest of the
+ * multi-source directions is the single-source direction. */
+TEST(GCCPhatMultiSourceTest, PrimaryMatchesSingleSource) {
+  for (int angle : {0, 135, 270}) {
+    MicRecording recording = readMicRecording(angle);
+    GCCPhaT gccPhat{WAVEFORM_SAMPLES, recording.sampleFrequency};
+    const float single = gccPhat.calculateDirection(
+        recording.mics[0].data(), recording.mics[1].data(),
+        recording.mics[2].data(), recording.mics[3].data());
+
+    DoASource sources[DOA_MAX_SOURCES];
+    const size_t numSources = gccPhat.calculateDirections(
+        recording.mics[0].data(), recording.mics[1].data(),
+        recording.mics[2].data(), recording.mics[3].data(), sources,
+        DOA_MAX_SOURCES);
+    ASSERT_GE(numSources, 1U);
+    ASSERT_LE(numSources, DOA_MAX_SOURCES);
+    EXPECT_EQ(sources[0].angle_rad, single) << "angle " << angle;
+    for (size_t i = 1; i < numSources; i++) {
+      EXPECT_LE(sources[i].strength, sources[i - 1].strength);
+    }
+  }
+}
+
+/**
+ * @brief Simulate the signal of each mic for a far-field source of white
+ * noise, with fractional delays from a windowed sinc.
+ *
+ * @param angle_rad Direction of the source.
+ * @param seed Seed of the noise.
+ * @param [out] mics Samples of each mic, added to the existing ones.
+ */
+static void addNoiseSource(float angle_rad, unsigned int seed,
+                           std::vector<float> mics[NUM_MICS]) {
+  const int HALF_TAPS = 16;
+  const size_t numSamples = mics[0].size();
+  srand(seed);
+  std::vector<float> noise(numSamples + 2 * HALF_TAPS + 16);
+  for (float& value : noise) {
+    value = (static_cast<float>(rand()) / RAND_MAX) * 2.0f - 1.0f;
+  }
+
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    // Arrival time relative to the array centre, in samples.
+    const float delay = -(MIC_POSITION_X_m[mic] * -std::sin(angle_rad) +
+                          MIC_POSITION_Y_m[mic] * std::cos(angle_rad)) /
+                        SOUND_AIR_mps * SAMPLE_FREQUENCY;
+    for (size_t n = 0; n < numSamples; n++) {
+      const float t = n + HALF_TAPS + 8 - delay;
+      const int centre = static_cast<int>(std::floor(t));
+      float sample = 0.0f;
+      for (int k = centre - HALF_TAPS + 1; k <= centre + HALF_TAPS; k++) {
+        const float x = t - k;
+        const float sinc =
+            (std::fabs(x) < 1e-6f) ? 1.0f : std::sin(PI_32 * x) / (PI_32 * x);
+        const float window = 0.5f + 0.5f * std::cos(PI_32 * x / HALF_TAPS);
+        sample += noise[k] * sinc * window;
+      }
+      mics[mic][n] += sample;
+    }
+  }
+}
+
+/** @brief Given two uncorrelated audio sources at once, assert that both
+ * directions are found. */
+TEST(GCCPhatMultiSourceTest, TwoSources) {
+  const float angles[2] = {degreeToRad(30.0f), degreeToRad(200.0f)};
+  std::vector<float> mics[NUM_MICS];
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    mics[mic].assign(DOA_SAMPLES, 0.0f);
+  }
+  addNoiseSource(angles[0], 1, mics);
+  addNoiseSource(angles[1], 2, mics);
+
+  GCCPhaT gccPhat{DOA_SAMPLES};
+  DoASource sources[DOA_MAX_SOURCES];
+  const size_t numSources =
+      gccPhat.calculateDirections(mics[0].data(), mics[1].data(),
+                                  mics[2].data(), mics[3].data(), sources,
+                                  DOA_MAX_SOURCES);
+  ASSERT_GE(numSources, 2U);
+
+  // Both sources are among the two strongest.
+  for (float angle : angles) {
+    float bestError = PI_32;
+    for (size_t i = 0; i < 2; i++) {
+      bestError = std::min(
+          bestError,
+          std::fabs(std::remainder(sources[i].angle_rad - angle, TWO_PI_32)));
+    }
+    EXPECT_LE(bestError, degreeToRad(10.0f))
+        << "angle " << radToDegree(angle);
+  }
+}
+
+/** @brief Report the time per frame of the single and multi-source paths. */
+TEST(GCCPhatMultiSourceTest, FrameCostReport) {
+  const int iterations = 20;
+  MicRecording recording = readMicRecording(90);
+  GCCPhaT gccPhat{DOA_SAMPLES, recording.sampleFrequency};
+  DoASource sources[DOA_MAX_SOURCES];
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    gccPhat.calculateDirection(
+        recording.mics[0].data(), recording.mics[1].data(),
+        recording.mics[2].data(), recording.mics[3].data());
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::micro> single = end - start;
+
+  start = std::chrono::high_resolution_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    gccPhat.calculateDirections(
+        recording.mics[0].data(), recording.mics[1].data(),
+        recording.mics[2].data(), recording.mics[3].data(), sources,
+        DOA_MAX_SOURCES);
+  }
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::micro> multi = end - start;
+
+  std::cout << "  us per " << DOA_SAMPLES << " sample frame: single peak "
+            << single.count() / iterations << ", top " << DOA_MAX_SOURCES
+            << " peaks " << multi.count() / iterations << std::endl;
+}
+
+/** @brief Given smoothing settings, assert that they are clamped to [0, 1) and
+ * that 0 disables smoothing. */
+TEST(GCCPhatSmoothingTest, SmoothingRange) {
+  GCCPhaT gccPhat{DOA_SAMPLES};
+  EXPECT_EQ(gccPhat.getCrossSpectrumSmoothing(), 0.0f);
+
+  gccPhat.setCrossSpectrumSmoothing(0.8f);
+  EXPECT_EQ(gccPhat.getCrossSpectrumSmoothing(), 0.8f);
+  gccPhat.setCrossSpectrumSmoothing(1.5f);
+  EXPECT_LT(gccPhat.getCrossSpectrumSmoothing(), 1.0f);
+  gccPhat.setCrossSpectrumSmoothing(-1.0f);
+  EXPECT_EQ(gccPhat.getCrossSpectrumSmoothing(), 0.0f);
+}
+
+/** @brief Given a first frame, assert that the smoothed spectra start from it
+ * and give the memoryless direction with either correlation evaluator. */
+TEST(GCCPhatSmoothingTest, FirstFrameMatchesMemoryless) {
+  MicRecording recording = readMicRecording(135);
+  for (CorrelationEvaluator evaluator :
+       {CorrelationEvaluator::FULL_IFFT, CorrelationEvaluator::PRUNED_LAGS}) {
+    GCCPhaT memoryless{DOA_SAMPLES, recording.sampleFrequency,
+                       PeakInterpolation::PARABOLIC, evaluator};
+    GCCPhaT smoothed{DOA_SAMPLES, recording.sampleFrequency,
+                     PeakInterpolation::PARABOLIC, evaluator};
+    smoothed.setCrossSpectrumSmoothing(0.9f);
+
+    const float expected = memoryless.calculateDirection(
+        recording.mics[0].data(), recording.mics[1].data(),
+        recording.mics[2].data(), recording.mics[3].data());
+    const float actual = smoothed.calculateDirection(
+        recording.mics[0].data(), recording.mics[1].data(),
+        recording.mics[2].data(), recording.mics[3].data());
+    EXPECT_NEAR(actual, expected, 1e-4f);
+  }
+}
+
+/**
+ * @brief Estimate the direction of consecutive frames of a simulated noise
+ * source with uncorrelated noise on every mic.
+ *
+ * @param frameSize Number of samples per frame.
+ * @param numFrames Number of frames.
+ * @param smoothing Cross-power spectrum smoothing.
+ * @param angle_rad Direction of the source.
+ * @return float Mean absolute error (rad) of the frames after the first.
+ */
+static float noisyFramesError(size_t frameSize, size_t numFrames,
+                              float smoothing, float angle_rad) {
+  std::vector<float> mics[NUM_MICS];
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    mics[mic].assign(frameSize * numFrames, 0.0f);
+  }
+  addNoiseSource(angle_rad, 7, mics);
+  srand(11);
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    for (float& sample : mics[mic]) {
+      sample += 1.5f * ((static_cast<float>(rand()) / RAND_MAX) * 2.0f - 1.0f);
+    }
+  }
+
+  GCCPhaT gccPhat{frameSize};
+  gccPhat.setCrossSpectrumSmoothing(smoothing);
+  float totalError = 0.0f;
+  for (size_t frame = 0; frame < numFrames; frame++) {
+    const size_t start = frame * frameSize;
+    const float angle = gccPhat.calculateDirection(
+        &mics[0][start], &mics[1][start], &mics[2][start], &mics[3][start]);
+    if (frame > 0) {
+      totalError += std::fabs(std::remainder(angle - angle_rad, TWO_PI_32));
+    }
+  }
+
+  return totalError / (numFrames - 1);
+}
+
+/** @brief Given short frames of a steady source in noise, assert that smoothing
+ * the cross-power spectra lowers the direction error. */
+TEST(GCCPhatSmoothingTest, SmoothingReducesErrorOfShortFrames) {
+  const float angle = degreeToRad(60.0f);
+  const float memoryless = noisyFramesError(256, 24, 0.0f, angle);
+  const float smoothed = noisyFramesError(256, 24, 0.8f, angle);
+  std::cout << "  Noisy 256 sample frames, MAE: memoryless "
+            << radToDegree(memoryless) << " deg, smoothed "
+            << radToDegree(smoothed) << " deg" << std::endl;
+  EXPECT_LT(smoothed, memoryless);
+  EXPECT_LE(smoothed, degreeToRad(20.0f));
+}
+
+/** @brief Report the direction error and time per frame of consecutive frames
+ * of the recordings by frame size and cross-power spectrum smoothing. */
+TEST(GCCPhatSmoothingTest, AccuracyAndCostReport) {
+  const std::vector<int> angles = {0, 45, 90, 135, 180, 225, 270, 315};
+  const std::vector<size_t> frameSizes = {256, 512, 1024, 2048};
+  const std::vector<float> smoothings = {0.0f, 0.5f, 0.8f, 0.9f};
+  const size_t OFFSET = 1500;
+  const size_t SPAN = 6144;
+
+  std::vector<std::vector<double>> recordings[NUM_MICS];
+  int sampleFrequency = SAMPLE_FREQUENCY;
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    for (int angle : angles) {
+      AudioFile<double> audioFile("audio/mic_recordings/mic" +
+                                  std::to_string(mic) + "_angle_" +
+                                  std::to_string(angle) + ".wav");
+      sampleFrequency = audioFile.getSampleRate();
+      recordings[mic].push_back(audioFile.samples[0]);
+    }
+  }
+
+  std::cout << "  DoA MAE (deg) / us per frame by frame size and smoothing:"
+            << std::endl
+            << "  " << std::setw(10) << "frame";
+  for (float smoothing : smoothings) {
+    std::cout << std::setw(16) << smoothing;
+  }
+  std::cout << std::endl;
+
+  for (size_t frameSize : frameSizes) {
+    std::cout << "  " << std::setw(10) << frameSize;
+    for (float smoothing : smoothings) {
+      double totalError = 0.0;
+      std::chrono::duration<double, std::micro> elapsed{0.0};
+      int count = 0;
+
+      for (size_t a = 0; a < angles.size(); a++) {
+        ASSERT_LE(OFFSET + SPAN, recordings[0][a].size());
+        GCCPhaT gccPhat{frameSize, sampleFrequency};
+        gccPhat.setCrossSpectrumSmoothing(smoothing);
+
+        for (size_t start = OFFSET; start + frameSize <= OFFSET + SPAN;
+             start += frameSize) {
+          std::vector<float> frames[NUM_MICS];
+          for (size_t mic = 0; mic < NUM_MICS; mic++) {
+            frames[mic].assign(recordings[mic][a].begin() + start,
+                               recordings[mic][a].begin() + start + frameSize);
+          }
+          auto begin = std::chrono::high_resolution_clock::now();
+          const float angle = gccPhat.calculateDirection(
+              frames[0].data(), frames[1].data(), frames[2].data(),
+              frames[3].data());
+          elapsed += std::chrono::high_resolution_clock::now() - begin;
+          totalError += std::fabs(
+              std::remainder(angle - degreeToRad(angles[a]), TWO_PI_32));
+          count++;
+        }
+      }
+
+      ASSERT_GT(count, 0);
+      std::cout << std::setw(9) << std::setprecision(3)
+                << radToDegree(totalError / count) << " / " << std::setw(4)
+                << std::setprecision(3) << elapsed.count() / count;
+    }
+    std::cout << std::endl;
+  }
+}
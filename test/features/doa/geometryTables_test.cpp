@@ -0,0 +1,183 @@
+/**
+ ******************************************************************************
+ * @file    geometryTables_test.cpp
+ * @brief   Unit tests for the tables derived from the microphone array
+ *          geometry and a report of the angle lookup cost.
+ ******************************************************************************
+ */
+
+#include "geometryTables.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "angles.hpp"
+#include "constants.h"
+#include "doa.h"
+#include "gccPhat.h"
+
+/**
+ * @brief Angle of the mean horizontal and vertical delays, normalized by the
+ * spacing of the adjacent mics.
+ *
+ * @param delayX_s Mean delay of the horizontal pairs.
+ * @param delayY_s Mean delay of the vertical pairs.
+ * @param spacingX_m Spacing of the horizontal pairs.
+ * @param spacingY_m Spacing of the vertical pairs.
+ * @return float The angle in radians.
+ */
+static float referenceAngle(float delayX_s, float delayY_s, float spacingX_m,
+                            float spacingY_m) {
+  const float dx = delayX_s / (spacingX_m / SOUND_AIR_mps);
+  const float dy = delayY_s / (spacingY_m / SOUND_AIR_mps);
+  return normalizeAngleRad(std::atan2(dy, dx) - PI_32 / 2.0f);
+}
+
+/** @brief Given every pair of integer lags, assert that the angle table holds
+ * the angle of the normalized delays. */
+TEST(GeometryTablesTest, AngleTableMatchesAtan2) {
+  GeometryTables tables(REV0_ARRAY_GEOMETRY, SAMPLE_FREQUENCY);
+  const int maxLagX = tables.getPairMaxLag(0);
+  const int maxLagY = tables.getPairMaxLag(1);
+  const float fs = static_cast<float>(SAMPLE_FREQUENCY);
+
+  for (int lagY = -maxLagY; lagY <= maxLagY; lagY++) {
+    for (int lagX = -maxLagX; lagX <= maxLagX; lagX++) {
+      if (lagX == 0 && lagY == 0) {
+        continue;
+      }
+      const float expected =
+          referenceAngle(lagX / fs, lagY / fs, REV0_MIC1_2_DISTANCE_m,
+                         REV0_MIC2_3_DISTANCE_m);
+      const float fromLags =
+          tables.estimateAngleFromLags(lagX, lagX, lagY, lagY);
+      const float fromDelays =
+          tables.estimateAngle(lagX / fs, lagX / fs, lagY / fs, lagY / fs);
+      EXPECT_NEAR(std::remainder(fromLags - expected, TWO_PI_32), 0.0f, 1e-5f)
+          << "lags " << lagX << ", " << lagY;
+      EXPECT_EQ(fromDelays, fromLags) << "lags " << lagX << ", " << lagY;
+    }
+  }
+}
+
+/** @brief Given fractional delays, assert that the angle is computed with
+ * fastAtan2 rather than snapped to the table. */
+TEST(GeometryTablesTest, FractionalDelaysAreComputed) {
+  GeometryTables tables(PCB_ARRAY_GEOMETRY, SAMPLE_FREQUENCY);
+  const float delayX_s = 2.3f / SAMPLE_FREQUENCY;
+  const float delayY_s = -4.6f / SAMPLE_FREQUENCY;
+  const float expected = referenceAngle(delayX_s, delayY_s,
+                                        PCB_MIC1_2_DISTANCE_m,
+                                        PCB_MIC2_3_DISTANCE_m);
+  EXPECT_NEAR(tables.estimateAngle(delayX_s, delayX_s, delayY_s, delayY_s),
+              expected, 1e-5f);
+}
+
+/** @brief Given each frame revision, assert that the lag search ranges follow
+ * its mic spacing. */
+TEST(GeometryTablesTest, LagRangesFollowGeometry) {
+  struct Revision {
+    const ArrayGeometry* geometry;
+    float horizontal_m;
+    float vertical_m;
+  };
+  for (const Revision& revision :
+       {Revision{&REV0_ARRAY_GEOMETRY, REV0_MIC1_2_DISTANCE_m,
+                 REV0_MIC2_3_DISTANCE_m},
+        Revision{&PCB_ARRAY_GEOMETRY, PCB_MIC1_2_DISTANCE_m,
+                 PCB_MIC2_3_DISTANCE_m},
+        Revision{&DEFAULT_ARRAY_GEOMETRY, MIC1_2_DISTANCE_m,
+                 MIC2_3_DISTANCE_m}}) {
+    GeometryTables tables(*revision.geometry, SAMPLE_FREQUENCY);
+    const float horizontal_s = revision.horizontal_m / SOUND_AIR_mps;
+    const float vertical_s = revision.vertical_m / SOUND_AIR_mps;
+
+    EXPECT_NEAR(tables.getPairMaxDelay(0), horizontal_s, 1e-7f);
+    EXPECT_NEAR(tables.getPairMaxDelay(1), vertical_s, 1e-7f);
+    EXPECT_EQ(tables.getPairMaxLag(0),
+              static_cast<int>(std::ceil(horizontal_s * SAMPLE_FREQUENCY)));
+    EXPECT_EQ(tables.getPairMaxLag(1),
+              static_cast<int>(std::ceil(vertical_s * SAMPLE_FREQUENCY)));
+    EXPECT_NEAR(tables.getMaxDelay(),
+                std::hypot(horizontal_s, vertical_s), 1e-6f);
+  }
+}
+
+/** @brief Given a GCC PhaT switched to another geometry and back, assert that
+ * it gives the same direction as one built for the default geometry. */
+TEST(GeometryTablesTest, SwitchingGeometryRebuildsTables) {
+  std::vector<float> mics[NUM_MICS];
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    mics[mic].resize(DOA_SAMPLES);
+    for (size_t i = 0; i < DOA_SAMPLES; i++) {
+      mics[mic][i] = std::sin(0.05f * (i + 2 * mic)) +
+                     0.5f * std::sin(0.21f * (i + 3 * mic));
+    }
+  }
+
+  GCCPhaT reference{DOA_SAMPLES};
+  const float expected = reference.calculateDirection(
+      mics[0].data(), mics[1].data(), mics[2].data(), mics[3].data());
+
+  GCCPhaT switched{DOA_SAMPLES};
+  switched.setArrayGeometry(REV0_ARRAY_GEOMETRY);
+  EXPECT_EQ(switched.getGeometryTables().getPairMaxLag(1),
+            GeometryTables(REV0_ARRAY_GEOMETRY).getPairMaxLag(1));
+  switched.setArrayGeometry(DEFAULT_ARRAY_GEOMETRY);
+  EXPECT_EQ(switched.calculateDirection(mics[0].data(), mics[1].data(),
+                                        mics[2].data(), mics[3].data()),
+            expected);
+
+  DOA doa(DOA_SAMPLES, REV0_ARRAY_GEOMETRY);
+  doa.setArrayGeometry(DEFAULT_ARRAY_GEOMETRY);
+  EXPECT_EQ(doa.calculateDirection(mics[0].data(), mics[1].data(),
+                                   mics[2].data(), mics[3].data()),
+            expected);
+}
+
+/** @brief Report the time per angle estimate of the table lookup and of the
+ * atan2 it replaces for integer lags, and of fractional lags. */
+TEST(GeometryTablesTest, AngleLookupCostReport) {
+  const int iterations = 100000;
+  GeometryTables tables(REV0_ARRAY_GEOMETRY, SAMPLE_FREQUENCY);
+  const int maxLag = tables.getPairMaxLag(1);
+  const float fs = static_cast<float>(SAMPLE_FREQUENCY);
+
+  volatile float sink = 0.0f;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    const int lagX = i % (2 * maxLag + 1) - maxLag;
+    const int lagY = (i / 7) % (2 * maxLag + 1) - maxLag;
+    sink = tables.estimateAngleFromLags(lagX, lagX, lagY, lagY);
+  }
+  auto mid = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    const int lagX = i % (2 * maxLag + 1) - maxLag;
+    const int lagY = (i / 7) % (2 * maxLag + 1) - maxLag;
+    sink = referenceAngle(lagX / fs, lagY / fs, REV0_MIC1_2_DISTANCE_m,
+                          REV0_MIC2_3_DISTANCE_m);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    const float lagX = (i % (2 * maxLag + 1) - maxLag) + 0.37f;
+    const float lagY = ((i / 7) % (2 * maxLag + 1) - maxLag) - 0.21f;
+    sink = tables.estimateAngle(lagX / fs, lagX / fs, lagY / fs, lagY / fs);
+  }
+  auto fractionalEnd = std::chrono::high_resolution_clock::now();
+  (void)sink;
+
+  std::chrono::duration<double, std::nano> table = mid - start;
+  std::chrono::duration<double, std::nano> direct = end - mid;
+  std::chrono::duration<double, std::nano> fractional = fractionalEnd - end;
+  std::cout << "  Angle from integer lags: table " << table.count() / iterations
+            << " ns, atan2 " << direct.count() / iterations << " ns ("
+            << tables.getAngleTableSize() << " entries, "
+            << tables.getAngleTableSize() * sizeof(float) << " bytes)"
+            << std::endl;
+  std::cout << "  Angle from fractional lags: "
+            << fractional.count() / iterations << " ns" << std::endl;
+}
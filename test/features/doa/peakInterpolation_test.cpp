@@ -0,0 +1,223 @@
+/**
+ ******************************************************************************
+ * @file    peakInterpolation_test.cpp
+ * @brief   Unit tests for sub-sample correlation peak interpolation and a
+ *          DoA accuracy versus frame size report.
+ ******************************************************************************
+ */
+
+#include "peakInterpolation.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AudioFile.h"
+#include "angles.hpp"
+#include "constants.h"
+#include "gccPhat.h"
+
+/** @brief Struct for parameterized testing. */
+struct PeakParamType {
+  PeakInterpolation method;
+  float tolerance;  // Allowed lag error in samples.
+};
+
+/** @brief Parameterized test class for peak interpolation methods. */
+class PeakInterpolationTest : public ::testing::TestWithParam<PeakParamType> {
+};
+
+/** @brief Given a band-limited pulse centred between samples, assert that the
+ * fractional lag is recovered on both sides of zero lag. */
+TEST_P(PeakInterpolationTest, RecoversFractionalLag) {
+  PeakParamType param = GetParam();
+  const size_t N = 256;
+
+  for (float trueLag : {-3.3f, -0.5f, 0.0f, 0.25f, 1.7f, 4.45f}) {
+    // Circular correlation of a band-limited (Hann windowed sinc) pulse.
+    std::vector<float> correlation(N);
+    for (size_t i = 0; i < N; i++) {
+      const int lag = (i < N / 2) ? static_cast<int>(i)
+                                  : static_cast<int>(i) - static_cast<int>(N);
+      const float x = lag - trueLag;
+      const float sinc = (std::fabs(x) < 1e-6f)
+                             ? 1.0f
+                             : std::sin(0.8f * PI_32 * x) / (0.8f * PI_32 * x);
+      const float window =
+          (std::fabs(x) < 16.0f) ? 0.5f + 0.5f * std::cos(PI_32 * x / 16.0f)
+                                 : 0.0f;
+      correlation[i] = sinc * window;
+    }
+
+    float lag = findPeakLag(correlation.data(), N, 8, param.method);
+    EXPECT_NEAR(lag, trueLag, param.tolerance) << "true lag " << trueLag;
+  }
+}
+
+/** @brief Parametized options. */
+INSTANTIATE_TEST_SUITE_P(
+    Methods, PeakInterpolationTest,
+    ::testing::Values(PeakParamType{PeakInterpolation::NONE, 0.5f},
+                      PeakParamType{PeakInterpolation::PARABOLIC, 0.15f},
+                      PeakParamType{PeakInterpolation::GAUSSIAN, 0.15f},
+                      PeakParamType{PeakInterpolation::UPSAMPLED, 0.02f}));
+
+/** @brief The search is limited to the allowed range and works on fixed-point
+ * correlations. */
+TEST(PeakInterpolationTest, SearchRangeAndFixedPoint) {
+  std::vector<int32_t> correlation(64, 0);
+  correlation[1] = 200;
+  correlation[2] = 1000;
+  correlation[3] = 800;
+  correlation[62] = 5000;  // Lag -2, outside a search range of 1.
+
+  EXPECT_FLOAT_EQ(findPeakLag(correlation.data(), correlation.size(), 1,
+                              PeakInterpolation::NONE),
+                  1.0f);
+  EXPECT_FLOAT_EQ(findPeakLag(correlation.data(), correlation.size(), 3,
+                              PeakInterpolation::NONE),
+                  -2.0f);
+
+  // Peak between lag 2 and 3, closer to 2.
+  correlation[62] = 0;
+  float lag = findPeakLag(correlation.data(), correlation.size(), 4,
+                          PeakInterpolation::PARABOLIC);
+  EXPECT_GT(lag, 2.0f);
+  EXPECT_LT(lag, 2.5f);
+}
+
+/** @brief The top peaks are local maxima by decreasing strength, the first one
+ * matches findPeakLag and the capacity is respected. */
+TEST(PeakInterpolationTest, TopPeaks) {
+  std::vector<float> correlation(64, 0.0f);
+  correlation[2] = 1.0f;    // Lag 2.
+  correlation[3] = 0.5f;    // Shoulder of lag 2, not a peak.
+  correlation[60] = 0.7f;   // Lag -4.
+  correlation[6] = 0.3f;    // Lag 6.
+  correlation[56] = 2.0f;   // Lag -8, outside a search range of 6.
+
+  CorrelationPeak peaks[3];
+  size_t numPeaks = findTopPeaks(correlation.data(), correlation.size(), 6,
+                                 PeakInterpolation::NONE, 3, peaks);
+  ASSERT_EQ(numPeaks, 3U);
+  EXPECT_FLOAT_EQ(peaks[0].lag, 2.0f);
+  EXPECT_FLOAT_EQ(peaks[0].strength, 1.0f);
+  EXPECT_FLOAT_EQ(peaks[1].lag, -4.0f);
+  EXPECT_FLOAT_EQ(peaks[2].lag, 6.0f);
+
+  numPeaks = findTopPeaks(correlation.data(), correlation.size(), 6,
+                          PeakInterpolation::NONE, 2, peaks);
+  ASSERT_EQ(numPeaks, 2U);
+  EXPECT_FLOAT_EQ(peaks[1].lag, -4.0f);
+
+  // Random correlations: the strongest peak is the single peak estimate.
+  srand(360);
+  for (int trial = 0; trial < 20; trial++) {
+    for (float& value : correlation) {
+      value = static_cast<float>(rand()) / RAND_MAX;
+    }
+    numPeaks = findTopPeaks(correlation.data(), correlation.size(), 10,
+                            PeakInterpolation::PARABOLIC, 3, peaks);
+    ASSERT_GE(numPeaks, 1U);
+    EXPECT_FLOAT_EQ(peaks[0].lag,
+                    findPeakLag(correlation.data(), correlation.size(), 10,
+                                PeakInterpolation::PARABOLIC));
+    for (size_t i = 1; i < numPeaks; i++) {
+      EXPECT_LE(peaks[i].strength, peaks[i - 1].strength);
+    }
+  }
+}
+
+/**
+ * @brief Calculate angular error with wrapping.
+ *
+ * @param estimated Estimated angle (rad).
+ * @param known Known angle (rad).
+ * @return double Shortest angular distance (rad).
+ */
+static double angularError(double estimated, double known) {
+  double error = std::fabs(estimated - known);
+  return (error > M_PI) ? 2.0 * M_PI - error : error;
+}
+
+/** @brief Report of DoA mean absolute error versus frame size for each peak
+ * interpolation method on the microphone recordings. Interpolated lags on
+ * short frames must be at least as accurate as integer lags on the current
+ * DOA_SAMPLES frames. */
+TEST(PeakInterpolationTest, AccuracyVersusFrameSizeReport) {
+  const std::vector<int> angles = {0, 45, 90, 135, 180, 225, 270, 315};
+  const std::vector<size_t> frameSizes = {256, 512, 1024, 2048};
+  const std::vector<size_t> offsets = {1500, 3500, 5500, 7500};
+  const std::vector<std::pair<const char*, PeakInterpolation>> methods = {
+      {"none", PeakInterpolation::NONE},
+      {"parabolic", PeakInterpolation::PARABOLIC},
+      {"gaussian", PeakInterpolation::GAUSSIAN},
+      {"upsampled", PeakInterpolation::UPSAMPLED}};
+
+  std::vector<std::vector<double>> recordings[NUM_MICS];
+  int sampleFrequency = SAMPLE_FREQUENCY;
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    for (int angle : angles) {
+      AudioFile<double> audioFile("audio/mic_recordings/mic" +
+                                  std::to_string(mic) + "_angle_" +
+                                  std::to_string(angle) + ".wav");
+      sampleFrequency = audioFile.getSampleRate();
+      recordings[mic].push_back(audioFile.samples[0]);
+    }
+  }
+
+  std::cout << "  DoA MAE (deg) by frame size:" << std::endl
+            << "  " << std::setw(10) << "frame";
+  for (const auto& method : methods) {
+    std::cout << std::setw(11) << method.first;
+  }
+  std::cout << std::endl;
+
+  double baselineMae = 0.0;
+  double interpolatedMae1024 = 0.0;
+  for (size_t frameSize : frameSizes) {
+    std::cout << "  " << std::setw(10) << frameSize;
+    for (const auto& [name, method] : methods) {
+      GCCPhaT gccPhat{frameSize, sampleFrequency, method};
+      double totalError = 0.0;
+      int count = 0;
+
+      for (size_t a = 0; a < angles.size(); a++) {
+        for (size_t offset : offsets) {
+          if (offset + frameSize > recordings[0][a].size()) {
+            continue;
+          }
+          std::vector<float> frames[NUM_MICS];
+          for (size_t mic = 0; mic < NUM_MICS; mic++) {
+            frames[mic].assign(recordings[mic][a].begin() + offset,
+                               recordings[mic][a].begin() + offset + frameSize);
+          }
+          float angle = gccPhat.calculateDirection(
+              frames[0].data(), frames[1].data(), frames[2].data(),
+              frames[3].data());
+          totalError += angularError(angle, degreeToRad(angles[a]));
+          count++;
+        }
+      }
+
+      ASSERT_GT(count, 0);
+      const double mae = radToDegree(totalError / count);
+      std::cout << std::setw(11) << std::setprecision(3) << mae;
+
+      if (frameSize == DOA_SAMPLES && method == PeakInterpolation::NONE) {
+        baselineMae = mae;
+      }
+      if (frameSize == 1024 && method == PeakInterpolation::PARABOLIC) {
+        interpolatedMae1024 = mae;
+      }
+    }
+    std::cout << std::endl;
+  }
+
+  EXPECT_LE(interpolatedMae1024, baselineMae);
+}
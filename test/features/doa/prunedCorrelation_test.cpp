@@ -0,0 +1,278 @@
+/**
+ ******************************************************************************
+ * @file    prunedCorrelation_test.cpp
+ * @brief   Unit tests for the lag-domain correlation evaluator and a report of
+ *          its crossover with the full inverse FFT.
+ ******************************************************************************
+ */
+
+#include "prunedCorrelation.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AudioFile.h"
+#include "constants.h"
+#include "frequencyDomain.h"
+#include "gccPhat.h"
+#include "ifft.h"
+
+/** @brief Given a random spectrum, assert that the evaluated lags match the
+ * inverse FFT. */
+TEST(PrunedCorrelationTest, MatchesInverseFFT) {
+  const uint16_t numSamples = 256;
+  const int maxLag = 9;
+
+  srand(360);
+  FrequencyDomain spectrum;
+  spectrum.N = numSamples / 2 + 1;
+  for (size_t k = 0; k < spectrum.N; k++) {
+    spectrum.real[k] = (static_cast<float>(rand()) / RAND_MAX) * 2.0f - 1.0f;
+    spectrum.img[k] = (static_cast<float>(rand()) / RAND_MAX) * 2.0f - 1.0f;
+  }
+  spectrum.img[0] = 0.0f;
+  spectrum.img[spectrum.N - 1] = 0.0f;
+
+  // Paired inverse FFT of Z[k] = C[k] + j * 0, the path of FULL_IFFT.
+  IFFT ifft(numSamples);
+  float* z = ifft.getPairInput();
+  for (size_t k = 0; k < spectrum.N; k++) {
+    z[2 * k] = spectrum.real[k];
+    z[2 * k + 1] = spectrum.img[k];
+    if (k > 0 && k < spectrum.N - 1) {
+      z[2 * (numSamples - k)] = spectrum.real[k];
+      z[2 * (numSamples - k) + 1] = -spectrum.img[k];
+    }
+  }
+  float* expected = nullptr;
+  float* unused = nullptr;
+  size_t outSize = 0;
+  ifft.pairInputToTime(expected, unused, outSize);
+
+  PrunedCorrelation pruned(numSamples, maxLag);
+  ASSERT_EQ(pruned.getNumLags(), 2U * maxLag + 1);
+  std::vector<float> correlation(pruned.getNumLags());
+  pruned.evaluate(spectrum.real, spectrum.img, correlation.data());
+
+  for (int lag = -maxLag; lag <= maxLag; lag++) {
+    const size_t full = (lag + numSamples) % numSamples;
+    const size_t compact = (lag + correlation.size()) % correlation.size();
+    EXPECT_NEAR(correlation[compact], expected[full], 1e-5f)
+        << "lag " << lag;
+  }
+}
+
+/** @brief The cost model prefers the pruned evaluator for short lag ranges and
+ * the inverse FFT for long ones. */
+TEST(PrunedCorrelationTest, CostModelChoice) {
+  EXPECT_EQ(chooseCorrelationEvaluator(2048, 2),
+            CorrelationEvaluator::PRUNED_LAGS);
+  EXPECT_EQ(chooseCorrelationEvaluator(2048, 100),
+            CorrelationEvaluator::FULL_IFFT);
+  EXPECT_LT(prunedCorrelationCost(2048, 8), prunedCorrelationCost(2048, 9));
+  EXPECT_LT(fullCorrelationCost(1024), fullCorrelationCost(2048));
+
+  // The calibrated model switches near the measured crossover of +-32 lags
+  // when memory is not limited.
+  for (size_t frameSize : {256, 2048, 4096}) {
+    EXPECT_EQ(chooseCorrelationEvaluator(frameSize, 16,
+                                         CORRELATION_FFT_FLOP_WEIGHT,
+                                         SIZE_MAX),
+              CorrelationEvaluator::PRUNED_LAGS)
+        << frameSize;
+    EXPECT_EQ(chooseCorrelationEvaluator(frameSize, 48,
+                                         CORRELATION_FFT_FLOP_WEIGHT,
+                                         SIZE_MAX),
+              CorrelationEvaluator::FULL_IFFT)
+        << frameSize;
+  }
+  EXPECT_EQ(chooseCorrelationEvaluator(2048, 16, 1.0f, SIZE_MAX),
+            CorrelationEvaluator::FULL_IFFT);
+
+  GCCPhaT automatic(DOA_SAMPLES);
+  EXPECT_NE(automatic.getCorrelationEvaluator(), CorrelationEvaluator::AUTO);
+}
+
+/** @brief The pruned evaluator is only chosen when its twiddle table fits the
+ * memory budget. */
+TEST(PrunedCorrelationTest, MemoryBudgetChoice) {
+  // +-10 lags at 2048 samples: 21 rows of 1025 bins.
+  EXPECT_EQ(prunedCorrelationMemory(2048, 10), 86100U);
+  EXPECT_EQ(PrunedCorrelation(2048, 10).getMemoryUsage(),
+            prunedCorrelationMemory(2048, 10));
+
+  EXPECT_EQ(chooseCorrelationEvaluator(2048, 10),
+            CorrelationEvaluator::FULL_IFFT);
+  EXPECT_EQ(chooseCorrelationEvaluator(2048, 3),
+            CorrelationEvaluator::PRUNED_LAGS);
+  EXPECT_EQ(chooseCorrelationEvaluator(512, 15),
+            CorrelationEvaluator::PRUNED_LAGS);
+  EXPECT_EQ(chooseCorrelationEvaluator(512, 16),
+            CorrelationEvaluator::FULL_IFFT);
+
+  for (size_t frameSize : {256, 512, 1024, 2048, 4096}) {
+    for (int maxLag : {1, 4, 16, 32}) {
+      if (chooseCorrelationEvaluator(frameSize, maxLag) ==
+          CorrelationEvaluator::PRUNED_LAGS) {
+        EXPECT_LE(prunedCorrelationMemory(frameSize, maxLag),
+                  PRUNED_CORRELATION_MAX_BYTES)
+            << frameSize << " +-" << maxLag;
+      }
+    }
+  }
+
+  // The PCB array needs +-10 lags at DOA_SAMPLES.
+  GCCPhaT pcb(DOA_SAMPLES, SAMPLE_FREQUENCY, PeakInterpolation::PARABOLIC,
+              CorrelationEvaluator::AUTO, TdoaSolver::PAIR_AVERAGE,
+              PCB_ARRAY_GEOMETRY);
+  EXPECT_EQ(pcb.getCorrelationEvaluator(), CorrelationEvaluator::FULL_IFFT);
+}
+
+/** @brief Read the recordings of every mic for a source at an angle.
+ *
+ * @param angle Angle in degree of the audio source.
+ * @param numSamples Number of samples to read from each mic.
+ * @param [out] sampleFrequency Sample frequency of the recordings (Hz).
+ * @return std::vector<std::vector<float>> Samples of each mic.
+ */
+static std::vector<std::vector<float>> readMics(int angle, size_t numSamples,
+                                                int& sampleFrequency) {
+  const size_t OFFSET = 1500;
+  std::vector<std::vector<float>> mics(NUM_MICS);
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    AudioFile<double> audioFile("audio/mic_recordings/mic" +
+                                std::to_string(mic) + "_angle_" +
+                                std::to_string(angle) + ".wav");
+    sampleFrequency = audioFile.getSampleRate();
+    mics[mic].assign(audioFile.samples[0].begin() + OFFSET,
+                     audioFile.samples[0].begin() + OFFSET + numSamples);
+  }
+  return mics;
+}
+
+/** @brief Given mic recordings, assert that both evaluators give the same
+ * direction and the same source strength. */
+TEST(PrunedCorrelationTest, SameDirectionAsFullIFFT) {
+  for (PeakInterpolation method :
+       {PeakInterpolation::PARABOLIC, PeakInterpolation::UPSAMPLED}) {
+    for (int angle : {0, 90, 225}) {
+      int sampleFrequency = SAMPLE_FREQUENCY;
+      std::vector<std::vector<float>> mics =
+          readMics(angle, DOA_SAMPLES, sampleFrequency);
+
+      GCCPhaT full(DOA_SAMPLES, sampleFrequency, method,
+                   CorrelationEvaluator::FULL_IFFT);
+      GCCPhaT pruned(DOA_SAMPLES, sampleFrequency, method,
+                     CorrelationEvaluator::PRUNED_LAGS);
+      const float fullAngle = full.calculateDirection(
+          mics[0].data(), mics[1].data(), mics[2].data(), mics[3].data());
+      const float prunedAngle = pruned.calculateDirection(
+          mics[0].data(), mics[1].data(), mics[2].data(), mics[3].data());
+
+      // Angles wrap at 2 pi.
+      EXPECT_NEAR(std::remainder(prunedAngle - fullAngle, TWO_PI_32), 0.0f,
+                  1e-3f)
+          << "angle " << angle;
+
+      DoASource fullSources[DOA_MAX_SOURCES];
+      DoASource prunedSources[DOA_MAX_SOURCES];
+      ASSERT_GT(full.calculateDirections(mics[0].data(), mics[1].data(),
+                                         mics[2].data(), mics[3].data(),
+                                         fullSources, DOA_MAX_SOURCES),
+                0U);
+      ASSERT_GT(pruned.calculateDirections(mics[0].data(), mics[1].data(),
+                                           mics[2].data(), mics[3].data(),
+                                           prunedSources, DOA_MAX_SOURCES),
+                0U);
+      EXPECT_NEAR(prunedSources[0].strength, fullSources[0].strength, 1e-4f)
+          << "angle " << angle;
+      EXPECT_GT(fullSources[0].strength, 0.01f) << "angle " << angle;
+      EXPECT_LE(fullSources[0].strength, 1.0f + 1e-4f) << "angle " << angle;
+    }
+  }
+}
+
+/** @brief Report the time per correlation of both evaluators across frame
+ * sizes and lag ranges, with the measured and modelled crossover lags and the
+ * largest lag whose twiddles fit the memory budget. */
+TEST(PrunedCorrelationTest, CrossoverReport) {
+  const int iterations = 20;
+  const std::vector<size_t> frameSizes = {256, 512, 1024, 2048, 4096};
+  const std::vector<int> maxLags = {2, 4, 8, 16, 32, 64};
+
+  std::cout << "  us per correlation:" << std::endl
+            << "  " << std::setw(6) << "frame" << std::setw(9) << "ifft";
+  for (int maxLag : maxLags) {
+    std::cout << std::setw(8) << ("+-" + std::to_string(maxLag));
+  }
+  std::cout << std::setw(10) << "measured" << std::setw(8) << "model"
+            << std::setw(8) << "budget" << std::endl;
+
+  srand(360);
+  for (size_t frameSize : frameSizes) {
+    FrequencyDomain spectrum;
+    spectrum.N = frameSize / 2 + 1;
+    for (size_t k = 0; k < spectrum.N; k++) {
+      const float phase = TWO_PI_32 * static_cast<float>(rand()) / RAND_MAX;
+      spectrum.real[k] = std::cos(phase);
+      spectrum.img[k] = std::sin(phase);
+    }
+
+    // The paired inverse FFT yields two correlations per transform.
+    IFFT ifft(frameSize);
+    float* outA = nullptr;
+    float* outB = nullptr;
+    size_t outSize = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int it = 0; it < iterations; it++) {
+      ifft.frequencyPairToTime(spectrum, spectrum, outA, outB, outSize);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    const double ifft_us =
+        std::chrono::duration<double, std::micro>(end - start).count() /
+        (2 * iterations);
+    std::cout << "  " << std::setw(6) << frameSize << std::setw(9)
+              << std::setprecision(4) << ifft_us;
+
+    int measuredCrossover = 0;
+    for (int maxLag : maxLags) {
+      PrunedCorrelation pruned(frameSize, maxLag);
+      std::vector<float> correlation(pruned.getNumLags());
+      start = std::chrono::high_resolution_clock::now();
+      for (int it = 0; it < iterations; it++) {
+        pruned.evaluate(spectrum.real, spectrum.img, correlation.data());
+      }
+      end = std::chrono::high_resolution_clock::now();
+      const double pruned_us =
+          std::chrono::duration<double, std::micro>(end - start).count() /
+          iterations;
+      std::cout << std::setw(8) << pruned_us;
+      if (pruned_us < ifft_us) {
+        measuredCrossover = maxLag;
+      }
+    }
+
+    int modelCrossover = 0;
+    while (chooseCorrelationEvaluator(frameSize, modelCrossover + 1,
+                                      CORRELATION_FFT_FLOP_WEIGHT,
+                                      SIZE_MAX) ==
+           CorrelationEvaluator::PRUNED_LAGS) {
+      modelCrossover++;
+    }
+    int budgetLag = 0;
+    while (prunedCorrelationMemory(frameSize, budgetLag + 1) <=
+           PRUNED_CORRELATION_MAX_BYTES) {
+      budgetLag++;
+    }
+    std::cout << std::setw(10) << measuredCrossover << std::setw(8)
+              << modelCrossover << std::setw(8) << budgetLag << std::endl;
+  }
+}
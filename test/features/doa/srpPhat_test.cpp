@@ -0,0 +1,164 @@
+/**
+ ******************************************************************************
+ * @file    srpPhat_test.cpp
+ * @brief   Unit tests for the SRP-PhaT DoA algorithm and a report of its cost
+ *          per frame next to GCC-PhaT.
+ ******************************************************************************
+ */
+
+#include "srpPhat.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AudioFile.h"
+#include "angles.hpp"
+#include "constants.h"
+#include "doa.h"
+#include "gccPhat.h"
+
+/** @brief Read the recordings of every mic for a source at an angle.
+ *
+ * @param angle Angle in degree of the audio source.
+ * @param numSamples Number of samples to read from each mic.
+ * @return std::vector<std::vector<float>> Samples of each mic.
+ */
+static std::vector<std::vector<float>> readMics(int angle, size_t numSamples) {
+  const size_t OFFSET = 1500;
+  std::vector<std::vector<float>> mics(NUM_MICS);
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    AudioFile<double> audioFile("audio/mic_recordings/mic" +
+                                std::to_string(mic) + "_angle_" +
+                                std::to_string(angle) + ".wav");
+    mics[mic].assign(audioFile.samples[0].begin() + OFFSET,
+                     audioFile.samples[0].begin() + OFFSET + numSamples);
+  }
+  return mics;
+}
+
+/**
+ * @brief Shortest angular distance between two angles.
+ *
+ * @param a First angle in radians.
+ * @param b Second angle in radians.
+ * @return float Distance in radians, in [0, pi].
+ */
+static float angularError(float a, float b) {
+  return std::fabs(std::remainder(a - b, TWO_PI_32));
+}
+
+/** @brief Given mic recordings at known angles, assert that SRP PhaT finds the
+ * source within 45 degrees. */
+TEST(SRPPhaTTest, KnownDirections) {
+  DOA doa(DOA_SAMPLES);
+  float totalError = 0.0f;
+  for (int angle = 0; angle < 360; angle += 45) {
+    std::vector<std::vector<float>> mics = readMics(angle, DOA_SAMPLES);
+    const float estimate =
+        doa.calculateDirection(mics[0].data(), mics[1].data(), mics[2].data(),
+                               mics[3].data(), DOA_Algorithms::SRP_PHAT);
+
+    const float error = angularError(estimate, degreeToRad(angle));
+    EXPECT_LE(error, degreeToRad(45.0f)) << "angle " << angle;
+    totalError += error;
+  }
+
+  std::cout << "  SRP PhaT MAE: " << radToDegree(totalError / 8) << " deg"
+            << std::endl;
+}
+
+/** @brief Given mic recordings, assert that SRP PhaT on its own matches SRP
+ * PhaT fed by the GCC PhaT spectra. */
+TEST(SRPPhaTTest, SharedSpectraMatchStandalone) {
+  std::vector<std::vector<float>> mics = readMics(135, DOA_SAMPLES);
+
+  SRPPhaT standalone(DOA_SAMPLES);
+  const float standaloneAngle = standalone.calculateDirection(
+      mics[0].data(), mics[1].data(), mics[2].data(), mics[3].data());
+
+  GCCPhaT gccPhaT(DOA_SAMPLES);
+  gccPhaT.computeSpectra(mics[0].data(), mics[1].data(), mics[2].data(),
+                         mics[3].data());
+  SRPPhaT shared(DOA_SAMPLES);
+  const float sharedAngle = shared.calculateDirection(
+      gccPhaT.getMicSpectrum(0), gccPhaT.getMicSpectrum(1),
+      gccPhaT.getMicSpectrum(2), gccPhaT.getMicSpectrum(3));
+
+  EXPECT_NEAR(angularError(standaloneAngle, sharedAngle), 0.0f, 1e-4f);
+}
+
+/** @brief Given mic recordings, assert that SRP PhaT with the pruned evaluator
+ * of GCC PhaT matches SRP PhaT with its own evaluator. */
+TEST(SRPPhaTTest, SharedCorrelationMatchesOwn) {
+  std::vector<std::vector<float>> mics = readMics(225, DOA_SAMPLES);
+
+  GCCPhaT gccPhaT(DOA_SAMPLES, SAMPLE_FREQUENCY, PeakInterpolation::PARABOLIC,
+                  CorrelationEvaluator::PRUNED_LAGS);
+  ASSERT_NE(gccPhaT.getPrunedCorrelation(), nullptr);
+  gccPhaT.computeSpectra(mics[0].data(), mics[1].data(), mics[2].data(),
+                         mics[3].data());
+
+  SRPPhaT own(DOA_SAMPLES);
+  SRPPhaT shared(DOA_SAMPLES, SAMPLE_FREQUENCY, DEFAULT_ARRAY_GEOMETRY,
+                 gccPhaT.getPrunedCorrelation());
+  EXPECT_FALSE(own.isCorrelationShared());
+  EXPECT_TRUE(shared.isCorrelationShared());
+  EXPECT_EQ(shared.getCorrelationEvaluator(),
+            CorrelationEvaluator::PRUNED_LAGS);
+
+  const float ownAngle = own.calculateDirection(
+      gccPhaT.getMicSpectrum(0), gccPhaT.getMicSpectrum(1),
+      gccPhaT.getMicSpectrum(2), gccPhaT.getMicSpectrum(3));
+  const float sharedAngle = shared.calculateDirection(
+      gccPhaT.getMicSpectrum(0), gccPhaT.getMicSpectrum(1),
+      gccPhaT.getMicSpectrum(2), gccPhaT.getMicSpectrum(3));
+  EXPECT_NEAR(angularError(ownAngle, sharedAngle), 0.0f, 1e-3f);
+
+  // Nothing to share with the full IFFT.
+  GCCPhaT fullIfft(DOA_SAMPLES, SAMPLE_FREQUENCY, PeakInterpolation::PARABOLIC,
+                   CorrelationEvaluator::FULL_IFFT);
+  EXPECT_EQ(fullIfft.getPrunedCorrelation(), nullptr);
+}
+
+/** @brief The steered lags cover the longest pair delay and the cost model
+ * picks an evaluator. */
+TEST(SRPPhaTTest, LagRange) {
+  SRPPhaT srpPhaT(DOA_SAMPLES);
+  const float diagonal_m =
+      std::hypot(MIC1_2_DISTANCE_m, MIC2_3_DISTANCE_m) / SOUND_AIR_mps;
+  EXPECT_GE(srpPhaT.getNumLags(),
+            2 * static_cast<size_t>(diagonal_m * SAMPLE_FREQUENCY) + 3);
+  EXPECT_NE(srpPhaT.getCorrelationEvaluator(), CorrelationEvaluator::AUTO);
+}
+
+/** @brief Report the time per frame of GCC PhaT and SRP PhaT, including the
+ * shared forward transforms. */
+TEST(SRPPhaTTest, FrameCostReport) {
+  const int iterations = 20;
+  std::vector<std::vector<float>> mics = readMics(90, DOA_SAMPLES);
+
+  DOA doa(DOA_SAMPLES);
+  std::cout << "  us per " << DOA_SAMPLES << " sample frame:";
+  for (DOA_Algorithms algo : {DOA_Algorithms::GCC_PHAT,
+                              DOA_Algorithms::SRP_PHAT}) {
+    // First call creates lazily allocated modules.
+    doa.calculateDirection(mics[0].data(), mics[1].data(), mics[2].data(),
+                           mics[3].data(), algo);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int it = 0; it < iterations; it++) {
+      doa.calculateDirection(mics[0].data(), mics[1].data(), mics[2].data(),
+                             mics[3].data(), algo);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::micro> elapsed = end - start;
+    std::cout << ((algo == DOA_Algorithms::GCC_PHAT) ? " gcc " : ", srp ")
+              << elapsed.count() / iterations;
+  }
+  std::cout << std::endl;
+}
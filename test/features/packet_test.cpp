@@ -62,3 +62,22 @@ INSTANTIATE_TEST_SUITE_P(
                                       DirectionLabel::West,
                                       SystemFaultState::CLASSIFICATION_FAULT,
                                       {0xAA, 0x03, 0x03, 0x02, 0x00}}));
+
+/** @brief Verify the sources packet lists every located direction and pads the
+ * rest with None. */
+TEST(SourcesPacketTest, CreateSourcesPacket) {
+  SourcesPacket sourcesPacket{};
+  sourcesPacket.numSources = 2U;
+  sourcesPacket.directions[0] = DirectionLabel::North;
+  sourcesPacket.directions[1] = DirectionLabel::South;
+
+  std::array<uint8_t, SOURCES_PACKET_BYTE_SIZE> packet =
+      createSourcesPacket(sourcesPacket);
+
+  std::array<uint8_t, SOURCES_PACKET_BYTE_SIZE> expected{};
+  expected[0] = 0xAB;
+  expected[1] = 0x02;
+  expected[2] = 0x01;
+  expected[3] = 0x05;
+  EXPECT_EQ(packet, expected);
+}
@@ -10,6 +10,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+
 #include "constants.h"
 #include "mp3.h"
 
@@ -110,3 +112,138 @@ TEST_F(FFTTest, SignalToFrequencyAssignment_285Hz) {
 
   EXPECT_NEAR(285.0, frequencyMaxMagnitude, windowBinsize);
 }
+
+/** @brief Given four microphone streams, assert that the batched FFT produces
+ * the same spectrum as transforming each stream separately. */
+TEST_F(FFTTest, SignalsToFrequencyMatchesSeparate) {
+  const size_t numChannels = NUM_MICS;
+  const uint16_t size = DOA_SAMPLES;
+  std::vector<std::vector<float>> channels(numChannels);
+  for (size_t c = 0; c < numChannels; c++) {
+    // Offset each channel so that every stream is distinct.
+    channels[c].assign(input.begin() + c * 7, input.begin() + c * 7 + size);
+  }
+
+  FFT fft = FFT(size, SAMPLE_FREQUENCY);
+  std::vector<FrequencyDomain> separate(numChannels);
+  for (size_t c = 0; c < numChannels; c++) {
+    fft.signalToFrequency(channels[c].data(), separate[c],
+                          WindowFunction::HANN_WINDOW);
+  }
+
+  std::vector<FrequencyDomain> batched(numChannels);
+  const float* channelData[NUM_MICS];
+  FrequencyDomain* batchedOut[NUM_MICS];
+  for (size_t c = 0; c < numChannels; c++) {
+    channelData[c] = channels[c].data();
+    batchedOut[c] = &batched[c];
+  }
+  fft.signalsToFrequency(channelData, numChannels, batchedOut,
+                         WindowFunction::HANN_WINDOW);
+
+  for (size_t c = 0; c < numChannels; c++) {
+    for (int i = 0; i < size / 2 + 1; i++) {
+      EXPECT_FLOAT_EQ(batched[c].real[i], separate[c].real[i]);
+      EXPECT_FLOAT_EQ(batched[c].img[i], separate[c].img[i]);
+      EXPECT_FLOAT_EQ(batched[c].magnitude[i], separate[c].magnitude[i]);
+    }
+  }
+}
+
+/** @brief Given two microphone streams, assert that the paired complex FFT
+ * produces the same spectra as transforming each stream separately. */
+TEST_F(FFTTest, SignalPairToFrequencyMatchesSeparate) {
+  const uint16_t size = DOA_SAMPLES;
+  std::vector<float> signalA(input.begin(), input.begin() + size);
+  std::vector<float> signalB(input.begin() + 13, input.begin() + 13 + size);
+
+  FFT fft = FFT(size, SAMPLE_FREQUENCY);
+  for (WindowFunction window :
+       {WindowFunction::HANN_WINDOW, WindowFunction::NONE}) {
+    FrequencyDomain separateA;
+    FrequencyDomain separateB;
+    fft.signalToFrequency(signalA.data(), separateA, window);
+    fft.signalToFrequency(signalB.data(), separateB, window);
+
+    FrequencyDomain pairedA;
+    FrequencyDomain pairedB;
+    fft.signalPairToFrequency(signalA.data(), signalB.data(), pairedA, pairedB,
+                              window);
+
+    // Separation adds one rounding step relative to the largest bin.
+    float peak = 0.0f;
+    for (int i = 0; i < size / 2 + 1; i++) {
+      peak = std::max({peak, separateA.magnitude[i], separateB.magnitude[i]});
+    }
+    const float tolerance = 1e-5f * peak;
+
+    for (int i = 0; i < size / 2 + 1; i++) {
+      EXPECT_NEAR(pairedA.real[i], separateA.real[i], tolerance);
+      EXPECT_NEAR(pairedA.img[i], separateA.img[i], tolerance);
+      EXPECT_NEAR(pairedB.real[i], separateB.real[i], tolerance);
+      EXPECT_NEAR(pairedB.img[i], separateB.img[i], tolerance);
+      EXPECT_NEAR(pairedB.magnitude[i], separateB.magnitude[i], tolerance);
+    }
+  }
+}
+
+/** @brief Given a field mask, assert that only the requested fields are written
+ * and that they match the full output. */
+TEST_F(FFTTest, SignalToFrequencySelectedFields) {
+  const uint16_t size = static_cast<uint16_t>(input.size());
+  const int numBins = size / 2 + 1;
+  const float SENTINEL = -12345.0f;
+
+  FFT fft = FFT(size, SAMPLE_FREQUENCY);
+  FrequencyDomain full;
+  fft.signalToFrequency(input.data(), full, WindowFunction::HANN_WINDOW);
+  EXPECT_EQ(full.fields, SPECTRUM_ALL);
+
+  for (uint8_t fields : {SPECTRUM_FREQUENCY, SPECTRUM_COMPLEX,
+                         SPECTRUM_MAGNITUDE, SPECTRUM_POWER}) {
+    FrequencyDomain partial;
+    std::fill(partial.frequency, partial.frequency + numBins, SENTINEL);
+    std::fill(partial.real, partial.real + numBins, SENTINEL);
+    std::fill(partial.img, partial.img + numBins, SENTINEL);
+    std::fill(partial.magnitude, partial.magnitude + numBins, SENTINEL);
+    std::fill(partial.powerMagnitude, partial.powerMagnitude + numBins,
+              SENTINEL);
+
+    fft.signalToFrequency(input.data(), partial, WindowFunction::HANN_WINDOW,
+                          fields);
+    EXPECT_EQ(partial.fields, fields);
+
+    for (int i = 0; i < numBins; i++) {
+      if (fields & SPECTRUM_FREQUENCY) {
+        EXPECT_FLOAT_EQ(partial.frequency[i], full.frequency[i]);
+      } else {
+        EXPECT_EQ(partial.frequency[i], SENTINEL);
+      }
+      if (fields & SPECTRUM_COMPLEX) {
+        EXPECT_FLOAT_EQ(partial.real[i], full.real[i]);
+        EXPECT_FLOAT_EQ(partial.img[i], full.img[i]);
+      } else {
+        EXPECT_EQ(partial.real[i], SENTINEL);
+        EXPECT_EQ(partial.img[i], SENTINEL);
+      }
+      if (fields & SPECTRUM_MAGNITUDE) {
+        EXPECT_FLOAT_EQ(partial.magnitude[i], full.magnitude[i]);
+      } else {
+        EXPECT_EQ(partial.magnitude[i], SENTINEL);
+      }
+      if (fields & SPECTRUM_POWER) {
+        EXPECT_FLOAT_EQ(partial.powerMagnitude[i], full.powerMagnitude[i]);
+      } else {
+        EXPECT_EQ(partial.powerMagnitude[i], SENTINEL);
+      }
+    }
+  }
+
+  // Power is the squared magnitude and frequency follows the bin spacing.
+  const float binSize = SAMPLE_FREQUENCY / static_cast<float>(size);
+  for (int i = 0; i < numBins; i++) {
+    EXPECT_NEAR(full.powerMagnitude[i], full.magnitude[i] * full.magnitude[i],
+                1e-3f * (1.0f + full.powerMagnitude[i]));
+    EXPECT_NEAR(full.frequency[i], i * binSize, 1e-3f);
+  }
+}
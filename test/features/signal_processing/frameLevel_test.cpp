@@ -0,0 +1,51 @@
+/**
+ ******************************************************************************
+ * @file    frameLevel_test.cpp
+ * @brief   Unit tests for the level of an audio frame.
+ ******************************************************************************
+ */
+
+#include "frameLevel.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "constants.h"
+
+/** @brief Given a sine, assert that the RMS and peak match its amplitude. */
+TEST(FrameLevelTest, SineLevel) {
+  std::vector<float> frame(DOA_SAMPLES);
+  for (size_t i = 0; i < frame.size(); i++) {
+    frame[i] = 0.5f * std::sin(TWO_PI_32 * 64.0f * i / frame.size());
+  }
+
+  const FrameLevel level = measureFrameLevel(frame.data(), frame.size());
+  EXPECT_NEAR(level.rms, 0.5f / std::sqrt(2.0f), 1e-4f);
+  EXPECT_NEAR(level.peak, 0.5f, 1e-4f);
+}
+
+/** @brief Given a small sine on a DC offset near the 24 bit full scale, assert
+ * that the RMS is the one of the sine alone. */
+TEST(FrameLevelTest, LargeDcOffset) {
+  const float dcOffset = 0.5f * MIC_SAMPLE_FULL_SCALE;
+  const float amplitude = 100.0f;
+  std::vector<float> frame(DOA_SAMPLES);
+  for (size_t i = 0; i < frame.size(); i++) {
+    frame[i] =
+        dcOffset + amplitude * std::sin(TWO_PI_32 * 64.0f * i / frame.size());
+  }
+
+  const FrameLevel level = measureFrameLevel(frame.data(), frame.size());
+  EXPECT_NEAR(level.rms, amplitude / std::sqrt(2.0f), 1.0f);
+  EXPECT_NEAR(level.peak, dcOffset + amplitude, 1.0f);
+}
+
+/** @brief A constant or empty frame has no RMS. */
+TEST(FrameLevelTest, ConstantAndEmptyFrames) {
+  std::vector<float> frame(DOA_SAMPLES, 1234.5f);
+  EXPECT_FLOAT_EQ(measureFrameLevel(frame.data(), frame.size()).rms, 0.0f);
+  EXPECT_FLOAT_EQ(measureFrameLevel(frame.data(), 0).rms, 0.0f);
+  EXPECT_FLOAT_EQ(measureFrameLevel(frame.data(), 0).peak, 0.0f);
+}
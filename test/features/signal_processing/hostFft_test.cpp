@@ -0,0 +1,171 @@
+/**
+ ******************************************************************************
+ * @file    hostFft_test.cpp
+ * @brief   Conformance tests of the native host FFT backend against CMSIS and
+ *          a throughput report.
+ ******************************************************************************
+ */
+
+#include "hostFft.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "arm_math.h"
+
+/** @brief Kernels that run on this CPU. */
+static std::vector<HostFFTKernel> supportedKernels() {
+  std::vector<HostFFTKernel> kernels;
+  for (HostFFTKernel kernel :
+       {HostFFTKernel::SCALAR, HostFFTKernel::SSE3, HostFFTKernel::AVX2}) {
+    if (HostFFT::isSupported(kernel)) {
+      kernels.push_back(kernel);
+    }
+  }
+  return kernels;
+}
+
+/**
+ * @brief Generate uniform noise in [-1, 1].
+ *
+ * @param size Number of values.
+ * @return std::vector<float> The noise.
+ */
+static std::vector<float> generateNoise(size_t size) {
+  std::vector<float> values(size);
+  for (float& value : values) {
+    value = (static_cast<float>(rand()) / RAND_MAX) * 2.0f - 1.0f;
+  }
+  return values;
+}
+
+/**
+ * @brief Assert that two arrays match within a tolerance relative to the
+ * largest expected value.
+ *
+ * @param actual Actual values.
+ * @param expected Expected values.
+ * @param relativeTolerance Allowed error relative to the largest value.
+ */
+static void expectMatches(const std::vector<float>& actual,
+                          const std::vector<float>& expected,
+                          float relativeTolerance) {
+  ASSERT_EQ(actual.size(), expected.size());
+  float peak = 0.0f;
+  for (float value : expected) {
+    peak = std::max(peak, std::fabs(value));
+  }
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_NEAR(actual[i], expected[i], relativeTolerance * peak)
+        << "index " << i;
+  }
+}
+
+/** @brief Parameterized test class over transform sizes. */
+class HostFFTTest : public ::testing::TestWithParam<uint16_t> {};
+
+/** @brief Given real signals, assert that every kernel produces the packed
+ * spectrum and inverse of the CMSIS real FFT. */
+TEST_P(HostFFTTest, RealMatchesCmsis) {
+  const uint16_t N = GetParam();
+  srand(N);
+  std::vector<float> signal = generateNoise(N);
+
+  arm_rfft_fast_instance_f32 instance;
+  ASSERT_EQ(arm_rfft_fast_init_f32(&instance, N), ARM_MATH_SUCCESS);
+  std::vector<float> scratch = signal;
+  std::vector<float> expectedSpectrum(N);
+  arm_rfft_fast_f32(&instance, scratch.data(), expectedSpectrum.data(), 0);
+  scratch = expectedSpectrum;
+  std::vector<float> expectedSignal(N);
+  arm_rfft_fast_f32(&instance, scratch.data(), expectedSignal.data(), 1);
+
+  for (HostFFTKernel kernel : supportedKernels()) {
+    SCOPED_TRACE(HostFFT::kernelName(kernel));
+    HostFFT fft(N, kernel);
+    ASSERT_EQ(fft.getKernel(), kernel);
+
+    std::vector<float> spectrum(N);
+    fft.rfft(signal.data(), spectrum.data(), false);
+    expectMatches(spectrum, expectedSpectrum, 1e-5f);
+
+    std::vector<float> roundTrip(N);
+    fft.rfft(spectrum.data(), roundTrip.data(), true);
+    expectMatches(roundTrip, expectedSignal, 1e-5f);
+  }
+}
+
+/** @brief Given complex signals, assert that every kernel matches the CMSIS
+ * complex FFT in both directions. */
+TEST_P(HostFFTTest, ComplexMatchesCmsis) {
+  const uint16_t N = GetParam();
+  srand(N + 1);
+  std::vector<float> signal = generateNoise(2 * N);
+
+  arm_cfft_instance_f32 instance;
+  ASSERT_EQ(arm_cfft_init_f32(&instance, N), ARM_MATH_SUCCESS);
+  std::vector<float> expectedForward = signal;
+  arm_cfft_f32(&instance, expectedForward.data(), 0, 1);
+  std::vector<float> expectedInverse = signal;
+  arm_cfft_f32(&instance, expectedInverse.data(), 1, 1);
+
+  for (HostFFTKernel kernel : supportedKernels()) {
+    SCOPED_TRACE(HostFFT::kernelName(kernel));
+    HostFFT fft(N, kernel);
+
+    std::vector<float> forward = signal;
+    fft.cfft(forward.data(), false);
+    expectMatches(forward, expectedForward, 1e-5f);
+
+    std::vector<float> inverse = signal;
+    fft.cfft(inverse.data(), true);
+    expectMatches(inverse, expectedInverse, 1e-5f);
+  }
+}
+
+/** @brief Parametized options. Sizes supported by the CMSIS real FFT. */
+INSTANTIATE_TEST_SUITE_P(Sizes, HostFFTTest,
+                         ::testing::Values(32, 64, 256, 1024, 2048, 4096));
+
+/** @brief Report the real FFT throughput of CMSIS and every host kernel. */
+TEST(HostFFTPerformanceTest, RealThroughput) {
+  const uint16_t N = 2048;
+  const int iterations = 200;
+  srand(360);
+  std::vector<float> signal = generateNoise(N);
+  std::vector<float> scratch(N);
+  std::vector<float> spectrum(N);
+
+  arm_rfft_fast_instance_f32 instance;
+  arm_rfft_fast_init_f32(&instance, N);
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    std::copy(signal.begin(), signal.end(), scratch.begin());
+    arm_rfft_fast_f32(&instance, scratch.data(), spectrum.data(), 0);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::micro> elapsed = end - start;
+  std::cout << "  " << N << " point real FFT: cmsis "
+            << elapsed.count() / iterations << " us";
+
+  for (HostFFTKernel kernel : supportedKernels()) {
+    HostFFT fft(N, kernel);
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; i++) {
+      fft.rfft(signal.data(), spectrum.data(), false);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    elapsed = end - start;
+    std::cout << ", " << HostFFT::kernelName(kernel) << " "
+              << elapsed.count() / iterations << " us";
+  }
+
+  std::cout << " (auto: " << HostFFT::kernelName(HostFFT(N).getKernel())
+            << ")" << std::endl;
+}
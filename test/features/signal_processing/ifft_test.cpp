@@ -11,8 +11,11 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <iostream>
+#include <vector>
 
+#include "constants.h"
 #include "frequencyDomain.h"
 
 const static float PRECISION_ERROR = 0.0001;
@@ -87,3 +90,64 @@ TEST_F(IFFTTest, AllFrequenciesToImpulseAssignment) {
     EXPECT_LT(std::abs(timeDomain[i]), PRECISION_ERROR);
   }
 }
+
+/** @brief Given two frequency domains, assert that the paired complex IFFT
+ * produces the same signals as transforming each one separately. */
+TEST_F(IFFTTest, FrequencyPairToTimeMatchesSeparate) {
+  const uint16_t numSamples = (N - 1) * 2;
+
+  // Second spectrum is an impulse delayed by 5 samples.
+  FrequencyDomain delayed = frequencyDomain;
+  for (int i = 0; i < N; i++) {
+    const float phase = -TWO_PI_32 * i * 5 / numSamples;
+    delayed.real[i] = std::cos(phase);
+    delayed.img[i] = std::sin(phase);
+  }
+
+  IFFT ifft = IFFT(numSamples);
+  size_t outSize = 0;
+  float* timeDomain = ifft.frequencyToTime(frequencyDomain, outSize);
+  std::vector<float> separateA(timeDomain, timeDomain + outSize);
+  timeDomain = ifft.frequencyToTime(delayed, outSize);
+  std::vector<float> separateB(timeDomain, timeDomain + outSize);
+
+  float* pairedA = nullptr;
+  float* pairedB = nullptr;
+  size_t pairedSize = 0;
+  ifft.frequencyPairToTime(frequencyDomain, delayed, pairedA, pairedB,
+                           pairedSize);
+
+  ASSERT_EQ(pairedSize, outSize);
+  for (size_t i = 0; i < outSize; i++) {
+    EXPECT_NEAR(pairedA[i], separateA[i], PRECISION_ERROR);
+    EXPECT_NEAR(pairedB[i], separateB[i], PRECISION_ERROR);
+  }
+  EXPECT_GT(pairedB[5], PRECISION_ERROR);
+}
+
+/** @brief Given an unscaled spectrum written to the pair input, assert that
+ * the inverse transform applies 1 / numSamples once, so a flat spectrum gives
+ * a unit impulse. */
+TEST_F(IFFTTest, PairInputToTimeScalesOnce) {
+  const uint16_t numSamples = (N - 1) * 2;
+  IFFT ifft = IFFT(numSamples);
+
+  // Z[k] = A[k] + j * B[k] with A flat and B an impulse delayed by 5 samples.
+  float* z = ifft.getPairInput();
+  for (int k = 0; k < numSamples; k++) {
+    const float phase = -TWO_PI_32 * k * 5 / numSamples;
+    z[2 * k] = 1.0f - std::sin(phase);
+    z[2 * k + 1] = std::cos(phase);
+  }
+
+  float* outA = nullptr;
+  float* outB = nullptr;
+  size_t outSize = 0;
+  ifft.pairInputToTime(outA, outB, outSize);
+
+  ASSERT_EQ(outSize, numSamples);
+  for (size_t i = 0; i < outSize; i++) {
+    EXPECT_NEAR(outA[i], i == 0 ? 1.0f : 0.0f, PRECISION_ERROR) << i;
+    EXPECT_NEAR(outB[i], i == 5 ? 1.0f : 0.0f, PRECISION_ERROR) << i;
+  }
+}
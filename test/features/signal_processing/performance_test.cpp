@@ -10,10 +10,12 @@
 
 #include <chrono>
 #include <cmath>
+#include <utility>
 #include <vector>
 
 #include "constants.h"
 #include "fft.h"
+#include "ifft.h"
 
 /**
  * @brief Generates a sine wave for performance testing.
@@ -134,3 +136,148 @@ TEST(PerformanceTest, NoBufferOverflows) {
     });
   }
 }
+
+/**
+ * @brief Compares transforming the four microphone frames of a DoA update one
+ * at a time against the batched multi-channel FFT.
+ */
+TEST(PerformanceTest, BatchedMicrophoneFFT) {
+  const int iterations = 100;
+
+  std::vector<std::vector<float>> signals;
+  const float* channels[NUM_MICS];
+  std::vector<FrequencyDomain> results(NUM_MICS);
+  FrequencyDomain* outFreqs[NUM_MICS];
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    signals.push_back(
+        generateTestSignal(DOA_SAMPLES, 1000.0f + 100.0f * mic, 16000));
+  }
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    channels[mic] = signals[mic].data();
+    outFreqs[mic] = &results[mic];
+  }
+
+  FFT fft(DOA_SAMPLES, SAMPLE_FREQUENCY);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    for (size_t mic = 0; mic < NUM_MICS; mic++) {
+      fft.signalToFrequency(signals[mic].data(), results[mic],
+                            WindowFunction::HANN_WINDOW);
+    }
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::micro> separateTime = end - start;
+
+  start = std::chrono::high_resolution_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    fft.signalsToFrequency(channels, NUM_MICS, outFreqs,
+                           WindowFunction::HANN_WINDOW);
+  }
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::micro> batchedTime = end - start;
+
+  std::cout << "  " << NUM_MICS << " x " << DOA_SAMPLES
+            << " FFT: separate " << separateTime.count() / iterations
+            << " us, batched " << batchedTime.count() / iterations << " us"
+            << std::endl;
+}
+
+/**
+ * @brief Compares the real FFTs and IFFTs of a GCC-PhaT update (four of each)
+ * against the paired complex transforms (two of each).
+ */
+TEST(PerformanceTest, PairedTransforms) {
+  const int iterations = 100;
+
+  std::vector<std::vector<float>> signals;
+  std::vector<FrequencyDomain> spectra(NUM_MICS);
+  for (size_t mic = 0; mic < NUM_MICS; mic++) {
+    signals.push_back(
+        generateTestSignal(DOA_SAMPLES, 1000.0f + 100.0f * mic, 16000));
+  }
+
+  FFT fft(DOA_SAMPLES, SAMPLE_FREQUENCY);
+  IFFT ifft(DOA_SAMPLES);
+  size_t outSize = 0;
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    for (size_t mic = 0; mic < NUM_MICS; mic++) {
+      fft.signalToFrequency(signals[mic].data(), spectra[mic],
+                            WindowFunction::HANN_WINDOW, SPECTRUM_COMPLEX);
+    }
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::micro> separateForward = end - start;
+
+  start = std::chrono::high_resolution_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    for (size_t mic = 0; mic < NUM_MICS; mic += 2) {
+      fft.signalPairToFrequency(signals[mic].data(), signals[mic + 1].data(),
+                                spectra[mic], spectra[mic + 1],
+                                WindowFunction::HANN_WINDOW, SPECTRUM_COMPLEX);
+    }
+  }
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::micro> pairedForward = end - start;
+
+  start = std::chrono::high_resolution_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    for (size_t mic = 0; mic < NUM_MICS; mic++) {
+      ifft.frequencyToTime(spectra[mic], outSize);
+    }
+  }
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::micro> separateInverse = end - start;
+
+  float* outA = nullptr;
+  float* outB = nullptr;
+  start = std::chrono::high_resolution_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    for (size_t mic = 0; mic < NUM_MICS; mic += 2) {
+      ifft.frequencyPairToTime(spectra[mic], spectra[mic + 1], outA, outB,
+                               outSize);
+    }
+  }
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::micro> pairedInverse = end - start;
+
+  std::cout << "  " << NUM_MICS << " x " << DOA_SAMPLES
+            << " FFT: real " << separateForward.count() / iterations
+            << " us, paired " << pairedForward.count() / iterations
+            << " us; IFFT: real " << separateInverse.count() / iterations
+            << " us, paired " << pairedInverse.count() / iterations << " us"
+            << std::endl;
+}
+
+/**
+ * @brief Compares populating every spectral field against only the fields
+ * read by GCC-PhaT (complex) and classification (power).
+ */
+TEST(PerformanceTest, SelectedSpectrumFields) {
+  const int iterations = 200;
+
+  std::vector<float> signal = generateTestSignal(DOA_SAMPLES);
+  FFT fft(DOA_SAMPLES, SAMPLE_FREQUENCY);
+  FrequencyDomain result;
+
+  const std::vector<std::pair<const char*, uint8_t>> cases = {
+      {"all", SPECTRUM_ALL},
+      {"complex", SPECTRUM_COMPLEX},
+      {"power", SPECTRUM_POWER}};
+
+  for (const auto& [name, fields] : cases) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int it = 0; it < iterations; it++) {
+      fft.signalToFrequency(signal.data(), result, WindowFunction::HANN_WINDOW,
+                            fields);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::micro> duration = end - start;
+
+    std::cout << "  " << DOA_SAMPLES << " FFT (" << name
+              << " fields): " << duration.count() / iterations << " us"
+              << std::endl;
+  }
+}
@@ -0,0 +1,174 @@
+/**
+ ******************************************************************************
+ * @file    streamingStft_test.cpp
+ * @brief   Unit tests and benchmark for the streaming STFT.
+ ******************************************************************************
+ */
+
+#include "streamingStft.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "constants.h"
+#include "fft.h"
+
+/**
+ * @brief Generate a distinct test signal per channel.
+ *
+ * @param numChannels The number of channels.
+ * @param numSamples The number of samples per channel.
+ * @return std::vector<std::vector<float>> The channel signals.
+ */
+static std::vector<std::vector<float>> generateChannels(size_t numChannels,
+                                                        size_t numSamples) {
+  std::vector<std::vector<float>> channels(numChannels);
+  for (size_t c = 0; c < numChannels; c++) {
+    channels[c].resize(numSamples);
+    for (size_t i = 0; i < numSamples; i++) {
+      channels[c][i] =
+          std::sin(TWO_PI_32 * (500.0f + 250.0f * c) * i / SAMPLE_FREQUENCY) +
+          0.001f * static_cast<float>(i % 97);
+    }
+  }
+  return channels;
+}
+
+/** @brief Given pushes of irregular sizes, assert that a frame is emitted every
+ * hop and that each frame is the latest frameSize samples of every channel. */
+TEST(StreamingSTFTTest, FramesFollowHop) {
+  const uint16_t frameSize = 256;
+  const uint16_t hopSize = 64;
+  const size_t numSamples = 2000;
+  std::vector<std::vector<float>> channels =
+      generateChannels(NUM_MICS, numSamples);
+
+  StreamingSTFT stft(frameSize, hopSize, NUM_MICS);
+  std::vector<size_t> frameEnds;
+  size_t pushed = 0;
+
+  auto onFrame = [&](StreamingSTFT& s) {
+    // Frame n (0-indexed) ends frameSize + n * hopSize samples into the stream.
+    const size_t end = frameSize + (s.getFramesEmitted() - 1) * hopSize;
+    frameEnds.push_back(end);
+    for (size_t c = 0; c < NUM_MICS; c++) {
+      const float* frame = s.frame(c);
+      for (size_t i = 0; i < frameSize; i++) {
+        ASSERT_EQ(frame[i], channels[c][end - frameSize + i]);
+      }
+    }
+  };
+
+  const size_t chunkSizes[] = {1, 17, 300, 64, 5, 1000};
+  size_t chunkIdx = 0;
+  while (pushed < numSamples) {
+    const size_t count = std::min(chunkSizes[chunkIdx++ % 6],
+                                  numSamples - pushed);
+    const float* blocks[NUM_MICS];
+    for (size_t c = 0; c < NUM_MICS; c++) {
+      blocks[c] = channels[c].data() + pushed;
+    }
+    stft.push(blocks, count, onFrame);
+    pushed += count;
+  }
+
+  const size_t expectedFrames = (numSamples - frameSize) / hopSize + 1;
+  EXPECT_EQ(frameEnds.size(), expectedFrames);
+  EXPECT_EQ(stft.getFramesEmitted(), expectedFrames);
+}
+
+/** @brief The transform of the streamed frame matches an FFT of the same
+ * samples. */
+TEST(StreamingSTFTTest, TransformMatchesFFT) {
+  const uint16_t frameSize = DOA_SAMPLES;
+  const uint16_t hopSize = DOA_SAMPLES / 4;
+  const size_t numSamples = frameSize + 3 * hopSize;
+  std::vector<std::vector<float>> channels =
+      generateChannels(NUM_MICS, numSamples);
+
+  StreamingSTFT stft(frameSize, hopSize, NUM_MICS);
+  std::vector<FrequencyDomain> streamed(NUM_MICS);
+  FrequencyDomain* outFreqs[NUM_MICS];
+  for (size_t c = 0; c < NUM_MICS; c++) {
+    outFreqs[c] = &streamed[c];
+  }
+
+  const float* blocks[NUM_MICS];
+  for (size_t c = 0; c < NUM_MICS; c++) {
+    blocks[c] = channels[c].data();
+  }
+  size_t numFrames = stft.push(blocks, numSamples, [](StreamingSTFT&) {});
+  EXPECT_EQ(numFrames, 4u);
+  stft.transform(outFreqs, WindowFunction::HANN_WINDOW, SPECTRUM_COMPLEX);
+
+  FFT fft(frameSize, SAMPLE_FREQUENCY);
+  for (size_t c = 0; c < NUM_MICS; c++) {
+    FrequencyDomain reference;
+    fft.signalToFrequency(&channels[c][numSamples - frameSize], reference,
+                          WindowFunction::HANN_WINDOW, SPECTRUM_COMPLEX);
+    for (int i = 0; i < frameSize / 2 + 1; i++) {
+      EXPECT_FLOAT_EQ(streamed[c].real[i], reference.real[i]);
+      EXPECT_FLOAT_EQ(streamed[c].img[i], reference.img[i]);
+    }
+  }
+}
+
+/** @brief Reset clears the history so a full frame is needed again. */
+TEST(StreamingSTFTTest, Reset) {
+  const uint16_t frameSize = 128;
+  std::vector<std::vector<float>> channels = generateChannels(1, frameSize);
+  const float* blocks[] = {channels[0].data()};
+
+  StreamingSTFT stft(frameSize, 32, 1);
+  EXPECT_EQ(stft.push(blocks, frameSize, [](StreamingSTFT&) {}), 1u);
+
+  stft.reset();
+  EXPECT_EQ(stft.getFramesEmitted(), 0u);
+  EXPECT_EQ(stft.push(blocks, frameSize - 1, [](StreamingSTFT&) {}), 0u);
+  EXPECT_EQ(stft.push(blocks, 1, [](StreamingSTFT&) {}), 1u);
+}
+
+/** @brief Benchmark of streaming one second of four microphone channels with a
+ * DOA_SAMPLES window at a quarter-frame hop versus non-overlapping frames. */
+TEST(StreamingSTFTTest, BenchmarkHop) {
+  const size_t blockSize = DOA_SAMPLES / 2;  // Microphone DMA half buffer.
+  const size_t numSamples = SAMPLE_FREQUENCY;
+  std::vector<std::vector<float>> channels =
+      generateChannels(NUM_MICS, numSamples);
+  std::vector<FrequencyDomain> spectra(NUM_MICS);
+  FrequencyDomain* outFreqs[NUM_MICS];
+  for (size_t c = 0; c < NUM_MICS; c++) {
+    outFreqs[c] = &spectra[c];
+  }
+
+  for (uint16_t hopSize : {static_cast<uint16_t>(DOA_SAMPLES),
+                           static_cast<uint16_t>(DOA_SAMPLES / 4)}) {
+    StreamingSTFT stft(DOA_SAMPLES, hopSize, NUM_MICS);
+    auto onFrame = [&](StreamingSTFT& s) {
+      s.transform(outFreqs, WindowFunction::HANN_WINDOW, SPECTRUM_COMPLEX);
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t numFrames = 0;
+    for (size_t pos = 0; pos + blockSize <= numSamples; pos += blockSize) {
+      const float* blocks[NUM_MICS];
+      for (size_t c = 0; c < NUM_MICS; c++) {
+        blocks[c] = channels[c].data() + pos;
+      }
+      numFrames += stft.push(blocks, blockSize, onFrame);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double, std::milli> duration = end - start;
+
+    std::cout << "  STFT " << NUM_MICS << " x " << DOA_SAMPLES << ", hop "
+              << hopSize << ": " << numFrames << " frames/s ("
+              << 1000.0f * hopSize / SAMPLE_FREQUENCY << " ms latency), "
+              << duration.count() << " ms per second of audio" << std::endl;
+
+    EXPECT_GT(numFrames, 0u);
+  }
+}
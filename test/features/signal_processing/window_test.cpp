@@ -0,0 +1,197 @@
+/**
+ ******************************************************************************
+ * @file    window_test.cpp
+ * @brief   Unit tests and benchmark for window functions and precomputed
+ *          window tables.
+ ******************************************************************************
+ */
+
+#include "window.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "constants.h"
+#include "fft.h"
+#include "windowTable.h"
+
+const static float WINDOW_PRECISION_ERROR = 1e-6f;
+
+/** @brief Struct for parameterized testing. */
+struct WindowParamType {
+  WindowFunction windowFunction;
+  uint16_t size;
+};
+
+/** @brief Parameterized test class for window tables. */
+class WindowTableTest : public ::testing::TestWithParam<WindowParamType> {};
+
+/** @brief Returns the window coefficient evaluated directly. */
+static float directCoefficient(WindowFunction windowFunction, size_t i,
+                               uint32_t size) {
+  switch (windowFunction) {
+    case WindowFunction::HANN_WINDOW:
+      return HannWindow<float>().coefficient(i, size);
+    case WindowFunction::HAMMING_WINDOW:
+      return HammingWindow<float>().coefficient(i, size);
+    case WindowFunction::BLACKMAN_HARRIS_WINDOW:
+      return BlackmanHarrisWindow<float>().coefficient(i, size);
+    case WindowFunction::SQRT_HANN_WINDOW:
+      return SqrtHannWindow<float>().coefficient(i, size);
+    default:
+      return 1.0f;
+  }
+}
+
+/** @brief Given a window type and size, the cached table matches the directly
+ * evaluated window and is only generated once. */
+TEST_P(WindowTableTest, TableMatchesDirectEvaluation) {
+  WindowParamType param = GetParam();
+
+  const float* table = WindowTable::get(param.windowFunction, param.size);
+  ASSERT_NE(table, nullptr);
+
+  for (size_t i = 0; i < param.size; i++) {
+    EXPECT_NEAR(table[i],
+                directCoefficient(param.windowFunction, i, param.size),
+                WINDOW_PRECISION_ERROR);
+  }
+
+  // Same table is served on the next request.
+  EXPECT_EQ(table, WindowTable::get(param.windowFunction, param.size));
+}
+
+/** @brief Parametized options. */
+INSTANTIATE_TEST_SUITE_P(
+    WindowValues, WindowTableTest,
+    ::testing::Values(
+        WindowParamType{WindowFunction::HANN_WINDOW, DOA_SAMPLES},
+        WindowParamType{WindowFunction::HAMMING_WINDOW, DOA_SAMPLES},
+        WindowParamType{WindowFunction::BLACKMAN_HARRIS_WINDOW, DOA_SAMPLES},
+        WindowParamType{WindowFunction::SQRT_HANN_WINDOW, DOA_SAMPLES}));
+
+/** @brief No table is created when no window is applied or the size does not
+ * fit the FFT buffer. */
+TEST(WindowTableTest, UnsupportedRequestsReturnNull) {
+  EXPECT_EQ(WindowTable::get(WindowFunction::NONE, DOA_SAMPLES), nullptr);
+  EXPECT_EQ(WindowTable::get(WindowFunction::HANN_WINDOW,
+                             FFT_BUFFER_SIZE_IN + 1),
+            nullptr);
+}
+
+/** @brief Window shapes have the expected end points and peaks. */
+TEST(WindowTableTest, WindowShapes) {
+  const uint16_t size = 513;  // Odd size so the centre sample is the peak.
+  std::vector<float> table(size);
+
+  ASSERT_TRUE(
+      WindowTable::generate(WindowFunction::HANN_WINDOW, size, table.data()));
+  EXPECT_NEAR(table[0], 0.0f, WINDOW_PRECISION_ERROR);
+  EXPECT_NEAR(table[size / 2], 1.0f, WINDOW_PRECISION_ERROR);
+
+  ASSERT_TRUE(WindowTable::generate(WindowFunction::HAMMING_WINDOW, size,
+                                    table.data()));
+  EXPECT_NEAR(table[0], 0.08f, WINDOW_PRECISION_ERROR);
+  EXPECT_NEAR(table[size - 1], 0.08f, WINDOW_PRECISION_ERROR);
+  EXPECT_NEAR(table[size / 2], 1.0f, WINDOW_PRECISION_ERROR);
+
+  ASSERT_TRUE(WindowTable::generate(WindowFunction::BLACKMAN_HARRIS_WINDOW,
+                                    size, table.data()));
+  EXPECT_NEAR(table[0], 6e-5f, 1e-5f);
+  EXPECT_NEAR(table[size / 2], 1.0f, WINDOW_PRECISION_ERROR);
+
+  // Square root Hann squared is the Hann window.
+  std::vector<float> hann(size);
+  WindowTable::generate(WindowFunction::HANN_WINDOW, size, hann.data());
+  ASSERT_TRUE(WindowTable::generate(WindowFunction::SQRT_HANN_WINDOW, size,
+                                    table.data()));
+  for (size_t i = 0; i < size; i++) {
+    EXPECT_NEAR(table[i] * table[i], hann[i], WINDOW_PRECISION_ERROR);
+  }
+
+  EXPECT_FALSE(
+      WindowTable::generate(WindowFunction::NONE, size, table.data()));
+}
+
+/** @brief The FFT output with the fused table window is the same as windowing
+ * the signal beforehand. The input signal is not modified. */
+TEST(WindowTableTest, FusedWindowMatchesPreWindowedSignal) {
+  std::vector<float> signal(DOA_SAMPLES);
+  for (int i = 0; i < DOA_SAMPLES; i++) {
+    signal[i] = std::sin(TWO_PI_32 * 440.0f * i / SAMPLE_FREQUENCY) +
+                0.5f * std::cos(TWO_PI_32 * 3000.0f * i / SAMPLE_FREQUENCY);
+  }
+  std::vector<float> original = signal;
+
+  std::vector<float> preWindowed = signal;
+  HannWindow<float>().applyWindow(preWindowed.data(), DOA_SAMPLES);
+
+  FFT fft(DOA_SAMPLES, SAMPLE_FREQUENCY);
+  FrequencyDomain fused;
+  fft.signalToFrequency(signal.data(), fused, WindowFunction::HANN_WINDOW);
+  FrequencyDomain reference;
+  fft.signalToFrequency(preWindowed.data(), reference, WindowFunction::NONE);
+
+  for (int i = 0; i < DOA_SAMPLES / 2 + 1; i++) {
+    EXPECT_NEAR(fused.real[i], reference.real[i], 1e-3f);
+    EXPECT_NEAR(fused.img[i], reference.img[i], 1e-3f);
+  }
+
+  EXPECT_EQ(signal, original);
+}
+
+/** @brief Benchmark of windowing the four microphone frames of a DoA update
+ * (DOA_SAMPLES each) with per-sample sin/pow versus the precomputed table
+ * fused into the copy. */
+TEST(WindowTableTest, BenchmarkDoAFrameWindowing) {
+  const int numMics = 4;
+  const int iterations = 200;
+
+  std::vector<float> signal(DOA_SAMPLES);
+  for (int i = 0; i < DOA_SAMPLES; i++) {
+    signal[i] = std::sin(TWO_PI_32 * 1000.0f * i / SAMPLE_FREQUENCY);
+  }
+  std::vector<float> scratch(DOA_SAMPLES);
+  float sink = 0.0f;
+
+  // Previous path: copy then evaluate the window per sample.
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    for (int mic = 0; mic < numMics; mic++) {
+      std::copy(signal.begin(), signal.end(), scratch.begin());
+      HannWindow<float>().applyWindow(scratch.data(), DOA_SAMPLES);
+      sink += scratch[DOA_SAMPLES / 2];
+    }
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::micro> directTime = end - start;
+
+  // Table path: multiply on copy.
+  const float* table =
+      WindowTable::get(WindowFunction::HANN_WINDOW, DOA_SAMPLES);
+  ASSERT_NE(table, nullptr);
+  start = std::chrono::high_resolution_clock::now();
+  for (int it = 0; it < iterations; it++) {
+    for (int mic = 0; mic < numMics; mic++) {
+      arm_mult_f32(signal.data(), table, scratch.data(), DOA_SAMPLES);
+      sink += scratch[DOA_SAMPLES / 2];
+    }
+  }
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::micro> tableTime = end - start;
+
+  const double directPerFrame = directTime.count() / iterations;
+  const double tablePerFrame = tableTime.count() / iterations;
+
+  std::cout << "  DoA frame windowing (" << numMics << " x " << DOA_SAMPLES
+            << " samples): direct " << directPerFrame << " us, table "
+            << tablePerFrame << " us, saved "
+            << directPerFrame - tablePerFrame << " us per frame" << std::endl;
+
+  EXPECT_GT(sink, -1.0f);  // Keep results alive.
+  EXPECT_LT(tablePerFrame, directPerFrame);
+}
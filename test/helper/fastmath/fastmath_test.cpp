@@ -0,0 +1,281 @@
+/**
+ ******************************************************************************
+ * @file    fastmath_test.cpp
+ * @brief   Accuracy tests of the fast math kernels against libm and a report
+ *          of their cost per value.
+ ******************************************************************************
+ */
+
+#include "fastmath.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+/** @brief Kernels that run on this CPU. */
+static std::vector<FastMathKernel> supportedKernels() {
+  std::vector<FastMathKernel> kernels;
+  for (FastMathKernel kernel : {FastMathKernel::SCALAR, FastMathKernel::AVX2,
+                                FastMathKernel::NEON}) {
+    if (isFastMathKernelSupported(kernel)) {
+      kernels.push_back(kernel);
+    }
+  }
+  return kernels;
+}
+
+/**
+ * @brief Generate evenly spaced values. The count is odd so that every kernel
+ * also runs its scalar tail.
+ *
+ * @param first First value.
+ * @param last Last value.
+ * @return std::vector<float> The values.
+ */
+static std::vector<float> linearSweep(float first, float last) {
+  const size_t count = 20001;
+  std::vector<float> values(count);
+  for (size_t i = 0; i < count; i++) {
+    values[i] = first + (last - first) * i / (count - 1);
+  }
+  return values;
+}
+
+/**
+ * @brief Generate logarithmically spaced positive values.
+ *
+ * @param firstExponent Base 10 exponent of the first value.
+ * @param lastExponent Base 10 exponent of the last value.
+ * @return std::vector<float> The values.
+ */
+static std::vector<float> logSweep(float firstExponent, float lastExponent) {
+  std::vector<float> values = linearSweep(firstExponent, lastExponent);
+  for (float& value : values) {
+    value = static_cast<float>(std::pow(10.0, value));
+  }
+  return values;
+}
+
+/** @brief Test class restoring the default kernel after each test. */
+class FastMathTest : public ::testing::Test {
+ protected:
+  void TearDown() override { setFastMathKernel(FastMathKernel::AUTO); }
+};
+
+/** @brief Given exponents over the whole clamped range, assert that every
+ * kernel meets the relative error bound of fastExp. */
+TEST_F(FastMathTest, ExpAccuracy) {
+  std::vector<float> input =
+      linearSweep(FASTMATH_EXP_MIN_INPUT, FASTMATH_EXP_MAX_INPUT);
+  std::vector<float> output(input.size());
+
+  for (FastMathKernel kernel : supportedKernels()) {
+    ASSERT_EQ(setFastMathKernel(kernel), kernel);
+    fastExp(input.data(), output.data(), input.size());
+    for (size_t i = 0; i < input.size(); i++) {
+      const double expected = std::exp(static_cast<double>(input[i]));
+      ASSERT_LE(std::fabs(output[i] - expected) / expected,
+                FASTMATH_EXP_MAX_REL_ERROR)
+          << fastMathKernelName(kernel) << " exp(" << input[i] << ")";
+    }
+  }
+}
+
+/** @brief Given values over 70 decades and close to 1, assert that every
+ * kernel meets the error bound of fastLog. */
+TEST_F(FastMathTest, LogAccuracy) {
+  std::vector<float> input = logSweep(-37.0f, 37.0f);
+  std::vector<float> nearOne = linearSweep(0.5f, 2.0f);
+  input.insert(input.end(), nearOne.begin(), nearOne.end());
+  std::vector<float> output(input.size());
+
+  for (FastMathKernel kernel : supportedKernels()) {
+    ASSERT_EQ(setFastMathKernel(kernel), kernel);
+    fastLog(input.data(), output.data(), input.size());
+    for (size_t i = 0; i < input.size(); i++) {
+      const double expected = std::log(static_cast<double>(input[i]));
+      ASSERT_LE(std::fabs(output[i] - expected),
+                FASTMATH_LOG_MAX_ABS_ERROR +
+                    FASTMATH_LOG_MAX_REL_ERROR * std::fabs(expected))
+          << fastMathKernelName(kernel) << " log(" << input[i] << ")";
+    }
+  }
+}
+
+/** @brief Given values through the polynomial, exponential and saturated
+ * ranges, assert that every kernel meets the error bound of fastTanh and
+ * stays within [-1, 1]. */
+TEST_F(FastMathTest, TanhAccuracy) {
+  std::vector<float> input = linearSweep(-20.0f, 20.0f);
+  std::vector<float> output(input.size());
+
+  for (FastMathKernel kernel : supportedKernels()) {
+    ASSERT_EQ(setFastMathKernel(kernel), kernel);
+    fastTanh(input.data(), output.data(), input.size());
+    for (size_t i = 0; i < input.size(); i++) {
+      const double expected = std::tanh(static_cast<double>(input[i]));
+      ASSERT_LE(std::fabs(output[i] - expected), FASTMATH_TANH_MAX_ABS_ERROR)
+          << fastMathKernelName(kernel) << " tanh(" << input[i] << ")";
+      ASSERT_LE(std::fabs(output[i]), 1.0f);
+    }
+  }
+}
+
+/** @brief Given positive values over 70 decades, assert that every kernel
+ * gives the exact square root and meets the error bound of fastRsqrt. */
+TEST_F(FastMathTest, SqrtAndRsqrtAccuracy) {
+  std::vector<float> input = logSweep(-37.0f, 37.0f);
+  std::vector<float> roots(input.size());
+  std::vector<float> inverseRoots(input.size());
+
+  for (FastMathKernel kernel : supportedKernels()) {
+    ASSERT_EQ(setFastMathKernel(kernel), kernel);
+    fastSqrt(input.data(), roots.data(), input.size());
+    fastRsqrt(input.data(), inverseRoots.data(), input.size());
+    for (size_t i = 0; i < input.size(); i++) {
+      ASSERT_EQ(roots[i], std::sqrt(input[i]))
+          << fastMathKernelName(kernel) << " sqrt(" << input[i] << ")";
+      const double expected = 1.0 / std::sqrt(static_cast<double>(input[i]));
+      ASSERT_LE(std::fabs(inverseRoots[i] - expected) / expected,
+                FASTMATH_RSQRT_MAX_REL_ERROR)
+          << fastMathKernelName(kernel) << " rsqrt(" << input[i] << ")";
+    }
+  }
+}
+
+/** @brief Given points on circles of several radii, including the axes and
+ * the origin, assert that fastAtan2 meets its error bound. */
+TEST_F(FastMathTest, Atan2Accuracy) {
+  const std::vector<float> angles = linearSweep(-3.14159f, 3.14159f);
+  for (float radius : {1e-3f, 1.0f, 17.0f, 1e4f}) {
+    for (float angle : angles) {
+      const float x = radius * std::cos(angle);
+      const float y = radius * std::sin(angle);
+      ASSERT_NEAR(fastAtan2(y, x), std::atan2(y, x),
+                  FASTMATH_ATAN2_MAX_ABS_ERROR)
+          << "(" << x << ", " << y << ")";
+    }
+  }
+
+  for (float x : {-2.0f, 0.0f, 2.0f}) {
+    for (float y : {-2.0f, 0.0f, 2.0f}) {
+      EXPECT_NEAR(fastAtan2(y, x), std::atan2(y, x),
+                  FASTMATH_ATAN2_MAX_ABS_ERROR)
+          << "(" << x << ", " << y << ")";
+    }
+  }
+}
+
+/** @brief Given inputs outside the documented ranges, assert that every kernel
+ * clamps them rather than returning inf or NaN. */
+TEST_F(FastMathTest, OutOfRangeInputsAreClamped) {
+  std::vector<float> input = {-1000.0f, 1000.0f, 0.0f, -1.0f, 1e-40f};
+  std::vector<float> output(input.size());
+
+  for (FastMathKernel kernel : supportedKernels()) {
+    ASSERT_EQ(setFastMathKernel(kernel), kernel);
+    fastExp(input.data(), output.data(), 2);
+    EXPECT_EQ(output[0], fastExp(FASTMATH_EXP_MIN_INPUT));
+    EXPECT_TRUE(std::isfinite(output[1])) << fastMathKernelName(kernel);
+
+    fastLog(&input[2], output.data(), 3);
+    for (size_t i = 0; i < 3; i++) {
+      EXPECT_NEAR(output[i], std::log(FLT_MIN), 1e-5f)
+          << fastMathKernelName(kernel) << " log(" << input[2 + i] << ")";
+    }
+
+    fastTanh(input.data(), output.data(), 2);
+    EXPECT_FLOAT_EQ(output[0], -1.0f);
+    EXPECT_FLOAT_EQ(output[1], 1.0f);
+  }
+}
+
+/** @brief Given the output aliasing the input, assert that every kernel gives
+ * the same values as the scalar functions. */
+TEST_F(FastMathTest, InPlaceMatchesScalar) {
+  const std::vector<float> input = linearSweep(-3.0f, 3.0f);
+
+  for (FastMathKernel kernel : supportedKernels()) {
+    ASSERT_EQ(setFastMathKernel(kernel), kernel);
+    std::vector<float> values = input;
+    fastTanh(values.data(), values.data(), values.size());
+    for (size_t i = 0; i < input.size(); i++) {
+      ASSERT_NEAR(values[i], fastTanh(input[i]), 2e-7f)
+          << fastMathKernelName(kernel);
+    }
+  }
+}
+
+/**
+ * @brief Time a block function.
+ *
+ * @param function Block function.
+ * @param input Input values.
+ * @param output Output values.
+ * @return double Time per value (ns).
+ */
+static double timeBlock(void (*function)(const float*, float*, size_t),
+                        const std::vector<float>& input,
+                        std::vector<float>& output) {
+  const int iterations = 200;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    function(input.data(), output.data(), input.size());
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double, std::nano> elapsed = end - start;
+  return elapsed.count() / iterations / input.size();
+}
+
+/** @brief Report the cost per value of libm and of every kernel of each
+ * function, on blocks the size of an FFT frame. */
+TEST_F(FastMathTest, KernelCostReport) {
+  const size_t blockSize = 2048;
+  std::vector<float> input(blockSize);
+  std::vector<float> output(blockSize);
+  for (size_t i = 0; i < blockSize; i++) {
+    input[i] = 0.1f + 4.0f * i / blockSize;
+  }
+
+  struct Function {
+    const char* name;
+    void (*block)(const float*, float*, size_t);
+    void (*libm)(const float*, float*, size_t);
+  };
+  const Function functions[] = {
+      {"tanh", fastTanh,
+       [](const float* in, float* out, size_t n) {
+         for (size_t i = 0; i < n; i++) out[i] = std::tanh(in[i]);
+       }},
+      {"log", fastLog,
+       [](const float* in, float* out, size_t n) {
+         for (size_t i = 0; i < n; i++) out[i] = std::log(in[i]);
+       }},
+      {"exp", fastExp,
+       [](const float* in, float* out, size_t n) {
+         for (size_t i = 0; i < n; i++) out[i] = std::exp(in[i]);
+       }},
+      {"sqrt", fastSqrt,
+       [](const float* in, float* out, size_t n) {
+         for (size_t i = 0; i < n; i++) out[i] = std::sqrt(in[i]);
+       }},
+      {"rsqrt", fastRsqrt,
+       [](const float* in, float* out, size_t n) {
+         for (size_t i = 0; i < n; i++) out[i] = 1.0f / std::sqrt(in[i]);
+       }},
+  };
+
+  for (const Function& function : functions) {
+    std::cout << "  " << function.name << " ns per value: libm "
+              << timeBlock(function.libm, input, output);
+    for (FastMathKernel kernel : supportedKernels()) {
+      setFastMathKernel(kernel);
+      std::cout << ", " << fastMathKernelName(kernel) << " "
+                << timeBlock(function.block, input, output);
+    }
+    std::cout << std::endl;
+  }
+}
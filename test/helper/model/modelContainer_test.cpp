@@ -0,0 +1,130 @@
+/**
+ ******************************************************************************
+ * @file    modelContainer_test.cpp
+ * @brief   Unit tests for the validation of model containers and their
+ *          memory mapping.
+ ******************************************************************************
+ */
+
+#include "modelContainer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <string>
+
+#include "mappedFile.h"
+#include "model_test_helper.h"
+
+/** @brief Container with a 2 x 3 and a 1 x 1 section. */
+static TestModelImage smallModel() {
+  return buildTestModel({{7, 2, 3, {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}},
+                         {9, 1, 1, {-0.5f}}});
+}
+
+/** @brief Given the check value of CRC-32, assert that the checksum matches
+ * zlib.crc32 used by the export script. */
+TEST(ModelContainerTest, ChecksumMatchesZlib) {
+  const char* text = "123456789";
+  EXPECT_EQ(modelChecksum(reinterpret_cast<const uint8_t*>(text), 9),
+            0xCBF43926U);
+}
+
+/** @brief Given a valid container, assert that its sections are read in place
+ * with their shapes checked. */
+TEST(ModelContainerTest, SectionsAreReadInPlace) {
+  TestModelImage image = smallModel();
+  ModelContainer container;
+  ASSERT_EQ(container.open(image.bytes, image.size), ModelStatus::OK);
+  EXPECT_EQ(container.getVersion(), MODEL_FORMAT_VERSION);
+
+  ModelStatus status = ModelStatus::OK;
+  const float* values = container.getFloatSection(7, 2, 3, status);
+  ASSERT_NE(values, nullptr);
+  EXPECT_EQ(status, ModelStatus::OK);
+  EXPECT_EQ(reinterpret_cast<const uint8_t*>(values),
+            image.bytes + container.findSection(7)->offset);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(values) % MODEL_ALIGNMENT, 0U);
+  EXPECT_EQ(values[5], 6.0f);
+
+  EXPECT_EQ(container.getFloatSection(9, 1, 2, status), nullptr);
+  EXPECT_EQ(status, ModelStatus::BAD_SHAPE);
+  EXPECT_EQ(container.getFloatSection(8, 1, 1, status), nullptr);
+  EXPECT_EQ(status, ModelStatus::MISSING_SECTION);
+}
+
+/** @brief Given damaged containers, assert that each is rejected with the
+ * reason and leaves the view empty. */
+TEST(ModelContainerTest, DamagedContainersAreRejected) {
+  ModelContainer container;
+  TestModelImage image = smallModel();
+
+  EXPECT_EQ(container.open(image.bytes, sizeof(ModelHeader) - 1),
+            ModelStatus::TOO_SMALL);
+  EXPECT_EQ(container.open(image.bytes, image.size - 1),
+            ModelStatus::TOO_SMALL);
+  EXPECT_EQ(container.open(image.bytes + 4, image.size),
+            ModelStatus::MISALIGNED);
+
+  image = smallModel();
+  image.header().magic ^= 1U;
+  EXPECT_EQ(container.open(image.bytes, image.size), ModelStatus::BAD_MAGIC);
+
+  image = smallModel();
+  image.header().version = MODEL_FORMAT_VERSION + 1;
+  EXPECT_EQ(container.open(image.bytes, image.size), ModelStatus::BAD_VERSION);
+
+  image = smallModel();
+  image.bytes[image.section(0).offset] ^= 0x40U;
+  EXPECT_EQ(container.open(image.bytes, image.size),
+            ModelStatus::BAD_CHECKSUM);
+
+  image = smallModel();
+  image.section(1).offset = static_cast<uint32_t>(image.size);
+  image.reseal();
+  EXPECT_EQ(container.open(image.bytes, image.size), ModelStatus::BAD_SECTION);
+
+  image = smallModel();
+  image.section(0).offset += 4;
+  image.reseal();
+  EXPECT_EQ(container.open(image.bytes, image.size), ModelStatus::BAD_SECTION);
+
+  image = smallModel();
+  image.section(0).type = 99;
+  image.reseal();
+  EXPECT_EQ(container.open(image.bytes, image.size), ModelStatus::BAD_SECTION);
+
+  EXPECT_FALSE(container.isOpen());
+  EXPECT_EQ(container.findSection(7), nullptr);
+}
+
+/** @brief Given a container written to a file, assert that the mapped file
+ * opens and that its sections point into the mapping. */
+TEST(ModelContainerTest, MappedFileIsReadInPlace) {
+  const TestModelImage image = smallModel();
+  const std::string path = ::testing::TempDir() + "model_container_test.bin";
+  FILE* file = std::fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(std::fwrite(image.bytes, 1, image.size, file), image.size);
+  std::fclose(file);
+
+  MappedFile mapped;
+  ASSERT_TRUE(mapped.open(path));
+  ASSERT_EQ(mapped.getSize(), image.size);
+
+  ModelContainer container;
+  ASSERT_EQ(container.open(mapped.getData(), mapped.getSize()),
+            ModelStatus::OK);
+  ModelStatus status = ModelStatus::OK;
+  const float* values = container.getFloatSection(9, 1, 1, status);
+  ASSERT_NE(values, nullptr);
+  EXPECT_GE(reinterpret_cast<const uint8_t*>(values), mapped.getData());
+  EXPECT_LT(reinterpret_cast<const uint8_t*>(values),
+            mapped.getData() + mapped.getSize());
+  EXPECT_EQ(*values, -0.5f);
+
+  mapped.close();
+  EXPECT_EQ(mapped.getData(), nullptr);
+  EXPECT_FALSE(mapped.open(path + ".missing"));
+  std::remove(path.c_str());
+}
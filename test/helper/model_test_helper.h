@@ -0,0 +1,78 @@
+/**
+ ******************************************************************************
+ * @file    model_test_helper.h
+ * @brief   Builds model containers in memory for testing.
+ ******************************************************************************
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "modelContainer.h"
+
+/** @brief Float section of a test container. */
+struct TestModelSection {
+  uint32_t id;
+  uint16_t rows;
+  uint16_t cols;
+  std::vector<float> values;
+};
+
+/** @brief Container bytes, aligned to MODEL_ALIGNMENT. */
+struct TestModelImage {
+  alignas(MODEL_ALIGNMENT) uint8_t bytes[4096];
+  size_t size;
+
+  /** @brief Header of the container. */
+  ModelHeader& header() { return *reinterpret_cast<ModelHeader*>(bytes); }
+
+  /** @brief Entry of the section table. */
+  ModelSection& section(size_t index) {
+    return reinterpret_cast<ModelSection*>(bytes + sizeof(ModelHeader))[index];
+  }
+
+  /** @brief Recompute the checksum after editing the container. */
+  void reseal() {
+    header().checksum = modelChecksum(bytes + sizeof(ModelHeader),
+                                      header().totalSize - sizeof(ModelHeader));
+  }
+};
+
+/**
+ * @brief Lay out sections the way export_model.py does.
+ *
+ * @param sections Float sections.
+ * @return TestModelImage The sealed container.
+ */
+inline TestModelImage buildTestModel(
+    const std::vector<TestModelSection>& sections) {
+  auto align = [](size_t offset) {
+    return (offset + MODEL_ALIGNMENT - 1) / MODEL_ALIGNMENT * MODEL_ALIGNMENT;
+  };
+
+  TestModelImage image{};
+  size_t offset =
+      align(sizeof(ModelHeader) + sections.size() * sizeof(ModelSection));
+  for (size_t i = 0; i < sections.size(); i++) {
+    const TestModelSection& section = sections[i];
+    image.section(i) = ModelSection{section.id,
+                                    static_cast<uint32_t>(offset),
+                                    section.rows,
+                                    section.cols,
+                                    MODEL_SECTION_F32,
+                                    0};
+    std::memcpy(image.bytes + offset, section.values.data(),
+                section.values.size() * sizeof(float));
+    offset = align(offset + section.values.size() * sizeof(float));
+  }
+
+  image.size = offset;
+  image.header() = ModelHeader{MODEL_MAGIC, MODEL_FORMAT_VERSION,
+                               static_cast<uint16_t>(sections.size()),
+                               static_cast<uint32_t>(offset), 0};
+  image.reseal();
+  return image;
+}